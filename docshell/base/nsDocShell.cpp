@@ -739,6 +739,35 @@ DecreasePrivateDocShellCount()
   }
 }
 
+// Starts loading the localStorage data of the document that aChannel is about
+// to produce on the storage thread, so that it's usually in memory by the
+// time the page's scripts first touch localStorage.
+static void
+PreloadLocalStorageForChannel(nsIChannel* aChannel)
+{
+  if (!Preferences::GetBool("dom.storage.enabled")) {
+    return;
+  }
+
+  nsIScriptSecurityManager* secMan = nsContentUtils::GetSecurityManager();
+  if (!secMan) {
+    return;
+  }
+
+  nsCOMPtr<nsIPrincipal> principal;
+  nsresult rv = secMan->GetChannelResultPrincipal(aChannel,
+                                                  getter_AddRefs(principal));
+  if (NS_FAILED(rv) || nsContentUtils::IsSystemPrincipal(principal)) {
+    return;
+  }
+
+  nsCOMPtr<nsIDOMStorageManager> storageManager =
+    do_GetService("@mozilla.org/dom/localStorage-manager;1");
+  if (storageManager) {
+    storageManager->PrecacheStorage(principal);
+  }
+}
+
 static uint64_t gDocshellIDCounter = 0;
 
 nsDocShell::nsDocShell()
@@ -8856,6 +8885,14 @@ nsDocShell::CreateContentViewer(const nsACString& aContentType,
 
   NS_ASSERTION(mLoadGroup, "Someone ignored return from Init()?");
 
+  // This is the earliest point at which we know the principal of the new
+  // document; nsGlobalWindow::PreloadLocalStorage only gets to it once the
+  // document and its window exist.
+  nsCOMPtr<nsIChannel> channel = do_QueryInterface(aRequest);
+  if (channel && mItemType == typeContent) {
+    PreloadLocalStorageForChannel(channel);
+  }
+
   // Instantiate the content viewer object
   nsCOMPtr<nsIContentViewer> viewer;
   nsresult rv = NewContentViewerObj(aContentType, aRequest, mLoadGroup,
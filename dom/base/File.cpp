@@ -32,6 +32,7 @@
 #include "nsPrintfCString.h"
 #include "mozilla/SHA1.h"
 #include "mozilla/CheckedInt.h"
+#include "mozilla/FileUtils.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/dom/BlobBinding.h"
@@ -40,6 +41,7 @@
 #include "mozilla/dom/FileBinding.h"
 #include "mozilla/dom/WorkerPrivate.h"
 #include "nsThreadUtils.h"
+#include "private/pprio.h"
 
 namespace mozilla {
 namespace dom {
@@ -1052,6 +1054,35 @@ BlobImplFile::GetInternalStream(nsIInputStream** aStream, ErrorResult& aRv)
                                           -1, -1, sFileStreamFlags);
 }
 
+void*
+BlobImplFile::CreateMappedArrayBufferContents(uint32_t* aLength)
+{
+#ifdef XP_WIN
+  // TODO: Bug 988813 - Support memory mapped array buffer for Windows platform.
+  return nullptr;
+#else
+  ErrorResult rv;
+  uint64_t length = GetSize(rv);
+  if (NS_WARN_IF(rv.Failed()) || length == 0 || length > UINT32_MAX) {
+    return nullptr;
+  }
+
+  // The mapping stays valid once the file is closed again.
+  AutoFDClose prfd;
+  if (NS_FAILED(mFile->OpenNSPRFileDesc(PR_RDONLY, 0, &prfd.rwget()))) {
+    return nullptr;
+  }
+
+  void* contents =
+    JS_CreateMappedArrayBufferContents(PR_FileDesc2NativeHandle(prfd),
+                                       mWholeFile ? 0 : mStart, length);
+  if (contents) {
+    *aLength = uint32_t(length);
+  }
+  return contents;
+#endif
+}
+
 void
 BlobImplFile::SetPath(const nsAString& aPath)
 {
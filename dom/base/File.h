@@ -401,6 +401,15 @@ public:
     return true;
   }
 
+  // Maps the contents of this blob into memory for
+  // JS_NewMappedArrayBufferWithContents, or returns nullptr if this blob can't
+  // be mapped and has to be read through GetInternalStream(). The caller owns
+  // the mapping and releases it with JS_ReleaseMappedArrayBufferContents.
+  virtual void* CreateMappedArrayBufferContents(uint32_t* aLength)
+  {
+    return nullptr;
+  }
+
 protected:
   virtual ~BlobImpl() {}
 };
@@ -906,6 +915,7 @@ public:
                                       ErrorResult& aRv) const override;
   virtual void GetInternalStream(nsIInputStream** aInputStream,
                                  ErrorResult& aRv) override;
+  virtual void* CreateMappedArrayBufferContents(uint32_t* aLength) override;
 
   void SetPath(const nsAString& aFullPath);
 
@@ -0,0 +1,189 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/dom/ScriptBytecodeCache.h"
+
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/LinkedList.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/StaticPtr.h"
+#include "nsClassHashtable.h"
+#include "nsThreadUtils.h"
+
+namespace mozilla {
+namespace dom {
+
+namespace {
+
+bool sPrefsInitialized = false;
+bool sEnabled = false;
+uint32_t sMinSourceLength = 64 * 1024;
+uint32_t sMaxCacheSizeKB = 32 * 1024;
+
+class CacheEntry final : public LinkedListElement<CacheEntry>
+{
+public:
+  CacheEntry(const nsACString& aKey, size_t aSourceLength, uint64_t aSourceHash,
+             void* aData, uint32_t aDataLength)
+    : mKey(aKey),
+      mSourceLength(aSourceLength),
+      mSourceHash(aSourceHash),
+      mData(aData),
+      mDataLength(aDataLength)
+  {}
+
+  ~CacheEntry()
+  {
+    js_free(mData);
+  }
+
+  const nsCString mKey;
+  const size_t mSourceLength;
+  const uint64_t mSourceHash;
+  void* const mData;
+  const uint32_t mDataLength;
+};
+
+class Cache final
+{
+public:
+  Cache() : mTotalSize(0) {}
+
+  CacheEntry* Get(const nsACString& aKey)
+  {
+    CacheEntry* entry = mEntries.Get(aKey);
+    if (entry) {
+      // Keep the most recently used entries at the back of the list.
+      entry->remove();
+      mLRU.insertBack(entry);
+    }
+    return entry;
+  }
+
+  void Put(CacheEntry* aEntry)
+  {
+    Remove(aEntry->mKey);
+
+    size_t maxSize = size_t(sMaxCacheSizeKB) * 1024;
+    if (aEntry->mDataLength > maxSize) {
+      delete aEntry;
+      return;
+    }
+    while (mTotalSize + aEntry->mDataLength > maxSize && !mLRU.isEmpty()) {
+      Remove(mLRU.getFirst()->mKey);
+    }
+
+    mTotalSize += aEntry->mDataLength;
+    mLRU.insertBack(aEntry);
+    mEntries.Put(aEntry->mKey, aEntry);
+  }
+
+  void Remove(const nsACString& aKey)
+  {
+    nsAutoPtr<CacheEntry> entry;
+    mEntries.RemoveAndForget(aKey, entry);
+    if (entry) {
+      entry->remove();
+      mTotalSize -= entry->mDataLength;
+    }
+  }
+
+private:
+  // mEntries owns the entries and must be destroyed first, so that they
+  // unlink themselves from mLRU.
+  LinkedList<CacheEntry> mLRU;
+  nsClassHashtable<nsCStringHashKey, CacheEntry> mEntries;
+  size_t mTotalSize;
+};
+
+StaticAutoPtr<Cache> sCache;
+
+Cache*
+GetCache()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sCache) {
+    sCache = new Cache();
+    ClearOnShutdown(&sCache);
+  }
+  return sCache;
+}
+
+} // anonymous namespace
+
+/* static */ bool
+ScriptBytecodeCache::ShouldUse(size_t aSourceLength)
+{
+  if (!sPrefsInitialized) {
+    Preferences::AddBoolVarCache(&sEnabled,
+                                 "dom.script_loader.bytecode_cache.enabled",
+                                 sEnabled);
+    Preferences::AddUintVarCache(&sMinSourceLength,
+                                 "dom.script_loader.bytecode_cache.min_length",
+                                 sMinSourceLength);
+    Preferences::AddUintVarCache(&sMaxCacheSizeKB,
+                                 "dom.script_loader.bytecode_cache.max_size_kb",
+                                 sMaxCacheSizeKB);
+    sPrefsInitialized = true;
+  }
+
+  return sEnabled && aSourceLength >= sMinSourceLength;
+}
+
+// 64-bit FNV-1a over the source text. Entries are also keyed on the URL and
+// the source length, so a collision would need a same-length change to the
+// script at the same URL that hashes identically.
+/* static */ uint64_t
+ScriptBytecodeCache::HashSource(const char16_t* aSource, size_t aSourceLength)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < aSourceLength; i++) {
+    hash ^= aSource[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/* static */ bool
+ScriptBytecodeCache::Lookup(JSContext* aCx, const nsACString& aKey,
+                            size_t aSourceLength, uint64_t aSourceHash,
+                            JS::MutableHandle<JSScript*> aScript)
+{
+  Cache* cache = GetCache();
+  CacheEntry* entry = cache->Get(aKey);
+  if (!entry || entry->mSourceLength != aSourceLength ||
+      entry->mSourceHash != aSourceHash) {
+    return false;
+  }
+
+  aScript.set(JS_DecodeScript(aCx, entry->mData, entry->mDataLength));
+  if (!aScript) {
+    // A buffer that cannot be decoded is not going to get any better.
+    JS_ClearPendingException(aCx);
+    cache->Remove(aKey);
+    return false;
+  }
+  return true;
+}
+
+/* static */ void
+ScriptBytecodeCache::Store(JSContext* aCx, const nsACString& aKey,
+                           size_t aSourceLength, uint64_t aSourceHash,
+                           JS::Handle<JSScript*> aScript)
+{
+  uint32_t length;
+  void* data = JS_EncodeScript(aCx, aScript, &length);
+  if (!data) {
+    JS_ClearPendingException(aCx);
+    return;
+  }
+
+  GetCache()->Put(new CacheEntry(aKey, aSourceLength, aSourceHash,
+                                 data, length));
+}
+
+} // namespace dom
+} // namespace mozilla
@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * A process-wide cache of XDR-encoded bytecode for large external scripts,
+ * so that loading the same script again (same URL, same source text) can
+ * skip the parser and bytecode emitter.
+ */
+
+#ifndef mozilla_dom_ScriptBytecodeCache_h
+#define mozilla_dom_ScriptBytecodeCache_h
+
+#include "jsapi.h"
+#include "nsStringGlue.h"
+
+namespace mozilla {
+namespace dom {
+
+class ScriptBytecodeCache final
+{
+public:
+  // Whether a script of the given length should go through the cache.
+  // Controlled by the dom.script_loader.bytecode_cache.* prefs.
+  static bool ShouldUse(size_t aSourceLength);
+
+  // Hash of the source text that entries are validated against. Compute
+  // this before compiling, as the compiler may take ownership of the text.
+  static uint64_t HashSource(const char16_t* aSource, size_t aSourceLength);
+
+  // Decode a previously stored script for aKey in the current compartment.
+  // Returns false if there is no entry for the given source, or if decoding
+  // failed. No exception is left pending on failure.
+  static bool Lookup(JSContext* aCx, const nsACString& aKey,
+                     size_t aSourceLength, uint64_t aSourceHash,
+                     JS::MutableHandle<JSScript*> aScript);
+
+  // Encode aScript and store it for aKey. aScript must not have been
+  // executed yet. Failures are silent.
+  static void Store(JSContext* aCx, const nsACString& aKey,
+                    size_t aSourceLength, uint64_t aSourceHash,
+                    JS::Handle<JSScript*> aScript);
+};
+
+} // namespace dom
+} // namespace mozilla
+
+#endif // mozilla_dom_ScriptBytecodeCache_h
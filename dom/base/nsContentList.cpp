@@ -671,20 +671,24 @@ nsContentList::AttributeChanged(nsIDocument *aDocument, Element* aElement,
     return;
   }
   
+  uint32_t index = FirstIndexNotBefore(aElement);
+  bool inList = index < mElements.Length() && mElements[index] == aElement;
   if (Match(aElement)) {
-    if (mElements.IndexOf(aElement) == mElements.NoIndex) {
-      // We match aElement now, and it's not in our list already.  Just dirty
-      // ourselves; this is simpler than trying to figure out where to insert
-      // aElement.
-      SetDirty();
+    if (!inList) {
+      // We match aElement now, and it's not in our list already.  If we're
+      // lazy and aElement comes after everything we have, PopulateSelf will
+      // pick it up; otherwise it goes in at |index|.
+      if (mState == LIST_UP_TO_DATE || index < mElements.Length()) {
+        mElements.InsertElementAt(index, aElement);
+      }
     }
-  } else {
-    // We no longer match aElement.  Remove it from our list.  If it's
-    // already not there, this is a no-op (though a potentially
-    // expensive one).  Either way, no change of mState is required
-    // here.
-    mElements.RemoveElement(aElement);
+  } else if (inList) {
+    // We no longer match aElement.  Remove it from our list.  No change of
+    // mState is required here.
+    mElements.RemoveElementAt(index);
   }
+
+  ASSERT_IN_SYNC;
 }
 
 void
@@ -801,9 +805,8 @@ nsContentList::ContentInserted(nsIDocument *aDocument,
   // should deal with that.
   if (mState != LIST_DIRTY &&
       MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) &&
-      nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
-      MatchSelf(aChild)) {
-    SetDirty();
+      nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild)) {
+    InsertMatchesInSubtree(aChild);
   }
 
   ASSERT_IN_SYNC;
@@ -821,9 +824,14 @@ nsContentList::ContentRemoved(nsIDocument *aDocument,
   // should deal with that.
   if (mState != LIST_DIRTY &&
       MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) &&
-      nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
-      MatchSelf(aChild)) {
-    SetDirty();
+      nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild)) {
+    if (aContainer) {
+      RemoveMatchesInSubtree(aContainer, aChild, aPreviousSibling);
+    } else if (MatchSelf(aChild)) {
+      // A child of the document itself, i.e. the root element, went
+      // away.  That takes out most of our list anyway.
+      SetDirty();
+    }
   }
 
   ASSERT_IN_SYNC;
@@ -895,6 +903,92 @@ nsContentList::MatchSelf(nsIContent *aContent)
   return false;
 }
 
+uint32_t
+nsContentList::FirstIndexNotBefore(nsIContent* aContent)
+{
+  uint32_t low = 0;
+  uint32_t high = mElements.Length();
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (nsContentUtils::PositionIsBefore(mElements[middle], aContent)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+void
+nsContentList::InsertMatchesInSubtree(nsIContent* aContent)
+{
+  uint32_t count = mElements.Length();
+  if (mState == LIST_LAZY &&
+      (count == 0 ||
+       nsContentUtils::PositionIsBefore(mElements[count - 1], aContent))) {
+    // Everything in aContent comes after what we have; be lazy.
+    return;
+  }
+
+  nsAutoTArray<nsIContent*, 8> matches;
+  if (aContent->IsElement() && Match(aContent->AsElement())) {
+    matches.AppendElement(aContent);
+  }
+  if (mDeep) {
+    for (nsIContent* cur = aContent->GetFirstChild();
+         cur;
+         cur = cur->GetNextNode(aContent)) {
+      if (cur->IsElement() && Match(cur->AsElement())) {
+        matches.AppendElement(cur);
+      }
+    }
+  }
+
+  if (matches.IsEmpty()) {
+    return;
+  }
+
+  // The new subtree is contiguous in document order, so all of its matches
+  // go in at the same place.
+  mElements.InsertElementsAt(FirstIndexNotBefore(aContent),
+                             matches.Elements(), matches.Length());
+}
+
+void
+nsContentList::RemoveMatchesInSubtree(nsIContent* aContainer,
+                                      nsIContent* aContent,
+                                      nsIContent* aPreviousSibling)
+{
+  // aContent isn't a child of aContainer anymore, so we can't compare
+  // positions against it.  Its subtree is still intact though, and it used to
+  // sit right after aPreviousSibling and its descendants, or at the start of
+  // aContainer if there was no previous sibling.
+  nsIContent* anchor = aPreviousSibling ? aPreviousSibling : aContainer;
+  uint32_t low = 0;
+  uint32_t high = mElements.Length();
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    nsIContent* cur = mElements[middle];
+    bool atOrAfterRemoved =
+      nsContentUtils::ContentIsDescendantOf(cur, aContent) ||
+      (nsContentUtils::PositionIsBefore(anchor, cur) &&
+       !(aPreviousSibling &&
+         nsContentUtils::ContentIsDescendantOf(cur, aPreviousSibling)));
+    if (atOrAfterRemoved) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+
+  uint32_t end = low;
+  while (end < mElements.Length() &&
+         nsContentUtils::ContentIsDescendantOf(mElements[end], aContent)) {
+    ++end;
+  }
+  mElements.RemoveElementsAt(low, end - low);
+}
+
 void 
 nsContentList::PopulateSelf(uint32_t aNeededLength)
 {
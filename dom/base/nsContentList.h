@@ -354,6 +354,33 @@ protected:
    */
   bool MatchSelf(nsIContent *aContent);
 
+  /**
+   * Find the index of the first element in our list that doesn't come
+   * before aContent in document order, using a binary search.
+   *
+   * @param  aContent a node in the same tree as the elements in our list
+   * @return the index aContent has, or would have, in our list
+   */
+  uint32_t FirstIndexNotBefore(nsIContent* aContent);
+
+  /**
+   * Insert the elements in the subtree rooted at aContent, including aContent
+   * itself, that match our criterion into our list.  None of them may be in
+   * the list already.  If we're lazy, elements that come after everything we
+   * have are left for PopulateSelf to find.
+   *
+   * @param  aContent the root of a subtree that was added to our tree
+   */
+  void InsertMatchesInSubtree(nsIContent* aContent);
+
+  /**
+   * Remove aContent and its descendants from our list.  aContent must just
+   * have been removed from aContainer, right after aPreviousSibling (which is
+   * null if aContent was the first child).
+   */
+  void RemoveMatchesInSubtree(nsIContent* aContainer, nsIContent* aContent,
+                              nsIContent* aPreviousSibling);
+
   /**
    * Populate our list.  Stop once we have at least aNeededLength
    * elements.  At the end of PopulateSelf running, either the last
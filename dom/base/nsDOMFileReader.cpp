@@ -12,12 +12,14 @@
 #include "nsError.h"
 #include "nsIFile.h"
 #include "nsNetCID.h"
+#include "nsStreamUtils.h"
 
 #include "nsXPCOM.h"
 #include "nsIDOMEventListener.h"
 #include "nsJSEnvironment.h"
 #include "nsCycleCollectionParticipant.h"
 #include "mozilla/Base64.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/dom/EncodingUtils.h"
 #include "mozilla/dom/File.h"
 #include "mozilla/dom/FileReaderBinding.h"
@@ -83,6 +85,7 @@ nsDOMFileReader::RootResultArrayBuffer()
 
 nsDOMFileReader::nsDOMFileReader()
   : mFileData(nullptr),
+    mMappedData(nullptr), mMappedLength(0),
     mDataLen(0), mDataFormat(FILE_AS_BINARY),
     mResultArrayBuffer(nullptr)
 {
@@ -96,6 +99,20 @@ nsDOMFileReader::~nsDOMFileReader()
   mozilla::DropJSObjects(this);
 }
 
+void
+nsDOMFileReader::FreeFileData()
+{
+  free(mFileData);
+  mFileData = nullptr;
+  mDataLen = 0;
+
+  if (mMappedData) {
+    JS_ReleaseMappedArrayBufferContents(mMappedData, mMappedLength);
+    mMappedData = nullptr;
+    mMappedLength = 0;
+  }
+}
+
 
 /**
  * This Init method is called from the factory constructor.
@@ -300,12 +317,22 @@ nsDOMFileReader::DoOnLoadEnd(nsresult aStatus,
       }
 
       RootResultArrayBuffer();
-      mResultArrayBuffer = JS_NewArrayBufferWithContents(jsapi.cx(), mTotal, mFileData);
+      if (mMappedData) {
+        mResultArrayBuffer =
+          JS_NewMappedArrayBufferWithContents(jsapi.cx(), mMappedLength,
+                                              mMappedData);
+      } else {
+        mResultArrayBuffer =
+          JS_NewArrayBufferWithContents(jsapi.cx(), mTotal, mFileData);
+      }
       if (!mResultArrayBuffer) {
         JS_ClearPendingException(jsapi.cx());
         rv = NS_ERROR_OUT_OF_MEMORY;
       } else {
-        mFileData = nullptr; // Transfer ownership
+        // Transfer ownership
+        mFileData = nullptr;
+        mMappedData = nullptr;
+        mMappedLength = 0;
       }
       break;
     }
@@ -367,7 +394,13 @@ nsDOMFileReader::DoReadData(nsIAsyncInputStream* aStream, uint64_t aCount)
     }
 
     uint32_t bytesRead = 0;
-    aStream->Read(mFileData + mDataLen, aCount, &bytesRead);
+    if (mMappedData) {
+      // The result is already mapped, this only pulls the file into the page
+      // cache ahead of the script touching it.
+      aStream->ReadSegments(NS_DiscardSegment, nullptr, aCount, &bytesRead);
+    } else {
+      aStream->Read(mFileData + mDataLen, aCount, &bytesRead);
+    }
     NS_ASSERTION(bytesRead == aCount, "failed to read data");
   }
 
@@ -452,6 +485,20 @@ nsDOMFileReader::ReadFileContent(Blob& aBlob,
   DispatchProgressEvent(NS_LITERAL_STRING(LOADSTART_STR));
 
   if (mDataFormat == FILE_AS_ARRAYBUFFER) {
+    // Map large files instead of copying them onto the heap. A file that is
+    // truncated while it is mapped makes accessing the missing pages fault,
+    // so this is off unless the threshold pref is set.
+    uint32_t mmapThreshold =
+      Preferences::GetUint("dom.filereader.mmap_threshold", 0);
+    if (mmapThreshold && mTotal >= mmapThreshold) {
+      mMappedData =
+        mBlob->Impl()->CreateMappedArrayBufferContents(&mMappedLength);
+      if (mMappedData && mMappedLength == mTotal) {
+        return;
+      }
+      FreeFileData();
+    }
+
     mFileData = js_pod_malloc<char>(mTotal);
     if (!mFileData) {
       NS_WARNING("Preallocation failed for ReadFileData");
@@ -134,13 +134,13 @@ protected:
   nsresult GetAsDataURL(Blob *aBlob, const char *aFileData,
                         uint32_t aDataLen, nsAString &aResult);
 
-  void FreeFileData() {
-    free(mFileData);
-    mFileData = nullptr;
-    mDataLen = 0;
-  }
+  void FreeFileData();
 
   char *mFileData;
+  // For array buffers over the mmap threshold, the file mapped into memory.
+  // The data that is read is then only used for progress events.
+  void *mMappedData;
+  uint32_t mMappedLength;
   nsRefPtr<Blob> mBlob;
   nsCString mCharset;
   uint32_t mDataLen;
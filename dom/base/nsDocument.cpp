@@ -250,6 +250,7 @@ typedef nsTArray<Link*> LinkArray;
 
 static PRLogModuleInfo* gDocumentLeakPRLog;
 static PRLogModuleInfo* gCspPRLog;
+static PRLogModuleInfo* gPageCachePRLog;
 
 #define NAME_NOT_VALID ((nsSimpleContentList*)1)
 
@@ -1540,6 +1541,9 @@ nsDocument::nsDocument(const char* aContentType)
   if (!gCspPRLog)
     gCspPRLog = PR_NewLogModule("CSP");
 
+  if (!gPageCachePRLog)
+    gPageCachePRLog = PR_NewLogModule("PageCache");
+
   // Start out mLastStyleSheetSet as null, per spec
   SetDOMStringToNull(mLastStyleSheetSet);
 
@@ -2091,6 +2095,7 @@ NS_IMPL_CYCLE_COLLECTION_UNLINK_END
 
 static bool sPrefsInitialized = false;
 static uint32_t sOnloadDecodeLimit = 0;
+static uint32_t sPreloadPriorityDecodeLimit = 0;
 
 nsresult
 nsDocument::Init()
@@ -2102,6 +2107,8 @@ nsDocument::Init()
   if (!sPrefsInitialized) {
     sPrefsInitialized = true;
     Preferences::AddUintVarCache(&sOnloadDecodeLimit, "image.onload.decode.limit", 0);
+    Preferences::AddUintVarCache(&sPreloadPriorityDecodeLimit,
+                                 "image.preload.priority_decode.limit", 8);
   }
 
   // Force initialization.
@@ -8706,19 +8713,36 @@ nsDocument::EnumerateSubDocuments(nsSubDocEnumFunc aCallback, void *aData)
   }
 }
 
-#ifdef DEBUG_bryner
-#define DEBUG_PAGE_CACHE
-#endif
+// Logs why a document can't go into the bfcache, so that pages which always
+// reload on back/forward can be diagnosed with NSPR_LOG_MODULES=PageCache:4.
+static void
+LogPageCacheRejection(nsIDocument* aDocument, const char* aReason)
+{
+  if (!MOZ_LOG_TEST(gPageCachePRLog, LogLevel::Debug)) {
+    return;
+  }
+
+  nsAutoCString spec;
+  nsIURI* uri = aDocument->GetDocumentURI();
+  if (uri) {
+    uri->GetSpec(spec);
+  }
+  MOZ_LOG(gPageCachePRLog, LogLevel::Debug,
+          ("document %p (%s) can't be cached: %s",
+           aDocument, spec.get(), aReason));
+}
 
 bool
 nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
 {
   if (EventHandlingSuppressed()) {
+    LogPageCacheRejection(this, "event handling suppressed");
     return false;
   }
 
   nsPIDOMWindow* win = GetInnerWindow();
   if (win && win->TimeoutSuspendCount()) {
+    LogPageCacheRejection(this, "timeouts suspended");
     return false;
   }
 
@@ -8727,6 +8751,7 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
   if (piTarget) {
     EventListenerManager* manager = piTarget->GetExistingListenerManager();
     if (manager && manager->HasUnloadListeners()) {
+      LogPageCacheRejection(this, "unload or beforeunload listener");
       return false;
     }
   }
@@ -8754,15 +8779,13 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
 
       nsCOMPtr<nsIRequest> request = do_QueryInterface(elem);
       if (request && request != aNewRequest && request != baseChannel) {
-#ifdef DEBUG_PAGE_CACHE
-        nsAutoCString requestName, docSpec;
-        request->GetName(requestName);
-        if (mDocumentURI)
-          mDocumentURI->GetSpec(docSpec);
-
-        printf("document %s has request %s\n",
-               docSpec.get(), requestName.get());
-#endif
+        if (MOZ_LOG_TEST(gPageCachePRLog, LogLevel::Debug)) {
+          nsAutoCString requestName;
+          request->GetName(requestName);
+          nsAutoCString reason("pending request ");
+          reason.Append(requestName);
+          LogPageCacheRejection(this, reason.get());
+        }
         return false;
       }
     }
@@ -8772,6 +8795,7 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
   // Check if we have active GetUserMedia use
   if (MediaManager::Exists() && win &&
       MediaManager::Get()->IsWindowStillActive(win->WindowID())) {
+    LogPageCacheRejection(this, "active getUserMedia");
     return false;
   }
 #endif // MOZ_MEDIA_NAVIGATOR
@@ -8785,6 +8809,7 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
     bool active;
     pcManager->HasActivePeerConnection(win->WindowID(), &active);
     if (active) {
+      LogPageCacheRejection(this, "active PeerConnection");
       return false;
     }
   }
@@ -8793,6 +8818,7 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
   // Don't save presentations for documents containing MSE content, to
   // reduce memory usage.
   if (ContainsMSEContent()) {
+    LogPageCacheRejection(this, "MSE content");
     return false;
   }
 
@@ -8804,6 +8830,7 @@ nsDocument::CanSavePresentation(nsIRequest *aNewRequest)
       // The aIgnoreRequest we were passed is only for us, so don't pass it on.
       bool canCache = subdoc ? subdoc->CanSavePresentation(nullptr) : false;
       if (!canCache) {
+        LogPageCacheRejection(this, "subdocument can't be cached");
         return false;
       }
     }
@@ -9701,7 +9728,8 @@ nsDocument::ResolvePreloadImage(nsIURI *aBaseURI,
 
 void
 nsDocument::MaybePreLoadImage(nsIURI* uri, const nsAString &aCrossOriginAttr,
-                              ReferrerPolicy aReferrerPolicy)
+                              ReferrerPolicy aReferrerPolicy,
+                              const CSSIntSize& aSizeHint)
 {
   // Early exit if the img is already present in the img-cache
   // which indicates that the "real" load has already started and
@@ -9741,12 +9769,32 @@ nsDocument::MaybePreLoadImage(nsIURI* uri, const nsAString &aCrossOriginAttr,
                               NS_LITERAL_STRING("img"),
                               getter_AddRefs(request));
 
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  // We don't know yet which images will be visible, but the first few in the
+  // document are the most likely to be above the fold, so start decoding them
+  // as soon as their data arrives instead of waiting for layout.
+  if (mPriorityDecodePreloads < sPreloadPriorityDecodeLimit) {
+    mPriorityDecodePreloads++;
+
+    // Only use the size hint if we know how it maps to device pixels.
+    gfx::IntSize decodeSize;
+    nsIPresShell* shell = GetShell();
+    nsPresContext* presContext = shell ? shell->GetPresContext() : nullptr;
+    if (presContext) {
+      decodeSize = gfx::IntSize(
+        NSToIntRound(presContext->CSSPixelsToDevPixels(float(aSizeHint.width))),
+        NSToIntRound(presContext->CSSPixelsToDevPixels(float(aSizeHint.height))));
+    }
+    request->RequestPriorityDecode(decodeSize);
+  }
+
   // Pin image-reference to avoid evicting it from the img-cache before
   // the "real" load occurs. Unpinned in DispatchContentLoadedEvents and
   // unlink
-  if (NS_SUCCEEDED(rv)) {
-    mPreloadingImages.Put(uri, request.forget());
-  }
+  mPreloadingImages.Put(uri, request.forget());
 }
 
 void
@@ -7,6 +7,7 @@
 #include "nsGlobalWindow.h"
 
 #include <algorithm>
+#include <math.h>
 
 #include "mozilla/MemoryReporting.h"
 
@@ -302,6 +303,33 @@ nsGlobalWindow::DOMMinTimeoutValue() const {
     std::max(isBackground ? gMinBackgroundTimeoutValue : gMinTimeoutValue, 0);
 }
 
+// Rounds the deadline of a clamped timeout in a background window up to the
+// next multiple of gMinBackgroundTimeoutValue, so that the timers of all
+// background windows wake the timer thread up together rather than each at
+// its own time. Returns the delay from aNow to the aligned deadline.
+//
+// Only delays up to the clamp itself are aligned; longer ones are left alone,
+// since pushing them back by up to another gMinBackgroundTimeoutValue would
+// add a noticeable amount to what the page asked for.
+static TimeDuration
+AlignBackgroundTimeoutDelay(const TimeStamp& aNow, const TimeDuration& aDelay)
+{
+  if (gMinBackgroundTimeoutValue <= 0 ||
+      aDelay > TimeDuration::FromMilliseconds(gMinBackgroundTimeoutValue)) {
+    return aDelay;
+  }
+
+  static TimeStamp sAlignmentEpoch;
+  if (sAlignmentEpoch.IsNull()) {
+    sAlignmentEpoch = aNow;
+  }
+
+  double period = gMinBackgroundTimeoutValue;
+  double whenMs = (aNow + aDelay - sAlignmentEpoch).ToMilliseconds();
+  double alignedMs = ceil(whenMs / period) * period;
+  return aDelay + TimeDuration::FromMilliseconds(alignedMs - whenMs);
+}
+
 // The number of nested timeouts before we start clamping. HTML5 says 1, WebKit
 // uses 5.
 #define DOM_CLAMP_TIMEOUT_NESTING_LEVEL 5
@@ -12470,6 +12498,13 @@ nsGlobalWindow::SetTimeoutOrInterval(nsIScriptTimeoutHandler *aHandler,
     // Don't allow timeouts less than DOMMinTimeoutValue() from
     // now...
     realInterval = std::max(realInterval, uint32_t(DOMMinTimeoutValue()));
+
+    if (!mOuterWindow || mOuterWindow->IsBackground()) {
+      TimeDuration aligned =
+        AlignBackgroundTimeoutDelay(TimeStamp::Now(),
+                                    TimeDuration::FromMilliseconds(realInterval));
+      realInterval = uint32_t(ceil(aligned.ToMilliseconds()));
+    }
   }
 
   // Get principal of currently executing code, save for execution of timeout.
@@ -12743,6 +12778,10 @@ nsGlobalWindow::RescheduleTimeout(nsTimeout* aTimeout, const TimeStamp& now,
     delay = TimeDuration(0);
   }
 
+  if (!mOuterWindow || mOuterWindow->IsBackground()) {
+    delay = AlignBackgroundTimeoutDelay(currentNow, delay);
+  }
+
   if (!aTimeout->mTimer) {
     NS_ASSERTION(IsFrozen() || mTimeoutsSuspendDepth,
                  "How'd our timer end up null if we're not frozen or "
@@ -13006,10 +13045,12 @@ nsresult nsGlobalWindow::ResetTimersForNonBackgroundWindow()
     }
 
     if (timeout->mWhen - now >
-        TimeDuration::FromMilliseconds(gMinBackgroundTimeoutValue)) {
+        TimeDuration::FromMilliseconds(2 * gMinBackgroundTimeoutValue)) {
       // No need to loop further.  Timeouts are sorted in mWhen order
       // and the ones after this point were all set up for at least
-      // gMinBackgroundTimeoutValue ms and hence were not clamped.
+      // gMinBackgroundTimeoutValue ms and hence were not clamped.  Clamped
+      // timeouts may have been aligned by up to another
+      // gMinBackgroundTimeoutValue ms, see AlignBackgroundTimeoutDelay.
       break;
     }
 
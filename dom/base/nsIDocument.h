@@ -2046,11 +2046,14 @@ public:
    * Called by nsParser to preload images. Can be removed and code moved
    * to nsPreloadURIs::PreloadURIs() in file nsParser.cpp whenever the
    * parser-module is linked with gklayout-module.  aCrossOriginAttr should
-   * be a void string if the attr is not present.
+   * be a void string if the attr is not present.  aSizeHint is the size the
+   * image's width and height attributes give it, with a zero dimension for a
+   * missing attribute.
    */
   virtual void MaybePreLoadImage(nsIURI* uri,
                                  const nsAString& aCrossOriginAttr,
-                                 ReferrerPolicyEnum aReferrerPolicy) = 0;
+                                 ReferrerPolicyEnum aReferrerPolicy,
+                                 const mozilla::CSSIntSize& aSizeHint) = 0;
 
   /**
    * Called by images to forget an image preload when they start doing
@@ -2775,6 +2775,59 @@ FindMatchingElementsWithId(const nsAString& aId, nsINode* aRoot,
   }
 }
 
+// Returns whether aSelectorList is a single compound selector made up of only
+// a type selector and class selectors, like "div", ".foo" or "li.a.b".  Those
+// can be matched against element names and classes directly, without going
+// through SelectorListMatches for every element.
+static bool
+IsTypeOrClassOnlySelector(nsCSSSelectorList* aSelectorList)
+{
+  if (aSelectorList->mNext) {
+    return false;
+  }
+  nsCSSSelector* sel = aSelectorList->mSelectors;
+  return !sel->mNext &&
+         !sel->mIDList &&
+         !sel->mPseudoClassList &&
+         !sel->mAttrList &&
+         !sel->mNegations &&
+         sel->mNameSpace == kNameSpaceID_Unknown &&
+         (sel->mLowercaseTag || sel->mClassList);
+}
+
+// Matches aElement against a selector for which IsTypeOrClassOnlySelector
+// returned true, the same way SelectorMatches does.
+static bool
+TypeOrClassOnlySelectorMatches(Element* aElement, nsCSSSelector* aSelector,
+                               bool aIsHTMLDocument, bool aCaseSensitive)
+{
+  if (aSelector->mLowercaseTag) {
+    nsIAtom* selectorTag = (aIsHTMLDocument && aElement->IsHTMLElement()) ?
+      aSelector->mLowercaseTag : aSelector->mCasedTag;
+    if (selectorTag != aElement->NodeInfo()->NameAtom()) {
+      return false;
+    }
+  }
+
+  nsAtomList* classList = aSelector->mClassList;
+  if (classList) {
+    const nsAttrValue* elementClasses = aElement->GetClasses();
+    if (!elementClasses) {
+      return false;
+    }
+    do {
+      if (!elementClasses->Contains(classList->mAtom,
+                                    aCaseSensitive ? eCaseMatters
+                                                   : eIgnoreCase)) {
+        return false;
+      }
+      classList = classList->mNext;
+    } while (classList);
+  }
+
+  return true;
+}
+
 // Actually find elements matching aSelectorList (which must not be
 // null) and which are descendants of aRoot and put them in aList.  If
 // onlyFirstMatch, then stop once the first one is found.
@@ -2812,18 +2865,39 @@ FindMatchingElements(nsINode* aRoot, nsCSSSelectorList* aSelectorList, T &aList,
   }
 
   Collector results;
-  for (nsIContent* cur = aRoot->GetFirstChild();
-       cur;
-       cur = cur->GetNextNode(aRoot)) {
-    if (cur->IsElement() &&
-        nsCSSRuleProcessor::SelectorListMatches(cur->AsElement(),
-                                                matchingContext,
-                                                aSelectorList)) {
-      if (onlyFirstMatch) {
-        aList.AppendElement(cur->AsElement());
-        return;
+  if (IsTypeOrClassOnlySelector(aSelectorList)) {
+    nsCSSSelector* selector = aSelectorList->mSelectors;
+    // Class selectors are case-insensitive in quirks mode, see bug 93371.
+    bool caseSensitive =
+      doc->GetCompatibilityMode() != eCompatibility_NavQuirks;
+    bool isHTMLDocument = doc->IsHTMLDocument();
+    for (nsIContent* cur = aRoot->GetFirstChild();
+         cur;
+         cur = cur->GetNextNode(aRoot)) {
+      if (cur->IsElement() &&
+          TypeOrClassOnlySelectorMatches(cur->AsElement(), selector,
+                                         isHTMLDocument, caseSensitive)) {
+        if (onlyFirstMatch) {
+          aList.AppendElement(cur->AsElement());
+          return;
+        }
+        results.AppendElement(cur->AsElement());
+      }
+    }
+  } else {
+    for (nsIContent* cur = aRoot->GetFirstChild();
+         cur;
+         cur = cur->GetNextNode(aRoot)) {
+      if (cur->IsElement() &&
+          nsCSSRuleProcessor::SelectorListMatches(cur->AsElement(),
+                                                  matchingContext,
+                                                  aSelectorList)) {
+        if (onlyFirstMatch) {
+          aList.AppendElement(cur->AsElement());
+          return;
+        }
+        results.AppendElement(cur->AsElement());
       }
-      results.AppendElement(cur->AsElement());
     }
   }
 
@@ -52,7 +52,9 @@
 #include "mozilla/dom/EncodingUtils.h"
 
 #include "mozilla/Attributes.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/unused.h"
+#include "mozilla/dom/ScriptBytecodeCache.h"
 #include "mozilla/dom/SRICheck.h"
 #include "nsIScriptError.h"
 
@@ -76,6 +78,19 @@ using namespace mozilla::dom;
 // context, but it will AddRef and Release it on other threads.
 NS_IMPL_ISUPPORTS0(nsScriptLoadRequest)
 
+nsScriptLoadRequest::~nsScriptLoadRequest()
+{
+  js_free(mScriptTextBuf);
+
+  // A request that was parsed off the main thread can be dropped before it
+  // runs, e.g. when the document goes away. Finish the parse so the JS engine
+  // does not leak it.
+  if (mOffThreadToken) {
+    MOZ_ASSERT(NS_IsMainThread());
+    JS::FinishOffThreadScript(nullptr, xpc::GetJSRuntime(), mOffThreadToken);
+  }
+}
+
 nsScriptLoadRequestList::~nsScriptLoadRequestList()
 {
   Clear();
@@ -840,6 +855,14 @@ nsScriptLoader::ProcessOffThreadRequest(nsScriptLoadRequest* aRequest)
 {
   MOZ_ASSERT(aRequest->mProgress == nsScriptLoadRequest::Progress_Compiling);
   aRequest->mProgress = nsScriptLoadRequest::Progress_DoneCompiling;
+  if (!aRequest->mIsAsync) {
+    // Requests that must run in order are still in their queue, and run from
+    // there once everything ahead of them is ready. If the request has been
+    // dropped in the meantime, its destructor finishes the off-thread parse.
+    ProcessPendingRequests();
+    mDocument->UnblockOnload(false);
+    return NS_OK;
+  }
   nsresult rv = ProcessRequest(aRequest);
   mDocument->UnblockOnload(false);
   return rv;
@@ -887,10 +910,37 @@ OffThreadScriptLoaderCallback(void *aToken, void *aCallbackData)
   NS_DispatchToMainThread(aRunnable);
 }
 
+// Whether external scripts that must run in order (parser-blocking, defer,
+// XSLT and ordered script-inserted ones) should also be parsed off the main
+// thread while they wait for their turn, when they are at least
+// dom.script_loader.off_thread_parse_all.min_length characters long.
+static bool
+ShouldParseOrderedScriptOffThread(size_t aScriptTextLength)
+{
+  static bool sPrefsInitialized = false;
+  static bool sEnabled = false;
+  static uint32_t sMinLength = 20 * 1024;
+  if (!sPrefsInitialized) {
+    Preferences::AddBoolVarCache(&sEnabled,
+                                 "dom.script_loader.off_thread_parse_all.enabled",
+                                 sEnabled);
+    Preferences::AddUintVarCache(&sMinLength,
+                                 "dom.script_loader.off_thread_parse_all.min_length",
+                                 sMinLength);
+    sPrefsInitialized = true;
+  }
+  return sEnabled && aScriptTextLength >= sMinLength;
+}
+
 nsresult
 nsScriptLoader::AttemptAsyncScriptParse(nsScriptLoadRequest* aRequest)
 {
-  if (!aRequest->mElement->GetScriptAsync() || aRequest->mIsInline) {
+  if (aRequest->mIsInline || aRequest->IsPreload()) {
+    return NS_ERROR_FAILURE;
+  }
+
+  if (!aRequest->mElement->GetScriptAsync() &&
+      !ShouldParseOrderedScriptOffThread(aRequest->mScriptTextLength)) {
     return NS_ERROR_FAILURE;
   }
 
@@ -1204,14 +1254,61 @@ nsScriptLoader::EvaluateScript(nsScriptLoadRequest* aRequest,
 
     JS::CompileOptions options(entryScript.cx());
     FillCompileOptionsForRequest(entryScript, aRequest, global, &options);
-    rv = nsJSUtils::EvaluateString(entryScript.cx(), aSrcBuf, global, options,
-                                   aRequest->OffThreadTokenPtr());
+    if (!aRequest->mOffThreadToken && !aRequest->mIsInline &&
+        !options.mutedErrors() &&
+        ScriptBytecodeCache::ShouldUse(aSrcBuf.length())) {
+      rv = EvaluateScriptWithBytecodeCache(entryScript.cx(), aRequest, aSrcBuf,
+                                           global, options);
+    } else {
+      rv = nsJSUtils::EvaluateString(entryScript.cx(), aSrcBuf, global, options,
+                                     aRequest->OffThreadTokenPtr());
+    }
   }
 
   context->SetProcessingScriptTag(oldProcessingScriptTag);
   return rv;
 }
 
+nsresult
+nsScriptLoader::EvaluateScriptWithBytecodeCache(JSContext* aCx,
+                                                nsScriptLoadRequest* aRequest,
+                                                JS::SourceBufferHolder& aSrcBuf,
+                                                JS::Handle<JSObject*> aGlobal,
+                                                JS::CompileOptions& aOptions)
+{
+  MOZ_ASSERT(aOptions.noScriptRval);
+
+  nsIScriptSecurityManager* ssm = nsContentUtils::GetSecurityManager();
+  NS_ENSURE_TRUE(ssm->ScriptAllowed(aGlobal), NS_OK);
+
+  // The bytecode depends on the JS version the script was compiled with, so
+  // that is part of the key. Cross-origin scripts are never cached, because
+  // decoded scripts do not remember that their errors are muted.
+  nsAutoCString key;
+  nsresult rv = aRequest->mURI->GetSpec(key);
+  NS_ENSURE_SUCCESS(rv, rv);
+  key.AppendLiteral("#version=");
+  key.AppendInt(aRequest->mJSVersion);
+
+  // Hash before compiling, since compiling may take the source buffer.
+  size_t length = aSrcBuf.length();
+  uint64_t hash = ScriptBytecodeCache::HashSource(aSrcBuf.get(), length);
+
+  JSAutoCompartment ac(aCx, aGlobal);
+  JS::Rooted<JSScript*> script(aCx);
+  if (!ScriptBytecodeCache::Lookup(aCx, key, length, hash, &script)) {
+    if (!JS::Compile(aCx, aOptions, aSrcBuf, &script)) {
+      return NS_SUCCESS_DOM_SCRIPT_EVALUATION_THREW;
+    }
+    ScriptBytecodeCache::Store(aCx, key, length, hash, script);
+  }
+
+  if (!JS_ExecuteScript(aCx, script)) {
+    return NS_SUCCESS_DOM_SCRIPT_EVALUATION_THREW;
+  }
+  return NS_OK;
+}
+
 void
 nsScriptLoader::ProcessPendingRequestsAsync()
 {
@@ -1525,6 +1622,13 @@ nsScriptLoader::OnStreamComplete(nsIStreamLoader* aLoader,
   } else {
     free(const_cast<uint8_t *>(aString));
     rv = NS_SUCCESS_ADOPTED_DATA;
+
+    // Async requests are parsed off-thread from ProcessPendingRequests. Start
+    // parsing large ordered ones now, so that the parse overlaps with waiting
+    // for the scripts ahead of them.
+    if (!request->mIsAsync) {
+      AttemptAsyncScriptParse(request);
+    }
   }
 
   // Process our request and/or any pending ones
@@ -43,10 +43,7 @@ class AutoJSAPI;
 class nsScriptLoadRequest final : public nsISupports,
                                   private mozilla::LinkedListElement<nsScriptLoadRequest>
 {
-  ~nsScriptLoadRequest()
-  {
-    js_free(mScriptTextBuf);
-  }
+  ~nsScriptLoadRequest();
 
   typedef LinkedListElement<nsScriptLoadRequest> super;
 
@@ -479,6 +476,11 @@ private:
                            nsScriptLoadRequest* aRequest);
   nsresult EvaluateScript(nsScriptLoadRequest* aRequest,
                           JS::SourceBufferHolder& aSrcBuf);
+  nsresult EvaluateScriptWithBytecodeCache(JSContext* aCx,
+                                           nsScriptLoadRequest* aRequest,
+                                           JS::SourceBufferHolder& aSrcBuf,
+                                           JS::Handle<JSObject*> aGlobal,
+                                           JS::CompileOptions& aOptions);
 
   already_AddRefed<nsIScriptGlobalObject> GetScriptGlobalObject();
   void FillCompileOptionsForRequest(const mozilla::dom::AutoJSAPI &jsapi,
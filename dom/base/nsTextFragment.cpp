@@ -19,6 +19,7 @@
 #include "nsUTF8Utils.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/SSE.h"
+#include "mozilla/ppc.h"
 #include "nsTextFragmentImpl.h"
 #include <algorithm>
 
@@ -172,6 +173,14 @@ namespace mozilla {
 } // namespace mozilla
 #endif
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+namespace mozilla {
+  namespace VMX {
+    int32_t FirstNon8Bit(const char16_t *str, const char16_t *end);
+  } // namespace VMX
+} // namespace mozilla
+#endif
+
 /*
  * This function returns -1 if all characters in str are 8 bit characters.
  * Otherwise, it returns a value less than or equal to the index of the first
@@ -188,6 +197,12 @@ FirstNon8Bit(const char16_t *str, const char16_t *end)
   }
 #endif
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+  if (mozilla::supports_vmx()) {
+    return mozilla::VMX::FirstNon8Bit(str, end);
+  }
+#endif
+
   return FirstNon8BitUnvectorized(str, end);
 }
 
@@ -0,0 +1,68 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// This file should only be compiled if you're on PowerPC with AltiVec
+// enabled, see --enable-altivec.
+
+#include <altivec.h>
+#include "nscore.h"
+#include "nsAlgorithm.h"
+#include "nsTextFragmentImpl.h"
+#include <algorithm>
+
+namespace mozilla {
+namespace VMX {
+
+int32_t
+FirstNon8Bit(const char16_t *str, const char16_t *end)
+{
+  const uint32_t numUnicharsPerVector = 8;
+  typedef Non8BitParameters<sizeof(size_t)> p;
+  const size_t mask = p::mask();
+  const uint32_t numUnicharsPerWord = p::numUnicharsPerWord();
+  const int32_t len = end - str;
+  int32_t i = 0;
+
+  // Align ourselves to a 16-byte boundary, as required by vec_ld.
+  int32_t alignLen =
+    std::min(len, int32_t(((-NS_PTR_TO_INT32(str)) & 0xf) / sizeof(char16_t)));
+  for (; i < alignLen; i++) {
+    if (str[i] > 255)
+      return i;
+  }
+
+  // Check one vector register (16 bytes) at a time. Shifting every
+  // character right by eight leaves only the bits that don't fit in 8 bits.
+  const int32_t vectWalkEnd = ((len - i) / numUnicharsPerVector) * numUnicharsPerVector;
+  const vector unsigned short eight = vec_splat_u16(8);
+  const vector unsigned short zero = vec_splat_u16(0);
+  for(; i < vectWalkEnd; i += numUnicharsPerVector) {
+    const vector unsigned short vect =
+      vec_ld(0, reinterpret_cast<const unsigned short*>(str + i));
+    if (vec_any_ne(vec_sr(vect, eight), zero))
+      return i;
+  }
+
+  // Check one word at a time.
+  const int32_t wordWalkEnd = ((len - i) / numUnicharsPerWord) * numUnicharsPerWord;
+  for(; i < wordWalkEnd; i += numUnicharsPerWord) {
+    const size_t word = *reinterpret_cast<const size_t*>(str + i);
+    if (word & mask)
+      return i;
+  }
+
+  // Take care of the remainder one character at a time.
+  for (; i < len; i++) {
+    if (str[i] > 255) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+} // namespace VMX
+} // namespace mozilla
@@ -395,6 +395,14 @@ CollectWindowReports(nsGlobalWindow *aWindow,
   aWindowTotalSizes->mArenaStats.mStyleStructs
     += windowSizes.mArenaStats.mStyleStructs;
 
+  REPORT_SIZE("/layout/free-arena-objects",
+              windowSizes.mArenaStats.mFreeObjects,
+              "Memory used by destroyed frames and other arena objects "
+              "within a window, which is kept for reuse by new objects of "
+              "the same type.");
+  aWindowTotalSizes->mArenaStats.mFreeObjects
+    += windowSizes.mArenaStats.mFreeObjects;
+
   REPORT_SIZE("/layout/style-sets", windowSizes.mLayoutStyleSetsSize,
               "Memory used by style sets within a window.");
   aWindowTotalSizes->mLayoutStyleSetsSize += windowSizes.mLayoutStyleSetsSize;
@@ -584,6 +592,11 @@ nsWindowMemoryReporter::CollectReports(nsIMemoryReporterCallback* aCb,
          windowTotalSizes.mArenaStats.mStyleStructs,
          "This is the sum of all windows' 'layout/style-structs' numbers.");
 
+  REPORT("window-objects/layout/free-arena-objects",
+         windowTotalSizes.mArenaStats.mFreeObjects,
+         "This is the sum of all windows' 'layout/free-arena-objects' "
+         "numbers.");
+
   REPORT("window-objects/layout/style-sets", windowTotalSizes.mLayoutStyleSetsSize,
          "This is the sum of all windows' 'layout/style-sets' numbers.");
 
@@ -2871,6 +2871,12 @@ WebGLContext::UseProgram(WebGLProgram* prog)
     if (!ValidateObject("useProgram", prog))
         return;
 
+    // Re-using the current program with the same link results is a no-op in
+    // GL, and would needlessly throw away the cached buffer fetching
+    // validation. Apps that call useProgram before every draw hit this a lot.
+    if (prog == mCurrentProgram && prog->LinkInfo() == mActiveProgramLinkInfo)
+        return;
+
     if (prog->UseProgram()) {
         mCurrentProgram = prog;
         mActiveProgramLinkInfo = mCurrentProgram->LinkInfo();
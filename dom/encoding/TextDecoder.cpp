@@ -64,18 +64,22 @@ TextDecoder::Decode(const char* aInput, const int32_t aLength,
     return;
   }
   // Need a fallible allocator because the caller may be a content
-  // and the content can specify the length of the string.
-  nsAutoArrayPtr<char16_t> buf(new (fallible) char16_t[outLen + 1]);
-  if (!buf) {
+  // and the content can specify the length of the string.  Decode straight
+  // into the output string rather than through a temporary buffer, so large
+  // inputs are neither allocated nor copied twice.
+  if (!aOutDecodedString.SetLength(outLen, fallible)) {
     aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
     return;
   }
 
   int32_t length = aLength;
-  rv = mDecoder->Convert(aInput, &length, buf, &outLen);
+  int32_t maxLen = outLen;
+  rv = mDecoder->Convert(aInput, &length, aOutDecodedString.BeginWriting(),
+                         &outLen);
   MOZ_ASSERT(mFatal || rv != NS_ERROR_ILLEGAL_INPUT);
-  buf[outLen] = 0;
-  aOutDecodedString.Append(buf, outLen);
+  if (outLen < maxLen) {
+    aOutDecodedString.Truncate(outLen);
+  }
 
   // If the internal streaming flag of the decoder object is not set,
   // then reset the encoding algorithm state to the default values
@@ -7,10 +7,29 @@
 #include "FileBlockCache.h"
 #include "VideoUtils.h"
 #include "prio.h"
+#include "mozilla/FileUtils.h"
 #include <algorithm>
 
 namespace mozilla {
 
+class FileBlockCache::PrefetchEvent : public nsRunnable {
+public:
+  PrefetchEvent(FileBlockCache* aCache, const nsTArray<int32_t>& aBlockIndexes)
+    : mCache(aCache),
+      mBlockIndexes(aBlockIndexes)
+  {}
+
+  NS_IMETHOD Run() override
+  {
+    mCache->PrefetchBlocksInFile(mBlockIndexes);
+    return NS_OK;
+  }
+
+private:
+  nsRefPtr<FileBlockCache> mCache;
+  nsTArray<int32_t> mBlockIndexes;
+};
+
 nsresult FileBlockCache::Open(PRFileDesc* aFD)
 {
   NS_ASSERTION(NS_IsMainThread(), "Only call on main thread");
@@ -176,6 +195,21 @@ nsresult FileBlockCache::WriteBlockToFile(int32_t aBlockIndex,
   return NS_OK;
 }
 
+void FileBlockCache::PrefetchBlocksInFile(const nsTArray<int32_t>& aBlockIndexes)
+{
+  NS_ASSERTION(!NS_IsMainThread(), "Don't call on main thread");
+  MonitorAutoLock mon(mFileMonitor);
+
+  if (!mFD)
+    return;
+
+  filedesc_t fd = (filedesc_t)PR_FileDesc2NativeHandle(mFD);
+  for (uint32_t i = 0; i < aBlockIndexes.Length(); ++i) {
+    // ReadAhead() restores the file pointer, so mFDCurrentPos stays valid.
+    ReadAhead(fd, BlockIndexToOffset(aBlockIndexes[i]), BLOCK_SIZE);
+  }
+}
+
 nsresult FileBlockCache::MoveBlockInFile(int32_t aSourceBlockIndex,
                                          int32_t aDestBlockIndex)
 {
@@ -303,6 +337,17 @@ nsresult FileBlockCache::Read(int64_t aOffset,
   return NS_OK;
 }
 
+void FileBlockCache::Prefetch(const nsTArray<int32_t>& aBlockIndexes)
+{
+  MonitorAutoLock mon(mDataMonitor);
+
+  if (!mIsOpen)
+    return;
+
+  nsCOMPtr<nsIRunnable> event = new PrefetchEvent(this, aBlockIndexes);
+  mThread->Dispatch(event.forget(), NS_DISPATCH_NORMAL);
+}
+
 nsresult FileBlockCache::MoveBlock(int32_t aSourceBlockIndex, int32_t aDestBlockIndex)
 {
   NS_ASSERTION(NS_IsMainThread(), "Only call on main thread");
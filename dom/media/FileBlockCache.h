@@ -84,6 +84,11 @@ public:
   // This defers file I/O to a non-main thread.
   nsresult MoveBlock(int32_t aSourceBlockIndex, int32_t aDestBlockIndex);
 
+  // Hints that the given blocks will be read soon, so the OS can start
+  // reading them into memory. Can be called on any thread. The hint is
+  // issued on our own thread, so this never blocks on file I/O.
+  void Prefetch(const nsTArray<int32_t>& aBlockIndexes);
+
   // Represents a change yet to be made to a block in the file. The change
   // is either a write (and the data to be written is stored in this struct)
   // or a move (and the index of the source block is stored instead).
@@ -156,6 +161,8 @@ public:
   };
 
 private:
+  class PrefetchEvent;
+
   int64_t BlockIndexToOffset(int32_t aBlockIndex) {
     return static_cast<int64_t>(aBlockIndex) * BLOCK_SIZE;
   }
@@ -175,6 +182,8 @@ private:
                         int32_t aBytesToRead,
                         int32_t& aBytesRead);
   nsresult WriteBlockToFile(int32_t aBlockIndex, const uint8_t* aBlockData);
+  // Issues read-ahead hints for blocks in the file.
+  void PrefetchBlocksInFile(const nsTArray<int32_t>& aBlockIndexes);
   // File descriptor we're writing to. This is created externally, but
   // shutdown by us.
   PRFileDesc* mFD;
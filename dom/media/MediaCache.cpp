@@ -52,6 +52,10 @@ static const uint32_t REPLAY_PENALTY_FACTOR = 3;
 // can.
 static const uint32_t FREE_BLOCK_SCAN_LIMIT = 16;
 
+// While playing, ask the cache file to start reading the cached blocks
+// needed for this many seconds of playback ahead of the read position.
+static const uint32_t PREFETCH_SECONDS = 2;
+
 #ifdef DEBUG
 // Turn this on to do very expensive cache state validation
 // #define DEBUG_VERIFY_CACHE
@@ -150,6 +154,8 @@ public:
                          int32_t* aBytes);
   // This will fail if all aLength bytes are not read
   nsresult ReadCacheFileAllBytes(int64_t aOffset, void* aData, int32_t aLength);
+  // Hints that the given cache blocks will be read soon.
+  void PrefetchCacheFile(const nsTArray<int32_t>& aBlockIndexes);
 
   int64_t AllocateResourceID()
   {
@@ -378,6 +384,7 @@ MediaCacheStream::MediaCacheStream(ChannelMediaResource* aClient)
     mStreamLength(-1),
     mStreamOffset(0),
     mPlaybackBytesPerSecond(10000),
+    mPrefetchBlock(0),
     mPinCount(0),
     mCurrentMode(MODE_PLAYBACK),
     mMetadataInPartialBlockBuffer(false),
@@ -691,6 +698,16 @@ MediaCache::ReadCacheFileAllBytes(int64_t aOffset, void* aData, int32_t aLength)
   return NS_OK;
 }
 
+void
+MediaCache::PrefetchCacheFile(const nsTArray<int32_t>& aBlockIndexes)
+{
+  mReentrantMonitor.AssertCurrentThreadIn();
+
+  if (mFileCache) {
+    mFileCache->Prefetch(aBlockIndexes);
+  }
+}
+
 static int32_t GetMaxBlocks()
 {
   // We look up the cache size every time. This means dynamic changes
@@ -2309,6 +2326,9 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
     // Some data was read, so queue an update since block priorities may
     // have changed
     gMediaCache->QueueUpdate();
+    if (mCurrentMode == MODE_PLAYBACK) {
+      PrefetchAhead();
+    }
   }
   CACHE_LOG(LogLevel::Debug,
             ("Stream %p Read at %lld count=%d", this, (long long)(mStreamOffset-count), count));
@@ -2316,6 +2336,36 @@ MediaCacheStream::Read(char* aBuffer, uint32_t aCount, uint32_t* aBytes)
   return NS_OK;
 }
 
+void
+MediaCacheStream::PrefetchAhead()
+{
+  gMediaCache->GetReentrantMonitor().AssertCurrentThreadIn();
+
+  int64_t bytesAhead = int64_t(mPlaybackBytesPerSecond)*PREFETCH_SECONDS;
+  uint32_t firstBlock = uint32_t(mStreamOffset/BLOCK_SIZE) + 1;
+  uint32_t endBlock = uint32_t(std::min<int64_t>(mBlocks.Length(),
+    firstBlock + (bytesAhead + BLOCK_SIZE - 1)/BLOCK_SIZE));
+
+  if (mPrefetchBlock < firstBlock || mPrefetchBlock > endBlock) {
+    // The reader has seeked, so start again from the read position.
+    mPrefetchBlock = firstBlock;
+  }
+
+  nsAutoTArray<int32_t, 8> cacheBlocks;
+  for (; mPrefetchBlock < endBlock; ++mPrefetchBlock) {
+    int32_t cacheBlock = mBlocks[mPrefetchBlock];
+    if (cacheBlock < 0) {
+      // Not downloaded yet. Try again from here once it has been.
+      break;
+    }
+    cacheBlocks.AppendElement(cacheBlock);
+  }
+
+  if (!cacheBlocks.IsEmpty()) {
+    gMediaCache->PrefetchCacheFile(cacheBlocks);
+  }
+}
+
 nsresult
 MediaCacheStream::ReadAt(int64_t aOffset, char* aBuffer,
                          uint32_t aCount, uint32_t* aBytes)
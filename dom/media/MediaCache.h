@@ -434,6 +434,11 @@ private:
   void CloseInternal(ReentrantMonitorAutoEnter& aReentrantMonitor);
   // Update mPrincipal given that data has been received from aPrincipal
   bool UpdatePrincipal(nsIPrincipal* aPrincipal);
+  // Asks the cache file to start reading the cached blocks the reader will
+  // need next, so that Read() doesn't wait on the disk while holding the
+  // cache monitor. Assumes that the cache monitor is held and can be called
+  // on any thread.
+  void PrefetchAhead();
 
   // These fields are main-thread-only.
   ChannelMediaResource*  mClient;
@@ -489,6 +494,9 @@ private:
   BlockList         mPlayedBlocks;
   // The last reported estimate of the decoder's playback rate
   uint32_t          mPlaybackBytesPerSecond;
+  // The stream block PrefetchAhead() will hint next; blocks between the
+  // read position and this one have already been hinted.
+  uint32_t          mPrefetchBlock;
   // The number of times this stream has been Pinned without a
   // corresponding Unpin
   uint32_t          mPinCount;
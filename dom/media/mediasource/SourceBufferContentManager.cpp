@@ -32,4 +32,15 @@ SourceBufferContentManager::CreateManager(dom::SourceBufferAttributes* aAttribut
   return  manager.forget();
 }
 
+/* static */ uint32_t
+SourceBufferContentManager::EvictionThreshold(const nsACString& aType)
+{
+  if (StringBeginsWith(aType, NS_LITERAL_CSTRING("audio/"))) {
+    return Preferences::GetUint("media.mediasource.eviction_threshold.audio",
+                                20 * (1 << 20));
+  }
+  return Preferences::GetUint("media.mediasource.eviction_threshold",
+                              100 * (1 << 20));
+}
+
 } // namespace mozilla
@@ -36,6 +36,11 @@ public:
                 MediaSourceDecoder* aParentDecoder,
                 const nsACString& aType);
 
+  // Returns the number of bytes a SourceBuffer of the given type may hold
+  // before we start evicting data from it. Audio only streams are much
+  // smaller, so they get a budget of their own.
+  static uint32_t EvictionThreshold(const nsACString& aType);
+
   // Add data to the end of the input buffer.
   // Returns false if the append failed.
   virtual bool
@@ -72,8 +72,7 @@ TrackBuffersManager::TrackBuffersManager(dom::SourceBufferAttributes* aAttribute
   , mTaskQueue(aParentDecoder->GetDemuxer()->GetTaskQueue())
   , mSourceBufferAttributes(aAttributes)
   , mParentDecoder(new nsMainThreadPtrHolder<MediaSourceDecoder>(aParentDecoder, false /* strict */))
-  , mEvictionThreshold(Preferences::GetUint("media.mediasource.eviction_threshold",
-                                            100 * (1 << 20)))
+  , mEvictionThreshold(EvictionThreshold(aType))
   , mEvictionOccurred(false)
   , mMonitor("TrackBuffersManager")
   , mAppendRunning(false)
@@ -528,12 +527,24 @@ TrackBuffersManager::AppendIncomingBuffers()
 {
   MOZ_ASSERT(OnTaskQueue());
   MonitorAutoLock mon(mMonitor);
+  // Whenever we append to the input buffer, make room for all the data still
+  // pending, so that several appends queued behind each other only get
+  // copied once. SetCapacity does nothing once the room is there.
+  size_t pending = 0;
   for (auto& incomingBuffer : mIncomingBuffers) {
-    if (!mInputBuffer) {
+    pending += incomingBuffer.first()->Length();
+  }
+  for (auto& incomingBuffer : mIncomingBuffers) {
+    if (!mInputBuffer || mInputBuffer->IsEmpty()) {
+      // Take the buffer over rather than copying it.
       mInputBuffer = incomingBuffer.first();
-    } else if (!mInputBuffer->AppendElements(*incomingBuffer.first(), fallible)) {
+    } else if (!mInputBuffer->SetCapacity(mInputBuffer->Length() + pending,
+                                          fallible) ||
+               !mInputBuffer->AppendElements(*incomingBuffer.first(),
+                                             fallible)) {
       RejectAppend(NS_ERROR_OUT_OF_MEMORY, __func__);
     }
+    pending -= incomingBuffer.first()->Length();
     mTimestampOffset = incomingBuffer.second();
     mLastTimestampOffset = mTimestampOffset;
   }
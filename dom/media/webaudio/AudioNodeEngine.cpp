@@ -9,6 +9,14 @@
 #include "mozilla/arm.h"
 #include "AudioNodeEngineNEON.h"
 #endif
+#ifdef USE_SSE2
+#include "mozilla/SSE.h"
+#include "AudioNodeEngineSSE2.h"
+#endif
+#ifdef USE_VMX
+#include "mozilla/gfx/2D.h"
+#include "AudioNodeEngineVMX.h"
+#endif
 
 namespace mozilla {
 
@@ -72,6 +80,18 @@ void AudioBufferAddWithScale(const float* aInput,
     AudioBufferAddWithScale_NEON(aInput, aScale, aOutput, aSize);
     return;
   }
+#endif
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    AudioBufferAddWithScale_SSE2(aInput, aScale, aOutput, aSize);
+    return;
+  }
+#endif
+#ifdef USE_VMX
+  if (gfx::Factory::HasVMX()) {
+    AudioBufferAddWithScale_VMX(aInput, aScale, aOutput, aSize);
+    return;
+  }
 #endif
   if (aScale == 1.0f) {
     for (uint32_t i = 0; i < aSize; ++i) {
@@ -105,6 +125,18 @@ AudioBlockCopyChannelWithScale(const float* aInput,
       AudioBlockCopyChannelWithScale_NEON(aInput, aScale, aOutput);
       return;
     }
+#endif
+#ifdef USE_SSE2
+    if (mozilla::supports_sse2()) {
+      AudioBlockCopyChannelWithScale_SSE2(aInput, aScale, aOutput);
+      return;
+    }
+#endif
+#ifdef USE_VMX
+    if (gfx::Factory::HasVMX()) {
+      AudioBlockCopyChannelWithScale_VMX(aInput, aScale, aOutput);
+      return;
+    }
 #endif
     for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; ++i) {
       aOutput[i] = aInput[i]*aScale;
@@ -153,6 +185,18 @@ AudioBlockCopyChannelWithScale(const float aInput[WEBAUDIO_BLOCK_SIZE],
     AudioBlockCopyChannelWithScale_NEON(aInput, aScale, aOutput);
     return;
   }
+#endif
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    AudioBlockCopyChannelWithScale_SSE2(aInput, aScale, aOutput);
+    return;
+  }
+#endif
+#ifdef USE_VMX
+  if (gfx::Factory::HasVMX()) {
+    AudioBlockCopyChannelWithScale_VMX(aInput, aScale, aOutput);
+    return;
+  }
 #endif
   for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; ++i) {
     aOutput[i] = aInput[i]*aScale[i];
@@ -179,6 +223,18 @@ AudioBufferInPlaceScale(float* aBlock,
     AudioBufferInPlaceScale_NEON(aBlock, aScale, aSize);
     return;
   }
+#endif
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    AudioBufferInPlaceScale_SSE2(aBlock, aScale, aSize);
+    return;
+  }
+#endif
+#ifdef USE_VMX
+  if (gfx::Factory::HasVMX()) {
+    AudioBufferInPlaceScale_VMX(aBlock, aScale, aSize);
+    return;
+  }
 #endif
   for (uint32_t i = 0; i < aSize; ++i) {
     *aBlock++ *= aScale;
@@ -221,6 +277,22 @@ AudioBlockPanStereoToStereo(const float aInputL[WEBAUDIO_BLOCK_SIZE],
     return;
   }
 #endif
+#ifdef USE_SSE2
+  if (mozilla::supports_sse2()) {
+    AudioBlockPanStereoToStereo_SSE2(aInputL, aInputR,
+                                     aGainL, aGainR, aIsOnTheLeft,
+                                     aOutputL, aOutputR);
+    return;
+  }
+#endif
+#ifdef USE_VMX
+  if (gfx::Factory::HasVMX()) {
+    AudioBlockPanStereoToStereo_VMX(aInputL, aInputR,
+                                    aGainL, aGainR, aIsOnTheLeft,
+                                    aOutputL, aOutputR);
+    return;
+  }
+#endif
 
   uint32_t i;
 
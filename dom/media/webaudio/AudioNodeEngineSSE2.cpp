@@ -0,0 +1,201 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioNodeEngineSSE2.h"
+#include <emmintrin.h>
+
+// The channel buffers aren't 16-byte aligned yet (see AllocateAudioBlock), so
+// all the loads and stores here are unaligned.
+
+namespace mozilla {
+void AudioBufferAddWithScale_SSE2(const float* aInput,
+                                  float aScale,
+                                  float* aOutput,
+                                  uint32_t aSize)
+{
+  __m128 vin0, vin1, vin2, vin3;
+  __m128 vout0, vout1, vout2, vout3;
+  __m128 vscale = _mm_set1_ps(aScale);
+
+  uint32_t dif = aSize % 16;
+  aSize -= dif;
+  unsigned i = 0;
+  for (; i < aSize; i+=16) {
+    vin0 = _mm_loadu_ps(&aInput[i]);
+    vin1 = _mm_loadu_ps(&aInput[i+4]);
+    vin2 = _mm_loadu_ps(&aInput[i+8]);
+    vin3 = _mm_loadu_ps(&aInput[i+12]);
+
+    vout0 = _mm_loadu_ps(&aOutput[i]);
+    vout1 = _mm_loadu_ps(&aOutput[i+4]);
+    vout2 = _mm_loadu_ps(&aOutput[i+8]);
+    vout3 = _mm_loadu_ps(&aOutput[i+12]);
+
+    vout0 = _mm_add_ps(vout0, _mm_mul_ps(vin0, vscale));
+    vout1 = _mm_add_ps(vout1, _mm_mul_ps(vin1, vscale));
+    vout2 = _mm_add_ps(vout2, _mm_mul_ps(vin2, vscale));
+    vout3 = _mm_add_ps(vout3, _mm_mul_ps(vin3, vscale));
+
+    _mm_storeu_ps(&aOutput[i], vout0);
+    _mm_storeu_ps(&aOutput[i+4], vout1);
+    _mm_storeu_ps(&aOutput[i+8], vout2);
+    _mm_storeu_ps(&aOutput[i+12], vout3);
+  }
+
+  for (unsigned j = 0; j < dif; ++i, ++j) {
+    aOutput[i] += aInput[i]*aScale;
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_SSE2(const float* aInput,
+                                    float aScale,
+                                    float* aOutput)
+{
+  __m128 vin0, vin1, vin2, vin3;
+  __m128 vout0, vout1, vout2, vout3;
+  __m128 vscale = _mm_set1_ps(aScale);
+
+  for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+    vin0 = _mm_loadu_ps(&aInput[i]);
+    vin1 = _mm_loadu_ps(&aInput[i+4]);
+    vin2 = _mm_loadu_ps(&aInput[i+8]);
+    vin3 = _mm_loadu_ps(&aInput[i+12]);
+
+    vout0 = _mm_mul_ps(vin0, vscale);
+    vout1 = _mm_mul_ps(vin1, vscale);
+    vout2 = _mm_mul_ps(vin2, vscale);
+    vout3 = _mm_mul_ps(vin3, vscale);
+
+    _mm_storeu_ps(&aOutput[i], vout0);
+    _mm_storeu_ps(&aOutput[i+4], vout1);
+    _mm_storeu_ps(&aOutput[i+8], vout2);
+    _mm_storeu_ps(&aOutput[i+12], vout3);
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_SSE2(const float aInput[WEBAUDIO_BLOCK_SIZE],
+                                    const float aScale[WEBAUDIO_BLOCK_SIZE],
+                                    float aOutput[WEBAUDIO_BLOCK_SIZE])
+{
+  __m128 vin0, vin1, vin2, vin3;
+  __m128 vout0, vout1, vout2, vout3;
+  __m128 vscale0, vscale1, vscale2, vscale3;
+
+  for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+    vin0 = _mm_loadu_ps(&aInput[i]);
+    vin1 = _mm_loadu_ps(&aInput[i+4]);
+    vin2 = _mm_loadu_ps(&aInput[i+8]);
+    vin3 = _mm_loadu_ps(&aInput[i+12]);
+
+    vscale0 = _mm_loadu_ps(&aScale[i]);
+    vscale1 = _mm_loadu_ps(&aScale[i+4]);
+    vscale2 = _mm_loadu_ps(&aScale[i+8]);
+    vscale3 = _mm_loadu_ps(&aScale[i+12]);
+
+    vout0 = _mm_mul_ps(vin0, vscale0);
+    vout1 = _mm_mul_ps(vin1, vscale1);
+    vout2 = _mm_mul_ps(vin2, vscale2);
+    vout3 = _mm_mul_ps(vin3, vscale3);
+
+    _mm_storeu_ps(&aOutput[i], vout0);
+    _mm_storeu_ps(&aOutput[i+4], vout1);
+    _mm_storeu_ps(&aOutput[i+8], vout2);
+    _mm_storeu_ps(&aOutput[i+12], vout3);
+  }
+}
+
+void
+AudioBufferInPlaceScale_SSE2(float* aBlock,
+                             float aScale,
+                             uint32_t aSize)
+{
+  __m128 vin0, vin1, vin2, vin3;
+  __m128 vout0, vout1, vout2, vout3;
+  __m128 vscale = _mm_set1_ps(aScale);
+
+  uint32_t dif = aSize % 16;
+  uint32_t vectorSize = aSize - dif;
+  uint32_t i = 0;
+  for (; i < vectorSize; i+=16) {
+    vin0 = _mm_loadu_ps(&aBlock[i]);
+    vin1 = _mm_loadu_ps(&aBlock[i+4]);
+    vin2 = _mm_loadu_ps(&aBlock[i+8]);
+    vin3 = _mm_loadu_ps(&aBlock[i+12]);
+
+    vout0 = _mm_mul_ps(vin0, vscale);
+    vout1 = _mm_mul_ps(vin1, vscale);
+    vout2 = _mm_mul_ps(vin2, vscale);
+    vout3 = _mm_mul_ps(vin3, vscale);
+
+    _mm_storeu_ps(&aBlock[i], vout0);
+    _mm_storeu_ps(&aBlock[i+4], vout1);
+    _mm_storeu_ps(&aBlock[i+8], vout2);
+    _mm_storeu_ps(&aBlock[i+12], vout3);
+  }
+
+  for (unsigned j = 0; j < dif; ++i, ++j) {
+    aBlock[i] *= aScale;
+  }
+}
+
+void
+AudioBlockPanStereoToStereo_SSE2(const float aInputL[WEBAUDIO_BLOCK_SIZE],
+                                 const float aInputR[WEBAUDIO_BLOCK_SIZE],
+                                 float aGainL, float aGainR, bool aIsOnTheLeft,
+                                 float aOutputL[WEBAUDIO_BLOCK_SIZE],
+                                 float aOutputR[WEBAUDIO_BLOCK_SIZE])
+{
+  __m128 vinL0, vinL1;
+  __m128 vinR0, vinR1;
+  __m128 voutL0, voutL1;
+  __m128 voutR0, voutR1;
+  __m128 vscaleL = _mm_set1_ps(aGainL);
+  __m128 vscaleR = _mm_set1_ps(aGainR);
+
+  if (aIsOnTheLeft) {
+    for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=8) {
+      vinL0 = _mm_loadu_ps(&aInputL[i]);
+      vinL1 = _mm_loadu_ps(&aInputL[i+4]);
+
+      vinR0 = _mm_loadu_ps(&aInputR[i]);
+      vinR1 = _mm_loadu_ps(&aInputR[i+4]);
+
+      voutL0 = _mm_add_ps(vinL0, _mm_mul_ps(vinR0, vscaleL));
+      voutL1 = _mm_add_ps(vinL1, _mm_mul_ps(vinR1, vscaleL));
+
+      _mm_storeu_ps(&aOutputL[i], voutL0);
+      _mm_storeu_ps(&aOutputL[i+4], voutL1);
+
+      voutR0 = _mm_mul_ps(vinR0, vscaleR);
+      voutR1 = _mm_mul_ps(vinR1, vscaleR);
+
+      _mm_storeu_ps(&aOutputR[i], voutR0);
+      _mm_storeu_ps(&aOutputR[i+4], voutR1);
+    }
+  } else {
+    for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=8) {
+      vinL0 = _mm_loadu_ps(&aInputL[i]);
+      vinL1 = _mm_loadu_ps(&aInputL[i+4]);
+
+      vinR0 = _mm_loadu_ps(&aInputR[i]);
+      vinR1 = _mm_loadu_ps(&aInputR[i+4]);
+
+      voutL0 = _mm_mul_ps(vinL0, vscaleL);
+      voutL1 = _mm_mul_ps(vinL1, vscaleL);
+
+      _mm_storeu_ps(&aOutputL[i], voutL0);
+      _mm_storeu_ps(&aOutputL[i+4], voutL1);
+
+      voutR0 = _mm_add_ps(vinR0, _mm_mul_ps(vinL0, vscaleR));
+      voutR1 = _mm_add_ps(vinR1, _mm_mul_ps(vinL1, vscaleR));
+
+      _mm_storeu_ps(&aOutputR[i], voutR0);
+      _mm_storeu_ps(&aOutputR[i+4], voutR1);
+    }
+  }
+}
+}
@@ -0,0 +1,174 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioNodeEngineVMX.h"
+#include <altivec.h>
+#include <string.h>
+
+#include "mozilla/Attributes.h"
+
+namespace mozilla {
+
+namespace {
+
+// Loads four floats from a possibly unaligned address. Both aligned loads only
+// touch 16 byte blocks that contain at least one of the floats requested.
+MOZ_ALWAYS_INLINE
+vector float LoadUnaligned(const float* aData)
+{
+  vector float first = vec_ld(0, aData);
+  vector float second = vec_ld(15, aData);
+  return vec_perm(first, second, vec_lvsl(0, aData));
+}
+
+// The channel buffers aren't 16-byte aligned yet (see AllocateAudioBlock), and
+// a read-modify-write of the surrounding blocks could race with other
+// channels, so copy the result out instead.
+MOZ_ALWAYS_INLINE
+void StoreUnaligned(float* aData, vector float aValue)
+{
+  union {
+    vector float v;
+    float f[4];
+  } out;
+  out.v = aValue;
+  memcpy(aData, out.f, sizeof(out.f));
+}
+
+MOZ_ALWAYS_INLINE
+vector float Splat(float aValue)
+{
+  union {
+    vector float v;
+    float f[4];
+  } splat;
+  for (int i = 0; i < 4; i++) {
+    splat.f[i] = aValue;
+  }
+  return splat.v;
+}
+
+// vec_madd is the only float multiply; adding -0.0 leaves every product,
+// including -0.0, unchanged.
+MOZ_ALWAYS_INLINE
+vector float Multiply(vector float aA, vector float aB)
+{
+  return vec_madd(aA, aB, Splat(-0.0f));
+}
+
+} // namespace
+
+void AudioBufferAddWithScale_VMX(const float* aInput,
+                                 float aScale,
+                                 float* aOutput,
+                                 uint32_t aSize)
+{
+  vector float vscale = Splat(aScale);
+
+  uint32_t dif = aSize % 8;
+  aSize -= dif;
+  unsigned i = 0;
+  for (; i < aSize; i+=8) {
+    vector float vin0 = LoadUnaligned(&aInput[i]);
+    vector float vin1 = LoadUnaligned(&aInput[i+4]);
+
+    vector float vout0 = LoadUnaligned(&aOutput[i]);
+    vector float vout1 = LoadUnaligned(&aOutput[i+4]);
+
+    StoreUnaligned(&aOutput[i], vec_madd(vin0, vscale, vout0));
+    StoreUnaligned(&aOutput[i+4], vec_madd(vin1, vscale, vout1));
+  }
+
+  for (unsigned j = 0; j < dif; ++i, ++j) {
+    aOutput[i] += aInput[i]*aScale;
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_VMX(const float* aInput,
+                                   float aScale,
+                                   float* aOutput)
+{
+  vector float vscale = Splat(aScale);
+
+  for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=8) {
+    vector float vin0 = LoadUnaligned(&aInput[i]);
+    vector float vin1 = LoadUnaligned(&aInput[i+4]);
+
+    StoreUnaligned(&aOutput[i], Multiply(vin0, vscale));
+    StoreUnaligned(&aOutput[i+4], Multiply(vin1, vscale));
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_VMX(const float aInput[WEBAUDIO_BLOCK_SIZE],
+                                   const float aScale[WEBAUDIO_BLOCK_SIZE],
+                                   float aOutput[WEBAUDIO_BLOCK_SIZE])
+{
+  for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=8) {
+    vector float vin0 = LoadUnaligned(&aInput[i]);
+    vector float vin1 = LoadUnaligned(&aInput[i+4]);
+
+    vector float vscale0 = LoadUnaligned(&aScale[i]);
+    vector float vscale1 = LoadUnaligned(&aScale[i+4]);
+
+    StoreUnaligned(&aOutput[i], Multiply(vin0, vscale0));
+    StoreUnaligned(&aOutput[i+4], Multiply(vin1, vscale1));
+  }
+}
+
+void
+AudioBufferInPlaceScale_VMX(float* aBlock,
+                            float aScale,
+                            uint32_t aSize)
+{
+  vector float vscale = Splat(aScale);
+
+  uint32_t dif = aSize % 8;
+  uint32_t vectorSize = aSize - dif;
+  uint32_t i = 0;
+  for (; i < vectorSize; i+=8) {
+    vector float vin0 = LoadUnaligned(&aBlock[i]);
+    vector float vin1 = LoadUnaligned(&aBlock[i+4]);
+
+    StoreUnaligned(&aBlock[i], Multiply(vin0, vscale));
+    StoreUnaligned(&aBlock[i+4], Multiply(vin1, vscale));
+  }
+
+  for (unsigned j = 0; j < dif; ++i, ++j) {
+    aBlock[i] *= aScale;
+  }
+}
+
+void
+AudioBlockPanStereoToStereo_VMX(const float aInputL[WEBAUDIO_BLOCK_SIZE],
+                                const float aInputR[WEBAUDIO_BLOCK_SIZE],
+                                float aGainL, float aGainR, bool aIsOnTheLeft,
+                                float aOutputL[WEBAUDIO_BLOCK_SIZE],
+                                float aOutputR[WEBAUDIO_BLOCK_SIZE])
+{
+  vector float vscaleL = Splat(aGainL);
+  vector float vscaleR = Splat(aGainR);
+
+  if (aIsOnTheLeft) {
+    for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=4) {
+      vector float vinL = LoadUnaligned(&aInputL[i]);
+      vector float vinR = LoadUnaligned(&aInputR[i]);
+
+      StoreUnaligned(&aOutputL[i], vec_madd(vinR, vscaleL, vinL));
+      StoreUnaligned(&aOutputR[i], Multiply(vinR, vscaleR));
+    }
+  } else {
+    for (uint32_t i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=4) {
+      vector float vinL = LoadUnaligned(&aInputL[i]);
+      vector float vinR = LoadUnaligned(&aInputR[i]);
+
+      StoreUnaligned(&aOutputL[i], Multiply(vinL, vscaleL));
+      StoreUnaligned(&aOutputR[i], vec_madd(vinL, vscaleR, vinR));
+    }
+  }
+}
+
+} // namespace mozilla
@@ -46,6 +46,9 @@ public:
     // This will read from, then clear-out numberOfFrames
     void readAndClear(float* destination, size_t numberOfFrames);
 
+    // Like readAndClear(), but adds the frames to destination instead of overwriting it
+    void readAndAddTo(float* destination, size_t numberOfFrames);
+
     // Each ReverbConvolverStage will accumulate its output at the appropriate delay from the read position.
     // We need to pass in and update readIndex here, since each ReverbConvolverStage may be running in
     // a different thread than the realtime thread calling ReadAndClear() and maintaining m_readIndex
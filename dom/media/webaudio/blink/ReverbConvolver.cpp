@@ -28,14 +28,20 @@
 
 #include "ReverbConvolver.h"
 #include "ReverbConvolverStage.h"
+#include "prsystem.h"
+#include <algorithm>
 
 using namespace mozilla;
 
+namespace WebCore {
+class ReverbConvolverWorker;
+}
+
 template<>
-struct RunnableMethodTraits<WebCore::ReverbConvolver>
+struct RunnableMethodTraits<WebCore::ReverbConvolverWorker>
 {
-  static void RetainCallee(WebCore::ReverbConvolver* obj) {}
-  static void ReleaseCallee(WebCore::ReverbConvolver* obj) {}
+  static void RetainCallee(WebCore::ReverbConvolverWorker* obj) {}
+  static void ReleaseCallee(WebCore::ReverbConvolverWorker* obj) {}
 };
 
 namespace WebCore {
@@ -54,17 +60,153 @@ const size_t RealtimeFrameLimit = 8192  + 4096; // ~278msec @ 44.1KHz
 const size_t MinFFTSize = 128;
 const size_t MaxRealtimeFFTSize = 2048;
 
+// Upper bound on the number of background threads used by each convolver.
+// Reverb runs one convolver per channel, so a stereo reverb uses twice this.
+const size_t MaxBackgroundThreads = 2;
+
+// Runs a share of the background stages on its own thread.  Every worker
+// accumulates into its own buffer, so the workers never write to the same
+// memory, and the realtime thread adds the buffers up in process().
+class ReverbConvolverWorker {
+public:
+    ReverbConvolverWorker(ReverbConvolver* convolver, size_t accumulationBufferLength)
+        : m_convolver(convolver)
+        , m_accumulationBuffer(accumulationBufferLength)
+        , m_thread("ConvolverWorker")
+        , m_threadCondition(&m_threadLock)
+        , m_wantsToExit(false)
+        , m_moreInputBuffered(false)
+    {
+    }
+
+    ~ReverbConvolverWorker()
+    {
+        // Wait for the thread to stop
+        if (m_thread.IsRunning()) {
+            m_wantsToExit = true;
+
+            // Wake up thread so it can return
+            {
+                AutoLock locker(m_threadLock);
+                m_moreInputBuffered = true;
+                m_threadCondition.Signal();
+            }
+
+            m_thread.Stop();
+        }
+    }
+
+    ReverbAccumulationBuffer* accumulationBuffer() { return &m_accumulationBuffer; }
+
+    bool hasStages() const { return m_stages.Length() > 0; }
+    void appendStage(nsAutoPtr<ReverbConvolverStage>& stage) { m_stages.AppendElement(stage.forget()); }
+
+    bool start()
+    {
+        MOZ_ASSERT(hasStages());
+        if (!m_thread.Start())
+            return false;
+
+        CancelableTask* task = NewRunnableMethod(this, &ReverbConvolverWorker::threadEntry);
+        m_thread.message_loop()->PostTask(FROM_HERE, task);
+        return true;
+    }
+
+    // Called from the realtime thread once more input has been buffered.
+    void signal()
+    {
+        // Not using a MutexLocker looks strange, but we use a tryLock() instead because this is run on the real-time
+        // thread where it is a disaster for the lock to be contended (causes audio glitching).  It's OK if we fail to
+        // signal from time to time, since we'll get to it the next time we're called.  We're called repeatedly
+        // and frequently (around every 3ms).  The background thread is processing well into the future and has a considerable amount of
+        // leeway here...
+        if (m_threadLock.Try()) {
+            m_moreInputBuffered = true;
+            m_threadCondition.Signal();
+            m_threadLock.Release();
+        }
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < m_stages.Length(); ++i)
+            m_stages[i]->reset();
+
+        m_accumulationBuffer.reset();
+    }
+
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
+    {
+        size_t amount = aMallocSizeOf(this);
+        amount += m_stages.ShallowSizeOfExcludingThis(aMallocSizeOf);
+        for (size_t i = 0; i < m_stages.Length(); i++) {
+            if (m_stages[i]) {
+                amount += m_stages[i]->sizeOfIncludingThis(aMallocSizeOf);
+            }
+        }
+
+        // NB: The buffer size is static, so even though it's written to
+        //     on another thread it's safe to measure it.
+        amount += m_accumulationBuffer.sizeOfExcludingThis(aMallocSizeOf);
+
+        // Possible future measurements:
+        // - m_thread
+        // - m_threadLock
+        // - m_threadCondition
+        return amount;
+    }
+
+private:
+    void threadEntry()
+    {
+        ReverbInputBuffer* inputBuffer = m_convolver->inputBuffer();
+
+        while (!m_wantsToExit) {
+            // Wait for realtime thread to give us more input
+            m_moreInputBuffered = false;
+            {
+                AutoLock locker(m_threadLock);
+                while (!m_moreInputBuffered && !m_wantsToExit)
+                    m_threadCondition.Wait();
+            }
+
+            // Process all of the stages until their read indices reach the input buffer's write index
+            int writeIndex = inputBuffer->writeIndex();
+
+            // Each stage maintains its own version of readIndex, which is what
+            // lets the workers run independently of each other.
+            int readIndex;
+
+            while ((readIndex = m_stages[0]->inputReadIndex()) != writeIndex) { // FIXME: do better to detect buffer overrun...
+                // The ReverbConvolverStages need to process in amounts which evenly divide half the FFT size
+                const int SliceSize = MinFFTSize / 2;
+
+                // Accumulate contributions from each stage
+                for (size_t i = 0; i < m_stages.Length(); ++i)
+                    m_stages[i]->processInBackground(m_convolver, SliceSize);
+            }
+        }
+    }
+
+    ReverbConvolver* m_convolver;
+    nsTArray<nsAutoPtr<ReverbConvolverStage> > m_stages;
+    ReverbAccumulationBuffer m_accumulationBuffer;
+
+    // Thread and synchronization
+    base::Thread m_thread;
+    Lock m_threadLock;
+    ConditionVariable m_threadCondition;
+    bool m_wantsToExit;
+    bool m_moreInputBuffered;
+};
+
 ReverbConvolver::ReverbConvolver(const float* impulseResponseData, size_t impulseResponseLength, size_t renderSliceSize, size_t maxFFTSize, size_t convolverRenderPhase, bool useBackgroundThreads)
     : m_impulseResponseLength(impulseResponseLength)
     , m_accumulationBuffer(impulseResponseLength + renderSliceSize)
     , m_inputBuffer(InputBufferSize)
     , m_minFFTSize(MinFFTSize) // First stage will have this size - successive stages will double in size each time
     , m_maxFFTSize(maxFFTSize) // until we hit m_maxFFTSize
-    , m_backgroundThread("ConvolverWorker")
-    , m_backgroundThreadCondition(&m_backgroundThreadLock)
     , m_useBackgroundThreads(useBackgroundThreads)
-    , m_wantsToExit(false)
-    , m_moreInputBuffered(false)
 {
     // If we are using background threads then don't exceed this FFT size for the
     // stages which run in the real-time thread.  This avoids having only one or two
@@ -76,6 +218,14 @@ ReverbConvolver::ReverbConvolver(const float* impulseResponseData, size_t impuls
     // Otherwise, assume we're being run from a command-line tool.
     bool hasRealtimeConstraint = useBackgroundThreads;
 
+    if (this->useBackgroundThreads()) {
+        // Leave a core for the realtime thread.
+        int32_t processors = PR_GetNumberOfProcessors();
+        size_t workerCount = processors > 2 ? std::min<size_t>(processors - 1, MaxBackgroundThreads) : 1;
+        for (size_t i = 0; i < workerCount; ++i)
+            m_workers.AppendElement(new ReverbConvolverWorker(this, impulseResponseLength + renderSliceSize));
+    }
+
     const float* response = impulseResponseData;
     size_t totalResponseLength = impulseResponseLength;
 
@@ -84,6 +234,7 @@ ReverbConvolver::ReverbConvolver(const float* impulseResponseData, size_t impuls
 
     size_t stageOffset = 0;
     int i = 0;
+    size_t backgroundStageCount = 0;
     size_t fftSize = m_minFFTSize;
     while (stageOffset < totalResponseLength) {
         size_t stageSize = fftSize / 2;
@@ -98,14 +249,18 @@ ReverbConvolver::ReverbConvolver(const float* impulseResponseData, size_t impuls
 
         bool useDirectConvolver = !stageOffset;
 
-        nsAutoPtr<ReverbConvolverStage> stage(new ReverbConvolverStage(response, totalResponseLength, reverbTotalLatency, stageOffset, stageSize, fftSize, renderPhase, renderSliceSize, &m_accumulationBuffer, useDirectConvolver));
+        bool isBackgroundStage = this->useBackgroundThreads() && stageOffset > RealtimeFrameLimit;
+
+        // Deal the background stages out in turn.  The later ones all have
+        // the maximum FFT size, so this spreads the work evenly.
+        ReverbConvolverWorker* worker = isBackgroundStage ? m_workers[backgroundStageCount++ % m_workers.Length()].get() : nullptr;
+        ReverbAccumulationBuffer* accumulationBuffer = worker ? worker->accumulationBuffer() : &m_accumulationBuffer;
 
-        bool isBackgroundStage = false;
+        nsAutoPtr<ReverbConvolverStage> stage(new ReverbConvolverStage(response, totalResponseLength, reverbTotalLatency, stageOffset, stageSize, fftSize, renderPhase, renderSliceSize, accumulationBuffer, useDirectConvolver));
 
-        if (this->useBackgroundThreads() && stageOffset > RealtimeFrameLimit) {
-            m_backgroundStages.AppendElement(stage.forget());
-            isBackgroundStage = true;
-        } else
+        if (worker)
+            worker->appendStage(stage);
+        else
             m_stages.AppendElement(stage.forget());
 
         stageOffset += stageSize;
@@ -122,33 +277,22 @@ ReverbConvolver::ReverbConvolver(const float* impulseResponseData, size_t impuls
             fftSize = m_maxFFTSize;
     }
 
-    // Start up background thread
+    // Drop the workers that didn't get any stages, then start up the rest.
     // FIXME: would be better to up the thread priority here.  It doesn't need to be real-time, but higher than the default...
-    if (this->useBackgroundThreads() && m_backgroundStages.Length() > 0) {
-        if (!m_backgroundThread.Start()) {
-          NS_WARNING("Cannot start convolver thread.");
-          return;
+    if (backgroundStageCount < m_workers.Length())
+        m_workers.SetLength(backgroundStageCount);
+    for (size_t i = 0; i < m_workers.Length(); ++i) {
+        if (!m_workers[i]->start()) {
+            NS_WARNING("Cannot start convolver thread.");
+            return;
         }
-        CancelableTask* task = NewRunnableMethod(this, &ReverbConvolver::backgroundThreadEntry);
-        m_backgroundThread.message_loop()->PostTask(FROM_HERE, task);
     }
 }
 
 ReverbConvolver::~ReverbConvolver()
 {
-    // Wait for background thread to stop
-    if (useBackgroundThreads() && m_backgroundThread.IsRunning()) {
-        m_wantsToExit = true;
-
-        // Wake up thread so it can return
-        {
-            AutoLock locker(m_backgroundThreadLock);
-            m_moreInputBuffered = true;
-            m_backgroundThreadCondition.Signal();
-        }
-
-        m_backgroundThread.Stop();
-    }
+    // Wait for the background threads to stop before the input buffer goes away
+    m_workers.Clear();
 }
 
 size_t ReverbConvolver::sizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const
@@ -161,11 +305,9 @@ size_t ReverbConvolver::sizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf)
         }
     }
 
-    amount += m_backgroundStages.ShallowSizeOfExcludingThis(aMallocSizeOf);
-    for (size_t i = 0; i < m_backgroundStages.Length(); i++) {
-        if (m_backgroundStages[i]) {
-            amount += m_backgroundStages[i]->sizeOfIncludingThis(aMallocSizeOf);
-        }
+    amount += m_workers.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    for (size_t i = 0; i < m_workers.Length(); i++) {
+        amount += m_workers[i]->sizeOfIncludingThis(aMallocSizeOf);
     }
 
     // NB: The buffer sizes are static, so even though they might be accessed
@@ -173,42 +315,9 @@ size_t ReverbConvolver::sizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf)
     amount += m_accumulationBuffer.sizeOfExcludingThis(aMallocSizeOf);
     amount += m_inputBuffer.sizeOfExcludingThis(aMallocSizeOf);
 
-    // Possible future measurements:
-    // - m_backgroundThread
-    // - m_backgroundThreadLock
-    // - m_backgroundThreadCondition
     return amount;
 }
 
-void ReverbConvolver::backgroundThreadEntry()
-{
-    while (!m_wantsToExit) {
-        // Wait for realtime thread to give us more input
-        m_moreInputBuffered = false;
-        {
-            AutoLock locker(m_backgroundThreadLock);
-            while (!m_moreInputBuffered && !m_wantsToExit)
-                m_backgroundThreadCondition.Wait();
-        }
-
-        // Process all of the stages until their read indices reach the input buffer's write index
-        int writeIndex = m_inputBuffer.writeIndex();
-
-        // Even though it doesn't seem like every stage needs to maintain its own version of readIndex 
-        // we do this in case we want to run in more than one background thread.
-        int readIndex;
-
-        while ((readIndex = m_backgroundStages[0]->inputReadIndex()) != writeIndex) { // FIXME: do better to detect buffer overrun...
-            // The ReverbConvolverStages need to process in amounts which evenly divide half the FFT size
-            const int SliceSize = MinFFTSize / 2;
-
-            // Accumulate contributions from each stage
-            for (size_t i = 0; i < m_backgroundStages.Length(); ++i)
-                m_backgroundStages[i]->processInBackground(this, SliceSize);
-        }
-    }
-}
-
 void ReverbConvolver::process(const float* sourceChannelData, size_t sourceChannelLength,
                               float* destinationChannelData, size_t destinationChannelLength,
                               size_t framesToProcess)
@@ -232,21 +341,14 @@ void ReverbConvolver::process(const float* sourceChannelData, size_t sourceChann
     for (size_t i = 0; i < m_stages.Length(); ++i)
         m_stages[i]->process(source, framesToProcess);
 
-    // Finally read from accumulation buffer
+    // Finally read from the accumulation buffers
     m_accumulationBuffer.readAndClear(destination, framesToProcess);
+    for (size_t i = 0; i < m_workers.Length(); ++i)
+        m_workers[i]->accumulationBuffer()->readAndAddTo(destination, framesToProcess);
 
-    // Now that we've buffered more input, wake up our background thread.
-
-    // Not using a MutexLocker looks strange, but we use a tryLock() instead because this is run on the real-time
-    // thread where it is a disaster for the lock to be contended (causes audio glitching).  It's OK if we fail to
-    // signal from time to time, since we'll get to it the next time we're called.  We're called repeatedly
-    // and frequently (around every 3ms).  The background thread is processing well into the future and has a considerable amount of 
-    // leeway here...
-    if (m_backgroundThreadLock.Try()) {
-        m_moreInputBuffered = true;
-        m_backgroundThreadCondition.Signal();
-        m_backgroundThreadLock.Release();
-    }
+    // Now that we've buffered more input, wake up our background threads.
+    for (size_t i = 0; i < m_workers.Length(); ++i)
+        m_workers[i]->signal();
 }
 
 void ReverbConvolver::reset()
@@ -254,8 +356,8 @@ void ReverbConvolver::reset()
     for (size_t i = 0; i < m_stages.Length(); ++i)
         m_stages[i]->reset();
 
-    for (size_t i = 0; i < m_backgroundStages.Length(); ++i)
-        m_backgroundStages[i]->reset();
+    for (size_t i = 0; i < m_workers.Length(); ++i)
+        m_workers[i]->reset();
 
     m_accumulationBuffer.reset();
     m_inputBuffer.reset();
@@ -43,6 +43,7 @@
 namespace WebCore {
 
 class ReverbConvolverStage;
+class ReverbConvolverWorker;
 
 class ReverbConvolver {
 public:
@@ -63,19 +64,17 @@ public:
     ReverbInputBuffer* inputBuffer() { return &m_inputBuffer; }
 
     bool useBackgroundThreads() const { return m_useBackgroundThreads; }
-    void backgroundThreadEntry();
 
     size_t latencyFrames() const;
 
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const;
 private:
     nsTArray<nsAutoPtr<ReverbConvolverStage> > m_stages;
-    nsTArray<nsAutoPtr<ReverbConvolverStage> > m_backgroundStages;
     size_t m_impulseResponseLength;
 
     ReverbAccumulationBuffer m_accumulationBuffer;
 
-    // One or more background threads read from this input buffer which is fed from the realtime thread.
+    // The background threads read from this input buffer which is fed from the realtime thread.
     ReverbInputBuffer m_inputBuffer;
 
     // First stage will be of size m_minFFTSize.  Each next stage will be twice as big until we hit m_maxFFTSize.
@@ -85,13 +84,10 @@ private:
     // But don't exceed this size in the real-time thread (if we're doing background processing).
     size_t m_maxRealtimeFFTSize;
 
-    // Background thread and synchronization
-    base::Thread m_backgroundThread;
-    Lock m_backgroundThreadLock;
-    ConditionVariable m_backgroundThreadCondition;
+    // The stages past RealtimeFrameLimit are spread over these, each of which
+    // processes its share on its own thread.
+    nsTArray<nsAutoPtr<ReverbConvolverWorker> > m_workers;
     bool m_useBackgroundThreads;
-    bool m_wantsToExit;
-    bool m_moreInputBuffered;
 };
 
 } // namespace WebCore
@@ -925,6 +925,20 @@ nsFind::Find(const char16_t *aPatText, nsIDOMRange* aSearchRange,
   aEndPoint->GetEndContainer(getter_AddRefs(endNode));
   aEndPoint->GetEndOffset(&endOffset);
 
+  // When no match is in progress we can scan ahead through a fragment for
+  // the first pattern character without going through the whole matching
+  // state machine for every character. That's only safe if the first
+  // pattern character is matched literally, i.e. isn't whitespace (which
+  // matches runs of any whitespace) or a quote (which matches curly quotes).
+  char16_t firstPatChar = patLen >= 0 ? patStr[mFindBackward ? patLen : 0] : 0;
+  bool canSkipAhead = firstPatChar && !IsSpace(firstPatChar) &&
+                      firstPatChar != CH_APOSTROPHE &&
+                      firstPatChar != CH_QUOTE &&
+                      firstPatChar != CH_LEFT_SINGLE_QUOTE &&
+                      firstPatChar != CH_RIGHT_SINGLE_QUOTE &&
+                      firstPatChar != CH_LEFT_DOUBLE_QUOTE &&
+                      firstPatChar != CH_RIGHT_DOUBLE_QUOTE;
+
   char16_t prevChar = 0;
   while (1)
   {
@@ -1061,6 +1075,23 @@ nsFind::Find(const char16_t *aPatText, nsIDOMRange* aSearchRange,
       }
     }
 
+    // Skip characters that can't start a match. We stop on the last
+    // character of the fragment or at the endpoint and let the code below
+    // deal with it as usual.
+    if (canSkipAhead && !matchAnchorNode) {
+      while (mIterNode != endNode || findex != endOffset) {
+        char16_t c = (t2b ? t2b[findex] : CHAR_TO_UNICHAR(t1b[findex]));
+        if (!mCaseSensitive && IsUpperCase(c))
+          c = ToLowerCase(c);
+        if (c == firstPatChar)
+          break;
+        int32_t nextIndex = findex + incr;
+        if (nextIndex < 0 || nextIndex >= fragLen)
+          break;
+        findex = nextIndex;
+      }
+    }
+
     // Have we gone past the endpoint yet?
     // If we have, and we're not in the middle of a match, return.
     if (mIterNode == endNode &&
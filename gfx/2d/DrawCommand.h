@@ -431,12 +431,15 @@ public:
     , mOptions(aOptions)
     , mRenderingOptions(const_cast<GlyphRenderingOptions*>(aRenderingOptions))
   {
-    mGlyphs.resize(aBuffer.mNumGlyphs);
-    memcpy(&mGlyphs.front(), aBuffer.mGlyphs, sizeof(Glyph) * aBuffer.mNumGlyphs);
+    mGlyphs.assign(aBuffer.mGlyphs, aBuffer.mGlyphs + aBuffer.mNumGlyphs);
   }
 
   virtual void ExecuteOnDT(DrawTarget* aDT, const Matrix*) const
   {
+    if (mGlyphs.empty()) {
+      return;
+    }
+
     GlyphBuffer buf;
     buf.mNumGlyphs = mGlyphs.size();
     buf.mGlyphs = &mGlyphs.front();
@@ -12,12 +12,16 @@ namespace gfx {
 
 DrawTargetCaptureImpl::~DrawTargetCaptureImpl()
 {
+  if (mDrawCommandStorage.empty()) {
+    return;
+  }
+
   uint8_t* start = &mDrawCommandStorage.front();
 
   uint8_t* current = start;
 
   while (current < start + mDrawCommandStorage.size()) {
-    reinterpret_cast<DrawingCommand*>(current + sizeof(uint32_t))->~DrawingCommand();
+    reinterpret_cast<DrawingCommand*>(current + kCommandHeaderSize)->~DrawingCommand();
     current += *(uint32_t*)current;
   }
 }
@@ -178,17 +182,25 @@ void
 DrawTargetCaptureImpl::SetTransform(const Matrix& aTransform)
 {
   AppendCommand(SetTransformCommand)(aTransform);
+
+  // Keep track of the current transform so that GetTransform() on the
+  // capture matches what the replayed DrawTarget will use.
+  DrawTarget::SetTransform(aTransform);
 }
 
 void
 DrawTargetCaptureImpl::ReplayToDrawTarget(DrawTarget* aDT, const Matrix& aTransform)
 {
+  if (mDrawCommandStorage.empty()) {
+    return;
+  }
+
   uint8_t* start = &mDrawCommandStorage.front();
 
   uint8_t* current = start;
 
   while (current < start + mDrawCommandStorage.size()) {
-    reinterpret_cast<DrawingCommand*>(current + sizeof(uint32_t))->ExecuteOnDT(aDT, &aTransform);
+    reinterpret_cast<DrawingCommand*>(current + kCommandHeaderSize)->ExecuteOnDT(aDT, &aTransform);
     current += *(uint32_t*)current;
   }
 }
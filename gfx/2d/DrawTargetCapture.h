@@ -9,6 +9,8 @@
 #include "2D.h"
 #include <vector>
 
+#include "mozilla/Alignment.h"
+
 #include "Filters.h"
 
 namespace mozilla {
@@ -138,17 +140,31 @@ protected:
 
 private:
 
+  // Every DrawingCommand in the storage is preceded by a header holding the
+  // size of the entry. Headers and entries are padded so that the commands
+  // are suitably aligned; they hold pointers and doubles and may be replayed
+  // on platforms that don't tolerate unaligned access.
+  static const size_t kCommandAlignment = 8;
+  static const size_t kCommandHeaderSize = kCommandAlignment;
+
+  static size_t AlignedCommandSize(size_t aSize)
+  {
+    return (aSize + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+  }
+
   // This storage system was used to minimize the amount of heap allocations
-  // that are required while recording. It should be noted there's no
-  // guarantees on the alignments of DrawingCommands allocated in this array.
+  // that are required while recording.
   template<typename T>
   T* AppendToCommandList()
   {
+    static_assert(MOZ_ALIGNOF(T) <= kCommandAlignment,
+                  "DrawingCommand needs stricter alignment than we provide");
+    uint32_t entrySize = kCommandHeaderSize + AlignedCommandSize(sizeof(T));
     size_t oldSize = mDrawCommandStorage.size();
-    mDrawCommandStorage.resize(mDrawCommandStorage.size() + sizeof(T) + sizeof(uint32_t));
+    mDrawCommandStorage.resize(mDrawCommandStorage.size() + entrySize);
     uint8_t* nextDrawLocation = &mDrawCommandStorage.front() + oldSize;
-    *(uint32_t*)(nextDrawLocation) = sizeof(T) + sizeof(uint32_t);
-    return reinterpret_cast<T*>(nextDrawLocation + sizeof(uint32_t));
+    *(uint32_t*)(nextDrawLocation) = entrySize;
+    return reinterpret_cast<T*>(nextDrawLocation + kCommandHeaderSize);
   }
   RefPtr<DrawTarget> mRefDT;
 
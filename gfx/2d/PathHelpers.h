@@ -233,6 +233,17 @@ struct RectCornerRadii {
 
   const Size BottomLeft() const { return radii[RectCorner::BottomLeft]; }
   Size& BottomLeft() { return radii[RectCorner::BottomLeft]; }
+
+  bool operator==(const RectCornerRadii& aOther) const {
+    for (size_t i = 0; i < RectCorner::Count; i++) {
+      if (radii[i] != aOther.radii[i]) return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const RectCornerRadii& aOther) const {
+    return !(*this == aOther);
+  }
 };
 
 /**
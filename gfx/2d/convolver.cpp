@@ -42,6 +42,12 @@
 #include "convolverLS3.h"
 #endif
 
+// The VMX kernels assume big endian pixel layout.
+#if defined(USE_VMX) && defined(SK_CPU_BENDIAN)
+#define USE_CONVOLVER_VMX
+#include "convolverVMX.h"
+#endif
+
 using mozilla::gfx::Factory;
 
 #if defined(SK_CPU_LENDIAN)
@@ -68,6 +74,12 @@ using mozilla::gfx::Factory;
 #define ConvolveVertically_SIMD ConvolveVertically_LS3
 #endif
 
+#if defined(USE_CONVOLVER_VMX)
+#define ConvolveHorizontally4_SIMD ConvolveHorizontally4_VMX
+#define ConvolveHorizontally_SIMD ConvolveHorizontally_VMX
+#define ConvolveVertically_SIMD ConvolveVertically_VMX
+#endif
+
 namespace skia {
 
 namespace {
@@ -292,7 +304,7 @@ void ConvolveVertically(const ConvolutionFilter1D::Fixed* filter_values,
                         bool has_alpha, bool use_simd) {
   int processed = 0;
 
-#if defined(USE_SSE2) || defined(_MIPS_ARCH_LOONGSON3A)
+#if defined(USE_SSE2) || defined(_MIPS_ARCH_LOONGSON3A) || defined(USE_CONVOLVER_VMX)
   // If the binary was not built with SSE2 support, we had to fallback to C version.
   int simd_width = width & ~3;
   if (use_simd && simd_width) {
@@ -320,13 +332,13 @@ void ConvolveHorizontally(const unsigned char* src_data,
                           bool has_alpha, bool use_simd) {
   int width = filter.num_values();
   int processed = 0;
-#if defined(USE_SSE2)
+#if defined(USE_SSE2) || defined(USE_CONVOLVER_VMX)
   int simd_width = width & ~3;
   if (use_simd && simd_width) {
     // SIMD implementation works with 4 pixels at a time.
     // Therefore we process as much as we can using SSE and then use
     // C implementation for leftovers
-    ConvolveHorizontally_SSE2(src_data, 0, simd_width, filter, out_row);
+    ConvolveHorizontally_SIMD(src_data, 0, simd_width, filter, out_row);
     processed = simd_width;
   }
 #endif
@@ -422,6 +434,10 @@ void BGRAConvolve2D(const unsigned char* source_data,
   use_simd = true;
 #endif
 
+#if defined(USE_CONVOLVER_VMX)
+  use_simd = Factory::HasVMX();
+#endif
+
 
   int max_y_filter_size = filter_y.max_filter();
 
@@ -469,7 +485,7 @@ void BGRAConvolve2D(const unsigned char* source_data,
 
     // Generate output rows until we have enough to run the current filter.
     if (use_simd) {
-#if defined(USE_SSE2) || defined(_MIPS_ARCH_LOONGSON3A)
+#if defined(USE_SSE2) || defined(_MIPS_ARCH_LOONGSON3A) || defined(USE_CONVOLVER_VMX)
       // We don't want to process too much rows in batches of 4 because
       // we can go out-of-bounds at the end
       while (next_x_row < filter_offset + filter_length) {
@@ -0,0 +1,217 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "convolverVMX.h"
+
+#include <altivec.h>
+#include <string.h>
+
+#include "mozilla/Attributes.h"
+
+namespace skia {
+
+namespace {
+
+union ShortVector {
+  vector signed short v;
+  short s[8];
+};
+
+union ByteVector {
+  vector unsigned char v;
+  unsigned char b[16];
+};
+
+// Loads 16 bytes from a possibly unaligned address. Both aligned loads only
+// touch 16 byte blocks that contain at least one of the bytes requested.
+MOZ_ALWAYS_INLINE
+vector unsigned char LoadUnaligned(const unsigned char* aData)
+{
+  vector unsigned char first = vec_ld(0, aData);
+  vector unsigned char second = vec_ld(15, aData);
+  return vec_perm(first, second, vec_lvsl(0, aData));
+}
+
+// Returns a vector with the first four lanes set to aFirst and the last four
+// set to aSecond, i.e. one coefficient for every channel of two pixels.
+MOZ_ALWAYS_INLINE
+vector signed short CoefficientsForTwoPixels(ConvolutionFilter1D::Fixed aFirst,
+                                             ConvolutionFilter1D::Fixed aSecond)
+{
+  ShortVector coeff;
+  for (int i = 0; i < 4; i++) {
+    coeff.s[i] = aFirst;
+    coeff.s[i + 4] = aSecond;
+  }
+  return coeff.v;
+}
+
+// Multiplies the channels of two 16-bit pixels by the matching coefficients,
+// returning the 32-bit products for the first and the second pixel.
+MOZ_ALWAYS_INLINE
+void MultiplyTwoPixels(vector signed short aPixels, vector signed short aCoeff,
+                       vector signed int* aFirst, vector signed int* aSecond)
+{
+  vector signed int even = vec_mule(aPixels, aCoeff);
+  vector signed int odd = vec_mulo(aPixels, aCoeff);
+  *aFirst = vec_mergeh(even, odd);
+  *aSecond = vec_mergel(even, odd);
+}
+
+// Adds four pixels, each multiplied by their own coefficient, to aAccum.
+MOZ_ALWAYS_INLINE
+vector signed int AccumulateFourTaps(vector signed int aAccum,
+                                     vector unsigned char aPixels,
+                                     const ConvolutionFilter1D::Fixed* aCoeff)
+{
+  vector unsigned char zero = vec_splat_u8(0);
+  vector signed short pixels01 = (vector signed short)vec_mergeh(zero, aPixels);
+  vector signed short pixels23 = (vector signed short)vec_mergel(zero, aPixels);
+
+  vector signed int p0, p1, p2, p3;
+  MultiplyTwoPixels(pixels01, CoefficientsForTwoPixels(aCoeff[0], aCoeff[1]),
+                    &p0, &p1);
+  MultiplyTwoPixels(pixels23, CoefficientsForTwoPixels(aCoeff[2], aCoeff[3]),
+                    &p2, &p3);
+
+  return vec_add(aAccum, vec_add(vec_add(p0, p1), vec_add(p2, p3)));
+}
+
+// Brings the fixed point sums back in range, and clamps and packs them into
+// four pixels.
+MOZ_ALWAYS_INLINE
+vector unsigned char PackPixels(vector signed int aPixel0,
+                                vector signed int aPixel1,
+                                vector signed int aPixel2,
+                                vector signed int aPixel3)
+{
+  vector unsigned int shift = vec_splat_u32(ConvolutionFilter1D::kShiftBits);
+  vector signed short pixels01 = vec_packs(vec_sra(aPixel0, shift),
+                                           vec_sra(aPixel1, shift));
+  vector signed short pixels23 = vec_packs(vec_sra(aPixel2, shift),
+                                           vec_sra(aPixel3, shift));
+  return vec_packsu(pixels01, pixels23);
+}
+
+}  // namespace
+
+void ConvolveHorizontally_VMX(const unsigned char* src_data,
+                              int begin, int end,
+                              const ConvolutionFilter1D& filter,
+                              unsigned char* out_row) {
+  vector signed int zero = (vector signed int)vec_splat_u32(0);
+
+  for (int out_x = begin; out_x < end; out_x++) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        filter.FilterForValue(out_x, &filter_offset, &filter_length);
+
+    const unsigned char* row_to_filter = &src_data[filter_offset << 2];
+
+    vector signed int accum = zero;
+    int filter_x = 0;
+    for (; filter_x + 4 <= filter_length; filter_x += 4) {
+      accum = AccumulateFourTaps(accum,
+                                 LoadUnaligned(&row_to_filter[filter_x << 2]),
+                                 &filter_values[filter_x]);
+    }
+
+    // Loading the remaining pixels directly could read past the end of the
+    // row, so copy them out and zero the unused coefficients.
+    int remaining = filter_length - filter_x;
+    if (remaining > 0) {
+      ByteVector tail;
+      memset(tail.b, 0, sizeof(tail.b));
+      memcpy(tail.b, &row_to_filter[filter_x << 2], remaining << 2);
+
+      ConvolutionFilter1D::Fixed coeff[4] = { 0, 0, 0, 0 };
+      memcpy(coeff, &filter_values[filter_x],
+             remaining * sizeof(ConvolutionFilter1D::Fixed));
+
+      accum = AccumulateFourTaps(accum, tail.v, coeff);
+    }
+
+    ByteVector result;
+    result.v = PackPixels(accum, zero, zero, zero);
+    memcpy(&out_row[out_x << 2], result.b, 4);
+  }
+}
+
+void ConvolveHorizontally4_VMX(const unsigned char* src_data[4],
+                               int begin, int end,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row[4]) {
+  for (int i = 0; i < 4; i++) {
+    ConvolveHorizontally_VMX(src_data[i], begin, end, filter, out_row[i]);
+  }
+}
+
+void ConvolveVertically_VMX(const ConvolutionFilter1D::Fixed* filter_values,
+                            int filter_length,
+                            unsigned char* const* source_data_rows,
+                            int begin, int end,
+                            unsigned char* out_row, bool has_alpha) {
+  vector unsigned char zero = vec_splat_u8(0);
+  // Splat immediates only go up to 15, but shifts only use the low five bits
+  // of the count, so -16 and -8 shift by 16 and 24.
+  vector unsigned int eight = vec_splat_u32(8);
+  vector unsigned int sixteen = vec_splat_u32(-16);
+  vector unsigned int twentyfour = vec_splat_u32(-8);
+  // The alpha channel is the most significant byte of every pixel.
+  vector unsigned char alpha_mask =
+      (vector unsigned char)vec_sl(vec_splat_u32(-1), twentyfour);
+
+  // Output four pixels per iteration.
+  for (int out_x = begin; out_x < end; out_x += 4) {
+    int byte_offset = out_x << 2;
+
+    vector signed int accum0 = (vector signed int)vec_splat_u32(0);
+    vector signed int accum1 = accum0;
+    vector signed int accum2 = accum0;
+    vector signed int accum3 = accum0;
+
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      vector signed short coeff =
+          CoefficientsForTwoPixels(filter_values[filter_y],
+                                   filter_values[filter_y]);
+      vector unsigned char pixels =
+          LoadUnaligned(&source_data_rows[filter_y][byte_offset]);
+
+      vector signed int p0, p1, p2, p3;
+      MultiplyTwoPixels((vector signed short)vec_mergeh(zero, pixels), coeff,
+                        &p0, &p1);
+      MultiplyTwoPixels((vector signed short)vec_mergel(zero, pixels), coeff,
+                        &p2, &p3);
+
+      accum0 = vec_add(accum0, p0);
+      accum1 = vec_add(accum1, p1);
+      accum2 = vec_add(accum2, p2);
+      accum3 = vec_add(accum3, p3);
+    }
+
+    vector unsigned char result = PackPixels(accum0, accum1, accum2, accum3);
+
+    if (has_alpha) {
+      // Make sure the alpha channel doesn't come out smaller than any of the
+      // color channels, like the C version does. Shifting every pixel left
+      // moves each color channel into the alpha position in turn.
+      vector unsigned int pixels = (vector unsigned int)result;
+      vector unsigned char max_channel =
+          vec_max(vec_max(result, (vector unsigned char)vec_sl(pixels, eight)),
+                  vec_max((vector unsigned char)vec_sl(pixels, sixteen),
+                          (vector unsigned char)vec_sl(pixels, twentyfour)));
+      result = vec_sel(result, max_channel, alpha_mask);
+    } else {
+      // No alpha channel, the image is opaque.
+      result = vec_or(result, alpha_mask);
+    }
+
+    ByteVector out;
+    out.v = result;
+    memcpy(&out_row[byte_offset], out.b, 16);
+  }
+}
+
+}  // namespace skia
@@ -0,0 +1,44 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SKIA_EXT_CONVOLVER_VMX_H_
+#define SKIA_EXT_CONVOLVER_VMX_H_
+
+#include "convolver.h"
+
+namespace skia {
+
+// AltiVec versions of the convolution kernels in convolverSSE2.h. These
+// assume big endian pixel layout, i.e. every pixel is stored as A, R, G, B.
+
+// Convolves horizontally along a single row. The row data is given in
+// |src_data| and continues for the [begin, end) of the filter.
+void ConvolveHorizontally_VMX(const unsigned char* src_data,
+                              int begin, int end,
+                              const ConvolutionFilter1D& filter,
+                              unsigned char* out_row);
+
+// Convolves horizontally along four rows. The row data is given in
+// |src_data| and continues for the [begin, end) of the filter.
+void ConvolveHorizontally4_VMX(const unsigned char* src_data[4],
+                               int begin, int end,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row[4]);
+
+// Does vertical convolution to produce one output row. The filter values and
+// length are given in the first two parameters. These are applied to each
+// of the rows pointed to in the |source_data_rows| array, with each row
+// being |pixel_width| wide. |end - begin| must be a multiple of four.
+//
+// The output must have room for |pixel_width * 4| bytes.
+void ConvolveVertically_VMX(const ConvolutionFilter1D::Fixed* filter_values,
+                            int filter_length,
+                            unsigned char* const* source_data_rows,
+                            int begin, int end,
+                            unsigned char* out_row, bool has_alpha);
+
+}  // namespace skia
+
+#endif  // SKIA_EXT_CONVOLVER_VMX_H_
@@ -224,6 +224,12 @@ HitTestingTreeNode::HitTest(const ParentLayerPoint& aPoint) const
     return HitTestResult::HitNothing;
   }
 
+  // Many nodes (e.g. pure container layers) have no hit region at all; skip
+  // inverting the transform for them since nothing can be hit anyway.
+  if (mEventRegions.mHitRegion.IsEmpty()) {
+    return HitTestResult::HitNothing;
+  }
+
   // convert into Layer coordinate space
   Maybe<LayerPoint> pointInLayerPixels = Untransform(aPoint);
   if (!pointInLayerPixels) {
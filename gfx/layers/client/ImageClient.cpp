@@ -294,7 +294,15 @@ ImageClient::ImageClient(CompositableForwarder* aFwd, TextureFlags aFlags,
 , mLayer(nullptr)
 , mType(aType)
 , mLastUpdateGenerationCounter(0)
-{}
+{
+  if (aFwd) {
+    mYCbCrRecycler = new YCbCrRecycleAllocator(aFwd);
+  }
+}
+
+ImageClient::~ImageClient()
+{
+}
 
 ImageClientBridge::ImageClientBridge(CompositableForwarder* aFwd,
                                      TextureFlags aFlags)
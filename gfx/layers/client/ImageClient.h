@@ -29,6 +29,7 @@ class AsyncTransactionTracker;
 class Image;
 class ImageContainer;
 class ShadowableLayer;
+class YCbCrRecycleAllocator;
 
 /**
  * Image clients are used by basic image layers on the content thread, they
@@ -47,7 +48,7 @@ public:
                                                      CompositableForwarder* aFwd,
                                                      TextureFlags aFlags);
 
-  virtual ~ImageClient() {}
+  virtual ~ImageClient();
 
   /**
    * Update this ImageClient from aContainer in aLayer
@@ -72,6 +73,16 @@ public:
   void RemoveTextureWithWaiter(TextureClient* aTexture,
                                AsyncTransactionWaiter* aAsyncTransactionWaiter = nullptr);
 
+  /**
+   * Returns the allocator which recycles the TextureClients of the
+   * SharedPlanarYCbCrImages created for this image client, or null.
+   * Can be called on any thread.
+   */
+  YCbCrRecycleAllocator* GetYCbCrRecycleAllocator() const
+  {
+    return mYCbCrRecycler;
+  }
+
 protected:
   ImageClient(CompositableForwarder* aFwd, TextureFlags aFlags,
               CompositableType aType);
@@ -79,6 +90,8 @@ protected:
   ClientLayer* mLayer;
   CompositableType mType;
   uint32_t mLastUpdateGenerationCounter;
+  // Created up front, since images are allocated on decoder threads.
+  RefPtr<YCbCrRecycleAllocator> mYCbCrRecycler;
 };
 
 /**
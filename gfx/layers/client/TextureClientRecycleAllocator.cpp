@@ -75,8 +75,7 @@ TextureClientRecycleAllocator::CreateOrRecycle(gfx::SurfaceFormat aFormat,
       textureHolder = mPooledClients.top();
       mPooledClients.pop();
       // If a pooled TextureClient is not compatible, release it.
-      if (textureHolder->GetTextureClient()->GetFormat() != aFormat ||
-          textureHolder->GetTextureClient()->GetSize() != aSize) {
+      if (!IsCompatible(textureHolder->GetTextureClient(), aFormat, aSize)) {
         TextureClientReleaseTask* task = new TextureClientReleaseTask(textureHolder->GetTextureClient());
         textureHolder->ClearTextureClient();
         textureHolder = nullptr;
@@ -122,6 +121,14 @@ TextureClientRecycleAllocator::Allocate(gfx::SurfaceFormat aFormat,
                                          aTextureFlags, aAllocFlags);
 }
 
+bool
+TextureClientRecycleAllocator::IsCompatible(TextureClient* aClient,
+                                            gfx::SurfaceFormat aFormat,
+                                            gfx::IntSize aSize)
+{
+  return aClient->GetFormat() == aFormat && aClient->GetSize() == aSize;
+}
+
 void
 TextureClientRecycleAllocator::RecycleTextureClient(TextureClient* aClient)
 {
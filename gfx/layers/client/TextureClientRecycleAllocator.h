@@ -57,6 +57,12 @@ protected:
            TextureFlags aTextureFlags,
            TextureAllocationFlags aAllocFlags);
 
+  // Returns true if the pooled TextureClient aClient can be handed out for
+  // a request with the given format and size.
+  virtual bool IsCompatible(TextureClient* aClient,
+                            gfx::SurfaceFormat aFormat,
+                            gfx::IntSize aSize);
+
   RefPtr<ISurfaceAllocator> mSurfaceAllocator;
 
 private:
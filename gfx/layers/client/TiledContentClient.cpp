@@ -966,6 +966,13 @@ ClientMultiTiledLayerBuffer::PaintThebes(const nsIntRegion& aNewValidRegion,
 
     mCallback(mPaintedLayer, ctxt, aPaintRegion, &aDirtyRegion,
               DrawRegionClip::NONE, nsIntRegion(), mCallbackData);
+    ctxt = nullptr;
+
+    mSinglePaintSnapshot = mSinglePaintDrawTarget->Snapshot();
+    if (!mSinglePaintSnapshot) {
+      mSinglePaintDrawTarget = nullptr;
+      return;
+    }
   }
 
 #ifdef GFX_TILEDLAYER_PREF_WARNINGS
@@ -1000,6 +1007,7 @@ ClientMultiTiledLayerBuffer::PaintThebes(const nsIntRegion& aNewValidRegion,
   mCallback = nullptr;
   mCallbackData = nullptr;
   mSinglePaintDrawTarget = nullptr;
+  mSinglePaintSnapshot = nullptr;
 }
 
 void PadDrawTargetOutFromRegion(RefPtr<DrawTarget> drawTarget, nsIntRegion &region)
@@ -1248,7 +1256,7 @@ ClientMultiTiledLayerBuffer::ValidateTile(TileClient& aTile,
   offsetScaledDirtyRegion.ScaleRoundOut(mResolution, mResolution);
 
   bool usingTiledDrawTarget = gfxPrefs::TiledDrawTargetEnabled();
-  MOZ_ASSERT(usingTiledDrawTarget || !!mSinglePaintDrawTarget);
+  MOZ_ASSERT(usingTiledDrawTarget || !!mSinglePaintSnapshot);
 
   nsIntRegion extraPainted;
   RefPtr<TextureClient> backBufferOnWhite;
@@ -1322,15 +1330,13 @@ ClientMultiTiledLayerBuffer::ValidateTile(TileClient& aTile,
   MOZ_ASSERT(!backBufferOnWhite, "Component alpha only supported with TiledDrawTarget");
 
   // We must not keep a reference to the DrawTarget after it has been unlocked,
-  // make sure these are null'd before unlocking as destruction of the context
-  // may cause the target to be flushed.
+  // make sure it is null'd before unlocking as that may cause the target to
+  // be flushed.
   RefPtr<DrawTarget> drawTarget = backBuffer->BorrowDrawTarget();
   drawTarget->SetTransform(Matrix());
 
-  RefPtr<gfxContext> ctxt = new gfxContext(drawTarget);
-
   // XXX Perhaps we should just copy the bounding rectangle here?
-  RefPtr<gfx::SourceSurface> source = mSinglePaintDrawTarget->Snapshot();
+  gfx::SourceSurface* source = mSinglePaintSnapshot;
   nsIntRegionRectIterator it(aDirtyRegion);
   for (const IntRect* dirtyRect = it.Next(); dirtyRect != nullptr; dirtyRect = it.Next()) {
 #ifdef GFX_TILEDLAYER_PREF_WARNINGS
@@ -1362,7 +1368,6 @@ ClientMultiTiledLayerBuffer::ValidateTile(TileClient& aTile,
                    aTileOrigin.y * GetPresShellResolution(), GetTileLength(), GetTileLength());
 #endif
 
-  ctxt = nullptr;
   drawTarget = nullptr;
 
   nsIntRegion tileRegion =
@@ -545,6 +545,9 @@ private:
 
   // The DrawTarget we use when UseSinglePaintBuffer() above is true.
   RefPtr<gfx::DrawTarget>       mSinglePaintDrawTarget;
+  // Snapshot of mSinglePaintDrawTarget once it has been painted, which
+  // all the tiles copy from.
+  RefPtr<gfx::SourceSurface>    mSinglePaintSnapshot;
   nsIntPoint                    mSinglePaintBufferOffset;
   SharedFrameMetricsHelper*  mSharedFrameMetricsHelper;
   // When using Moz2D's CreateTiledDrawTarget we maintain a list of gfx::Tiles
@@ -347,6 +347,14 @@ ContainerPrepare(ContainerT* aContainer,
         CULLING_LOG("Sublayer %p has an empty world clip rect\n", layerToRender->GetLayer());
         continue;
       }
+
+      // Fully transparent layers (e.g. ones that have faded out or are
+      // waiting for an opacity animation to start) would cost a draw call and
+      // their texture binds without touching a single pixel.
+      if (layerToRender->GetLayer()->GetEffectiveOpacity() == 0.0f) {
+        CULLING_LOG("Sublayer %p is fully transparent\n", layerToRender->GetLayer());
+        continue;
+      }
     }
 
     CULLING_LOG("Preparing sublayer %p\n", layerToRender->GetLayer());
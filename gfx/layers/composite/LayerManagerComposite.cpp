@@ -204,20 +204,45 @@ LayerManagerComposite::BeginTransactionWithDrawTarget(DrawTarget* aTarget, const
   mTargetBounds = aRect;
 }
 
+/**
+ * Returns the part of aRegion transformed by aTransform that is covered
+ * entirely by whole pixels. aTransform must preserve axis aligned rectangles.
+ */
+static nsIntRegion
+TransformRegionRoundingIn(const nsIntRegion& aRegion, const Matrix& aTransform)
+{
+  nsIntRegion result;
+  nsIntRegionRectIterator iter(aRegion);
+  while (const IntRect* rect = iter.Next()) {
+    Rect transformed = aTransform.TransformBounds(Rect(*rect));
+    result.Or(result, RoundedIn(transformed));
+  }
+  return result;
+}
+
 void
 LayerManagerComposite::ApplyOcclusionCulling(Layer* aLayer, nsIntRegion& aOpaqueRegion)
 {
   nsIntRegion localOpaque;
   Matrix transform2d;
   bool isTranslation = false;
+  bool isRectilinear = false;
   // If aLayer has a simple transform (only an integer translation) then we
   // can easily convert aOpaqueRegion into pre-transform coordinates and include
-  // that region.
+  // that region. Other transforms that keep rectangles axis aligned (such as
+  // scales) work too, as long as we only keep the pixels that stay fully
+  // covered.
   if (aLayer->GetLocalTransform().Is2D(&transform2d)) {
     if (transform2d.IsIntegerTranslation()) {
       isTranslation = true;
       localOpaque = aOpaqueRegion;
       localOpaque.MoveBy(-transform2d._31, -transform2d._32);
+    } else if (transform2d.PreservesAxisAlignedRectangles()) {
+      Matrix inverse = transform2d;
+      if (inverse.Invert()) {
+        isRectilinear = true;
+        localOpaque = TransformRegionRoundingIn(aOpaqueRegion, inverse);
+      }
     }
   }
 
@@ -238,13 +263,17 @@ LayerManagerComposite::ApplyOcclusionCulling(Layer* aLayer, nsIntRegion& aOpaque
 
   // If we have a simple transform, then we can add our opaque area into
   // aOpaqueRegion.
-  if (isTranslation &&
+  if ((isTranslation || isRectilinear) &&
       !aLayer->HasMaskLayers() &&
       aLayer->GetLocalOpacity() == 1.0f) {
     if (aLayer->GetContentFlags() & Layer::CONTENT_OPAQUE) {
       localOpaque.Or(localOpaque, composite->GetFullyRenderedRegion());
     }
-    localOpaque.MoveBy(transform2d._31, transform2d._32);
+    if (isTranslation) {
+      localOpaque.MoveBy(transform2d._31, transform2d._32);
+    } else {
+      localOpaque = TransformRegionRoundingIn(localOpaque, transform2d);
+    }
     const Maybe<ParentLayerIntRect>& clip = aLayer->GetEffectiveClipRect();
     if (clip) {
       localOpaque.And(localOpaque, ParentLayerIntRect::ToUntyped(*clip));
@@ -25,6 +25,64 @@ namespace layers {
 
 using namespace mozilla::ipc;
 
+already_AddRefed<BufferTextureClient>
+YCbCrRecycleAllocator::CreateOrRecycleClient(const gfx::IntSize& aYSize,
+                                             const gfx::IntSize& aCbCrSize,
+                                             StereoMode aStereoMode,
+                                             TextureFlags aTextureFlags)
+{
+  MutexAutoLock lock(mLock);
+  mCbCrSize = aCbCrSize;
+  mStereoMode = aStereoMode;
+
+  RefPtr<TextureClient> textureClient =
+    CreateOrRecycle(gfx::SurfaceFormat::YUV,
+                    aYSize,
+                    BackendSelector::Content,
+                    aTextureFlags);
+  if (!textureClient) {
+    return nullptr;
+  }
+
+  RefPtr<BufferTextureClient> bufferClient =
+    static_cast<BufferTextureClient*>(textureClient.get());
+  return bufferClient.forget();
+}
+
+already_AddRefed<TextureClient>
+YCbCrRecycleAllocator::Allocate(gfx::SurfaceFormat aFormat,
+                                gfx::IntSize aSize,
+                                BackendSelector aSelector,
+                                TextureFlags aTextureFlags,
+                                TextureAllocationFlags aAllocFlags)
+{
+  mLock.AssertCurrentThreadOwns();
+  MOZ_ASSERT(aFormat == gfx::SurfaceFormat::YUV);
+
+  RefPtr<BufferTextureClient> client =
+    TextureClient::CreateForYCbCr(mSurfaceAllocator, aSize, mCbCrSize,
+                                  mStereoMode, aTextureFlags);
+  return client.forget();
+}
+
+bool
+YCbCrRecycleAllocator::IsCompatible(TextureClient* aClient,
+                                    gfx::SurfaceFormat aFormat,
+                                    gfx::IntSize aSize)
+{
+  mLock.AssertCurrentThreadOwns();
+
+  if (!TextureClientRecycleAllocator::IsCompatible(aClient, aFormat, aSize)) {
+    return false;
+  }
+
+  // SharedPlanarYCbCrImage::Allocate() rewrites the plane layout, so any
+  // buffer of the right size will do.
+  BufferTextureClient* bufferClient = static_cast<BufferTextureClient*>(aClient);
+  return bufferClient->GetBufferSize() ==
+         YCbCrImageDataSerializer::ComputeMinBufferSize(aSize, mCbCrSize);
+}
+
 SharedPlanarYCbCrImage::SharedPlanarYCbCrImage(ImageClient* aCompositable)
 : PlanarYCbCrImage(nullptr)
 , mCompositable(aCompositable)
@@ -181,10 +239,18 @@ SharedPlanarYCbCrImage::Allocate(PlanarYCbCrData& aData)
   MOZ_ASSERT(!mTextureClient,
              "This image already has allocated data");
 
-  mTextureClient = TextureClient::CreateForYCbCr(mCompositable->GetForwarder(),
-                                                 aData.mYSize, aData.mCbCrSize,
-                                                 aData.mStereoMode,
-                                                 mCompositable->GetTextureFlags());
+  YCbCrRecycleAllocator* recycler = mCompositable->GetYCbCrRecycleAllocator();
+  if (recycler) {
+    mTextureClient = recycler->CreateOrRecycleClient(aData.mYSize,
+                                                     aData.mCbCrSize,
+                                                     aData.mStereoMode,
+                                                     mCompositable->GetTextureFlags());
+  } else {
+    mTextureClient = TextureClient::CreateForYCbCr(mCompositable->GetForwarder(),
+                                                   aData.mYSize, aData.mCbCrSize,
+                                                   aData.mStereoMode,
+                                                   mCompositable->GetTextureFlags());
+  }
   if (!mTextureClient) {
     NS_WARNING("SharedPlanarYCbCrImage::Allocate failed.");
     return false;
@@ -6,8 +6,10 @@
 #include <stdint.h>                     // for uint8_t, uint32_t
 #include "ImageContainer.h"             // for PlanarYCbCrImage, etc
 #include "mozilla/Attributes.h"         // for override
+#include "mozilla/Mutex.h"              // for Mutex
 #include "mozilla/RefPtr.h"             // for RefPtr
 #include "mozilla/ipc/Shmem.h"          // for Shmem
+#include "mozilla/layers/TextureClientRecycleAllocator.h"
 #include "nsCOMPtr.h"                   // for already_AddRefed
 #include "nsDebug.h"                    // for NS_WARNING
 #include "nsISupportsImpl.h"            // for MOZ_COUNT_CTOR
@@ -22,6 +24,44 @@ class BufferTextureClient;
 class ImageClient;
 class TextureClient;
 
+// Recycles the shared memory TextureClients that SharedPlanarYCbCrImages
+// copy video frames into, so playback doesn't allocate, map and send to the
+// compositor a new buffer for every frame.
+class YCbCrRecycleAllocator : public TextureClientRecycleAllocator
+{
+public:
+  explicit YCbCrRecycleAllocator(ISurfaceAllocator* aAllocator)
+    : TextureClientRecycleAllocator(aAllocator)
+    , mLock("YCbCrRecycleAllocator.mLock")
+    , mStereoMode(StereoMode::MONO)
+  {}
+
+  already_AddRefed<BufferTextureClient>
+  CreateOrRecycleClient(const gfx::IntSize& aYSize,
+                        const gfx::IntSize& aCbCrSize,
+                        StereoMode aStereoMode,
+                        TextureFlags aTextureFlags);
+
+protected:
+  virtual already_AddRefed<TextureClient>
+  Allocate(gfx::SurfaceFormat aFormat,
+           gfx::IntSize aSize,
+           BackendSelector aSelector,
+           TextureFlags aTextureFlags,
+           TextureAllocationFlags aAllocFlags) override;
+
+  virtual bool IsCompatible(TextureClient* aClient,
+                            gfx::SurfaceFormat aFormat,
+                            gfx::IntSize aSize) override;
+
+private:
+  // Held across CreateOrRecycle(), and guards the parameters of the request
+  // being served, which Allocate() and IsCompatible() need.
+  Mutex mLock;
+  gfx::IntSize mCbCrSize;
+  StereoMode mStereoMode;
+};
+
 class SharedPlanarYCbCrImage : public PlanarYCbCrImage
 {
 public:
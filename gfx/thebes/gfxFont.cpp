@@ -2298,6 +2298,68 @@ gfxFont::AgeCachedWords()
     }
 }
 
+void
+gfxFont::TrimCachedWords(uint32_t aMaxEntries)
+{
+    if (!mWordCache) {
+        return;
+    }
+
+    // Trim below the limit so that we don't have to do this on every miss.
+    uint32_t target = aMaxEntries - aMaxEntries / 4;
+    if (mWordCache->Count() <= target) {
+        return;
+    }
+
+    // A hit resets a word's age, and the expiration timer and earlier trims
+    // increment it, so older words have gone unused for longer.  Count the
+    // words of each age.
+    uint32_t wordsOfAge[kShapedWordCacheMaxAge] = { 0 };
+    for (auto it = mWordCache->Iter(); !it.Done(); it.Next()) {
+        CacheHashEntry *entry = it.Get();
+        if (!entry->mShapedWord) {
+            NS_ASSERTION(entry->mShapedWord,
+                         "cache entry has no gfxShapedWord!");
+            it.Remove();
+            continue;
+        }
+        wordsOfAge[std::min(entry->mShapedWord->Age(),
+                            kShapedWordCacheMaxAge - 1)]++;
+    }
+
+    uint32_t count = mWordCache->Count();
+    if (count <= target) {
+        return;
+    }
+
+    // Find the youngest age we have to evict words of.  All older words go,
+    // and of the words of exactly that age, only as many as we need.
+    uint32_t excess = count - target;
+    uint32_t cutoffAge = kShapedWordCacheMaxAge - 1;
+    uint32_t evictAtCutoff = 0;
+    for (uint32_t age = kShapedWordCacheMaxAge; age-- > 0 && excess > 0; ) {
+        cutoffAge = age;
+        evictAtCutoff = std::min(excess, wordsOfAge[age]);
+        excess -= evictAtCutoff;
+    }
+
+    // The survivors get older too, so that the words used between now and
+    // the next trim rank ahead of them.  They aren't expired here; that is
+    // left to the timer.
+    for (auto it = mWordCache->Iter(); !it.Done(); it.Next()) {
+        gfxShapedWord *sw = it.Get()->mShapedWord;
+        uint32_t age = std::min(sw->Age(), kShapedWordCacheMaxAge - 1);
+        if (age > cutoffAge) {
+            it.Remove();
+        } else if (age == cutoffAge && evictAtCutoff > 0) {
+            it.Remove();
+            --evictAtCutoff;
+        } else if (age + 1 < kShapedWordCacheMaxAge) {
+            sw->IncrementAge();
+        }
+    }
+}
+
 void
 gfxFont::NotifyGlyphsChanged()
 {
@@ -2338,12 +2400,11 @@ gfxFont::GetShapedWord(gfxContext *aContext,
                        uint32_t    aFlags,
                        gfxTextPerfMetrics *aTextPerf GFX_MAYBE_UNUSED)
 {
-    // if the cache is getting too big, flush it and start over
+    // if the cache is getting too big, drop the least recently used words
     uint32_t wordCacheMaxEntries =
         gfxPlatform::GetPlatform()->WordCacheMaxEntries();
     if (mWordCache->Count() > wordCacheMaxEntries) {
-        NS_WARNING("flushing shaped-word cache");
-        ClearCachedWords();
+        TrimCachedWords(wordCacheMaxEntries);
     }
 
     // if there's a cached entry for this word, just return it
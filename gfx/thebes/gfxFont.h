@@ -1219,6 +1219,9 @@ public:
     void ResetAge() {
         mAgeCounter = 0;
     }
+    uint32_t Age() const {
+        return mAgeCounter;
+    }
     uint32_t IncrementAge() {
         return ++mAgeCounter;
     }
@@ -1708,6 +1711,10 @@ public:
     // so that they'll expire after a sufficient period of non-use
     void AgeCachedWords();
 
+    // Called when the cache outgrows aMaxEntries: discard the oldest words,
+    // by age, until three quarters of aMaxEntries remain.
+    void TrimCachedWords(uint32_t aMaxEntries);
+
     // Discard all cached word records; called on memory-pressure notification.
     void ClearCachedWords() {
         if (mWordCache) {
@@ -9,6 +9,7 @@
 #include "nsExpirationTracker.h"
 #include "nsClassHashtable.h"
 #include "mozilla/Telemetry.h"
+#include "nsIMemoryReporter.h"
 #include "gfxGradientCache.h"
 #include <time.h>
 
@@ -22,17 +23,33 @@ struct GradientCacheKey : public PLDHashEntryHdr {
   typedef const GradientCacheKey* KeyTypePointer;
   enum { ALLOW_MEMMOVE = true };
   const nsTArray<GradientStop> mStops;
+  // Only set for keys built by ForLookup, which point at the caller's stops
+  // instead of copying them. Keys stored in the table always own mStops.
+  const nsTArray<GradientStop>* mBorrowedStops;
   ExtendMode mExtend;
   BackendType mBackendType;
 
   GradientCacheKey(const nsTArray<GradientStop>& aStops, ExtendMode aExtend, BackendType aBackendType)
-    : mStops(aStops), mExtend(aExtend), mBackendType(aBackendType)
+    : mStops(aStops), mBorrowedStops(nullptr), mExtend(aExtend), mBackendType(aBackendType)
   { }
 
   explicit GradientCacheKey(const GradientCacheKey* aOther)
-    : mStops(aOther->mStops), mExtend(aOther->mExtend), mBackendType(aOther->mBackendType)
+    : mStops(aOther->Stops()), mBorrowedStops(nullptr), mExtend(aOther->mExtend), mBackendType(aOther->mBackendType)
   { }
 
+  // Builds a temporary key for Lookup without copying the stops, so finding
+  // a cached gradient doesn't allocate. The key must not outlive aStops.
+  static GradientCacheKey
+  ForLookup(const nsTArray<GradientStop>& aStops, ExtendMode aExtend, BackendType aBackendType)
+  {
+    return GradientCacheKey(&aStops, aExtend, aBackendType);
+  }
+
+  const nsTArray<GradientStop>& Stops() const
+  {
+    return mBorrowedStops ? *mBorrowedStops : mStops;
+  }
+
   union FloatUint32
   {
     float    f;
@@ -46,10 +63,11 @@ struct GradientCacheKey : public PLDHashEntryHdr {
     FloatUint32 convert;
     hash = AddToHash(hash, int(aKey->mBackendType));
     hash = AddToHash(hash, int(aKey->mExtend));
-    for (uint32_t i = 0; i < aKey->mStops.Length(); i++) {
-      hash = AddToHash(hash, aKey->mStops[i].color.ToABGR());
+    const nsTArray<GradientStop>& stops = aKey->Stops();
+    for (uint32_t i = 0; i < stops.Length(); i++) {
+      hash = AddToHash(hash, stops[i].color.ToABGR());
       // Use the float bits as hash, except for the cases of 0.0 and -0.0 which both map to 0
-      convert.f = aKey->mStops[i].offset;
+      convert.f = stops[i].offset;
       hash = AddToHash(hash, convert.f ? convert.u : 0);
     }
     return hash;
@@ -57,13 +75,15 @@ struct GradientCacheKey : public PLDHashEntryHdr {
 
   bool KeyEquals(KeyTypePointer aKey) const
   {
+    const nsTArray<GradientStop>& stops = Stops();
+    const nsTArray<GradientStop>& otherStops = aKey->Stops();
     bool sameStops = true;
-    if (aKey->mStops.Length() != mStops.Length()) {
+    if (otherStops.Length() != stops.Length()) {
       sameStops = false;
     } else {
-      for (uint32_t i = 0; i < mStops.Length(); i++) {
-        if (mStops[i].color.ToABGR() != aKey->mStops[i].color.ToABGR() ||
-            mStops[i].offset != aKey->mStops[i].offset) {
+      for (uint32_t i = 0; i < stops.Length(); i++) {
+        if (stops[i].color.ToABGR() != otherStops[i].color.ToABGR() ||
+            stops[i].offset != otherStops[i].offset) {
           sameStops = false;
           break;
         }
@@ -78,6 +98,11 @@ struct GradientCacheKey : public PLDHashEntryHdr {
   {
     return &aKey;
   }
+
+private:
+  GradientCacheKey(const nsTArray<GradientStop>* aStops, ExtendMode aExtend, BackendType aBackendType)
+    : mBorrowedStops(aStops), mExtend(aExtend), mBackendType(aBackendType)
+  { }
 };
 
 /**
@@ -139,7 +164,7 @@ class GradientCache final : public nsExpirationTracker<GradientCacheData,4>
     GradientCacheData* Lookup(const nsTArray<GradientStop>& aStops, ExtendMode aExtend, BackendType aBackendType)
     {
       GradientCacheData* gradient =
-        mHashEntries.Get(GradientCacheKey(aStops, aExtend, aBackendType));
+        mHashEntries.Get(GradientCacheKey::ForLookup(aStops, aExtend, aBackendType));
 
       if (gradient) {
         MarkUsed(gradient);
@@ -165,6 +190,23 @@ class GradientCache final : public nsExpirationTracker<GradientCacheData,4>
       return true;
     }
 
+    // The GradientStops themselves are backend objects (possibly living on
+    // the GPU) that we can't measure, so this only covers the cache's own
+    // bookkeeping and the stop arrays kept around as keys.
+    size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const
+    {
+      size_t n = aMallocSizeOf(this);
+      n += mHashEntries.ShallowSizeOfExcludingThis(aMallocSizeOf);
+      for (auto iter = mHashEntries.ConstIter(); !iter.Done(); iter.Next()) {
+        // The table's key and the entry's key each own a copy of the stops.
+        const GradientCacheData* data = iter.UserData();
+        n += iter.Key().mStops.ShallowSizeOfExcludingThis(aMallocSizeOf);
+        n += aMallocSizeOf(data);
+        n += data->mKey.mStops.ShallowSizeOfExcludingThis(aMallocSizeOf);
+      }
+      return n;
+    }
+
   protected:
     uint32_t mTimerPeriod;
     static const uint32_t MAX_GENERATION_MS = 10000;
@@ -177,12 +219,49 @@ class GradientCache final : public nsExpirationTracker<GradientCacheData,4>
 
 static GradientCache* gGradientCache = nullptr;
 
-GradientStops *
-gfxGradientCache::GetGradientStops(const DrawTarget *aDT, nsTArray<GradientStop>& aStops, ExtendMode aExtend)
+MOZ_DEFINE_MALLOC_SIZE_OF(GradientCacheMallocSizeOf)
+
+class GradientCacheReporter final : public nsIMemoryReporter
+{
+  ~GradientCacheReporter() {}
+
+public:
+  NS_DECL_ISUPPORTS
+
+  NS_IMETHOD
+  CollectReports(nsIHandleReportCallback* aHandleReport, nsISupports* aData,
+                 bool aAnonymize) override
+  {
+    size_t amount = gGradientCache
+                  ? gGradientCache->SizeOfIncludingThis(GradientCacheMallocSizeOf)
+                  : 0;
+    return MOZ_COLLECT_REPORT(
+      "explicit/gfx/gradient-cache", KIND_HEAP, UNITS_BYTES, amount,
+      "Memory used by the cache of gradient stops, not including the "
+      "backend gradient objects themselves.");
+  }
+};
+
+NS_IMPL_ISUPPORTS(GradientCacheReporter, nsIMemoryReporter)
+
+static void
+EnsureGradientCache()
 {
   if (!gGradientCache) {
     gGradientCache = new GradientCache();
+
+    static bool sReporterRegistered = false;
+    if (!sReporterRegistered) {
+      RegisterStrongMemoryReporter(new GradientCacheReporter());
+      sReporterRegistered = true;
+    }
   }
+}
+
+GradientStops *
+gfxGradientCache::GetGradientStops(const DrawTarget *aDT, nsTArray<GradientStop>& aStops, ExtendMode aExtend)
+{
+  EnsureGradientCache();
   GradientCacheData* cached =
     gGradientCache->Lookup(aStops, aExtend, aDT->GetBackendType());
   if (cached && cached->mStops) {
@@ -196,7 +275,7 @@ gfxGradientCache::GetGradientStops(const DrawTarget *aDT, nsTArray<GradientStop>
   return nullptr;
 }
 
-GradientStops *
+already_AddRefed<GradientStops>
 gfxGradientCache::GetOrCreateGradientStops(const DrawTarget *aDT, nsTArray<GradientStop>& aStops, ExtendMode aExtend)
 {
   RefPtr<GradientStops> gs = GetGradientStops(aDT, aStops, aExtend);
@@ -212,7 +291,8 @@ gfxGradientCache::GetOrCreateGradientStops(const DrawTarget *aDT, nsTArray<Gradi
       delete cached;
     }
   }
-  return gs;
+  // Hand out a reference, if registering failed ours is the only one left.
+  return gs.forget();
 }
 
 void
@@ -102,6 +102,7 @@ class mozilla::gl::SkiaGLGlue : public GenericAtomicRefCounted {
 #include "mozilla/Assertions.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/StaticMutex.h"
 
 #include "nsIGfxInfo.h"
 #include "nsIXULRuntime.h"
@@ -140,6 +141,26 @@ static qcms_transform *gCMSRGBATransform = nullptr;
 static bool gCMSInitialized = false;
 static eCMSMode gCMSMode = eCMSMode_Off;
 
+namespace {
+
+struct CMSTransformCacheEntry
+{
+    nsTArray<uint8_t> mProfileData;
+    qcms_data_type mInType;
+    qcms_intent mIntent;
+    uint32_t mLastUse;
+    nsRefPtr<gfxCMSTransform> mTransform;
+};
+
+} // namespace
+
+// Transforms for embedded ICC profiles, see GetCMSTransformForProfile. They
+// all target gCMSOutputProfile, so ShutdownCMS empties the cache.
+static StaticMutex gCMSTransformCacheMutex;
+static nsTArray<CMSTransformCacheEntry>* gCMSTransformCache = nullptr;
+static uint32_t gCMSTransformCacheUseCount = 0;
+static const uint32_t kMaxCMSTransformCacheEntries = 8;
+
 static void ShutdownCMS();
 
 #include "mozilla/gfx/2D.h"
@@ -1737,8 +1758,10 @@ gfxPlatform::InitBackendPrefs(uint32_t aCanvasBitmask, BackendType aCanvasDefaul
                               uint32_t aContentBitmask, BackendType aContentDefault)
 {
     mPreferredCanvasBackend = GetCanvasBackendPref(aCanvasBitmask);
+    bool usingCanvasDefault = false;
     if (mPreferredCanvasBackend == BackendType::NONE) {
         mPreferredCanvasBackend = aCanvasDefault;
+        usingCanvasDefault = true;
     }
 
     if (mPreferredCanvasBackend == BackendType::DIRECT2D1_1) {
@@ -1753,6 +1776,15 @@ gfxPlatform::InitBackendPrefs(uint32_t aCanvasBitmask, BackendType aCanvasDefaul
           GetCanvasBackendPref(aCanvasBitmask & ~BackendTypeBit(mPreferredCanvasBackend));
     }
 
+    // When the platform picked the canvas backend rather than the pref, still
+    // let canvases the default backend can't create fall back to cairo.
+    if (usingCanvasDefault &&
+        mFallbackCanvasBackend == BackendType::NONE &&
+        mPreferredCanvasBackend != BackendType::CAIRO &&
+        (aCanvasBitmask & BackendTypeBit(BackendType::CAIRO))) {
+        mFallbackCanvasBackend = BackendType::CAIRO;
+    }
+
     mContentBackendBitmask = aContentBitmask;
     mContentBackend = GetContentBackendPref(mContentBackendBitmask);
     if (mContentBackend == BackendType::NONE) {
@@ -2027,9 +2059,82 @@ gfxPlatform::GetCMSRGBATransform()
     return gCMSRGBATransform;
 }
 
+/* static */ already_AddRefed<gfxCMSTransform>
+gfxPlatform::GetCMSTransformForProfile(const uint8_t* aProfileData,
+                                       uint32_t aProfileLength,
+                                       qcms_profile* aInProfile,
+                                       qcms_data_type aInType,
+                                       qcms_intent aIntent)
+{
+    qcms_profile* outProfile = GetCMSOutputProfile();
+    if (!aInProfile || !outProfile) {
+        return nullptr;
+    }
+
+    {
+        StaticMutexAutoLock lock(gCMSTransformCacheMutex);
+        if (gCMSTransformCache) {
+            for (uint32_t i = 0; i < gCMSTransformCache->Length(); ++i) {
+                CMSTransformCacheEntry& entry = (*gCMSTransformCache)[i];
+                if (entry.mInType == aInType &&
+                    entry.mIntent == aIntent &&
+                    entry.mProfileData.Length() == aProfileLength &&
+                    !memcmp(entry.mProfileData.Elements(), aProfileData,
+                            aProfileLength)) {
+                    entry.mLastUse = ++gCMSTransformCacheUseCount;
+                    nsRefPtr<gfxCMSTransform> transform = entry.mTransform;
+                    return transform.forget();
+                }
+            }
+        }
+    }
+
+    // Build the transform without holding the lock, this is the slow part.
+    qcms_transform* qtransform = qcms_transform_create(aInProfile, aInType,
+                                                       outProfile,
+                                                       QCMS_DATA_RGB_8,
+                                                       aIntent);
+    if (!qtransform) {
+        return nullptr;
+    }
+    nsRefPtr<gfxCMSTransform> transform = new gfxCMSTransform(qtransform);
+
+    StaticMutexAutoLock lock(gCMSTransformCacheMutex);
+    if (!gCMSTransformCache) {
+        gCMSTransformCache = new nsTArray<CMSTransformCacheEntry>();
+    }
+
+    if (gCMSTransformCache->Length() >= kMaxCMSTransformCacheEntries) {
+        // Evict the least recently used transform. Decoders still using it
+        // keep their own reference.
+        uint32_t oldest = 0;
+        for (uint32_t i = 1; i < gCMSTransformCache->Length(); ++i) {
+            if ((*gCMSTransformCache)[i].mLastUse <
+                (*gCMSTransformCache)[oldest].mLastUse) {
+                oldest = i;
+            }
+        }
+        gCMSTransformCache->RemoveElementAt(oldest);
+    }
+
+    CMSTransformCacheEntry* entry = gCMSTransformCache->AppendElement();
+    entry->mProfileData.AppendElements(aProfileData, aProfileLength);
+    entry->mInType = aInType;
+    entry->mIntent = aIntent;
+    entry->mLastUse = ++gCMSTransformCacheUseCount;
+    entry->mTransform = transform;
+
+    return transform.forget();
+}
+
 /* Shuts down various transforms and profiles for CMS. */
 static void ShutdownCMS()
 {
+    {
+        StaticMutexAutoLock lock(gCMSTransformCacheMutex);
+        delete gCMSTransformCache;
+        gCMSTransformCache = nullptr;
+    }
 
     if (gCMSRGBTransform) {
         qcms_transform_release(gCMSRGBTransform);
@@ -21,6 +21,7 @@
 #include "qcms.h"
 
 #include "mozilla/RefPtr.h"
+#include "nsISupportsImpl.h"
 #include "GfxInfoCollector.h"
 
 #include "mozilla/layers/CompositorTypes.h"
@@ -69,6 +70,31 @@ BackendTypeBit(BackendType b)
 
 extern cairo_user_data_key_t kDrawTarget;
 
+/**
+ * A reference counted qcms_transform, so that transforms for embedded ICC
+ * profiles can be shared between the decoders of images tagged with the
+ * same profile. See gfxPlatform::GetCMSTransformForProfile.
+ */
+class gfxCMSTransform final
+{
+public:
+    NS_INLINE_DECL_THREADSAFE_REFCOUNTING(gfxCMSTransform)
+
+    explicit gfxCMSTransform(qcms_transform* aTransform)
+      : mTransform(aTransform)
+    {}
+
+    qcms_transform* get() const { return mTransform; }
+
+private:
+    ~gfxCMSTransform()
+    {
+        qcms_transform_release(mTransform);
+    }
+
+    qcms_transform* mTransform;
+};
+
 // pref lang id's for font prefs
 // !!! needs to match the list of pref font.default.xx entries listed in all.js !!!
 // !!! don't use as bit mask, this may grow larger !!!
@@ -581,6 +607,20 @@ public:
      */
     static qcms_transform* GetCMSRGBATransform();
 
+    /**
+     * Return a transform from aInProfile to the output device, for data of
+     * type aInType. aProfileData is the raw ICC profile aInProfile was read
+     * from; images tagged with the same profile share one transform, so it
+     * isn't rebuilt for every image. Returns nullptr if no transform can be
+     * created. Can be called from any thread.
+     */
+    static already_AddRefed<gfxCMSTransform>
+    GetCMSTransformForProfile(const uint8_t* aProfileData,
+                              uint32_t aProfileLength,
+                              qcms_profile* aInProfile,
+                              qcms_data_type aInType,
+                              qcms_intent aIntent);
+
     virtual void FontsPrefsChanged(const char *aPref);
 
     int32_t GetBidiNumeralOption();
@@ -30,6 +30,7 @@
 #include <gdk/gdkx.h>
 #include "gfxXlibSurface.h"
 #include "cairo-xlib.h"
+#include "mozilla/Endian.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/X11Util.h"
 
@@ -78,7 +79,16 @@ gfxPlatformGtk::gfxPlatformGtk()
 
     uint32_t canvasMask = BackendTypeBit(BackendType::CAIRO) | BackendTypeBit(BackendType::SKIA);
     uint32_t contentMask = BackendTypeBit(BackendType::CAIRO) | BackendTypeBit(BackendType::SKIA);
-    InitBackendPrefs(canvasMask, BackendType::CAIRO,
+#if defined(USE_SKIA) && defined(MOZ_LITTLE_ENDIAN)
+    // Skia has much faster paths than cairo for what canvas does. Canvases
+    // Skia can't create fall back to cairo, see InitBackendPrefs. Content
+    // stays on cairo since the widget code paints through cairo surfaces.
+    BackendType canvasDefault = BackendType::SKIA;
+#else
+    // Our Skia pixel formats haven't been verified on big endian.
+    BackendType canvasDefault = BackendType::CAIRO;
+#endif
+    InitBackendPrefs(canvasMask, canvasDefault,
                      contentMask, BackendType::CAIRO);
 }
 
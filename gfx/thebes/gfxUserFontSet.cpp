@@ -228,6 +228,58 @@ private:
     nsTHashtable<nsCStringHashKey> mWarningsIssued;
 };
 
+struct WOFFHeader {
+    AutoSwap_PRUint32 signature;
+    AutoSwap_PRUint32 flavor;
+    AutoSwap_PRUint32 length;
+    AutoSwap_PRUint16 numTables;
+    AutoSwap_PRUint16 reserved;
+    AutoSwap_PRUint32 totalSfntSize;
+    AutoSwap_PRUint16 majorVersion;
+    AutoSwap_PRUint16 minorVersion;
+    AutoSwap_PRUint32 metaOffset;
+    AutoSwap_PRUint32 metaCompLen;
+    AutoSwap_PRUint32 metaOrigLen;
+    AutoSwap_PRUint32 privOffset;
+    AutoSwap_PRUint32 privLen;
+};
+
+struct WOFF2Header {
+    AutoSwap_PRUint32 signature;
+    AutoSwap_PRUint32 flavor;
+    AutoSwap_PRUint32 length;
+    AutoSwap_PRUint16 numTables;
+    AutoSwap_PRUint16 reserved;
+    AutoSwap_PRUint32 totalSfntSize;
+    AutoSwap_PRUint32 totalCompressedSize;
+    AutoSwap_PRUint16 majorVersion;
+    AutoSwap_PRUint16 minorVersion;
+    AutoSwap_PRUint32 metaOffset;
+    AutoSwap_PRUint32 metaCompLen;
+    AutoSwap_PRUint32 metaOrigLen;
+    AutoSwap_PRUint32 privOffset;
+    AutoSwap_PRUint32 privLen;
+};
+
+// Returns the decoded sfnt size declared in a WOFF/WOFF2 header, for use as
+// the sanitizer's initial buffer size, or 0 if the header is missing or the
+// declared size is implausible for the amount of data we actually have.
+template<typename HeaderT>
+static uint32_t
+DeclaredSfntSize(const uint8_t* aData, uint32_t aLength)
+{
+    if (aLength < sizeof(HeaderT)) {
+        return 0;
+    }
+    uint32_t size = reinterpret_cast<const HeaderT*>(aData)->totalSfntSize;
+    // Don't let a tiny (possibly hostile) file make us allocate a huge buffer
+    // up front; the output stream will still grow on demand if needed.
+    if (size < aLength || size / 8 > aLength) {
+        return 0;
+    }
+    return size;
+}
+
 // Call the OTS library to sanitize an sfnt before attempting to use it.
 // Returns a newly-allocated block, or nullptr in case of fatal errors.
 const uint8_t*
@@ -241,11 +293,20 @@ gfxUserFontEntry::SanitizeOpenTypeData(const uint8_t* aData,
         return nullptr;
     }
 
+    // Start with the decoded size the WOFF header declares, when it is sane,
+    // so that the output buffer doesn't have to be reallocated and copied as
+    // the sanitizer writes tables.
     uint32_t lengthHint = aLength;
     if (aFontType == GFX_USERFONT_WOFF) {
-        lengthHint *= 2;
+        lengthHint = DeclaredSfntSize<WOFFHeader>(aData, aLength);
+        if (!lengthHint) {
+            lengthHint = aLength * 2;
+        }
     } else if (aFontType == GFX_USERFONT_WOFF2) {
-        lengthHint *= 3;
+        lengthHint = DeclaredSfntSize<WOFF2Header>(aData, aLength);
+        if (!lengthHint) {
+            lengthHint = aLength * 3;
+        }
     }
 
     // limit output/expansion to 256MB
@@ -316,39 +377,6 @@ gfxUserFontEntry::GetFamilyNameAndURIForLogging(nsACString& aFamilyName,
   }
 }
 
-struct WOFFHeader {
-    AutoSwap_PRUint32 signature;
-    AutoSwap_PRUint32 flavor;
-    AutoSwap_PRUint32 length;
-    AutoSwap_PRUint16 numTables;
-    AutoSwap_PRUint16 reserved;
-    AutoSwap_PRUint32 totalSfntSize;
-    AutoSwap_PRUint16 majorVersion;
-    AutoSwap_PRUint16 minorVersion;
-    AutoSwap_PRUint32 metaOffset;
-    AutoSwap_PRUint32 metaCompLen;
-    AutoSwap_PRUint32 metaOrigLen;
-    AutoSwap_PRUint32 privOffset;
-    AutoSwap_PRUint32 privLen;
-};
-
-struct WOFF2Header {
-    AutoSwap_PRUint32 signature;
-    AutoSwap_PRUint32 flavor;
-    AutoSwap_PRUint32 length;
-    AutoSwap_PRUint16 numTables;
-    AutoSwap_PRUint16 reserved;
-    AutoSwap_PRUint32 totalSfntSize;
-    AutoSwap_PRUint32 totalCompressedSize;
-    AutoSwap_PRUint16 majorVersion;
-    AutoSwap_PRUint16 minorVersion;
-    AutoSwap_PRUint32 metaOffset;
-    AutoSwap_PRUint32 metaCompLen;
-    AutoSwap_PRUint32 metaOrigLen;
-    AutoSwap_PRUint32 privOffset;
-    AutoSwap_PRUint32 privLen;
-};
-
 template<typename HeaderT>
 void
 CopyWOFFMetadata(const uint8_t* aFontData,
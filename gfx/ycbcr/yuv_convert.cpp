@@ -20,8 +20,16 @@
 
 // Header for low level row functions.
 #include "yuv_row.h"
+#include "mozilla/Endian.h"
 #include "mozilla/SSE.h"
 
+// The VMX row functions store pixels in big endian order. Whether they are
+// used is decided at run time with Factory::HasVMX(), as in gfx/2d.
+#if defined(USE_VMX) && MOZ_BIG_ENDIAN
+#define MOZILLA_MAY_SUPPORT_VMX 1
+#include "mozilla/gfx/2D.h"
+#endif
+
 namespace mozilla {
 
 namespace gfx {
@@ -31,6 +39,15 @@ const int kFractionBits = 16;
 const int kFractionMax = 1 << kFractionBits;
 const int kFractionMask = ((1 << kFractionBits) - 1);
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+void FastConvertYUVToRGB32Row_VMX(const uint8* y_buf,
+                                  const uint8* u_buf,
+                                  const uint8* v_buf,
+                                  uint8* rgb_buf,
+                                  int width,
+                                  unsigned int x_shift);
+#endif
+
 NS_GFX_(YUVType) TypeFromSize(int ywidth, 
                               int yheight, 
                               int cbcrwidth, 
@@ -67,6 +84,9 @@ NS_GFX_(void) ConvertYCbCrToRGB32(const uint8* y_buf,
   // There is no optimized YV24 SSE routine so we check for this and
   // fall back to the C code.
   has_sse &= yuv_type != YV24;
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+  bool has_vmx = Factory::HasVMX();
+#endif
   bool odd_pic_x = yuv_type != YV24 && pic_x % 2 != 0;
   int x_width = odd_pic_x ? pic_width - 1 : pic_width;
 
@@ -88,6 +108,17 @@ NS_GFX_(void) ConvertYCbCrToRGB32(const uint8* y_buf,
       rgb_row += 4;
     }
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+    if (has_vmx) {
+      FastConvertYUVToRGB32Row_VMX(y_ptr,
+                                   u_ptr,
+                                   v_ptr,
+                                   rgb_row,
+                                   x_width,
+                                   x_shift);
+      continue;
+    }
+#endif
     if (has_sse) {
       FastConvertYUVToRGB32Row(y_ptr,
                                u_ptr,
@@ -141,9 +172,21 @@ void FilterRows_SSE2(uint8* ybuf, const uint8* y0_ptr, const uint8* y1_ptr,
                      int source_width, int source_y_fraction);
 #endif
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+void FilterRows_VMX(uint8* ybuf, const uint8* y0_ptr, const uint8* y1_ptr,
+                    int source_width, int source_y_fraction);
+#endif
+
 static inline void FilterRows(uint8* ybuf, const uint8* y0_ptr,
                               const uint8* y1_ptr, int source_width,
                               int source_y_fraction) {
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+  if (Factory::HasVMX()) {
+    FilterRows_VMX(ybuf, y0_ptr, y1_ptr, source_width, source_y_fraction);
+    return;
+  }
+#endif
+
 #ifdef MOZILLA_MAY_SUPPORT_SSE2
   if (mozilla::supports_sse2()) {
     FilterRows_SSE2(ybuf, y0_ptr, y1_ptr, source_width, source_y_fraction);
@@ -310,8 +353,16 @@ NS_GFX_(void) ScaleYCbCrToRGB32(const uint8* y_buf,
       vbuf[uv_source_width] = vbuf[uv_source_width - 1];
     }
     if (source_dx == kFractionMax) {  // Not scaled
-      FastConvertYUVToRGB32Row(y_ptr, u_ptr, v_ptr,
-                               dest_pixel, width);
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+      if (Factory::HasVMX()) {
+        FastConvertYUVToRGB32Row_VMX(y_ptr, u_ptr, v_ptr,
+                                     dest_pixel, width, 1);
+      } else
+#endif
+      {
+        FastConvertYUVToRGB32Row(y_ptr, u_ptr, v_ptr,
+                                 dest_pixel, width);
+      }
     } else if (filter & FILTER_BILINEAR_H) {
         LinearScaleYUVToRGB32Row(y_ptr, u_ptr, v_ptr,
                                  dest_pixel, width, source_dx);
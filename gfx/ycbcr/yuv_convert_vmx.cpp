@@ -0,0 +1,193 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <altivec.h>
+#include <string.h>
+#include "yuv_row.h"
+
+namespace mozilla {
+namespace gfx {
+
+// Loads 16 bytes from a possibly unaligned address. Like _mm_loadu_si128,
+// this may touch bytes up to 15 past aData, but never past the 16 byte block
+// holding aData + 15.
+static inline vector unsigned char LoadUnaligned(const uint8* aData)
+{
+  vector unsigned char first = vec_ld(0, aData);
+  vector unsigned char second = vec_ld(15, aData);
+  return vec_perm(first, second, vec_lvsl(0, aData));
+}
+
+static inline vector signed short Splat16(short aValue)
+{
+  union {
+    vector signed short v;
+    short s[8];
+  } splat;
+  for (int i = 0; i < 8; i++) {
+    splat.s[i] = aValue;
+  }
+  return splat.v;
+}
+
+// FilterRows combines two rows of the image using linear interpolation.
+// VMX version does 16 pixels at a time. Just like the SSE2 version it may
+// write up to 15 pixels past the end of ybuf, which must be 16 byte aligned.
+void FilterRows_VMX(uint8* ybuf, const uint8* y0_ptr, const uint8* y1_ptr,
+                    int source_width, int source_y_fraction) {
+  vector unsigned char zero = vec_splat_u8(0);
+  vector unsigned short y1_fraction =
+    (vector unsigned short)Splat16(source_y_fraction);
+  vector unsigned short y0_fraction =
+    (vector unsigned short)Splat16(256 - source_y_fraction);
+  vector unsigned short eight = vec_splat_u16(8);
+  vector unsigned short zero16 = vec_splat_u16(0);
+
+  uint8* end = ybuf + source_width;
+  do {
+    vector unsigned char y0 = LoadUnaligned(y0_ptr);
+    vector unsigned char y1 = LoadUnaligned(y1_ptr);
+
+    // y0 * (256 - fraction) + y1 * fraction can't exceed 255 * 256, so this
+    // doesn't overflow 16 bits.
+    vector unsigned short hi =
+      vec_mladd((vector unsigned short)vec_mergeh(zero, y0), y0_fraction,
+                vec_mladd((vector unsigned short)vec_mergeh(zero, y1),
+                          y1_fraction, zero16));
+    vector unsigned short lo =
+      vec_mladd((vector unsigned short)vec_mergel(zero, y0), y0_fraction,
+                vec_mladd((vector unsigned short)vec_mergel(zero, y1),
+                          y1_fraction, zero16));
+
+    vec_st(vec_pack(vec_sr(hi, eight), vec_sr(lo, eight)), 0, ybuf);
+    y0_ptr += 16;
+    y1_ptr += 16;
+    ybuf += 16;
+  } while (ybuf < end);
+}
+
+// Fixed point coefficients for vec_mradds, which computes
+// (a * b + 0x4000) >> 15. Luma is passed in as (y - 16) << 7 and chroma as
+// (c - 128) << 8, and the results are scaled by 64 like those in
+// kCoefficientsRgbY.
+static const short kLumaCoefficient = 19071;          // 1.164 * 64 * 256
+static const short kBlueFromUCoefficient = 16531;     // 2.018 * 64 * 128
+static const short kGreenFromUCoefficient = -3203;    // -0.391 * 64 * 128
+static const short kGreenFromVCoefficient = -6660;    // -0.813 * 64 * 128
+static const short kRedFromVCoefficient = 13074;      // 1.596 * 64 * 128
+
+// Converts 16 bytes of chroma to signed 16-bit (c - 128) << 8.
+static inline void UnpackChroma(vector unsigned char aChroma,
+                                vector signed short* aHigh,
+                                vector signed short* aLow)
+{
+  vector unsigned char zero = vec_splat_u8(0);
+  // Flipping the top bit of c << 8 is the same as subtracting 128 << 8.
+  vector signed short bias = Splat16(-32768);
+  *aHigh = vec_xor((vector signed short)vec_mergeh(aChroma, zero), bias);
+  *aLow = vec_xor((vector signed short)vec_mergel(aChroma, zero), bias);
+}
+
+// Converts eight pixels to one 16-bit value per channel.
+static inline void ConvertEightPixels(vector signed short aY,
+                                      vector signed short aU,
+                                      vector signed short aV,
+                                      vector signed short* aR,
+                                      vector signed short* aG,
+                                      vector signed short* aB)
+{
+  vector signed short zero = (vector signed short)vec_splat_u16(0);
+  vector unsigned short six = vec_splat_u16(6);
+
+  vector signed short y =
+    vec_mradds(vec_sl(vec_sub(aY, Splat16(16)), vec_splat_u16(7)),
+               Splat16(kLumaCoefficient), zero);
+
+  vector signed short b =
+    vec_mradds(aU, Splat16(kBlueFromUCoefficient), y);
+  vector signed short g =
+    vec_mradds(aU, Splat16(kGreenFromUCoefficient),
+               vec_mradds(aV, Splat16(kGreenFromVCoefficient), y));
+  vector signed short r =
+    vec_mradds(aV, Splat16(kRedFromVCoefficient), y);
+
+  *aB = vec_sra(b, six);
+  *aG = vec_sra(g, six);
+  *aR = vec_sra(r, six);
+}
+
+// Converts a row of pixels like FastConvertYUVToRGB32Row_C, 16 pixels at a
+// time. The output is stored as A, R, G, B, which is what the C version
+// produces on big endian machines.
+void FastConvertYUVToRGB32Row_VMX(const uint8* y_buf,
+                                  const uint8* u_buf,
+                                  const uint8* v_buf,
+                                  uint8* rgb_buf,
+                                  int width,
+                                  unsigned int x_shift) {
+  union {
+    vector unsigned char v;
+    uint8 b[16];
+  } y_in, u_in, v_in, out[4];
+
+  vector unsigned char zero = vec_splat_u8(0);
+  vector unsigned char alpha = (vector unsigned char)vec_splat_s8(-1);
+  int chroma_bytes = 16 >> x_shift;
+
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    // Copy the input so that we never read past the end of the planes.
+    memcpy(y_in.b, y_buf + x, 16);
+    memcpy(u_in.b, u_buf + (x >> x_shift), chroma_bytes);
+    memcpy(v_in.b, v_buf + (x >> x_shift), chroma_bytes);
+
+    vector unsigned char u = u_in.v;
+    vector unsigned char v = v_in.v;
+    if (x_shift) {
+      // Every chroma sample covers two pixels.
+      u = vec_mergeh(u, u);
+      v = vec_mergeh(v, v);
+    }
+
+    vector signed short u_hi, u_lo, v_hi, v_lo;
+    UnpackChroma(u, &u_hi, &u_lo);
+    UnpackChroma(v, &v_hi, &v_lo);
+
+    vector signed short r_hi, g_hi, b_hi, r_lo, g_lo, b_lo;
+    ConvertEightPixels((vector signed short)vec_mergeh(zero, y_in.v),
+                       u_hi, v_hi, &r_hi, &g_hi, &b_hi);
+    ConvertEightPixels((vector signed short)vec_mergel(zero, y_in.v),
+                       u_lo, v_lo, &r_lo, &g_lo, &b_lo);
+
+    vector unsigned char r = vec_packsu(r_hi, r_lo);
+    vector unsigned char g = vec_packsu(g_hi, g_lo);
+    vector unsigned char b = vec_packsu(b_hi, b_lo);
+
+    vector unsigned short ar_hi = (vector unsigned short)vec_mergeh(alpha, r);
+    vector unsigned short ar_lo = (vector unsigned short)vec_mergel(alpha, r);
+    vector unsigned short gb_hi = (vector unsigned short)vec_mergeh(g, b);
+    vector unsigned short gb_lo = (vector unsigned short)vec_mergel(g, b);
+
+    out[0].v = (vector unsigned char)vec_mergeh(ar_hi, gb_hi);
+    out[1].v = (vector unsigned char)vec_mergel(ar_hi, gb_hi);
+    out[2].v = (vector unsigned char)vec_mergeh(ar_lo, gb_lo);
+    out[3].v = (vector unsigned char)vec_mergel(ar_lo, gb_lo);
+    for (int i = 0; i < 4; i++) {
+      memcpy(rgb_buf + (x << 2) + (i << 4), out[i].b, 16);
+    }
+  }
+
+  if (x < width) {
+    FastConvertYUVToRGB32Row_C(y_buf + x,
+                               u_buf + (x >> x_shift),
+                               v_buf + (x >> x_shift),
+                               rgb_buf + (x << 2),
+                               width - x,
+                               x_shift);
+  }
+}
+
+} // namespace gfx
+} // namespace mozilla
@@ -204,6 +204,8 @@ public:
 
     if (aDecoder->IsMetadataDecode()) {
       mMetadataDecodeQueue.AppendElement(Move(decoder));
+    } else if (aDecoder->IsHighPriority()) {
+      mHighPriorityDecodeQueue.AppendElement(Move(decoder));
     } else {
       mFullDecodeQueue.AppendElement(Move(decoder));
     }
@@ -222,6 +224,11 @@ public:
         return PopWorkFromQueue(mMetadataDecodeQueue);
       }
 
+      // Then full decodes of images we expect to be visible right away.
+      if (!mHighPriorityDecodeQueue.IsEmpty()) {
+        return PopWorkFromQueue(mHighPriorityDecodeQueue);
+      }
+
       if (!mFullDecodeQueue.IsEmpty()) {
         return PopWorkFromQueue(mFullDecodeQueue);
       }
@@ -255,6 +262,7 @@ private:
   // mMonitor guards the queues and mShuttingDown.
   Monitor mMonitor;
   nsTArray<nsRefPtr<Decoder>> mMetadataDecodeQueue;
+  nsTArray<nsRefPtr<Decoder>> mHighPriorityDecodeQueue;
   nsTArray<nsRefPtr<Decoder>> mFullDecodeQueue;
   bool mShuttingDown;
 };
@@ -29,18 +29,27 @@ Decoder::Decoder(RasterImage* aImage)
   , mImage(aImage)
   , mProgress(NoProgress)
   , mFrameCount(0)
+  , mFirstFrameToStore(0)
+  , mFrameLimit(UINT32_MAX)
+  , mIgnoreFrameLimit(false)
+  , mAbortAtFrameLimit(false)
+  , mPaused(false)
+  , mPausedData(nullptr)
+  , mPausedDataLength(0)
   , mFailCode(NS_OK)
   , mChunkCount(0)
   , mFlags(0)
   , mBytesDecoded(0)
   , mInitialized(false)
   , mMetadataDecode(false)
+  , mHighPriority(false)
   , mSendPartialInvalidations(false)
   , mImageIsTransient(false)
   , mImageIsLocked(false)
   , mFirstFrameDecode(false)
   , mInFrame(false)
   , mIsAnimated(false)
+  , mRedecodingAnimation(false)
   , mDataDone(false)
   , mDecodeDone(false)
   , mDataError(false)
@@ -102,6 +111,29 @@ Decoder::Decode()
   // We keep decoding chunks until the decode completes or there are no more
   // chunks available.
   while (!GetDecodeDone() && !HasError()) {
+    if (mPausedDataLength > 0) {
+      // We paused partway through a chunk because we got far enough ahead of
+      // the animation. Once we're allowed to continue, write the rest of the
+      // chunk before moving on to the next one.
+      if (WaitForFrameLimit()) {
+        return NS_OK;
+      }
+
+      if (mAbortAtFrameLimit && ShouldPauseBeforeFrame(mFrameCount)) {
+        // Nobody wants the frames we'd decode next.
+        mDecodeAborted = true;
+        PostDecoderError(NS_ERROR_ABORT);
+        break;
+      }
+
+      const char* data = mPausedData;
+      uint32_t length = mPausedDataLength;
+      mPausedData = nullptr;
+      mPausedDataLength = 0;
+      Write(data, length);
+      continue;
+    }
+
     auto newState = mIterator->AdvanceOrScheduleResume(this);
 
     if (newState == SourceBufferIterator::WAITING) {
@@ -141,6 +173,62 @@ Decoder::Resume()
   decodePool->AsyncDecode(this);
 }
 
+void
+Decoder::SetFrameLimit(uint32_t aFrameLimit)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  mFrameLimit = aFrameLimit;
+  ResumeIfPaused();
+}
+
+void
+Decoder::FinishPastFrameLimit()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  mIgnoreFrameLimit = true;
+  ResumeIfPaused();
+}
+
+void
+Decoder::AbortAtFrameLimit()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  mAbortAtFrameLimit = true;
+  ResumeIfPaused();
+}
+
+void
+Decoder::ResumeIfPaused()
+{
+  // If the decoder stopped to wait for us, it's up to us to get it going again.
+  if (mPaused.compareExchange(true, false)) {
+    Resume();
+  }
+}
+
+bool
+Decoder::WaitForFrameLimit()
+{
+  if (!ShouldPauseBeforeFrame(mFrameCount) || mAbortAtFrameLimit) {
+    return false;
+  }
+
+  mPaused = true;
+
+  // We may have been told to carry on after we checked above. If so, whichever
+  // of us clears mPaused first gets to carry on decoding.
+  if ((!ShouldPauseBeforeFrame(mFrameCount) || mAbortAtFrameLimit) &&
+      mPaused.compareExchange(true, false)) {
+    return false;
+  }
+
+  if (mImage) {
+    mImage->OnDecoderPaused(this);
+  }
+
+  return true;
+}
+
 bool
 Decoder::ShouldSyncDecode(size_t aByteLimit)
 {
@@ -158,6 +246,7 @@ Decoder::Write(const char* aBuffer, uint32_t aCount)
 
   MOZ_ASSERT(aBuffer);
   MOZ_ASSERT(aCount > 0);
+  MOZ_ASSERT(mPausedDataLength == 0, "Should write paused data first");
 
   // We're strict about decoder errors
   MOZ_ASSERT(!HasDecoderError(),
@@ -183,6 +272,14 @@ Decoder::Write(const char* aBuffer, uint32_t aCount)
   // Pass the data along to the implementation.
   WriteInternal(aBuffer, aCount);
 
+  // If the implementation paused partway through, hang on to the rest of the
+  // data so we can write it again when we resume.
+  if (mPausedDataLength > 0) {
+    MOZ_ASSERT(mPausedDataLength <= aCount);
+    mPausedData = aBuffer + aCount - mPausedDataLength;
+    mBytesDecoded -= mPausedDataLength;
+  }
+
   // Finish telemetry.
   mDecodeTime += (TimeStamp::Now() - start);
 }
@@ -315,7 +412,13 @@ Decoder::AllocateFrameInternal(uint32_t aFrameNum,
     return RawAccessFrameRef();
   }
 
-  if (ShouldUseSurfaceCache()) {
+  // Frames outside the range we were asked to store are decoded just like any
+  // other frame, but nobody else gets to see them.
+  bool storeFrame = ShouldUseSurfaceCache() &&
+                    aFrameNum >= mFirstFrameToStore &&
+                    !(mIgnoreFrameLimit && aFrameNum >= mFrameLimit);
+
+  if (storeFrame) {
     InsertOutcome outcome =
       SurfaceCache::Insert(frame, ImageKey(mImage.get()),
                            RasterSurfaceKey(aTargetSize,
@@ -328,13 +431,18 @@ Decoder::AllocateFrameInternal(uint32_t aFrameNum,
       // we might just end up attempting to decode this image again immediately.
       ref->Abort();
       return RawAccessFrameRef();
-    } else if (outcome == InsertOutcome::FAILURE_ALREADY_PRESENT) {
+    } else if (outcome == InsertOutcome::FAILURE_ALREADY_PRESENT &&
+               !mRedecodingAnimation) {
       // Another decoder beat us to decoding this frame. We abort this decoder
       // rather than treat this as a real error.
       mDecodeAborted = true;
       ref->Abort();
       return RawAccessFrameRef();
     }
+
+    // If we're decoding the frames of a windowed animation again, the frames
+    // we still have can stay where they are. We just decode into our own copy
+    // and move on.
   }
 
   nsIntRect refreshArea;
@@ -379,6 +487,14 @@ void Decoder::InitInternal() { }
 void Decoder::FinishInternal() { }
 void Decoder::FinishWithErrorInternal() { }
 
+void
+Decoder::PostPause(uint32_t aUnconsumedBytes)
+{
+  MOZ_ASSERT(aUnconsumedBytes > 0, "Nothing to write when we resume?");
+  MOZ_ASSERT(!mInFrame, "Pausing in the middle of a frame");
+  mPausedDataLength = aUnconsumedBytes;
+}
+
 /*
  * Progress Notifications
  */
@@ -8,6 +8,7 @@
 
 #include "FrameAnimator.h"
 #include "RasterImage.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/RefPtr.h"
 #include "DecodePool.h"
 #include "ImageMetadata.h"
@@ -103,6 +104,14 @@ public:
   }
   bool IsMetadataDecode() const { return mMetadataDecode; }
 
+  /**
+   * A high priority decode is run by the DecodePool ahead of other full
+   * decodes. Used for images which are likely to be visible as soon as the
+   * page is laid out. Must be called before the decoder is launched.
+   */
+  void SetHighPriority(bool aHighPriority) { mHighPriority = aHighPriority; }
+  bool IsHighPriority() const { return mHighPriority; }
+
   /**
    * If this decoder supports downscale-during-decode, sets the target size that
    * this image should be decoded to.
@@ -206,6 +215,48 @@ public:
 
   bool IsFirstFrameDecode() const { return mFirstFrameDecode; }
 
+  /**
+   * Set the first frame this decoder should store in the SurfaceCache. Earlier
+   * frames are still decoded, since we can't get to the frames after them
+   * otherwise, but they're thrown away. Used to decode the frames of a large
+   * animation again after they've been discarded; frames such a decoder finds
+   * already stored in the SurfaceCache are left alone rather than aborting
+   * the decode.
+   *
+   * This must be called before Init() is called.
+   */
+  void SetFirstFrameToStore(uint32_t aFrameNum)
+  {
+    MOZ_ASSERT(!mInitialized, "Shouldn't be initialized yet");
+    mFirstFrameToStore = aFrameNum;
+    mRedecodingAnimation = true;
+  }
+
+  /**
+   * Pause before decoding frame @aFrameLimit until the limit is raised by
+   * another call. Used to decode large animations only a few frames ahead of
+   * the frame being displayed. Decoders which can't pause ignore the limit.
+   *
+   * Main thread only. May be called at any time.
+   */
+  void SetFrameLimit(uint32_t aFrameLimit);
+
+  /**
+   * Stop honoring the frame limit and decode the rest of the image without
+   * pausing. Frames past the limit are decoded but not stored.
+   *
+   * Main thread only.
+   */
+  void FinishPastFrameLimit();
+
+  /**
+   * Stop decoding, rather than pausing, when the frame limit is reached. The
+   * decode is aborted; only frames decoded before the limit are kept.
+   *
+   * Main thread only.
+   */
+  void AbortAtFrameLimit();
+
   size_t BytesDecoded() const { return mBytesDecoded; }
 
   // The amount of time we've spent inside Write() so far for this decoder.
@@ -322,6 +373,24 @@ protected:
   virtual void FinishInternal();
   virtual void FinishWithErrorInternal();
 
+  /**
+   * Returns true if decoders which support pausing should stop before they
+   * start frame @aFrameNum. To pause, they stop consuming data and call
+   * PostPause() before returning from WriteInternal().
+   */
+  bool ShouldPauseBeforeFrame(uint32_t aFrameNum) const
+  {
+    return aFrameNum >= mFrameLimit && !mIgnoreFrameLimit;
+  }
+
+  /**
+   * Called by decoders which pause in WriteInternal() because
+   * ShouldPauseBeforeFrame() returned true. @aUnconsumedBytes is the number of
+   * bytes at the end of the buffer which weren't consumed; they'll be written
+   * again when decoding resumes.
+   */
+  void PostPause(uint32_t aUnconsumedBytes);
+
   /*
    * Progress notifications.
    */
@@ -429,6 +498,15 @@ protected:
   uint32_t mColormapSize;
 
 private:
+  /**
+   * Returns true if we've reached our frame limit and should stop decoding
+   * until SetFrameLimit(), FinishPastFrameLimit() or AbortAtFrameLimit()
+   * resumes us.
+   */
+  bool WaitForFrameLimit();
+
+  void ResumeIfPaused();
+
   nsRefPtr<RasterImage> mImage;
   Maybe<SourceBufferIterator> mIterator;
   RawAccessFrameRef mCurrentFrame;
@@ -437,6 +515,16 @@ private:
   Progress mProgress;
 
   uint32_t mFrameCount; // Number of frames, including anything in-progress
+  uint32_t mFirstFrameToStore;
+
+  // Pausing at the frame limit. The data left over from the Write() call in
+  // which we paused is written again when we resume.
+  Atomic<uint32_t> mFrameLimit;
+  Atomic<bool> mIgnoreFrameLimit;
+  Atomic<bool> mAbortAtFrameLimit;
+  Atomic<bool> mPaused;
+  const char* mPausedData;
+  uint32_t mPausedDataLength;
 
   nsresult mFailCode;
 
@@ -449,12 +537,14 @@ private:
 
   bool mInitialized : 1;
   bool mMetadataDecode : 1;
+  bool mHighPriority : 1;
   bool mSendPartialInvalidations : 1;
   bool mImageIsTransient : 1;
   bool mImageIsLocked : 1;
   bool mFirstFrameDecode : 1;
   bool mInFrame : 1;
   bool mIsAnimated : 1;
+  bool mRedecodingAnimation : 1;
   bool mDataDone : 1;
   bool mDecodeDone : 1;
   bool mDataError : 1;
@@ -103,6 +103,26 @@ public:
                         int aSampleSize,
                         const gfx::IntSize& aResolution);
 
+  /**
+   * Creates and initializes a decoder which decodes the frames of the animated
+   * image @aImage again, after some of them have been discarded. Frames before
+   * @aFirstFrame are decoded but not stored. The caller is expected to give the
+   * decoder a frame limit using Decoder::SetFrameLimit().
+   *
+   * @param aType Which type of decoder to create - JPEG, PNG, etc.
+   * @param aImage The image will own the decoder and which should receive
+   *               notifications as decoding progresses.
+   * @param aSourceBuffer The SourceBuffer which the decoder will read its data
+   *                      from.
+   * @param aFirstFrame The first frame the decoder should store in the
+   *                    SurfaceCache.
+   */
+  static already_AddRefed<Decoder>
+  CreateAnimationDecoder(DecoderType aType,
+                         RasterImage* aImage,
+                         SourceBuffer* aSourceBuffer,
+                         uint32_t aFirstFrame);
+
   static already_AddRefed<Decoder>
   CreateAnonymousDecoder(DecoderType aType,
                          SourceBuffer* aSourceBuffer,
@@ -83,6 +83,10 @@ void
 DynamicImage::OnSurfaceDiscarded()
 { }
 
+void
+DynamicImage::RequestPriorityDecode(const nsIntSize& aSize)
+{ }
+
 void
 DynamicImage::SetInnerWindowID(uint64_t aInnerWindowId)
 { }
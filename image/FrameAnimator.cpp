@@ -33,6 +33,12 @@ FrameAnimator::GetSingleLoopTime() const
     return -1;
   }
 
+  // If we're only keeping a window of frames, we don't have all the timeouts,
+  // and skipping ahead would mean decoding frames we never display anyway.
+  if (mImage->IsAnimationWindowed()) {
+    return -1;
+  }
+
   uint32_t looptime = 0;
   for (uint32_t i = 0; i < mImage->GetNumFrames(); ++i) {
     int32_t timeout = GetTimeoutForFrame(i);
@@ -93,6 +99,16 @@ FrameAnimator::AdvanceFrame(TimeStamp aTime)
   bool canDisplay = mDoneDecoding ||
                     (nextFrame && nextFrame->IsImageComplete());
 
+  // If we're only keeping a window of frames around, the next frame may not
+  // have been decoded yet, or may have been discarded after we displayed it
+  // on an earlier loop. Ask for it and wait.
+  if (mImage->IsAnimationWindowed() &&
+      nextFrameIndex < mImage->GetNumFrames() &&
+      !(nextFrame && nextFrame->IsImageComplete())) {
+    mImage->RequestAnimationFrames(nextFrameIndex);
+    canDisplay = false;
+  }
+
   if (!canDisplay) {
     // Uh oh, the frame we want to show is currently being decoded (partial)
     // Wait until the next refresh driver tick and try again
@@ -178,6 +194,19 @@ FrameAnimator::AdvanceFrame(TimeStamp aTime)
   // Set currentAnimationFrameIndex at the last possible moment
   mCurrentAnimationFrameIndex = nextFrameIndex;
 
+  // If we're only keeping a window of frames around, we're done with the frame
+  // we were displaying until the next loop, unless it's the first frame, which
+  // we always keep. Make sure the decoder stays ahead of us.
+  if (mImage->IsAnimationWindowed()) {
+    if (currentFrameIndex != 0) {
+      SurfaceCache::RemoveSurface(ImageKey(mImage),
+                                  RasterSurfaceKey(mSize,
+                                                   0,  // Default decode flags.
+                                                   currentFrameIndex));
+    }
+    mImage->RequestAnimationFrames(nextFrameIndex + 1);
+  }
+
   // If we're here, we successfully advanced the frame.
   ret.frameAdvanced = true;
 
@@ -219,6 +219,17 @@ public:
    */
   virtual void OnSurfaceDiscarded() = 0;
 
+  /**
+   * Like RequestDecode(), but the decode is run ahead of other full decodes.
+   * Used for images we expect to be visible as soon as the page is laid out.
+   *
+   * @param aSize A guess at the size, in device pixels, the image will be
+   *              drawn at. Images which support downscale-during-decode are
+   *              decoded at this size if it is smaller than their intrinsic
+   *              size. May be empty if there is no guess.
+   */
+  virtual void RequestPriorityDecode(const nsIntSize& aSize) = 0;
+
   virtual void SetInnerWindowID(uint64_t aInnerWindowId) = 0;
   virtual uint64_t InnerWindowID() const = 0;
 
@@ -259,6 +270,11 @@ public:
 
   virtual void OnSurfaceDiscarded() override { }
 
+  virtual void RequestPriorityDecode(const nsIntSize& aSize) override
+  {
+    RequestDecode();
+  }
+
   virtual void SetInnerWindowID(uint64_t aInnerWindowId) override
   {
     mInnerWindowId = aInnerWindowId;
@@ -37,7 +37,9 @@ ShouldDownscaleDuringDecode(const nsCString& aMimeType)
 {
   return aMimeType.EqualsLiteral(IMAGE_JPEG) ||
          aMimeType.EqualsLiteral(IMAGE_JPG) ||
-         aMimeType.EqualsLiteral(IMAGE_PJPEG);
+         aMimeType.EqualsLiteral(IMAGE_PJPEG) ||
+         aMimeType.EqualsLiteral(IMAGE_PNG) ||
+         aMimeType.EqualsLiteral(IMAGE_X_PNG);
 }
 
 static uint32_t
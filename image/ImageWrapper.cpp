@@ -91,6 +91,12 @@ ImageWrapper::OnSurfaceDiscarded()
   return mInnerImage->OnSurfaceDiscarded();
 }
 
+void
+ImageWrapper::RequestPriorityDecode(const nsIntSize& aSize)
+{
+  mInnerImage->RequestPriorityDecode(aSize);
+}
+
 void
 ImageWrapper::SetInnerWindowID(uint64_t aInnerWindowId)
 {
@@ -47,6 +47,8 @@ public:
 
   virtual void OnSurfaceDiscarded() override;
 
+  virtual void RequestPriorityDecode(const nsIntSize& aSize) override;
+
   virtual void SetInnerWindowID(uint64_t aInnerWindowId) override;
   virtual uint64_t InnerWindowID() const override;
 
@@ -227,6 +227,7 @@ RasterImage::RasterImage(ImageURL* aURI /* = nullptr */) :
 #endif
   mSourceBuffer(new SourceBuffer()),
   mFrameCount(0),
+  mAnimationDecoderFrame(0),
   mHasSize(false),
   mTransient(false),
   mSyncLoad(false),
@@ -236,7 +237,9 @@ RasterImage::RasterImage(ImageURL* aURI /* = nullptr */) :
   mDownscaleDuringDecode(false),
   mPendingAnimation(false),
   mAnimationFinished(false),
-  mWantFullDecode(false)
+  mWantFullDecode(false),
+  mHighPriorityDecode(false),
+  mAnimationWindowed(false)
 {
   Telemetry::GetHistogramById(Telemetry::IMAGE_DECODE_COUNT)->Add(0);
 }
@@ -949,7 +952,154 @@ RasterImage::OnAddedFrame(uint32_t aNewFrameCount,
     if (aNewFrameCount > 1) {
       mAnim->UnionFirstFrameRefreshArea(aNewRefreshArea);
     }
+
+    // Once we have more frames than fit in the window, we're not keeping all
+    // of them anymore.
+    uint32_t window = AnimationFrameWindow();
+    if (window > 0 && aNewFrameCount > window) {
+      mAnimationWindowed = true;
+    }
+  }
+}
+
+class OnDecoderPausedRunnable : public nsRunnable
+{
+public:
+  OnDecoderPausedRunnable(RasterImage* aImage, Decoder* aDecoder)
+    : mImage(aImage)
+    , mDecoder(aDecoder)
+  {
+    MOZ_ASSERT(aImage);
+    MOZ_ASSERT(aDecoder);
+  }
+
+  NS_IMETHOD Run()
+  {
+    mImage->OnDecoderPaused(mDecoder);
+    return NS_OK;
+  }
+
+private:
+  nsRefPtr<RasterImage> mImage;
+  nsRefPtr<Decoder> mDecoder;
+};
+
+void
+RasterImage::OnDecoderPaused(Decoder* aDecoder)
+{
+  if (!NS_IsMainThread()) {
+    nsCOMPtr<nsIRunnable> runnable =
+      new OnDecoderPausedRunnable(this, aDecoder);
+    NS_DispatchToMainThread(runnable);
+    return;
+  }
+
+  // The decoder only pauses once it has a full window of frames, and there are
+  // more to come.
+  mAnimationWindowed = true;
+
+  // If nothing is going to ask for more frames, don't leave the decoder
+  // paused, or it'll keep itself and the image alive forever.
+  if (aDecoder == mAnimationDecoder && (mError || !mAnimating)) {
+    DropAnimationDecoder();
+  }
+}
+
+void
+RasterImage::DropAnimationDecoder()
+{
+  if (!mAnimationDecoder) {
+    return;
+  }
+
+  // The first decode has to run to the end so that we know how many frames we
+  // have, but it doesn't need to store any more of them. Later decodes only
+  // produce frames we've seen before, so they can just stop.
+  if (mHasBeenDecoded) {
+    mAnimationDecoder->AbortAtFrameLimit();
+  } else {
+    mAnimationDecoder->FinishPastFrameLimit();
+  }
+
+  mAnimationDecoder = nullptr;
+}
+
+bool
+RasterImage::HasAnimationFrame(uint32_t aFrameNum)
+{
+  LookupResult result =
+    SurfaceCache::Lookup(ImageKey(this),
+                         RasterSurfaceKey(mSize, DECODE_FLAGS_DEFAULT,
+                                          aFrameNum));
+  return bool(result);
+}
+
+uint32_t
+RasterImage::AnimationFrameWindow() const
+{
+  // Only the GIF and PNG decoders know how to pause.
+  if (mDecoderType != DecoderType::GIF && mDecoderType != DecoderType::PNG) {
+    return 0;
+  }
+
+  uint64_t frameBytes = uint64_t(mSize.width) * mSize.height * 4;
+  uint64_t maxBytes = uint64_t(gfxPrefs::ImageAnimatedDecodeAheadMaxKB()) * 1024;
+  if (frameBytes == 0 || maxBytes == 0) {
+    return 0;
+  }
+
+  // Always keep enough frames around to hide the latency of the decoder.
+  const uint64_t kMinFrames = 4;
+  const uint64_t kMaxFrames = 1 << 16;
+  return uint32_t(std::min(std::max(maxBytes / frameBytes, kMinFrames),
+                           kMaxFrames));
+}
+
+void
+RasterImage::RequestAnimationFrames(uint32_t aFrameNum)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(mAnimationWindowed, "Should only need this for windowed images");
+
+  uint32_t window = AnimationFrameWindow();
+  if (mError || window == 0) {
+    return;
+  }
+
+  uint32_t frameLimit = aFrameNum + window;
+
+  // If we've looped around, the decoder is past the frames we want now.
+  if (mAnimationDecoder && aFrameNum < mAnimationDecoderFrame) {
+    DropAnimationDecoder();
   }
+
+  if (mAnimationDecoder) {
+    mAnimationDecoderFrame = aFrameNum;
+    mAnimationDecoder->SetFrameLimit(frameLimit);
+    return;
+  }
+
+  // Frames are stored in order as they're decoded and discarded in order as
+  // they're displayed, so if the first and last frames we want are there, so
+  // is everything in between.
+  uint32_t lastFrame = std::min(frameLimit, mFrameCount);
+  if (aFrameNum >= lastFrame ||
+      (HasAnimationFrame(aFrameNum) && HasAnimationFrame(lastFrame - 1))) {
+    return;
+  }
+
+  // The frames we need were discarded, or never stored. Decode them again.
+  nsRefPtr<Decoder> decoder =
+    DecoderFactory::CreateAnimationDecoder(mDecoderType, this, mSourceBuffer,
+                                           aFrameNum);
+  if (!decoder) {
+    return;
+  }
+
+  decoder->SetFrameLimit(frameLimit);
+  mAnimationDecoder = decoder;
+  mAnimationDecoderFrame = aFrameNum;
+  DecodePool::Singleton()->AsyncDecode(decoder);
 }
 
 nsresult
@@ -1039,6 +1189,9 @@ RasterImage::StopAnimation()
     mAnim->SetAnimationFrameTime(TimeStamp());
   }
 
+  // Nobody will ask for more frames, so don't leave the decoder paused.
+  DropAnimationDecoder();
+
   mAnimating = false;
   return rv;
 }
@@ -1067,6 +1220,16 @@ RasterImage::ResetAnimation()
   MOZ_ASSERT(mAnim, "Should have a FrameAnimator");
   mAnim->ResetAnimation();
 
+  // If we're windowed, the frames we were keeping around won't be needed for
+  // a while. The first frame is always kept.
+  if (mAnimationWindowed) {
+    for (uint32_t i = 1; i < mFrameCount; ++i) {
+      SurfaceCache::RemoveSurface(ImageKey(this),
+                                  RasterSurfaceKey(mSize,
+                                                   DECODE_FLAGS_DEFAULT, i));
+    }
+  }
+
   NotifyProgress(NoProgress, mAnim->GetFirstFrameRefreshArea());
 
   // Start the animation again. It may not have been running before, if
@@ -1335,6 +1498,32 @@ RasterImage::RequestDecodeForSize(const IntSize& aSize, uint32_t aFlags)
   return NS_OK;
 }
 
+void
+RasterImage::RequestPriorityDecode(const IntSize& aSize)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  mHighPriorityDecode = true;
+  mPriorityDecodeSize = aSize;
+
+  RequestDecodeForSize(PriorityDecodeSize(), DECODE_FLAGS_DEFAULT);
+}
+
+IntSize
+RasterImage::PriorityDecodeSize() const
+{
+  // The size is only a guess, so don't bother with it unless we'd actually
+  // downscale, and fall back to our intrinsic size when we have nothing better.
+  if (!mHasSize || !mDownscaleDuringDecode ||
+      mPriorityDecodeSize.width <= 0 || mPriorityDecodeSize.height <= 0 ||
+      mPriorityDecodeSize.width > mSize.width ||
+      mPriorityDecodeSize.height > mSize.height) {
+    return mSize;
+  }
+
+  return mPriorityDecodeSize;
+}
+
 static void
 LaunchDecoder(Decoder* aDecoder,
               RasterImage* aImage,
@@ -1417,6 +1606,10 @@ RasterImage::Decode(const IntSize& aSize, uint32_t aFlags)
     return NS_ERROR_FAILURE;
   }
 
+  if (mHighPriorityDecode && !mHasBeenDecoded) {
+    decoder->SetHighPriority(true);
+  }
+
   // Add a placeholder for the first frame to the SurfaceCache so we won't
   // trigger any more decoders with the same parameters.
   InsertOutcome outcome =
@@ -1428,6 +1621,19 @@ RasterImage::Decode(const IntSize& aSize, uint32_t aFlags)
     return NS_ERROR_FAILURE;
   }
 
+  // If this turns out to be a large animation, only decode a window of frames
+  // ahead of the animation. FrameAnimator only uses frames decoded at our
+  // intrinsic size with the default flags. Once a full decode has finished
+  // without producing a second frame, we know the image isn't animated, so
+  // there's no point.
+  uint32_t window = AnimationFrameWindow();
+  if (window > 0 && (mAnim || !mHasBeenDecoded) && !mAnimationDecoder &&
+      !targetSize && decoder->GetDecodeFlags() == DECODE_FLAGS_DEFAULT) {
+    decoder->SetFrameLimit(window);
+    mAnimationDecoder = decoder;
+    mAnimationDecoderFrame = 0;
+  }
+
   // Report telemetry.
   Telemetry::GetHistogramById(Telemetry::IMAGE_DECODE_COUNT)
     ->Subtract(mDecodeCount);
@@ -1948,6 +2154,10 @@ RasterImage::FinalizeDecoder(Decoder* aDecoder)
   MOZ_ASSERT(aDecoder->HasError() || !aDecoder->InFrame(),
              "Finalizing a decoder in the middle of a frame");
 
+  if (aDecoder == mAnimationDecoder) {
+    mAnimationDecoder = nullptr;
+  }
+
   // If the decoder detected an error, log it to the error console.
   if (aDecoder->ShouldReportError() && !aDecoder->WasAborted()) {
     ReportDecoderError(aDecoder);
@@ -2031,7 +2241,11 @@ RasterImage::FinalizeDecoder(Decoder* aDecoder)
   // If we were a metadata decode and a full decode was requested, do it.
   if (done && wasMetadata && mWantFullDecode) {
     mWantFullDecode = false;
-    RequestDecode();
+    if (mHighPriorityDecode) {
+      RequestDecodeForSize(PriorityDecodeSize(), DECODE_FLAGS_DEFAULT);
+    } else {
+      RequestDecode();
+    }
   }
 }
 
@@ -169,6 +169,7 @@ public:
 
   // Methods inherited from Image
   virtual void OnSurfaceDiscarded() override;
+  virtual void RequestPriorityDecode(const nsIntSize& aSize) override;
 
   /* The total number of frames in this image. */
   uint32_t GetNumFrames() const { return mFrameCount; }
@@ -188,6 +189,13 @@ public:
 
   void OnAddedFrame(uint32_t aNewFrameCount, const nsIntRect& aNewRefreshArea);
 
+  /**
+   * Called by a decoder which stopped because it reached its frame limit.
+   * If we aren't animating, the decoder is told to finish without storing any
+   * more frames, so that it doesn't stay paused indefinitely.
+   */
+  void OnDecoderPaused(Decoder* aDecoder);
+
   /** Sets the size and inherent orientation of the container. This should only
    * be called by the decoder. This function may be called multiple times, but
    * will throw an error if subsequent calls do not match the first.
@@ -227,6 +235,30 @@ public:
   void ReportDecoderError(Decoder* aDecoder);
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Decoding animations ahead.
+  //////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * Returns true if this animation is too large to keep all of its frames
+   * around, so that frames are only decoded a few at a time ahead of the one
+   * being displayed and are discarded again once they've been displayed.
+   * The first frame is always kept.
+   *
+   * Main-thread only.
+   */
+  bool IsAnimationWindowed() const { return mAnimationWindowed; }
+
+  /**
+   * Makes sure that frame @aFrameNum and the ones after it are being decoded,
+   * up to the size of the frame window. Used by FrameAnimator when the image
+   * is windowed.
+   *
+   * Main-thread only.
+   */
+  void RequestAnimationFrames(uint32_t aFrameNum);
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Network callbacks.
   //////////////////////////////////////////////////////////////////////////////
@@ -397,6 +429,16 @@ private: // data
   // The number of frames this image has.
   uint32_t                   mFrameCount;
 
+  // If this image is windowed, the decoder which is decoding frames ahead of
+  // the animation, if any. It pauses when it gets far enough ahead.
+  nsRefPtr<Decoder>          mAnimationDecoder;
+
+  // The first frame we last asked mAnimationDecoder for.
+  uint32_t                   mAnimationDecoderFrame;
+
+  // The size passed to RequestPriorityDecode(), if any.
+  IntSize                    mPriorityDecodeSize;
+
   // Boolean flags (clustered together to conserve space):
   bool                       mHasSize:1;       // Has SetSize() been called?
   bool                       mTransient:1;     // Is the image short-lived?
@@ -419,6 +461,14 @@ private: // data
   // kick off a full decode.
   bool                       mWantFullDecode:1;
 
+  // Whether RequestPriorityDecode() was called. Our decoders are high priority
+  // until we've been decoded once.
+  bool                       mHighPriorityDecode:1;
+
+  // Whether we're only keeping a window of this animation's frames decoded.
+  // See IsAnimationWindowed().
+  bool                       mAnimationWindowed:1;
+
   TimeStamp mDrawStartTime;
 
 
@@ -437,6 +487,25 @@ private: // data
   // parameters.
   bool CanDownscaleDuringDecode(const nsIntSize& aSize, uint32_t aFlags);
 
+  /// Returns the size to decode at for RequestPriorityDecode().
+  IntSize PriorityDecodeSize() const;
+
+  /**
+   * Returns how many frames of this image we keep decoded ahead of the one
+   * being displayed, based on the image.animated.decode-ahead.max-kb pref, or
+   * 0 if we keep all of them.
+   */
+  uint32_t AnimationFrameWindow() const;
+
+  /// Returns true if frame @aFrameNum of this animation is in the SurfaceCache.
+  bool HasAnimationFrame(uint32_t aFrameNum);
+
+  /**
+   * Tells mAnimationDecoder that no more frames will be requested from it, and
+   * forgets about it.
+   */
+  void DropAnimationDecoder();
+
   // Called by the HQ scaler when a new scaled frame is ready.
   void NotifyNewScaledFrame();
 
@@ -28,6 +28,7 @@
 #include "Image.h"
 #include "LookupResult.h"
 #include "nsAutoPtr.h"
+#include "nsClassHashtable.h"
 #include "nsExpirationTracker.h"
 #include "nsHashKeys.h"
 #include "nsRefPtrHashtable.h"
@@ -138,6 +139,7 @@ public:
     : mSurface(aSurface)
     , mCost(aCost)
     , mImageKey(aImageKey)
+    , mInnerWindowId(static_cast<Image*>(aImageKey)->InnerWindowID())
     , mSurfaceKey(aSurfaceKey)
     , mLifetime(aLifetime)
   {
@@ -177,6 +179,7 @@ public:
   bool IsLocked() const { return bool(mDrawableRef); }
 
   ImageKey GetImageKey() const { return mImageKey; }
+  uint64_t GetInnerWindowId() const { return mInnerWindowId; }
   SurfaceKey GetSurfaceKey() const { return mSurfaceKey; }
   CostEntry GetCostEntry() { return image::CostEntry(this, mCost); }
   nsExpirationState* GetExpirationState() { return &mExpirationState; }
@@ -230,6 +233,7 @@ private:
   DrawableFrameRef   mDrawableRef;
   const Cost         mCost;
   const ImageKey     mImageKey;
+  const uint64_t     mInnerWindowId;
   const SurfaceKey   mSurfaceKey;
   const Lifetime     mLifetime;
 };
@@ -423,6 +427,59 @@ private:
   bool         mLocked;
 };
 
+/**
+ * WindowCosts tracks the cost of the surfaces belonging to the images of a
+ * single window. We use this to keep one image-heavy document from pushing the
+ * surfaces of every other document out of the cache. Images which don't belong
+ * to a window are all tracked under window ID 0.
+ */
+class WindowCosts
+{
+public:
+  WindowCosts() : mLockedCost(0), mUnlockedCost(0) { }
+
+  void StartTracking(const CostEntry& aCostEntry, bool aLocked)
+  {
+    if (aLocked) {
+      mLockedCost += aCostEntry.GetCost();
+    } else {
+      mUnlockedCost += aCostEntry.GetCost();
+      mCosts.InsertElementSorted(aCostEntry);
+    }
+  }
+
+  void StopTracking(const CostEntry& aCostEntry, bool aLocked)
+  {
+    if (aLocked) {
+      MOZ_ASSERT(mLockedCost >= aCostEntry.GetCost(), "Costs don't balance");
+      mLockedCost -= aCostEntry.GetCost();
+    } else {
+      MOZ_ASSERT(mUnlockedCost >= aCostEntry.GetCost(), "Costs don't balance");
+      mUnlockedCost -= aCostEntry.GetCost();
+      DebugOnly<bool> foundInCosts = mCosts.RemoveElementSorted(aCostEntry);
+      MOZ_ASSERT(foundInCosts, "Lost track of costs for this surface");
+    }
+  }
+
+  bool IsEmpty() const { return mLockedCost == 0 && mUnlockedCost == 0; }
+  Cost TotalCost() const { return mLockedCost + mUnlockedCost; }
+
+  // Documents lock their images while they're being displayed, so a window
+  // without any locked surfaces is most likely in a background tab.
+  bool IsHidden() const { return mLockedCost == 0; }
+
+  /// @return the entry for the most costly unlocked surface, if any.
+  const CostEntry* CostliestUnlockedEntry() const
+  {
+    return mCosts.IsEmpty() ? nullptr : &mCosts.LastElement();
+  }
+
+private:
+  nsTArray<CostEntry> mCosts;  // Only unlocked surfaces, which we can evict.
+  Cost                mLockedCost;
+  Cost                mUnlockedCost;
+};
+
 /**
  * SurfaceCacheImpl is responsible for determining which surfaces will be cached
  * and managing the surface cache data structures. Rather than interact with
@@ -437,12 +494,14 @@ public:
 
   SurfaceCacheImpl(uint32_t aSurfaceCacheExpirationTimeMS,
                    uint32_t aSurfaceCacheDiscardFactor,
-                   uint32_t aSurfaceCacheSize)
+                   uint32_t aSurfaceCacheSize,
+                   uint32_t aSurfaceCacheWindowSize)
     : mExpirationTracker(aSurfaceCacheExpirationTimeMS)
     , mMemoryPressureObserver(new MemoryPressureObserver)
     , mMutex("SurfaceCache")
     , mDiscardFactor(aSurfaceCacheDiscardFactor)
     , mMaxCost(aSurfaceCacheSize)
+    , mMaxWindowCost(aSurfaceCacheWindowSize)
     , mAvailableCost(aSurfaceCacheSize)
     , mLockedCost(0)
   {
@@ -496,12 +555,13 @@ public:
       return InsertOutcome::FAILURE;
     }
 
-    // Remove elements in order of cost until we can fit this in the cache. Note
-    // that locked surfaces aren't in mCosts, so we never remove them here.
+    // Remove elements until we can fit this in the cache. Note that locked
+    // surfaces aren't in mCosts, so we never remove them here.
+    const uint64_t windowId = static_cast<Image*>(aImageKey)->InnerWindowID();
     while (aCost > mAvailableCost) {
       MOZ_ASSERT(!mCosts.IsEmpty(),
                  "Removed everything and it still won't fit");
-      Remove(mCosts.LastElement().GetSurface());
+      Remove(SurfaceToEvict(windowId, aCost));
     }
 
     // Locate the appropriate per-image cache. If there's not an existing cache
@@ -563,6 +623,8 @@ public:
                "Cost too large and the caller didn't catch it");
 
     mAvailableCost -= costEntry.GetCost();
+    mWindowCosts.LookupOrAdd(aSurface->GetInnerWindowId())
+      ->StartTracking(costEntry, aSurface->IsLocked());
 
     if (aSurface->IsLocked()) {
       mLockedCost += costEntry.GetCost();
@@ -580,6 +642,16 @@ public:
     MOZ_ASSERT(aSurface, "Should have a surface");
     CostEntry costEntry = aSurface->GetCostEntry();
 
+    WindowCosts* windowCosts = nullptr;
+    if (mWindowCosts.Get(aSurface->GetInnerWindowId(), &windowCosts)) {
+      windowCosts->StopTracking(costEntry, aSurface->IsLocked());
+      if (windowCosts->IsEmpty()) {
+        mWindowCosts.Remove(aSurface->GetInnerWindowId());
+      }
+    } else {
+      MOZ_ASSERT_UNREACHABLE("Lost track of costs for this surface's window");
+    }
+
     if (aSurface->IsLocked()) {
       MOZ_ASSERT(mLockedCost >= costEntry.GetCost(), "Costs don't balance");
       mLockedCost -= costEntry.GetCost();
@@ -806,10 +878,12 @@ public:
       return;
     }
 
-    // Discard surfaces until we've reduced our cost to our target cost.
+    // Discard surfaces until we've reduced our cost to our target cost. The
+    // surfaces of documents that aren't being displayed go first.
     while (mAvailableCost < targetCost) {
       MOZ_ASSERT(!mCosts.IsEmpty(), "Removed everything and still not done");
-      Remove(mCosts.LastElement().GetSurface());
+      Remove(SurfaceToEvict(/* aInsertingWindowId = */ 0,
+                            /* aInsertingCost = */ 0));
     }
   }
 
@@ -923,6 +997,58 @@ private:
     return aCost <= mMaxCost - mLockedCost;
   }
 
+  /**
+   * Chooses the next unlocked surface to evict. In order of preference, that's
+   * the costliest surface of the window we're inserting a surface for, if that
+   * would take the window over its share of the cache; the costliest surface of
+   * a window that isn't being displayed; and the costliest surface overall.
+   * Images which don't belong to a window don't have a share to stay within.
+   *
+   * Pass an @aInsertingCost of 0 if we're not evicting to make room for a new
+   * surface.
+   */
+  CachedSurface* SurfaceToEvict(const uint64_t aInsertingWindowId,
+                                const Cost aInsertingCost)
+  {
+    MOZ_ASSERT(!mCosts.IsEmpty(), "Nothing to evict");
+
+    WindowCosts* windowCosts = nullptr;
+    if (aInsertingCost > 0 && aInsertingWindowId != 0 &&
+        mWindowCosts.Get(aInsertingWindowId, &windowCosts) &&
+        windowCosts->TotalCost() + aInsertingCost > mMaxWindowCost) {
+      const CostEntry* entry = windowCosts->CostliestUnlockedEntry();
+      if (entry) {
+        return entry->GetSurface();
+      }
+    }
+
+    const CostEntry* hiddenEntry = nullptr;
+    mWindowCosts.EnumerateRead(FindCostliestHiddenEntry, &hiddenEntry);
+    if (hiddenEntry) {
+      return hiddenEntry->GetSurface();
+    }
+
+    return mCosts.LastElement().GetSurface();
+  }
+
+  static PLDHashOperator FindCostliestHiddenEntry(const uint64_t& aWindowId,
+                                                  WindowCosts* aWindowCosts,
+                                                  void*        aBestEntry)
+  {
+    // Without a window we can't tell whether an image is being displayed.
+    if (aWindowId == 0 || !aWindowCosts->IsHidden()) {
+      return PL_DHASH_NEXT;
+    }
+
+    auto bestEntry = static_cast<const CostEntry**>(aBestEntry);
+    const CostEntry* entry = aWindowCosts->CostliestUnlockedEntry();
+    if (entry && (!*bestEntry || **bestEntry < *entry)) {
+      *bestEntry = entry;
+    }
+
+    return PL_DHASH_NEXT;
+  }
+
   void MarkUsed(CachedSurface* aSurface, ImageSurfaceCache* aCache)
   {
     if (aCache->IsLocked()) {
@@ -970,11 +1096,14 @@ private:
   nsTArray<CostEntry>                     mCosts;
   nsRefPtrHashtable<nsPtrHashKey<Image>,
     ImageSurfaceCache> mImageCaches;
+  nsClassHashtable<nsUint64HashKey,
+    WindowCosts>       mWindowCosts;
   SurfaceTracker                          mExpirationTracker;
   nsRefPtr<MemoryPressureObserver>        mMemoryPressureObserver;
   Mutex                                   mMutex;
   const uint32_t                          mDiscardFactor;
   const Cost                              mMaxCost;
+  const Cost                              mMaxWindowCost;
   Cost                                    mAvailableCost;
   Cost                                    mLockedCost;
 };
@@ -1033,12 +1162,22 @@ SurfaceCache::Initialize()
   uint32_t finalSurfaceCacheSizeBytes =
     min(surfaceCacheSizeBytes, uint64_t(UINT32_MAX));
 
+  // The percentage of the surface cache that the images of a single window can
+  // use before we start evicting their own surfaces, rather than those of other
+  // windows, to make room for new ones. 100 disables this.
+  uint32_t surfaceCacheWindowShare =
+    min(gfxPrefs::ImageMemSurfaceCacheWindowShare(), 100u);
+  uint32_t surfaceCacheWindowSizeBytes =
+    uint32_t(uint64_t(finalSurfaceCacheSizeBytes) *
+             surfaceCacheWindowShare / 100);
+
   // Create the surface cache singleton with the requested settings.  Note that
   // the size is a limit that the cache may not grow beyond, but we do not
   // actually allocate any storage for surfaces at this time.
   sInstance = new SurfaceCacheImpl(surfaceCacheExpirationTimeMS,
                                    surfaceCacheDiscardFactor,
-                                   finalSurfaceCacheSizeBytes);
+                                   finalSurfaceCacheSizeBytes,
+                                   surfaceCacheWindowSizeBytes);
   sInstance->InitMemoryReporter();
 }
 
@@ -908,6 +908,16 @@ nsGIFDecoder2::WriteInternal(const char* aBuffer, uint32_t aCount)
         break;
       }
 
+      // If we're far enough ahead of the animation, stop here until more
+      // frames are needed. We can only hand back data that's still in the
+      // caller's buffer, so if the header came through the hold we go on.
+      if (ShouldPauseBeforeFrame(mGIFStruct.images_decoded) &&
+          q >= (const uint8_t*)aBuffer &&
+          q < (const uint8_t*)aBuffer + aCount) {
+        PostPause(uint32_t((const uint8_t*)aBuffer + aCount - q));
+        return;
+      }
+
       // Get image offsets, with respect to the screen origin
       mGIFStruct.x_offset = GETINT16(q);
       mGIFStruct.y_offset = GETINT16(q + 2);
@@ -57,7 +57,8 @@ GetJPEGDecoderAccountingLog()
 }
 
 static qcms_profile*
-GetICCProfile(struct jpeg_decompress_struct& info)
+GetICCProfile(struct jpeg_decompress_struct& info,
+              nsTArray<uint8_t>& aProfileData)
 {
   JOCTET* profilebuf;
   uint32_t profileLength;
@@ -65,6 +66,10 @@ GetICCProfile(struct jpeg_decompress_struct& info)
 
   if (read_icc_profile(&info, &profilebuf, &profileLength)) {
     profile = qcms_profile_from_memory(profilebuf, profileLength);
+    if (profile) {
+      // Keep the raw profile, it's the key for sharing the transform.
+      aProfileData.AppendElements(profilebuf, profileLength);
+    }
     free(profilebuf);
   }
 
@@ -86,6 +91,7 @@ nsJPEGDecoder::nsJPEGDecoder(RasterImage* aImage,
  : Decoder(aImage)
  , mDecodeStyle(aDecodeStyle)
  , mSampleSize(0)
+ , mDCTScaleDenom(1)
 {
   mState = JPEG_HEADER;
   mReading = true;
@@ -119,9 +125,6 @@ nsJPEGDecoder::~nsJPEGDecoder()
   jpeg_destroy_decompress(&mInfo);
 
   PR_FREEIF(mBackBuffer);
-  if (mTransform) {
-    qcms_transform_release(mTransform);
-  }
   if (mInProfile) {
     qcms_profile_release(mInProfile);
   }
@@ -273,9 +276,16 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount)
         return;
       }
 
+      // If we're downscaling during decode, let libjpeg do as much of the
+      // scaling as it can while decoding.
+      if (mDownscaler && mSampleSize == 0) {
+        ChooseDCTScale();
+      }
+
       // We're doing a full decode.
+      nsTArray<uint8_t> profileData;
       if (mCMSMode != eCMSMode_Off &&
-          (mInProfile = GetICCProfile(mInfo)) != nullptr) {
+          (mInProfile = GetICCProfile(mInfo, profileData)) != nullptr) {
         uint32_t profileSpace = qcms_profile_get_color_space(mInProfile);
         bool mismatch = false;
 
@@ -351,12 +361,14 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount)
             intent = qcms_profile_get_rendering_intent(mInProfile);
           }
 
-          // Create the color management transform.
-          mTransform = qcms_transform_create(mInProfile,
-                                          type,
-                                          gfxPlatform::GetCMSOutputProfile(),
-                                          QCMS_DATA_RGB_8,
-                                          (qcms_intent)intent);
+          // Get the color management transform, shared with other images
+          // tagged with the same profile.
+          mTransform =
+            gfxPlatform::GetCMSTransformForProfile(profileData.Elements(),
+                                                   profileData.Length(),
+                                                   mInProfile,
+                                                   type,
+                                                   (qcms_intent)intent);
         }
       } else {
 #ifdef DEBUG_tor
@@ -400,7 +412,8 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount)
                            jpeg_has_multiple_scans(&mInfo);
 
     MOZ_ASSERT(!mImageData, "Already have a buffer allocated?");
-    nsIntSize targetSize = mDownscaler ? mDownscaler->TargetSize() : GetSize();
+    nsIntSize outputSize(mInfo.output_width, mInfo.output_height);
+    nsIntSize targetSize = mDownscaler ? mDownscaler->TargetSize() : outputSize;
     nsresult rv = AllocateFrame(0, targetSize,
                                 nsIntRect(nsIntPoint(), targetSize),
                                 gfx::SurfaceFormat::B8G8R8A8);
@@ -414,7 +427,7 @@ nsJPEGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount)
     MOZ_ASSERT(mImageData, "Should have a buffer now");
 
     if (mDownscaler) {
-      nsresult rv = mDownscaler->BeginFrame(GetSize(),
+      nsresult rv = mDownscaler->BeginFrame(outputSize,
                                             mImageData,
                                             /* aHasAlpha = */ false);
       if (NS_FAILED(rv)) {
@@ -610,6 +623,42 @@ nsJPEGDecoder::ReadOrientationFromEXIF()
   return exif.orientation;
 }
 
+void
+nsJPEGDecoder::ChooseDCTScale()
+{
+  MOZ_ASSERT(mDownscaler);
+
+  // libjpeg can scale by 1/2, 1/4 and 1/8 in the DCT domain, which skips most
+  // of the IDCT and color conversion work for the pixels we'd throw away. Pick
+  // the largest factor that still leaves the output at least as large as the
+  // target size, and leave the rest of the scaling to the downscaler.
+  const nsIntSize targetSize = mDownscaler->TargetSize();
+  const uint32_t width = mInfo.image_width;
+  const uint32_t height = mInfo.image_height;
+
+  uint32_t denom = 8;
+  while (denom > 1 &&
+         ((width + denom - 1) / denom < uint32_t(targetSize.width) ||
+          (height + denom - 1) / denom < uint32_t(targetSize.height))) {
+    denom /= 2;
+  }
+
+  if (denom == 1) {
+    return;
+  }
+
+  mInfo.scale_num = 1;
+  mInfo.scale_denom = denom;
+  jpeg_calc_output_dimensions(&mInfo);
+  mDCTScaleDenom = denom;
+
+  // If libjpeg produces exactly the size we want, we don't need to filter its
+  // output at all.
+  if (nsIntSize(mInfo.output_width, mInfo.output_height) == targetSize) {
+    mDownscaler.reset();
+  }
+}
+
 void
 nsJPEGDecoder::NotifyDone()
 {
@@ -666,7 +715,8 @@ nsJPEGDecoder::OutputScanlines(bool* suspend)
           // to the 3byte RGB byte pixels at 'end' of row
           sampleRow += mInfo.output_width;
         }
-        qcms_transform_data(mTransform, source, sampleRow, mInfo.output_width);
+        qcms_transform_data(mTransform->get(), source, sampleRow,
+                            mInfo.output_width);
         // Move 3byte RGB data to end of row
         if (mInfo.out_color_space == JCS_CMYK) {
           memmove(sampleRow + mInfo.output_width,
@@ -726,11 +776,25 @@ nsJPEGDecoder::OutputScanlines(bool* suspend)
   }
 
   if (top != mInfo.output_scanline) {
-    PostInvalidation(nsIntRect(0, top,
-                               mInfo.output_width,
-                               mInfo.output_scanline - top),
-                     mDownscaler ? Some(mDownscaler->TakeInvalidRect())
-                                 : Nothing());
+    nsIntRect outputRect(0, top, mInfo.output_width,
+                         mInfo.output_scanline - top);
+    Maybe<nsIntRect> targetRect;
+    if (mDownscaler) {
+      targetRect = Some(mDownscaler->TakeInvalidRect());
+    } else if (mDCTScaleDenom > 1) {
+      targetRect = Some(outputRect);
+    }
+
+    // The invalidation in image space covers every row libjpeg's DCT scaling
+    // folded into the rows we just produced.
+    nsIntRect imageRect = outputRect;
+    if (mDCTScaleDenom > 1) {
+      imageRect = nsIntRect(0, top * mDCTScaleDenom, GetSize().width,
+                            (mInfo.output_scanline - top) * mDCTScaleDenom);
+      imageRect.IntersectRect(imageRect, nsIntRect(nsIntPoint(), GetSize()));
+    }
+
+    PostInvalidation(imageRect, targetRect);
   }
 
   MOZ_ASSERT(!mDownscaler || !mDownscaler->HasInvalidation(),
@@ -28,6 +28,8 @@ extern "C" {
 
 #include <setjmp.h>
 
+class gfxCMSTransform;
+
 namespace mozilla {
 namespace image {
 
@@ -72,6 +74,7 @@ public:
 protected:
   Orientation ReadOrientationFromEXIF();
   void OutputScanlines(bool* suspend);
+  void ChooseDCTScale();
 
   Maybe<Downscaler> mDownscaler;
 
@@ -101,7 +104,7 @@ public:
   uint32_t mProfileLength;
 
   qcms_profile* mInProfile;
-  qcms_transform* mTransform;
+  nsRefPtr<gfxCMSTransform> mTransform;
 
   bool mReading;
 
@@ -110,6 +113,10 @@ public:
   uint32_t mCMSMode;
 
   int mSampleSize;
+
+  // The factor libjpeg scales the image down by in the DCT domain when we're
+  // downscaling during decode. 1 if it doesn't scale at all.
+  uint32_t mDCTScaleDenom;
 };
 
 } // namespace image
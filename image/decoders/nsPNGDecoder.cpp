@@ -59,6 +59,9 @@ GetPNGDecoderAccountingLog()
 #define HEIGHT_OFFSET (WIDTH_OFFSET + 4)
 #define BYTES_NEEDED_FOR_DIMENSIONS (HEIGHT_OFFSET + 4)
 
+// Adam7 interlacing has seven passes, the last one fills in the odd rows.
+static const int kLastInterlacePass = 6;
+
 nsPNGDecoder::AnimFrameInfo::AnimFrameInfo()
  : mDispose(DisposalMethod::KEEP)
  , mBlend(BlendMethod::OVER)
@@ -123,6 +126,7 @@ nsPNGDecoder::nsPNGDecoder(RasterImage* aImage)
    mChannels(0), mFrameIsHidden(false),
    mDisablePremultipliedAlpha(false),
    mSuccessfulEarlyFinish(false),
+   mResumeSavedData(false),
    mNumFrames(0)
 {
 }
@@ -175,13 +179,24 @@ nsPNGDecoder::CreateFrame(png_uint_32 aXOffset, png_uint_32 aYOffset,
     format = gfx::SurfaceFormat::B8G8R8A8;
   }
 
-  nsresult rv = AllocateFrame(mNumFrames, GetSize(), frameRect, format);
+  nsIntSize targetSize = mDownscaler ? mDownscaler->TargetSize() : GetSize();
+  nsIntRect targetFrameRect = mDownscaler ? nsIntRect(nsIntPoint(), targetSize)
+                                          : frameRect;
+  nsresult rv = AllocateFrame(mNumFrames, targetSize, targetFrameRect, format);
   if (NS_FAILED(rv)) {
     return rv;
   }
 
   mFrameRect = frameRect;
 
+  if (mDownscaler) {
+    rv = mDownscaler->BeginFrame(frameRect.Size(), mImageData,
+                                 aFormat == gfx::SurfaceFormat::B8G8R8A8);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+  }
+
   MOZ_LOG(GetPNGDecoderAccountingLog(), LogLevel::Debug,
          ("PNGDecoderAccounting: nsPNGDecoder::CreateFrame -- created "
           "image frame with %dx%d pixels for decoder %p",
@@ -206,7 +221,8 @@ nsPNGDecoder::CreateFrame(png_uint_32 aXOffset, png_uint_32 aYOffset,
 void
 nsPNGDecoder::EndImageFrame()
 {
-  if (mFrameIsHidden) {
+  // If we're not in a frame, frame_end_callback already finished it.
+  if (mFrameIsHidden || !InFrame()) {
     return;
   }
 
@@ -230,6 +246,20 @@ nsPNGDecoder::EndImageFrame()
                 mAnimInfo.mBlend);
 }
 
+nsresult
+nsPNGDecoder::SetTargetSize(const nsIntSize& aSize)
+{
+  // Make sure the size is reasonable.
+  if (MOZ_UNLIKELY(aSize.width <= 0 || aSize.height <= 0)) {
+    return NS_ERROR_FAILURE;
+  }
+
+  // Create a downscaler that we'll filter our output through.
+  mDownscaler.emplace(aSize);
+
+  return NS_OK;
+}
+
 void
 nsPNGDecoder::InitInternal()
 {
@@ -403,6 +433,13 @@ nsPNGDecoder::WriteInternal(const char* aBuffer, uint32_t aCount)
     // Pass the data off to libpng
     png_process_data(mPNG, mInfo, (unsigned char*)aBuffer, aCount);
 
+    // If frame_end_callback paused libpng while it was working through data
+    // from its own buffer, let it carry on.
+    while (mResumeSavedData) {
+      mResumeSavedData = false;
+      png_process_data(mPNG, mInfo, nullptr, 0);
+    }
+
   }
 }
 
@@ -669,7 +706,12 @@ nsPNGDecoder::info_callback(png_structp png_ptr, png_infop info_ptr)
 #ifdef PNG_APNG_SUPPORTED
   if (png_get_valid(png_ptr, info_ptr, PNG_INFO_acTL)) {
     png_set_progressive_frame_fn(png_ptr, nsPNGDecoder::frame_info_callback,
-                                 nullptr);
+                                 nsPNGDecoder::frame_end_callback);
+
+    // We don't downscale animated images during decode, and frames after the
+    // first may not cover the whole image. RasterImage can ask for it before
+    // it knows the image is animated, so decode at full size instead.
+    decoder->mDownscaler.reset();
   }
 
   if (png_get_first_frame_is_hidden(png_ptr, info_ptr)) {
@@ -748,7 +790,20 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
     return;
   }
 
-  if (new_row) {
+  // The downscaler needs every row exactly once, from top to bottom. For
+  // interlaced images we collect the earlier passes in interlacebuf and feed
+  // it all rows of the last pass, including the ones that didn't change.
+  bool downscaleInterlaced = decoder->mDownscaler && decoder->interlacebuf;
+  if (downscaleInterlaced && pass != kLastInterlacePass) {
+    if (new_row) {
+      png_bytep line = decoder->interlacebuf +
+                       (row_num * decoder->mChannels * decoder->mFrameRect.width);
+      png_progressive_combine_row(png_ptr, line, new_row);
+    }
+    return;
+  }
+
+  if (new_row || downscaleInterlaced) {
     int32_t width = decoder->mFrameRect.width;
     uint32_t iwidth = decoder->mFrameRect.width;
 
@@ -759,7 +814,9 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
     }
 
     uint32_t bpr = width * sizeof(uint32_t);
-    uint32_t* cptr32 = (uint32_t*)(decoder->mImageData + (row_num*bpr));
+    uint32_t* cptr32 = decoder->mDownscaler
+      ? reinterpret_cast<uint32_t*>(decoder->mDownscaler->RowBuffer())
+      : (uint32_t*)(decoder->mImageData + (row_num*bpr));
 
     if (decoder->mTransform) {
       if (decoder->mCMSLine) {
@@ -823,11 +880,19 @@ nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
         png_longjmp(decoder->mPNG, 1);
     }
 
+    if (decoder->mDownscaler) {
+      decoder->mDownscaler->CommitRow();
+    }
+
     if (decoder->mNumFrames <= 1) {
       // Only do incremental image display for the first frame
       // XXXbholley - this check should be handled in the superclass
       nsIntRect r(0, row_num, width, 1);
-      decoder->PostInvalidation(r);
+      if (!decoder->mDownscaler) {
+        decoder->PostInvalidation(r);
+      } else if (decoder->mDownscaler->HasInvalidation()) {
+        decoder->PostInvalidation(r, Some(decoder->mDownscaler->TakeInvalidRect()));
+      }
     }
   }
 }
@@ -878,6 +943,32 @@ nsPNGDecoder::frame_info_callback(png_structp png_ptr, png_uint_32 frame_num)
   }
   MOZ_ASSERT(decoder->mImageData, "Should have a buffer now");
 }
+
+// got all the data for the current frame
+void
+nsPNGDecoder::frame_end_callback(png_structp png_ptr, png_uint_32 frame_num)
+{
+  nsPNGDecoder* decoder =
+               static_cast<nsPNGDecoder*>(png_get_progressive_ptr(png_ptr));
+
+  // If we're far enough ahead of the animation, stop here until more frames
+  // are needed. Finish the frame first, so it can be displayed.
+  if (decoder->mFrameIsHidden ||
+      !decoder->ShouldPauseBeforeFrame(decoder->GetFrameCount())) {
+    return;
+  }
+
+  decoder->EndImageFrame();
+
+  png_size_t unconsumed = png_process_data_pause(png_ptr, /* save = */ 0);
+  if (unconsumed > 0) {
+    decoder->PostPause(unconsumed);
+  } else {
+    // Everything that's left is in libpng's own buffer, which we can't hand
+    // back to be written again later, so don't pause after all.
+    decoder->mResumeSavedData = true;
+  }
+}
 #endif
 
 void
@@ -15,6 +15,8 @@
 
 #include "png.h"
 
+#include "Downscaler.h"
+
 #include "qcms.h"
 
 namespace mozilla {
@@ -26,6 +28,7 @@ class nsPNGDecoder : public Decoder
 public:
   virtual ~nsPNGDecoder();
 
+  virtual nsresult SetTargetSize(const nsIntSize& aSize) override;
   virtual void InitInternal() override;
   virtual void WriteInternal(const char* aBuffer, uint32_t aCount) override;
   virtual Telemetry::ID SpeedHistogram() override;
@@ -78,6 +81,7 @@ public:
   png_structp mPNG;
   png_infop mInfo;
   nsIntRect mFrameRect;
+  Maybe<Downscaler> mDownscaler;
   uint8_t* mCMSLine;
   uint8_t* interlacebuf;
   qcms_profile* mInProfile;
@@ -97,6 +101,10 @@ public:
   bool mDisablePremultipliedAlpha;
   bool mSuccessfulEarlyFinish;
 
+  // Whether libpng was paused while it was working on data it had buffered
+  // itself, which we have to let it finish.
+  bool mResumeSavedData;
+
   struct AnimFrameInfo
   {
     AnimFrameInfo();
@@ -122,6 +130,8 @@ public:
 #ifdef PNG_APNG_SUPPORTED
   static void PNGAPI frame_info_callback(png_structp png_ptr,
                                          png_uint_32 frame_num);
+  static void PNGAPI frame_end_callback(png_structp png_ptr,
+                                        png_uint_32 frame_num);
 #endif
   static void PNGAPI end_callback(png_structp png_ptr, png_infop info_ptr);
   static void PNGAPI error_callback(png_structp png_ptr,
@@ -41,6 +41,7 @@
 
 using namespace mozilla;
 using namespace mozilla::image;
+using mozilla::gfx::IntSize;
 
 PRLogModuleInfo*
 GetImgLog()
@@ -75,6 +76,7 @@ imgRequest::imgRequest(imgLoader* aLoader, const ImageCacheKey& aCacheKey)
  , mGotData(false)
  , mIsInCache(false)
  , mDecodeRequested(false)
+ , mPriorityDecodeRequested(false)
  , mNewPartPending(false)
  , mHadInsecureRedirect(false)
 { }
@@ -418,6 +420,25 @@ imgRequest::IsDecodeRequested() const
   return mDecodeRequested;
 }
 
+void
+imgRequest::RequestPriorityDecode(const IntSize& aSize)
+{
+  MutexAutoLock lock(mMutex);
+  mDecodeRequested = true;
+  mPriorityDecodeRequested = true;
+  mPriorityDecodeSize = aSize;
+}
+
+bool
+imgRequest::IsPriorityDecodeRequested(IntSize* aSize) const
+{
+  MOZ_ASSERT(aSize);
+
+  MutexAutoLock lock(mMutex);
+  *aSize = mPriorityDecodeSize;
+  return mPriorityDecodeRequested;
+}
+
 nsresult imgRequest::GetURI(ImageURL** aURI)
 {
   MOZ_ASSERT(aURI);
@@ -1052,7 +1073,10 @@ imgRequest::FinishPreparingForNewPart(const NewPartResult& aResult)
     ResetCacheEntry();
   }
 
-  if (IsDecodeRequested()) {
+  IntSize priorityDecodeSize;
+  if (IsPriorityDecodeRequested(&priorityDecodeSize)) {
+    aResult.mImage->RequestPriorityDecode(priorityDecodeSize);
+  } else if (IsDecodeRequested()) {
     aResult.mImage->RequestDecode();
   }
 }
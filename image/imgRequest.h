@@ -20,6 +20,7 @@
 #include "nsError.h"
 #include "nsIAsyncVerifyRedirectCallback.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/gfx/Point.h"
 #include "mozilla/net/ReferrerPolicy.h"
 #include "ImageCacheKey.h"
 
@@ -98,6 +99,11 @@ public:
   // Request that we start decoding the image as soon as data becomes available.
   void RequestDecode();
 
+  // Like RequestDecode(), but the decode is given priority over other image
+  // decodes. @aSize is a guess at the size the image will be drawn at. See
+  // Image::RequestPriorityDecode().
+  void RequestPriorityDecode(const mozilla::gfx::IntSize& aSize);
+
   inline uint64_t InnerWindowID() const {
     return mInnerWindowId;
   }
@@ -224,6 +230,10 @@ private:
   /// Returns true if RequestDecode() was called.
   bool IsDecodeRequested() const;
 
+  /// Returns true if RequestPriorityDecode() was called, and the size it was
+  /// given in @aSize.
+  bool IsPriorityDecodeRequested(mozilla::gfx::IntSize* aSize) const;
+
   // Weak reference to parent loader; this request cannot outlive its owner.
   imgLoader* mLoader;
   nsCOMPtr<nsIRequest> mRequest;
@@ -279,10 +289,12 @@ private:
   // must not be a part of this bitfield.
   nsRefPtr<ProgressTracker> mProgressTracker;
   nsRefPtr<Image> mImage;
+  mozilla::gfx::IntSize mPriorityDecodeSize;
   bool mIsMultiPartChannel : 1;
   bool mGotData : 1;
   bool mIsInCache : 1;
   bool mDecodeRequested : 1;
+  bool mPriorityDecodeRequested : 1;
   bool mNewPartPending : 1;
   bool mHadInsecureRedirect : 1;
 };
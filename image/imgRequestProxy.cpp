@@ -15,6 +15,7 @@
 #include "imgINotificationObserver.h"
 
 using namespace mozilla::image;
+using mozilla::gfx::IntSize;
 
 // The split of imgRequestProxy and imgRequestProxyStatic means that
 // certain overridden functions need to be usable in the destructor.
@@ -409,6 +410,23 @@ imgRequestProxy::RequestDecode()
   return NS_OK;
 }
 
+void
+imgRequestProxy::RequestPriorityDecode(const IntSize& aSize)
+{
+  // Flag this, so we know to transfer the request if our owner changes
+  mDecodeRequested = true;
+
+  nsRefPtr<Image> image = GetImage();
+  if (image) {
+    image->RequestPriorityDecode(aSize);
+    return;
+  }
+
+  if (GetOwner()) {
+    GetOwner()->RequestPriorityDecode(aSize);
+  }
+}
+
 
 NS_IMETHODIMP
 imgRequestProxy::LockImage()
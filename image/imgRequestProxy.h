@@ -131,6 +131,10 @@ public:
 
   nsresult GetURI(ImageURL** aURI);
 
+  // Like RequestDecode(), but asks for the decode to run ahead of other image
+  // decodes, at @aSize if possible. See Image::RequestPriorityDecode().
+  void RequestPriorityDecode(const mozilla::gfx::IntSize& aSize);
+
 protected:
   friend class mozilla::image::ProgressTracker;
   friend class imgStatusNotifyRunnable;
@@ -0,0 +1,250 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+
+#include "Common.h"
+#include "Decoder.h"
+#include "DecoderFactory.h"
+#include "DecodePool.h"
+#include "imgIContainer.h"
+#include "imgITools.h"
+#include "ImageFactory.h"
+#include "ProgressTracker.h"
+#include "RasterImage.h"
+#include "SourceBuffer.h"
+#include "SurfaceCache.h"
+#include "nsComponentManagerUtils.h"
+#include "nsCOMPtr.h"
+#include "nsIInputStream.h"
+#include "mozilla/nsRefPtr.h"
+#include "nsString.h"
+#include "nsThreadUtils.h"
+
+using namespace mozilla;
+using namespace mozilla::gfx;
+using namespace mozilla::image;
+
+
+TEST(ImageDecoderFrameLimit, ImageModuleAvailable)
+{
+  // We can run into problems if XPCOM modules get initialized in the wrong
+  // order. It's important that this test run first, both as a sanity check and
+  // to ensure we get the module initialization order we want.
+  nsCOMPtr<imgITools> imgTools =
+    do_CreateInstance("@mozilla.org/image/tools;1");
+  EXPECT_TRUE(imgTools != nullptr);
+}
+
+static already_AddRefed<SourceBuffer>
+LoadSourceBuffer(const ImageTestCase& aTestCase)
+{
+  nsCOMPtr<nsIInputStream> inputStream = LoadFile(aTestCase.mPath);
+  EXPECT_TRUE(inputStream != nullptr);
+  if (!inputStream) {
+    return nullptr;
+  }
+
+  uint64_t length;
+  nsresult rv = inputStream->Available(&length);
+  EXPECT_TRUE(NS_SUCCEEDED(rv));
+  if (NS_FAILED(rv)) {
+    return nullptr;
+  }
+
+  nsRefPtr<SourceBuffer> sourceBuffer = new SourceBuffer();
+  sourceBuffer->ExpectLength(length);
+  rv = sourceBuffer->AppendFromInputStream(inputStream, length);
+  EXPECT_TRUE(NS_SUCCEEDED(rv));
+  sourceBuffer->Complete(NS_OK);
+
+  return sourceBuffer.forget();
+}
+
+static already_AddRefed<RasterImage>
+CreateImage(const ImageTestCase& aTestCase)
+{
+  nsRefPtr<Image> image =
+    ImageFactory::CreateAnonymousImage(nsAutoCString(aTestCase.mMimeType));
+  EXPECT_TRUE(image != nullptr);
+  EXPECT_FALSE(image->HasError());
+  if (!image || image->HasError()) {
+    return nullptr;
+  }
+
+  nsRefPtr<RasterImage> rasterImage = static_cast<RasterImage*>(image.get());
+  return rasterImage.forget();
+}
+
+static already_AddRefed<Decoder>
+CreateDecoder(const ImageTestCase& aTestCase,
+              RasterImage* aImage,
+              SourceBuffer* aSourceBuffer)
+{
+  DecoderType type =
+    DecoderFactory::GetDecoderType(aTestCase.mMimeType);
+  nsRefPtr<Decoder> decoder =
+    DecoderFactory::CreateDecoder(type, aImage, aSourceBuffer,
+                                  /* aTargetSize = */ Nothing(),
+                                  imgIContainer::DECODE_FLAGS_DEFAULT,
+                                  /* aSampleSize = */ 0,
+                                  /* aResolution = */ IntSize(),
+                                  /* aIsRedecode = */ false,
+                                  /* aImageIsTransient = */ false,
+                                  /* aImageIsLocked = */ false);
+  EXPECT_TRUE(decoder != nullptr);
+  return decoder.forget();
+}
+
+static bool
+HasFrame(const ImageTestCase& aTestCase, RasterImage* aImage,
+         uint32_t aFrameNum)
+{
+  LookupResult result =
+    SurfaceCache::Lookup(ImageKey(aImage),
+                         RasterSurfaceKey(aTestCase.mSize,
+                                          imgIContainer::DECODE_FLAGS_DEFAULT,
+                                          aFrameNum));
+  return bool(result);
+}
+
+/// Spins the event loop until a decoder resumed on the DecodePool finishes.
+static void
+WaitForDecodeComplete(RasterImage* aImage)
+{
+  nsRefPtr<ProgressTracker> tracker = aImage->GetProgressTracker();
+  while (!(tracker->GetProgress() & FLAG_DECODE_COMPLETE)) {
+    NS_ProcessNextEvent(nullptr, /* aMayWait = */ true);
+  }
+}
+
+static void
+CheckPauseAtFrameLimit(const ImageTestCase& aTestCase,
+                       bool aStoreFramesPastLimit)
+{
+  nsRefPtr<RasterImage> image = CreateImage(aTestCase);
+  ASSERT_TRUE(image != nullptr);
+  nsRefPtr<SourceBuffer> sourceBuffer = LoadSourceBuffer(aTestCase);
+  ASSERT_TRUE(sourceBuffer != nullptr);
+  nsRefPtr<Decoder> decoder = CreateDecoder(aTestCase, image, sourceBuffer);
+  ASSERT_TRUE(decoder != nullptr);
+
+  // All the data is there, so without a frame limit this would decode the
+  // whole animation. Instead, the decoder should stop before the second frame.
+  decoder->SetFrameLimit(1);
+  DecodePool::Singleton()->SyncDecodeIfPossible(decoder);
+
+  EXPECT_FALSE(decoder->GetDecodeDone());
+  EXPECT_FALSE(decoder->HasError());
+  EXPECT_EQ(1u, decoder->GetFrameCount());
+  EXPECT_TRUE(HasFrame(aTestCase, image, 0));
+  EXPECT_FALSE(HasFrame(aTestCase, image, 1));
+
+  // Let the decoder carry on. It resumes on the DecodePool.
+  if (aStoreFramesPastLimit) {
+    decoder->SetFrameLimit(UINT32_MAX);
+  } else {
+    decoder->FinishPastFrameLimit();
+  }
+  WaitForDecodeComplete(image);
+
+  EXPECT_TRUE(decoder->GetDecodeDone());
+  EXPECT_FALSE(decoder->WasAborted());
+  EXPECT_LE(2u, decoder->GetFrameCount());
+  EXPECT_TRUE(HasFrame(aTestCase, image, 0));
+  EXPECT_EQ(aStoreFramesPastLimit, HasFrame(aTestCase, image, 1));
+}
+
+TEST(ImageDecoderFrameLimit, GIFPausesAtFrameLimit)
+{
+  CheckPauseAtFrameLimit(GreenFirstFrameAnimatedGIFTestCase(),
+                         /* aStoreFramesPastLimit = */ true);
+}
+
+TEST(ImageDecoderFrameLimit, PNGPausesAtFrameLimit)
+{
+  CheckPauseAtFrameLimit(GreenFirstFrameAnimatedPNGTestCase(),
+                         /* aStoreFramesPastLimit = */ true);
+}
+
+TEST(ImageDecoderFrameLimit, GIFFinishPastFrameLimit)
+{
+  CheckPauseAtFrameLimit(GreenFirstFrameAnimatedGIFTestCase(),
+                         /* aStoreFramesPastLimit = */ false);
+}
+
+TEST(ImageDecoderFrameLimit, PNGFinishPastFrameLimit)
+{
+  CheckPauseAtFrameLimit(GreenFirstFrameAnimatedPNGTestCase(),
+                         /* aStoreFramesPastLimit = */ false);
+}
+
+static void
+CheckAlreadyPresentFrame(const ImageTestCase& aTestCase,
+                         bool aFrameLimit,
+                         bool aRedecodingAnimation)
+{
+  nsRefPtr<RasterImage> image = CreateImage(aTestCase);
+  ASSERT_TRUE(image != nullptr);
+  nsRefPtr<SourceBuffer> sourceBuffer = LoadSourceBuffer(aTestCase);
+  ASSERT_TRUE(sourceBuffer != nullptr);
+
+  // Decode the image once, so its first frame is in the SurfaceCache.
+  nsRefPtr<Decoder> first = CreateDecoder(aTestCase, image, sourceBuffer);
+  ASSERT_TRUE(first != nullptr);
+  DecodePool::Singleton()->SyncDecodeIfPossible(first);
+  EXPECT_TRUE(first->GetDecodeDone());
+  EXPECT_FALSE(first->WasAborted());
+  EXPECT_TRUE(HasFrame(aTestCase, image, 0));
+
+  nsRefPtr<Decoder> second;
+  if (aRedecodingAnimation) {
+    second =
+      DecoderFactory::CreateAnimationDecoder(
+        DecoderFactory::GetDecoderType(aTestCase.mMimeType),
+        image, sourceBuffer, /* aFirstFrame = */ 0);
+  } else {
+    second = CreateDecoder(aTestCase, image, sourceBuffer);
+  }
+  ASSERT_TRUE(second != nullptr);
+  if (aFrameLimit) {
+    second->SetFrameLimit(4);
+  }
+  DecodePool::Singleton()->SyncDecodeIfPossible(second);
+
+  // A decoder which finds that another decoder beat it to the first frame
+  // should give up, whether or not it has a frame limit. Only a decoder which
+  // is decoding a windowed animation's frames again keeps going.
+  EXPECT_TRUE(second->GetDecodeDone());
+  EXPECT_EQ(!aRedecodingAnimation, second->WasAborted());
+  EXPECT_TRUE(HasFrame(aTestCase, image, 0));
+}
+
+TEST(ImageDecoderFrameLimit, GIFAbortsIfFramePresent)
+{
+  CheckAlreadyPresentFrame(GreenGIFTestCase(),
+                           /* aFrameLimit = */ false,
+                           /* aRedecodingAnimation = */ false);
+}
+
+TEST(ImageDecoderFrameLimit, GIFWithFrameLimitAbortsIfFramePresent)
+{
+  CheckAlreadyPresentFrame(GreenGIFTestCase(),
+                           /* aFrameLimit = */ true,
+                           /* aRedecodingAnimation = */ false);
+}
+
+TEST(ImageDecoderFrameLimit, PNGWithFrameLimitAbortsIfFramePresent)
+{
+  CheckAlreadyPresentFrame(GreenPNGTestCase(),
+                           /* aFrameLimit = */ true,
+                           /* aRedecodingAnimation = */ false);
+}
+
+TEST(ImageDecoderFrameLimit, AnimationRedecodeKeepsGoingIfFramePresent)
+{
+  CheckAlreadyPresentFrame(GreenFirstFrameAnimatedGIFTestCase(),
+                           /* aFrameLimit = */ true,
+                           /* aRedecodingAnimation = */ true);
+}
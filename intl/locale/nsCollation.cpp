@@ -51,23 +51,9 @@ nsCollation::~nsCollation()
 
 nsresult nsCollation::NormalizeString(const nsAString& stringIn, nsAString& stringOut)
 {
-  int32_t aLength = stringIn.Length();
-
-  if (aLength <= 64) {
-    char16_t conversionBuffer[64];
-    ToLowerCase(PromiseFlatString(stringIn).get(), conversionBuffer, aLength);
-    stringOut.Assign(conversionBuffer, aLength);
-  }
-  else {
-    char16_t* conversionBuffer;
-    conversionBuffer = new char16_t[aLength];
-    if (!conversionBuffer) {
-      return NS_ERROR_OUT_OF_MEMORY;
-    }
-    ToLowerCase(PromiseFlatString(stringIn).get(), conversionBuffer, aLength);
-    stringOut.Assign(conversionBuffer, aLength);
-    delete [] conversionBuffer;
-  }
+  // Lower-case straight into the output; callers pass nsAutoStrings, so
+  // short strings never touch the heap and long ones are copied only once.
+  ToLowerCase(stringIn, stringOut);
   return NS_OK;
 }
 
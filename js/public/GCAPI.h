@@ -69,9 +69,9 @@ using mozilla::UniquePtr;
     D(PERIODIC_FULL_GC)                         \
     D(INCREMENTAL_TOO_SLOW)                     \
     D(ABORT_GC)                                 \
+    D(FRAGMENTED_ZONES)                         \
                                                 \
     /* These are reserved for future use. */    \
-    D(RESERVED0)                                \
     D(RESERVED1)                                \
     D(RESERVED2)                                \
     D(RESERVED3)                                \
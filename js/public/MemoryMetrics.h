@@ -457,6 +457,7 @@ struct RuntimeSizes
     macro(_, MallocHeap, temporary) \
     macro(_, MallocHeap, interpreterStack) \
     macro(_, MallocHeap, mathCache) \
+    macro(_, MallocHeap, regExpByteCodeCache) \
     macro(_, MallocHeap, uncompressedSourceCache) \
     macro(_, MallocHeap, compressedSourceSet) \
     macro(_, MallocHeap, scriptData)
@@ -804,14 +804,23 @@ AsmJSModule::staticallyLink(ExclusiveContext* cx)
     for (size_t immIndex = 0; immIndex < AsmJSImm_Limit; immIndex++) {
         AsmJSImmKind imm = AsmJSImmKind(immIndex);
         const OffsetVector& offsets = staticLinkData_.absoluteLinks[imm];
+        if (offsets.empty())
+            continue;
+
+        // Large modules have a great many absolute links of each kind, so
+        // resolve the address once per kind rather than once per link.
+        void* address = AddressOf(imm, cx);
+
+        // Builtin calls are another case where, when profiling is enabled,
+        // we must point to the profiling entry.
+        AsmJSExit::BuiltinKind builtin;
+        bool patchBuiltinThunks = profilingEnabled_ && ImmKindIsBuiltin(imm, &builtin);
+
         for (size_t i = 0; i < offsets.length(); i++) {
             uint8_t* patchAt = code_ + offsets[i];
-            void* target = AddressOf(imm, cx);
+            void* target = address;
 
-            // Builtin calls are another case where, when profiling is enabled,
-            // we must point to the profiling entry.
-            AsmJSExit::BuiltinKind builtin;
-            if (profilingEnabled_ && ImmKindIsBuiltin(imm, &builtin)) {
+            if (patchBuiltinThunks) {
                 const CodeRange* codeRange = lookupCodeRange(patchAt);
                 if (codeRange->isFunction())
                     target = code_ + builtinThunkOffsets_[builtin];
@@ -6,6 +6,8 @@
 
 #include "builtin/MapObject.h"
 
+#include "mozilla/HashFunctions.h"
+
 #include "jscntxt.h"
 #include "jsiter.h"
 #include "jsobj.h"
@@ -69,7 +71,12 @@ HashableValue::hash() const
     // HashableValue::setValue normalizes values so that the SameValue relation
     // on HashableValues is the same as the == relationship on
     // value.data.asBits.
-    return value.asRawBits();
+    //
+    // Mix in all 64 bits: simply truncating would drop the high half of a
+    // double's bits, and doubles like 0.5, 1.5, 2.5, ... all have zero low
+    // words and would land in the same bucket.
+    uint64_t bits = value.asRawBits();
+    return mozilla::HashGeneric(uint32_t(bits), uint32_t(bits >> 32));
 }
 
 bool
@@ -308,11 +308,15 @@ static const struct ParamPair {
     {"sliceTimeBudget",     JSGC_SLICE_TIME_BUDGET},
     {"markStackLimit",      JSGC_MARK_STACK_LIMIT},
     {"minEmptyChunkCount",  JSGC_MIN_EMPTY_CHUNK_COUNT},
-    {"maxEmptyChunkCount",  JSGC_MAX_EMPTY_CHUNK_COUNT}
+    {"maxEmptyChunkCount",  JSGC_MAX_EMPTY_CHUNK_COUNT},
+    {"parallelUnmarkEnabled", JSGC_PARALLEL_UNMARK_ENABLED},
+    {"nurseryGrowThreshold", JSGC_NURSERY_GROW_THRESHOLD},
+    {"nurseryShrinkThreshold", JSGC_NURSERY_SHRINK_THRESHOLD},
+    {"compactingFreeCellThreshold", JSGC_COMPACTING_FREE_CELL_THRESHOLD}
 };
 
 // Keep this in sync with above params.
-#define GC_PARAMETER_ARGS_LIST "maxBytes, maxMallocBytes, gcBytes, gcNumber, sliceTimeBudget, markStackLimit, minEmptyChunkCount or maxEmptyChunkCount"
+#define GC_PARAMETER_ARGS_LIST "maxBytes, maxMallocBytes, gcBytes, gcNumber, sliceTimeBudget, markStackLimit, minEmptyChunkCount, maxEmptyChunkCount, parallelUnmarkEnabled, nurseryGrowThreshold, nurseryShrinkThreshold or compactingFreeCellThreshold"
 
 static bool
 GCParameter(JSContext* cx, unsigned argc, Value* vp)
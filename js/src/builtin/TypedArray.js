@@ -146,6 +146,10 @@ function TypedArrayFill(value, start = 0, end = undefined) {
     // Steps 3-5.
     var len = TypedArrayLength(O);
 
+    // Convert |value| once rather than on every element store, as ES2016
+    // specifies.
+    value = ToNumber(value);
+
     // Steps 6-7.
     var relativeStart = ToInteger(start);
 
@@ -163,9 +167,8 @@ function TypedArrayFill(value, start = 0, end = undefined) {
                 : std_Math_min(relativeEnd, len);
 
     // Step 12.
-    for (; k < final; k++) {
-        O[k] = value;
-    }
+    if (k < final)
+        FillTypedArrayElements(O, value, k, final);
 
     // Step 13.
     return O;
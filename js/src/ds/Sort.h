@@ -86,6 +86,44 @@ MergeSort(T* array, size_t nelems, T* scratch, Comparator c)
     if (nelems <= 1)
         return true;
 
+    /*
+     * Input that is already sorted, or strictly descending, is common (e.g.
+     * re-sorting a table by the same column) and can be handled with a single
+     * linear scan. On other input the scan stops at the first element out of
+     * order, so it costs only a couple of extra comparisons.
+     */
+    bool lessOrEqual;
+    if (!c(array[0], array[1], &lessOrEqual))
+        return false;
+    if (lessOrEqual) {
+        size_t i = 2;
+        for (; i < nelems; i++) {
+            if (!c(array[i - 1], array[i], &lessOrEqual))
+                return false;
+            if (!lessOrEqual)
+                break;
+        }
+        if (i == nelems)
+            return true;
+    } else {
+        size_t i = 2;
+        for (; i < nelems; i++) {
+            if (!c(array[i - 1], array[i], &lessOrEqual))
+                return false;
+            if (lessOrEqual)
+                break;
+        }
+        if (i == nelems) {
+            /* No two elements compare equal, so reversing keeps the sort stable. */
+            for (size_t lo = 0, hi = nelems - 1; lo < hi; lo++, hi--) {
+                T tmp = array[lo];
+                array[lo] = array[hi];
+                array[hi] = tmp;
+            }
+            return true;
+        }
+    }
+
     /*
      * Apply insertion sort to small chunks to reduce the number of merge
      * passes needed.
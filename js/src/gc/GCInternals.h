@@ -210,16 +210,31 @@ struct TenureCount
 
 // Keep rough track of how many times we tenure objects in particular groups
 // during minor collections, using a fixed size hash for efficiency at the cost
-// of potential collisions.
+// of potential collisions. Colliding groups compete for an entry: a miss
+// decrements the count of the group holding it and takes the entry over once
+// that count reaches zero, so that a heavily tenured group cannot be locked
+// out by one that happened to be tenured first.
 struct TenureCountCache
 {
-    TenureCount entries[16];
+    TenureCount entries[32];
 
     TenureCountCache() { mozilla::PodZero(this); }
 
     TenureCount& findEntry(ObjectGroup* group) {
         return entries[PointerHasher<ObjectGroup*, 3>::hash(group) % mozilla::ArrayLength(entries)];
     }
+
+    void noteTenured(ObjectGroup* group) {
+        TenureCount& entry = findEntry(group);
+        if (entry.group == group) {
+            entry.count++;
+        } else if (!entry.group || entry.count <= 1) {
+            entry.group = group;
+            entry.count = 1;
+        } else {
+            entry.count--;
+        }
+    }
 };
 
 } /* namespace gc */
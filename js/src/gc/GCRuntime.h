@@ -157,6 +157,12 @@ class GCSchedulingTunables
     unsigned minEmptyChunkCount_;
     unsigned maxEmptyChunkCount_;
 
+    /*
+     * Zones whose relocatable arenas have more than this percentage of their
+     * cell space free are compacted by the periodic GC. Zero disables this.
+     */
+    unsigned compactingFreeCellThreshold_;
+
   public:
     GCSchedulingTunables()
       : gcMaxBytes_(0),
@@ -172,7 +178,8 @@ class GCSchedulingTunables
         lowFrequencyHeapGrowth_(1.5),
         dynamicMarkSliceEnabled_(false),
         minEmptyChunkCount_(1),
-        maxEmptyChunkCount_(30)
+        maxEmptyChunkCount_(30),
+        compactingFreeCellThreshold_(50)
     {}
 
     size_t gcMaxBytes() const { return gcMaxBytes_; }
@@ -189,6 +196,7 @@ class GCSchedulingTunables
     bool isDynamicMarkSliceEnabled() const { return dynamicMarkSliceEnabled_; }
     unsigned minEmptyChunkCount() const { return minEmptyChunkCount_; }
     unsigned maxEmptyChunkCount() const { return maxEmptyChunkCount_; }
+    unsigned compactingFreeCellThreshold() const { return compactingFreeCellThreshold_; }
 
     void setParameter(JSGCParamKey key, uint32_t value);
 };
@@ -601,6 +609,7 @@ class GCRuntime
     bool triggerZoneGC(Zone* zone, JS::gcreason::Reason reason);
     bool maybeGC(Zone* zone);
     void maybePeriodicFullGC();
+    bool prepareFragmentedZonesForGC();
     void minorGC(JS::gcreason::Reason reason) {
         gcstats::AutoPhase ap(stats, gcstats::PHASE_MINOR_GC);
         minorGCImpl(reason, nullptr);
@@ -740,6 +749,8 @@ class GCRuntime
     void enableCompactingGC();
     bool isCompactingGCEnabled();
 
+    bool isParallelUnmarkEnabled() const { return parallelUnmarkEnabled; }
+
     void setGrayRootsTracer(JSTraceDataOp traceOp, void* data);
     bool addBlackRootsTracer(JSTraceDataOp traceOp, void* data);
     void removeBlackRootsTracer(JSTraceDataOp traceOp, void* data);
@@ -901,6 +912,7 @@ class GCRuntime
     void pushZealSelectedObjects();
     void purgeRuntime();
     bool beginMarkPhase(JS::gcreason::Reason reason);
+    bool unmarkCollectedZonesParallel();
     bool shouldPreserveJITCode(JSCompartment* comp, int64_t currentTime,
                                JS::gcreason::Reason reason);
     void bufferGrayRoots();
@@ -1190,6 +1202,12 @@ class GCRuntime
      */
     bool compactingEnabled;
 
+    /*
+     * Whether helper threads are used to clear the mark bitmaps of the zones
+     * being collected.
+     */
+    bool parallelUnmarkEnabled;
+
     /*
      * Some code cannot tolerate compacting GC so it can be disabled temporarily
      * with AutoDisableCompactingGC which uses this counter.
@@ -90,7 +90,8 @@ js::Nursery::init(uint32_t maxNurseryBytes)
     if (env) {
         if (0 == strcmp(env, "help")) {
             fprintf(stderr, "JS_GC_PROFILE_NURSERY=N\n\n"
-                    "\tReport minor GC's taking more than N microseconds.");
+                    "\tReport minor GC's taking more than N microseconds, and\n"
+                    "\tthe object groups that minor GCs decide to pretenure.");
             exit(0);
         }
         enableProfiling_ = true;
@@ -519,9 +520,9 @@ js::Nursery::collect(JSRuntime* rt, JS::gcreason::Reason reason, ObjectGroupList
     // Resize the nursery.
     TIME_START(resize);
     double promotionRate = mover.tenuredSize / double(allocationEnd() - start());
-    if (promotionRate > 0.05)
+    if (promotionRate * 100 > growThreshold_)
         growAllocableSpace();
-    else if (promotionRate < 0.01)
+    else if (promotionRate * 100 < shrinkThreshold_)
         shrinkAllocableSpace();
     TIME_END(resize);
 
@@ -533,8 +534,13 @@ js::Nursery::collect(JSRuntime* rt, JS::gcreason::Reason reason, ObjectGroupList
     if (pretenureGroups && (promotionRate > 0.8 || reason == JS::gcreason::FULL_STORE_BUFFER)) {
         for (size_t i = 0; i < ArrayLength(tenureCounts.entries); i++) {
             const TenureCount& entry = tenureCounts.entries[i];
-            if (entry.count >= 3000)
+            if (entry.count >= 3000) {
                 (void)pretenureGroups->append(entry.group); // ignore alloc failure
+                if (enableProfiling_) {
+                    fprintf(stderr, "MinorGC: pretenuring group %p (%s), %d objects tenured\n",
+                            (void*)entry.group, entry.group->clasp()->name, entry.count);
+                }
+            }
         }
     }
     TIME_END(pretenure);
@@ -713,3 +719,20 @@ js::Nursery::shrinkAllocableSpace()
     numActiveChunks_ = Max(numActiveChunks_ - 1, 1);
     updateDecommittedRegion();
 }
+
+void
+js::Nursery::shrinkAllocableSpaceToMinimum()
+{
+    // Objects may have been allocated in the nursery since it was evicted,
+    // e.g. by finalizers or GC callbacks. Those must stay where they are.
+    if (!isEnabled() || !isEmpty())
+        return;
+#ifdef JS_GC_ZEAL
+    if (runtime()->gcZeal() == ZealGenerationalGCValue)
+        return;
+#endif
+    numActiveChunks_ = 1;
+    setCurrentChunk(0);
+    currentStart_ = position();
+    updateDecommittedRegion();
+}
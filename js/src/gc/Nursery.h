@@ -102,6 +102,8 @@ class Nursery
         currentChunk_(0),
         numActiveChunks_(0),
         numNurseryChunks_(0),
+        growThreshold_(DefaultGrowThreshold),
+        shrinkThreshold_(DefaultShrinkThreshold),
         profileThreshold_(0),
         enableProfiling_(false),
         freeMallocedBuffersTask(nullptr)
@@ -118,6 +120,26 @@ class Nursery
     void disable();
     bool isEnabled() const { return numActiveChunks_ != 0; }
 
+    /*
+     * The nursery grows after a minor GC that promotes more than
+     * |growThreshold| percent of its used space, and shrinks by one chunk
+     * after a minor GC that promotes less than |shrinkThreshold| percent.
+     */
+    static const uint32_t DefaultGrowThreshold = 5;
+    static const uint32_t DefaultShrinkThreshold = 1;
+
+    uint32_t growThreshold() const { return growThreshold_; }
+    uint32_t shrinkThreshold() const { return shrinkThreshold_; }
+    void setGrowThreshold(uint32_t percent) { growThreshold_ = percent; }
+    void setShrinkThreshold(uint32_t percent) { shrinkThreshold_ = percent; }
+
+    /*
+     * Return all but the first nursery chunk to the system. This is used by
+     * shrinking GCs so that idle runtimes do not keep a fully grown nursery
+     * committed. Does nothing if the nursery is not empty.
+     */
+    void shrinkAllocableSpaceToMinimum();
+
     /* Return true if no allocations have been made since the last collection. */
     bool isEmpty() const;
 
@@ -247,6 +269,10 @@ class Nursery
     /* Number of chunks allocated for the nursery. */
     int numNurseryChunks_;
 
+    /* Promotion rate thresholds for resizing, in percent. */
+    uint32_t growThreshold_;
+    uint32_t shrinkThreshold_;
+
     /* Report minor collections taking more than this many us, if enabled. */
     int64_t profileThreshold_;
     bool enableProfiling_;
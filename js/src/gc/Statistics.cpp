@@ -481,6 +481,7 @@ Statistics::formatDetailedDescription()
   HeapSize: %.3f MiB\n\
   Chunk Delta (magnitude): %+d  (%d)\n\
   Arenas Relocated: %.3f MiB\n\
+  Functions Compiled/Lazy (Relazified): %d/%d (%d)\n\
 ";
     char buffer[1024];
     memset(buffer, 0, sizeof(buffer));
@@ -498,7 +499,10 @@ Statistics::formatDetailedDescription()
                 double(preBytes) / bytesPerMiB,
                 counts[STAT_NEW_CHUNK] - counts[STAT_DESTROY_CHUNK], counts[STAT_NEW_CHUNK] +
                                                                      counts[STAT_DESTROY_CHUNK],
-                double(ArenaSize * counts[STAT_ARENA_RELOCATED]) / bytesPerMiB);
+                double(ArenaSize * counts[STAT_ARENA_RELOCATED]) / bytesPerMiB,
+                counts[STAT_COMPILED_FUNCTIONS],
+                counts[STAT_LAZY_FUNCTIONS],
+                counts[STAT_RELAZIFIED_FUNCTIONS]);
     return make_string_copy(buffer);
 }
 
@@ -643,7 +647,10 @@ Statistics::formatJsonDescription(uint64_t timestamp)
         "\"nonincremental_reason\":\"%s\","
         "\"allocated\":%u,"
         "\"added_chunks\":%d,"
-        "\"removed_chunks\":%d,";
+        "\"removed_chunks\":%d,"
+        "\"compiled_functions\":%d,"
+        "\"lazy_functions\":%d,"
+        "\"relazified_functions\":%d,";
     char buffer[1024];
     memset(buffer, 0, sizeof(buffer));
     JS_snprintf(buffer, sizeof(buffer), format,
@@ -662,7 +669,10 @@ Statistics::formatJsonDescription(uint64_t timestamp)
                 nonincrementalReason_ ? nonincrementalReason_ : "none",
                 unsigned(preBytes / 1024 / 1024),
                 counts[STAT_NEW_CHUNK],
-                counts[STAT_DESTROY_CHUNK]);
+                counts[STAT_DESTROY_CHUNK],
+                counts[STAT_COMPILED_FUNCTIONS],
+                counts[STAT_LAZY_FUNCTIONS],
+                counts[STAT_RELAZIFIED_FUNCTIONS]);
     return make_string_copy(buffer);
 }
 
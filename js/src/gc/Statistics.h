@@ -99,6 +99,13 @@ enum Stat {
     // Number of arenas relocated by compacting GC.
     STAT_ARENA_RELOCATED,
 
+    // Number of interpreted functions in the collected zones which have
+    // bytecode after relazification, which are lazy, and which were
+    // relazified by this GC.
+    STAT_COMPILED_FUNCTIONS,
+    STAT_LAZY_FUNCTIONS,
+    STAT_RELAZIFIED_FUNCTIONS,
+
     STAT_LIMIT
 };
 
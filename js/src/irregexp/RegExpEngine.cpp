@@ -1637,8 +1637,8 @@ SampleChars(FrequencyCollator* collator, const CharT* chars, size_t length)
     }
 }
 
-static bool
-IsNativeRegExpEnabled(JSContext* cx)
+bool
+irregexp::IsNativeRegExpEnabled(JSContext* cx)
 {
 #ifdef JS_CODEGEN_NONE
     return false;
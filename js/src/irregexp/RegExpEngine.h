@@ -71,9 +71,10 @@ struct RegExpCode
 {
     jit::JitCode* jitCode;
     uint8_t* byteCode;
+    size_t byteCodeLength;
 
     RegExpCode()
-      : jitCode(nullptr), byteCode(nullptr)
+      : jitCode(nullptr), byteCode(nullptr), byteCodeLength(0)
     {}
 
     bool empty() {
@@ -85,6 +86,10 @@ struct RegExpCode
     }
 };
 
+// Whether CompilePattern generates native code when bytecode isn't forced.
+bool
+IsNativeRegExpEnabled(JSContext* cx);
+
 RegExpCode
 CompilePattern(JSContext* cx, RegExpShared* shared, RegExpCompileData* data,
                HandleLinearString sample,  bool is_global, bool ignore_case,
@@ -95,6 +95,7 @@ InterpretedRegExpMacroAssembler::GenerateCode(JSContext* cx, bool match_only)
 
     RegExpCode res;
     res.byteCode = buffer_;
+    res.byteCodeLength = pc_;
     buffer_ = nullptr;
     return res;
 }
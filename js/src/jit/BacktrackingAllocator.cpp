@@ -1138,7 +1138,7 @@ BacktrackingAllocator::mergeAndQueueRegisters()
                     return false;
                 bundle->setSpillSet(spill);
 
-                size_t priority = computePriority(bundle);
+                size_t priority = computeQueuePriority(bundle);
                 if (!allocationQueue.insert(QueueItem(bundle, priority)))
                     return false;
             }
@@ -1252,6 +1252,12 @@ BacktrackingAllocator::processBundle(LiveBundle* bundle)
     Requirement requirement, hint;
     bool canAllocate = computeRequirement(bundle, &requirement, &hint);
 
+    // In linear scan mode, a bundle which can be split evicts conflicting
+    // bundles only once before being split at its register uses. Minimal
+    // bundles can't be split, so they get the usual number of attempts to
+    // evict their way to a register.
+    size_t maxAttempts = (linearScan && !minimalBundle(bundle)) ? 1 : MAX_ATTEMPTS;
+
     bool fixed;
     LiveBundleVector conflicting;
     for (size_t attempt = 0;; attempt++) {
@@ -1275,7 +1281,7 @@ BacktrackingAllocator::processBundle(LiveBundle* bundle)
 
             // If that didn't work, but we have one or more non-fixed bundles
             // known to be conflicting, maybe we can evict them and try again.
-            if (attempt < MAX_ATTEMPTS &&
+            if (attempt < maxAttempts &&
                 !fixed &&
                 !conflicting.empty() &&
                 maximumSpillWeight(conflicting) < computeSpillWeight(bundle))
@@ -1466,7 +1472,7 @@ BacktrackingAllocator::evictBundle(LiveBundle* bundle)
 
     bundle->setAllocation(LAllocation());
 
-    size_t priority = computePriority(bundle);
+    size_t priority = computeQueuePriority(bundle);
     return allocationQueue.insert(QueueItem(bundle, priority));
 }
 
@@ -1498,7 +1504,7 @@ BacktrackingAllocator::splitAndRequeueBundles(LiveBundle* bundle,
     // Queue the new bundles for register assignment.
     for (size_t i = 0; i < newBundles.length(); i++) {
         LiveBundle* newBundle = newBundles[i];
-        size_t priority = computePriority(newBundle);
+        size_t priority = computeQueuePriority(newBundle);
         if (!allocationQueue.insert(QueueItem(newBundle, priority)))
             return false;
     }
@@ -2329,6 +2335,15 @@ BacktrackingAllocator::computePriority(LiveBundle* bundle)
     return lifetimeTotal;
 }
 
+size_t
+BacktrackingAllocator::computeQueuePriority(LiveBundle* bundle)
+{
+    // In linear scan mode, bundles which start earlier are processed first.
+    if (linearScan)
+        return SIZE_MAX - bundle->firstRange()->from().bits();
+    return computePriority(bundle);
+}
+
 bool
 BacktrackingAllocator::minimalDef(LiveRange* range, LNode* ins)
 {
@@ -2962,6 +2977,15 @@ BacktrackingAllocator::chooseBundleSplit(LiveBundle* bundle, bool fixed, LiveBun
 {
     bool success = false;
 
+    if (linearScan) {
+        if (fixed)
+            return splitAcrossCalls(bundle);
+
+        // Split at all register uses.
+        SplitPositionVector emptyPositions;
+        return splitAt(bundle, emptyPositions);
+    }
+
     if (!trySplitAcrossHotcode(bundle, &success))
         return false;
     if (success)
@@ -549,6 +549,13 @@ class BacktrackingAllocator : protected RegisterAllocator
     // This flag is set when testing new allocator modifications.
     bool testbed;
 
+    // This flag is set to allocate bundles in a single linear pass: bundles
+    // are processed in order of their start position, evictions are limited
+    // to one round, and bundles which can't get a register are split at their
+    // register uses right away instead of trying the more precise splits.
+    // This trades code quality for allocation time on large graphs.
+    bool linearScan;
+
     BitSet* liveIn;
     FixedList<VirtualRegister> vregs;
 
@@ -609,9 +616,11 @@ class BacktrackingAllocator : protected RegisterAllocator
     SpillSlotList normalSlots, doubleSlots, quadSlots;
 
   public:
-    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed)
+    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed,
+                          bool linearScan = false)
       : RegisterAllocator(mir, lir, graph),
         testbed(testbed),
+        linearScan(linearScan),
         liveIn(nullptr),
         callRanges(nullptr)
     { }
@@ -717,6 +726,7 @@ class BacktrackingAllocator : protected RegisterAllocator
     // Heuristic methods.
 
     size_t computePriority(LiveBundle* bundle);
+    size_t computeQueuePriority(LiveBundle* bundle);
     size_t computeSpillWeight(LiveBundle* bundle);
 
     size_t maximumSpillWeight(const LiveBundleVector& bundles);
@@ -7048,6 +7048,17 @@ DoGetPropGeneric(JSContext* cx, BaselineFrame* frame, ICGetProp_Generic* stub, M
     jsbytecode* pc = stub->getChainFallback()->icEntry()->pc(frame->script());
     JSOp op = JSOp(*pc);
     RootedPropertyName name(cx, frame->script()->getName(pc));
+
+    // This site is megamorphic, so try the runtime's property lookup cache
+    // before doing a full lookup. Undefined results of CALLPROP take the slow
+    // path, which handles __noSuchMethod__.
+    if (val.isObject() &&
+        GetOwnDataPropertyCached(cx, &val.toObject(), NameToId(name), res.address()) &&
+        !(op == JSOP_CALLPROP && res.isUndefined()))
+    {
+        return true;
+    }
+
     return ComputeGetPropResult(cx, frame, op, name, val, res);
 }
 
@@ -7544,11 +7555,18 @@ DoSetPropFallback(JSContext* cx, BaselineFrame* frame, ICSetProp_Fallback* stub_
     } else {
         MOZ_ASSERT(op == JSOP_SETPROP || op == JSOP_STRICTSETPROP);
 
-        ObjectOpResult result;
-        if (!SetProperty(cx, obj, id, rhs, lhs, result) ||
-            !result.checkStrictErrorOrWarning(cx, obj, id, op == JSOP_STRICTSETPROP))
+        // Once no more stubs can be attached, try the runtime's property
+        // lookup cache before doing a full lookup.
+        if (stub->numOptimizedStubs() < ICSetProp_Fallback::MAX_OPTIMIZED_STUBS ||
+            !lhs.isObject() ||
+            !SetOwnDataPropertyCached(cx, obj, id, rhs))
         {
-            return false;
+            ObjectOpResult result;
+            if (!SetProperty(cx, obj, id, rhs, lhs, result) ||
+                !result.checkStrictErrorOrWarning(cx, obj, id, op == JSOP_STRICTSETPROP))
+            {
+                return false;
+            }
         }
     }
 
@@ -1772,14 +1772,16 @@ GenerateLIR(MIRGenerator* mir)
 
         switch (allocator) {
           case RegisterAllocator_Backtracking:
-          case RegisterAllocator_Testbed: {
+          case RegisterAllocator_Testbed:
+          case RegisterAllocator_LinearScan: {
 #ifdef DEBUG
             if (!integrity.record())
                 return nullptr;
 #endif
 
             BacktrackingAllocator regalloc(mir, &lirgen, *lir,
-                                           allocator == RegisterAllocator_Testbed);
+                                           allocator == RegisterAllocator_Testbed,
+                                           allocator == RegisterAllocator_LinearScan);
             if (!regalloc.go())
                 return nullptr;
 
@@ -5205,7 +5205,12 @@ IonBuilder::makeInliningDecision(JSObject* targetArg, CallInfo& callInfo)
         // outermost script a max inlining depth of 0, so that it won't be
         // inlined in other scripts. This heuristic is currently only used
         // when we're inlining scripts with loops, see the comment below.
-        outerBaseline->setMaxInliningDepth(0);
+        //
+        // The lite level's depth limit is much lower than the normal one, and
+        // the baseline script's depth outlives the lite compilation, so don't
+        // let it stop the normal level from inlining this script later.
+        if (optimizationInfo().level() != Optimization_Lite)
+            outerBaseline->setMaxInliningDepth(0);
 
         trackOptimizationOutcome(TrackedOutcome::CantInlineExceededDepth);
         return DontInline(targetScript, "Vetoed: exceeding allowed inline depth");
@@ -2005,9 +2005,13 @@ GetPropertyIC::update(JSContext* cx, HandleScript outerScript, size_t cacheIndex
         return Invalidate(cx, outerScript);
     }
 
+    // Once the cache is full, look in the runtime's property lookup cache
+    // before doing a full lookup.
     RootedId id(cx, NameToId(name));
-    if (!GetProperty(cx, obj, obj, id, vp))
-        return false;
+    if (cache.canAttachStub() || !GetOwnDataPropertyCached(cx, obj, id, vp.address())) {
+        if (!GetProperty(cx, obj, obj, id, vp))
+            return false;
+    }
 
     if (!cache.idempotent()) {
         RootedScript script(cx);
@@ -3342,8 +3346,11 @@ SetPropertyIC::update(JSContext* cx, HandleScript outerScript, size_t cacheIndex
     }
 
     // Set/Add the property on the object, the inlined cache are setup for the next execution.
-    if (!SetProperty(cx, obj, name, value, cache.strict(), cache.pc()))
-        return false;
+    // Once the cache is full, try the runtime's property lookup cache first.
+    if (cache.canAttachStub() || !SetOwnDataPropertyCached(cx, obj, id, value)) {
+        if (!SetProperty(cx, obj, name, value, cache.strict(), cache.pc()))
+            return false;
+    }
 
     // A GC may have caused cache.value() to become stale as it is not traced.
     // In this case the IonScript will have been invalidated, so check for that.
@@ -51,6 +51,34 @@ OptimizationInfo::initNormalOptimizationInfo()
     inliningRecompileThresholdFactor_ = 4;
 }
 
+void
+OptimizationInfo::initLiteOptimizationInfo()
+{
+    // The lite optimization level
+    // Gets reasonable code out of Baseline quickly: skips the expensive
+    // passes and allocates registers in a single linear pass. Scripts that
+    // stay hot are recompiled at the normal level.
+
+    // Take normal option values for not specified values.
+    initNormalOptimizationInfo();
+
+    level_ = Optimization_Lite;
+    gvn_ = false;
+    licm_ = false;
+    rangeAnalysis_ = false;
+    loopUnrolling_ = false;
+    reordering_ = false;
+    autoTruncate_ = false;
+    sink_ = false;
+    scalarReplacement_ = false;
+    registerAllocator_ = RegisterAllocator_LinearScan;
+
+    // Only inline small functions, which is almost free.
+    maxInlineDepth_ = 0;
+    inlineMaxTotalBytecodeLength_ = 1000;
+    compilerWarmUpThreshold_ = LiteCompilerWarmupThreshold;
+}
+
 void
 OptimizationInfo::initAsmjsOptimizationInfo()
 {
@@ -108,6 +136,7 @@ OptimizationInfo::compilerWarmUpThreshold(JSScript* script, jsbytecode* pc) cons
 
 OptimizationInfos::OptimizationInfos()
 {
+    infos_[Optimization_Lite - 1].initLiteOptimizationInfo();
     infos_[Optimization_Normal - 1].initNormalOptimizationInfo();
     infos_[Optimization_AsmJS - 1].initAsmjsOptimizationInfo();
 
@@ -127,6 +156,12 @@ OptimizationInfos::nextLevel(OptimizationLevel level) const
     MOZ_ASSERT(!isLastLevel(level));
     switch (level) {
       case Optimization_DontCompile:
+        // A forced warm-up threshold (e.g. --ion-eager) asks for fully
+        // optimized code at that threshold, so skip the lite level.
+        if (!js_JitOptions.ionLite || js_JitOptions.forcedDefaultIonWarmUpThreshold.isSome())
+            return Optimization_Normal;
+        return Optimization_Lite;
+      case Optimization_Lite:
         return Optimization_Normal;
       default:
         MOZ_CRASH("Unknown optimization level.");
@@ -19,6 +19,7 @@ namespace jit {
 enum OptimizationLevel
 {
     Optimization_DontCompile,
+    Optimization_Lite,
     Optimization_Normal,
     Optimization_AsmJS,
     Optimization_Count
@@ -31,6 +32,8 @@ OptimizationLevelString(OptimizationLevel level)
     switch (level) {
       case Optimization_DontCompile:
         return "Optimization_DontCompile";
+      case Optimization_Lite:
+        return "Optimization_Lite";
       case Optimization_Normal:
         return "Optimization_Normal";
       case Optimization_AsmJS:
@@ -129,6 +132,9 @@ class OptimizationInfo
     // Default compiler warmup threshold, unless it is overridden.
     static const uint32_t CompilerWarmupThreshold = 1000;
 
+    // Default compiler warmup threshold of the lite level.
+    static const uint32_t LiteCompilerWarmupThreshold = 200;
+
     // How many invocations or loop iterations are needed before calls
     // are inlined, as a fraction of compilerWarmUpThreshold.
     double inliningWarmUpThresholdFactor_;
@@ -141,6 +147,7 @@ class OptimizationInfo
     OptimizationInfo()
     { }
 
+    void initLiteOptimizationInfo();
     void initNormalOptimizationInfo();
     void initAsmjsOptimizationInfo();
 
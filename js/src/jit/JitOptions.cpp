@@ -123,6 +123,11 @@ JitOptions::JitOptions()
     // Whether IonBuilder should prefer IC generation above specialized MIR.
     SET_DEFAULT(forceInlineCaches, false);
 
+    // Toggles whether scripts are first compiled at the lite optimization
+    // level before being recompiled with all optimizations. Off until the
+    // lite level has had more testing.
+    SET_DEFAULT(ionLite, false);
+
     // Toggles whether large scripts are rejected.
     SET_DEFAULT(limitScriptSize, true);
 
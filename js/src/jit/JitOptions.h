@@ -24,6 +24,7 @@ static const uint32_t MAX_MAIN_THREAD_LOCALS_AND_ARGS = 256;
 enum IonRegisterAllocator {
     RegisterAllocator_Backtracking,
     RegisterAllocator_Testbed,
+    RegisterAllocator_LinearScan,
     RegisterAllocator_Stupid
 };
 
@@ -34,6 +35,8 @@ LookupRegisterAllocator(const char* name)
         return mozilla::Some(RegisterAllocator_Backtracking);
     if (!strcmp(name, "testbed"))
         return mozilla::Some(RegisterAllocator_Testbed);
+    if (!strcmp(name, "linearscan"))
+        return mozilla::Some(RegisterAllocator_LinearScan);
     if (!strcmp(name, "stupid"))
         return mozilla::Some(RegisterAllocator_Stupid);
     return mozilla::Nothing();
@@ -62,6 +65,7 @@ struct JitOptions
     bool disableSink;
     bool eagerCompilation;
     bool forceInlineCaches;
+    bool ionLite;
     bool limitScriptSize;
     bool osr;
     uint32_t baselineWarmUpThreshold;
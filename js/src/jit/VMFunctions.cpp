@@ -1090,6 +1090,63 @@ Recompile(JSContext* cx)
     return RecompileImpl(cx, /* force = */ false);
 }
 
+static Shape*
+LookupOwnPropertyCached(JSContext* cx, NativeObject* obj, jsid id)
+{
+    Shape* shape = obj->lastProperty();
+    if (shape->inDictionary())
+        return obj->lookupPure(id);
+
+    PropertyLookupCache& cache = cx->runtime()->propertyLookupCache;
+    Shape* prop;
+    if (!cache.lookup(shape, id, &prop)) {
+        prop = obj->lookupPure(id);
+        cache.fill(shape, id, prop);
+    }
+    return prop;
+}
+
+bool
+GetOwnDataPropertyCached(JSContext* cx, JSObject* obj, jsid id, Value* vp)
+{
+    if (!obj->isNative() || obj->getOps()->getProperty || obj->getClass()->getProperty)
+        return false;
+
+    NativeObject* nobj = &obj->as<NativeObject>();
+    Shape* prop = LookupOwnPropertyCached(cx, nobj, id);
+    if (!prop || !prop->hasSlot() || !prop->hasDefaultGetter())
+        return false;
+
+    // Scope objects keep uninitialized lexicals as magic values.
+    const Value& v = nobj->getSlot(prop->slot());
+    if (v.isMagic())
+        return false;
+
+    *vp = v;
+    return true;
+}
+
+bool
+SetOwnDataPropertyCached(JSContext* cx, JSObject* obj, jsid id, const Value& v)
+{
+    if (!obj->isNative() || obj->getOps()->setProperty || obj->getClass()->setProperty ||
+        obj->watched())
+    {
+        return false;
+    }
+
+    NativeObject* nobj = &obj->as<NativeObject>();
+    Shape* prop = LookupOwnPropertyCached(cx, nobj, id);
+    if (!prop || !prop->hasSlot() || !prop->hasDefaultSetter() || !prop->writable())
+        return false;
+
+    if (nobj->getSlot(prop->slot()).isMagic())
+        return false;
+
+    nobj->setSlotWithType(cx, prop, v);
+    return true;
+}
+
 bool
 SetDenseOrUnboxedArrayElement(JSContext* cx, HandleObject obj, int32_t index,
                               HandleValue value, bool strict)
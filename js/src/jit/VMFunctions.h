@@ -703,6 +703,13 @@ JSString* StringReplace(JSContext* cx, HandleString string, HandleString pattern
 bool SetDenseOrUnboxedArrayElement(JSContext* cx, HandleObject obj, int32_t index,
                                    HandleValue value, bool strict);
 
+// Fast paths for megamorphic property accesses, which look the property up in
+// the runtime's PropertyLookupCache. These handle own data properties of
+// plain native objects only, and return false (without reporting an error)
+// if the access needs the generic path.
+bool GetOwnDataPropertyCached(JSContext* cx, JSObject* obj, jsid id, Value* vp);
+bool SetOwnDataPropertyCached(JSContext* cx, JSObject* obj, jsid id, const Value& v);
+
 void AssertValidObjectPtr(JSContext* cx, JSObject* obj);
 void AssertValidObjectOrNullPtr(JSContext* cx, JSObject* obj);
 void AssertValidStringPtr(JSContext* cx, JSString* str);
@@ -0,0 +1,33 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+
+BEGIN_TEST(testArraySort_presorted)
+{
+    JS::RootedValue v(cx);
+
+    // Already sorted input, including equal neighbours, is left alone.
+    EVAL("[1, 2, 2, 3, 10].sort((a, b) => a - b).join() === '1,2,2,3,10'", &v);
+    CHECK(v.isTrue());
+
+    // Strictly descending input is reversed.
+    EVAL("[9, 7, 5, 3, 1].sort((a, b) => a - b).join() === '1,3,5,7,9'", &v);
+    CHECK(v.isTrue());
+
+    // Descending input with equal elements still sorts stably.
+    EVAL("var a = [{k: 3, i: 0}, {k: 2, i: 1}, {k: 2, i: 2}, {k: 1, i: 3}];"
+         "a.sort((x, y) => x.k - y.k).map(o => o.i).join() === '3,1,2,0'", &v);
+    CHECK(v.isTrue());
+
+    // Input that is only sorted at the start falls back to the merge sort.
+    EVAL("['a', 'b', 'c', 'b', 'a'].sort().join() === 'a,a,b,b,c'", &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testArraySort_presorted)
@@ -0,0 +1,28 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+
+BEGIN_TEST(testGCParallelUnmark)
+{
+    CHECK_EQUAL(JS_GetGCParameter(rt, JSGC_PARALLEL_UNMARK_ENABLED), 0u);
+    JS_SetGCParameter(rt, JSGC_PARALLEL_UNMARK_ENABLED, 1);
+    CHECK_EQUAL(JS_GetGCParameter(rt, JSGC_PARALLEL_UNMARK_ENABLED), 1u);
+
+    JS::RootedValue v(cx);
+    EVAL("var obj = { a: [1, 2, 3], b: 'str' }; obj", &v);
+
+    JS_GC(rt);
+    JS_GC(rt);
+
+    EVAL("obj.a.length", &v);
+    CHECK(v.isInt32(3));
+
+    JS_SetGCParameter(rt, JSGC_PARALLEL_UNMARK_ENABLED, 0);
+    return true;
+}
+END_TEST(testGCParallelUnmark)
@@ -0,0 +1,160 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jit/JitOptions.h"
+
+#include "jsapi-tests/tests.h"
+
+// Turns on the lite Ion level, and synchronous Ion compilation so that the
+// scripts below run the code compiled for them, for the duration of a test.
+class AutoEnableIonLite
+{
+    JSRuntime* rt_;
+    bool saved_;
+
+  public:
+    explicit AutoEnableIonLite(JSRuntime* rt)
+      : rt_(rt), saved_(js::jit::js_JitOptions.ionLite)
+    {
+        rt_->options().setBaseline(true);
+        rt_->options().setIon(true);
+        JS_SetOffthreadIonCompilationEnabled(rt_, false);
+        js::jit::js_JitOptions.ionLite = true;
+    }
+
+    ~AutoEnableIonLite() {
+        js::jit::js_JitOptions.ionLite = saved_;
+        JS_SetOffthreadIonCompilationEnabled(rt_, true);
+    }
+};
+
+static const char assertEqSource[] =
+    "function assertEq(actual, expected) {\n"
+    "    if (actual !== expected && (actual === actual || expected === expected))\n"
+    "        throw new Error('got ' + actual + ', expected ' + expected);\n"
+    "}\n";
+
+// Scripts compiled at the lite level, which skips range analysis and
+// truncation, and recompiled at the normal level must keep computing the
+// same results, including when int32 arithmetic overflows.
+BEGIN_TEST(testJitLite_tierUp)
+{
+    AutoEnableIonLite lite(rt);
+    EXEC(assertEqSource);
+    EXEC("function mix(a, b) {\n"
+         "    var x = a * 31 + b;\n"
+         "    var y = (x | 0) + (a ^ b);\n"
+         "    return x + y;\n"
+         "}\n"
+         "function run(n) {\n"
+         "    var sum = 0;\n"
+         "    for (var i = 0; i < n; i++)\n"
+         "        sum = (sum + mix(i, n - i)) % 1000003;\n"
+         "    return sum;\n"
+         "}\n"
+         "function expected(n) {\n"
+         "    var sum = 0;\n"
+         "    for (var i = 0; i < n; i++) {\n"
+         "        var x = i * 31 + (n - i);\n"
+         "        var y = (x | 0) + (i ^ (n - i));\n"
+         "        sum = (sum + x + y) % 1000003;\n"
+         "    }\n"
+         "    return sum;\n"
+         "}\n"
+         "for (var n = 0; n < 1500; n++)\n"
+         "    assertEq(run(n % 50), expected(n % 50));\n"
+         "function grow(x) {\n"
+         "    return x * 65536 + 1;\n"
+         "}\n"
+         "for (var i = 0; i < 1500; i++) {\n"
+         "    assertEq(grow(i), i * 65536 + 1);\n"
+         "    assertEq(grow(32768 + i), (32768 + i) * 65536 + 1);\n"
+         "}\n");
+    return true;
+}
+END_TEST(testJitLite_tierUp)
+
+// Loops enter Ion through OSR at the lite warm-up threshold. Bailing out of
+// lite code, on a type change or an out-of-bounds read, must resume in
+// Baseline with the right state.
+BEGIN_TEST(testJitLite_osrBailout)
+{
+    AutoEnableIonLite lite(rt);
+    EXEC(assertEqSource);
+    EXEC("function sumArray(arr, n) {\n"
+         "    var total = 0;\n"
+         "    for (var i = 0; i < n; i++)\n"
+         "        total += arr[i % arr.length];\n"
+         "    return total;\n"
+         "}\n"
+         "var ints = [];\n"
+         "for (var i = 0; i < 100; i++)\n"
+         "    ints.push(i);\n"
+         "assertEq(sumArray(ints, 5000), 50 * 4950);\n"
+         "var mixed = ints.slice();\n"
+         "mixed[50] = 0.5;\n"
+         "assertEq(sumArray(mixed, 100), 4950 - 50 + 0.5);\n"
+         "mixed[10] = 'x';\n"
+         "assertEq(typeof sumArray(mixed, 100), 'string');\n"
+         "function readPast(arr) {\n"
+         "    var r = 0;\n"
+         "    for (var i = 0; i <= arr.length; i++)\n"
+         "        r += arr[i];\n"
+         "    return r;\n"
+         "}\n"
+         "for (var i = 0; i < 1500; i++)\n"
+         "    assertEq(readPast(ints), NaN);\n");
+    return true;
+}
+END_TEST(testJitLite_osrBailout)
+
+// The lite level only inlines small functions. A caller that hits that limit
+// while compiled at the lite level must still be inlined into its own callers
+// once they are recompiled at the normal level, and calls inlined at one
+// level and not the other must behave the same.
+BEGIN_TEST(testJitLite_inlining)
+{
+    AutoEnableIonLite lite(rt);
+    EXEC(assertEqSource);
+    EXEC("function small(x) {\n"
+         "    return x + 1;\n"
+         "}\n"
+         "function medium(x) {\n"
+         "    var r = small(x);\n"
+         "    for (var i = 0; i < 3; i++)\n"
+         "        r = small(r) * 2 - small(i);\n"
+         "    return r;\n"
+         "}\n"
+         "function polymorphic(o) {\n"
+         "    return o.f(3);\n"
+         "}\n"
+         "var objs = [\n"
+         "    { f: function(x) { return x * 2; } },\n"
+         "    { f: function(x) { return x + '!'; } },\n"
+         "    { f: small },\n"
+         "    { f: medium },\n"
+         "];\n"
+         "function medExpected(x) {\n"
+         "    var r = x + 1;\n"
+         "    for (var i = 0; i < 3; i++)\n"
+         "        r = (r + 1) * 2 - (i + 1);\n"
+         "    return r;\n"
+         "}\n"
+         "for (var i = 0; i < 3000; i++) {\n"
+         "    assertEq(small(i), i + 1);\n"
+         "    assertEq(medium(i), medExpected(i));\n"
+         "    var res = polymorphic(objs[i % objs.length]);\n"
+         "    switch (i % objs.length) {\n"
+         "      case 0: assertEq(res, 6); break;\n"
+         "      case 1: assertEq(res, '3!'); break;\n"
+         "      case 2: assertEq(res, 4); break;\n"
+         "      case 3: assertEq(res, medExpected(3)); break;\n"
+         "    }\n"
+         "}\n");
+    return true;
+}
+END_TEST(testJitLite_inlining)
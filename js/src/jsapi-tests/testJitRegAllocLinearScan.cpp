@@ -0,0 +1,67 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jit/JitOptions.h"
+
+#include "jsapi-tests/tests.h"
+
+using namespace js;
+using namespace js::jit;
+
+// Many values live across calls and fixed-register instructions (division,
+// shifts) force the linear scan allocator to evict and split repeatedly,
+// including minimal bundles, which need more than one round of evictions.
+BEGIN_TEST(testJitRegAllocLinearScan_pressure)
+{
+    JitOptions saved = js_JitOptions;
+    js_JitOptions.forcedRegisterAllocator = mozilla::Some(RegisterAllocator_LinearScan);
+    js_JitOptions.setEagerCompilation();
+    rt->options().setBaseline(true);
+    rt->options().setIon(true);
+    JS_SetOffthreadIonCompilationEnabled(rt, false);
+
+    JS::RootedValue v(cx);
+    bool ok = evaluate(
+        "function id(x) {\n"
+        "    return x;\n"
+        "}\n"
+        "function pressure(n) {\n"
+        "    var a = n + 1, b = n + 2, c = n + 3, d = n + 4, e = n + 5, f = n + 6;\n"
+        "    var g = n + 7, h = n + 8, i = n + 9, j = n + 10, k = n + 11, l = n + 12;\n"
+        "    var m = (a * b) % 7 + id(c);\n"
+        "    var o = (d << (e & 7)) / (f | 1);\n"
+        "    var p = id(g) + (h % (i | 1)) + (j >> (k & 3));\n"
+        "    var q = (l / (a | 1)) | 0;\n"
+        "    return a + b + c + d + e + f + g + h + i + j + k + l + m + o + p + q;\n"
+        "}\n"
+        "function expected(n) {\n"
+        "    var a = n + 1, b = n + 2, c = n + 3, d = n + 4, e = n + 5, f = n + 6;\n"
+        "    var g = n + 7, h = n + 8, i = n + 9, j = n + 10, k = n + 11, l = n + 12;\n"
+        "    var m = (a * b) % 7 + c;\n"
+        "    var o = (d << (e & 7)) / (f | 1);\n"
+        "    var p = g + (h % (i | 1)) + (j >> (k & 3));\n"
+        "    var q = (l / (a | 1)) | 0;\n"
+        "    return a + b + c + d + e + f + g + h + i + j + k + l + m + o + p + q;\n"
+        "}\n"
+        "var mismatches = 0;\n"
+        "for (var n = 0; n < 200; n++) {\n"
+        "    if (pressure(n) !== expected(n))\n"
+        "        mismatches++;\n"
+        "    if (pressure(n + 0.5) !== expected(n + 0.5))\n"
+        "        mismatches++;\n"
+        "}\n"
+        "mismatches;\n",
+        __FILE__, __LINE__, &v);
+
+    js_JitOptions = saved;
+    JS_SetOffthreadIonCompilationEnabled(rt, true);
+
+    CHECK(ok);
+    CHECK(v.isInt32(0));
+    return true;
+}
+END_TEST(testJitRegAllocLinearScan_pressure)
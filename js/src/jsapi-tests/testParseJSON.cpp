@@ -138,6 +138,28 @@ BEGIN_TEST(testParseJSON_success)
     CHECK(JS_GetProperty(cx, obj, "f", &v2));
     CHECK(v2.isInt32(17));
 
+    // Long strings with escapes and terminators at various offsets, to
+    // exercise the word-at-a-time scanner.
+    const char16_t longstr[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+                                 'a', 'b', 'c', 'd', 'e', 'f', '\n', 'x' };
+    str = NewString(cx, longstr);
+    CHECK(str);
+    expected = JS::StringValue(str);
+    CHECK(TryParse(cx, "\"0123456789abcdef\\nx\"", expected));
+    CHECK(TryParse(cx, "\"0123456789abcdef\\u000Ax\"", expected));
+
+    // Property names that share a property name cache slot.
+    CHECK(Parse(cx, "[{ \"axb\": 1, \"ayb\": 2 }, { \"axb\": 3, \"ayb\": 4 }]", &v));
+    CHECK(v.isObject());
+    obj = &v.toObject();
+    CHECK(JS_GetProperty(cx, obj, "1", &v2));
+    CHECK(v2.isObject());
+    obj = &v2.toObject();
+    CHECK(JS_GetProperty(cx, obj, "axb", &v2));
+    CHECK(v2.isInt32(3));
+    CHECK(JS_GetProperty(cx, obj, "ayb", &v2));
+    CHECK(v2.isInt32(4));
+
     return true;
 }
 
@@ -58,3 +58,39 @@ BEGIN_TEST(testGetRegExpSource)
     return true;
 }
 END_TEST(testGetRegExpSource)
+
+BEGIN_TEST(testRegExpByteCodeCache)
+{
+    JS::RuntimeOptions oldOptions = JS::RuntimeOptionsRef(rt);
+    JS::RuntimeOptionsRef(rt).setNativeRegExp(false);
+
+    JS::RootedValue val(cx);
+    bool match;
+    EVAL("/(a+)b/.exec('xaab')[1]", &val);
+    CHECK(JS_StringEqualsAscii(cx, val.toString(), "aa", &match) && match);
+
+    /* A second compartment reuses the bytecode compiled by the first. */
+    JS::CompartmentOptions options;
+    JS::RootedObject global2(cx, JS_NewGlobalObject(cx, getGlobalClass(), nullptr,
+                                                    JS::FireOnNewGlobalHook, options));
+    CHECK(global2);
+    {
+        JSAutoCompartment ac(cx, global2);
+        CHECK(JS_InitStandardClasses(cx, global2));
+        EVAL("/(a+)b/.exec('aaab')[1]", &val);
+        CHECK(JS_StringEqualsAscii(cx, val.toString(), "aaa", &match) && match);
+        EVAL("/(a+)b/i.exec('AAB')[1]", &val);
+        CHECK(JS_StringEqualsAscii(cx, val.toString(), "AA", &match) && match);
+    }
+
+    /* Entries don't outlive their pattern atoms, and a shrinking GC empties the cache. */
+    JS_GC(rt);
+    JS::PrepareForFullGC(rt);
+    JS::GCForReason(rt, GC_SHRINK, JS::gcreason::API);
+    EVAL("/(a+)b/.test('ab')", &val);
+    CHECK(val.isTrue());
+
+    JS::RuntimeOptionsRef(rt) = oldOptions;
+    return true;
+}
+END_TEST(testRegExpByteCodeCache)
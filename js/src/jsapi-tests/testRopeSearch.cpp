@@ -0,0 +1,81 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+#include "vm/String.h"
+
+BEGIN_TEST(testRopeSearch)
+{
+    JS::RootedString left(cx, JS_NewStringCopyZ(cx, "0123456789abcdefghijklmnopqrstuv"));
+    JS::RootedString right(cx, JS_NewStringCopyZ(cx, "wxyz0123456789ABCDEFGHIJKLMNOPQR"));
+    CHECK(left && right);
+
+    JS::RootedString rope(cx, JS_ConcatStrings(cx, left, right));
+    CHECK(rope);
+    CHECK(rope->isRope());
+
+    JS::RootedValue v(cx, JS::StringValue(rope));
+    CHECK(JS_SetProperty(cx, global, "rope", v));
+
+    // A single search, including one that spans both children and one that
+    // starts past the first match, leaves the rope unflattened.
+    EVAL("rope.indexOf('uvwxyz')", &v);
+    CHECK(v.isInt32(30));
+    CHECK(rope->isRope());
+
+    // Searching the same rope again flattens it; results don't change.
+    EVAL("rope.indexOf('0123', 1)", &v);
+    CHECK(v.isInt32(36));
+    EVAL("rope.includes('QR', 40) && !rope.includes('01', 40) && rope.indexOf('R', 64) == -1", &v);
+    CHECK(v.isTrue());
+    CHECK(!rope->isRope());
+
+    return true;
+}
+END_TEST(testRopeSearch)
+
+// indexOf and includes with a start position on fresh ropes agree with the
+// same searches on the flat string, including matches that straddle leaves
+// and starts inside or past the first leaf.
+BEGIN_TEST(testRopeSearch_start)
+{
+    JS::RootedValue v(cx);
+    EVAL("var parts = ['0123456789abcdefghijklmnopqrstuv',\n"
+         "             'wxyz0123456789ABCDEFGHIJKLMNOPQR',\n"
+         "             '\\u1234abc0123',\n"
+         "             'xyz'];\n"
+         "function makeRope() {\n"
+         "    var s = parts[0];\n"
+         "    for (var i = 1; i < parts.length; i++)\n"
+         "        s = s + parts[i];\n"
+         "    return s;\n"
+         "}\n"
+         "var flat = parts.join('');\n"
+         "var patterns = ['0123', 'uvwx', 'vwxyz0', 'R\\u1234a', '123x', 'z', '', 'notthere'];\n"
+         "var mismatches = 0;\n"
+         "for (var p of patterns) {\n"
+         "    for (var start = 0; start <= flat.length + 1; start++) {\n"
+         "        if (makeRope().indexOf(p, start) !== flat.indexOf(p, start))\n"
+         "            mismatches++;\n"
+         "        if (makeRope().includes(p, start) !== flat.includes(p, start))\n"
+         "            mismatches++;\n"
+         "    }\n"
+         "}\n"
+         "mismatches;\n",
+         &v);
+    CHECK(v.isInt32(0));
+
+    // Searching the same rope repeatedly, which flattens it.
+    EVAL("var rope = makeRope();\n"
+         "rope.indexOf('0123', 1) === 36 && rope.indexOf('0123', 37) === 68 &&\n"
+         "rope.includes('QR', 40) && !rope.includes('01', 72);\n",
+         &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testRopeSearch_start)
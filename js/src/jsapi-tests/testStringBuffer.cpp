@@ -27,3 +27,37 @@ BEGIN_TEST(testStringBuffer_finishString)
     return true;
 }
 END_TEST(testStringBuffer_finishString)
+
+BEGIN_TEST(testStringBuffer_segmented)
+{
+    const size_t SegmentLength = js::SegmentedStringBuffer::SegmentLength;
+    const size_t length = 3 * SegmentLength + 5;
+    const size_t twoByteIndex = SegmentLength + 7;
+
+    js::SegmentedStringBuffer buffer(cx);
+    CHECK(buffer.empty());
+    for (size_t i = 0; i < length; i++) {
+        char16_t c = (i == twoByteIndex) ? char16_t(0x263A) : char16_t('a' + i % 26);
+        CHECK(buffer.append(c));
+        CHECK(buffer.maybeFlushSegment());
+    }
+    CHECK(!buffer.empty());
+
+    JS::RootedString str(cx, buffer.finishString());
+    CHECK(str);
+    CHECK_EQUAL(JS_GetStringLength(str), length);
+
+    for (size_t i = 0; i < length; i += 997) {
+        char16_t c;
+        CHECK(JS_GetStringCharAt(cx, str, i, &c));
+        CHECK(c == ((i == twoByteIndex) ? char16_t(0x263A) : char16_t('a' + i % 26)));
+    }
+
+    char16_t c;
+    CHECK(JS_GetStringCharAt(cx, str, twoByteIndex, &c));
+    CHECK(c == char16_t(0x263A));
+    CHECK(JS_GetStringCharAt(cx, str, twoByteIndex + SegmentLength, &c));
+    CHECK(c == char16_t('a' + (twoByteIndex + SegmentLength) % 26));
+    return true;
+}
+END_TEST(testStringBuffer_segmented)
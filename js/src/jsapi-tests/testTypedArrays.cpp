@@ -190,3 +190,30 @@ TestArrayFromBuffer(JSContext* cx)
 }
 
 END_TEST(testTypedArrays)
+
+BEGIN_TEST(testTypedArrayFill)
+{
+    JS::RootedValue v(cx);
+
+    // The fill value is converted once, before the range arguments.
+    EVAL("var calls = 0;\n"
+         "var a = new Int16Array(8);\n"
+         "a.fill({ valueOf() { calls++; return 70000; } }, -0, 6);\n"
+         "calls === 1 && a[0] === 4464 && a[5] === 4464 && a[6] === 0", &v);
+    CHECK(v.isTrue());
+
+    EVAL("var c = new Uint8ClampedArray(5).fill(300.5, 1);\n"
+         "c.join()", &v);
+    JSString* str = v.toString();
+    bool match;
+    CHECK(JS_StringEqualsAscii(cx, str, "0,255,255,255,255", &match));
+    CHECK(match);
+
+    EVAL("Array.prototype.join.call(new Float32Array(3).fill(NaN, 0, 2))", &v);
+    str = v.toString();
+    CHECK(JS_StringEqualsAscii(cx, str, "NaN,NaN,0", &match));
+    CHECK(match);
+
+    return true;
+}
+END_TEST(testTypedArrayFill)
@@ -78,6 +78,7 @@
 #include "vm/Runtime.h"
 #include "vm/SavedStacks.h"
 #include "vm/ScopeObject.h"
+#include "vm/SelfHosting.h"
 #include "vm/Shape.h"
 #include "vm/StopIterationObject.h"
 #include "vm/StringBuffer.h"
@@ -630,6 +631,8 @@ JS_ShutDown(void)
 
     DestroyHelperThreadsState();
 
+    FreeSelfHostedXDR();
+
 #ifdef JS_TRACE_LOGGING
     DestroyTraceLoggerThreadState();
     DestroyTraceLoggerGraphState();
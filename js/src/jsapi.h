@@ -1835,7 +1835,32 @@ typedef enum JSGCParamKey {
     JSGC_MAX_EMPTY_CHUNK_COUNT = 22,
 
     /* Whether compacting GC is enabled. */
-    JSGC_COMPACTING_ENABLED = 23
+    JSGC_COMPACTING_ENABLED = 23,
+
+    /*
+     * Whether clearing the mark bitmaps of the zones being collected, at the
+     * start of the mark phase, is split across helper threads. Marking itself
+     * is always done on the main thread. Off by default.
+     */
+    JSGC_PARALLEL_UNMARK_ENABLED = 24,
+
+    /*
+     * Nursery promotion rate, in percent, above which a minor GC grows the
+     * nursery.
+     */
+    JSGC_NURSERY_GROW_THRESHOLD = 25,
+
+    /*
+     * Nursery promotion rate, in percent, below which a minor GC shrinks the
+     * nursery.
+     */
+    JSGC_NURSERY_SHRINK_THRESHOLD = 26,
+
+    /*
+     * Percentage of free cell space in a zone's relocatable arenas above
+     * which the periodic GC compacts that zone. Zero disables this.
+     */
+    JSGC_COMPACTING_FREE_CELL_THRESHOLD = 27
 } JSGCParamKey;
 
 extern JS_PUBLIC_API(void)
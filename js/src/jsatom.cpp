@@ -333,6 +333,13 @@ AtomizeAndCopyChars(ExclusiveContext* cx, const CharT* tbchars, size_t length, P
             return pp->asPtr();
     }
 
+    // Pinning has to update the table entry, so it always takes the lock.
+    AtomizeCache* cache = pin == DoNotPinAtom ? cx->maybeAtomizeCache() : nullptr;
+    if (cache) {
+        if (JSAtom* atom = cache->lookup(lookup))
+            return atom;
+    }
+
     AutoLockForExclusiveAccess lock(cx);
 
     AtomSet& atoms = cx->atoms();
@@ -340,6 +347,8 @@ AtomizeAndCopyChars(ExclusiveContext* cx, const CharT* tbchars, size_t length, P
     if (p) {
         JSAtom* atom = p->asPtr();
         p->setPinned(bool(pin));
+        if (cache)
+            cache->put(lookup.hash, atom);
         return atom;
     }
 
@@ -364,6 +373,8 @@ AtomizeAndCopyChars(ExclusiveContext* cx, const CharT* tbchars, size_t length, P
         return nullptr;
     }
 
+    if (cache)
+        cache->put(lookup.hash, atom);
     return atom;
 }
 
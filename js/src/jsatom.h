@@ -8,6 +8,7 @@
 #define jsatom_h
 
 #include "mozilla/HashFunctions.h"
+#include "mozilla/PodOperations.h"
 
 #include "jsalloc.h"
 
@@ -136,6 +137,44 @@ public:
     AtomSet::Range all() const { return mSet->all(); }
 };
 
+// Small direct-mapped cache of recently atomized strings, private to a single
+// helper thread context. Hits are answered without taking the exclusive
+// access lock, so several off thread parses can atomize the identifiers they
+// see over and over without serializing on the runtime's atoms table.
+//
+// Atoms are never collected while exclusive threads are present (see
+// JSRuntime::keepAtoms), so the cached pointers stay valid for as long as the
+// owning context is in use.
+class AtomizeCache
+{
+    static const size_t NumEntries = 512;
+
+    struct Entry
+    {
+        HashNumber hash;
+        JSAtom* atom;
+    };
+
+    Entry entries[NumEntries];
+
+    static size_t index(HashNumber hash) {
+        return hash & (NumEntries - 1);
+    }
+
+  public:
+    AtomizeCache() {
+        mozilla::PodArrayZero(entries);
+    }
+
+    inline JSAtom* lookup(const AtomHasher::Lookup& lookup);
+
+    void put(HashNumber hash, JSAtom* atom) {
+        Entry& e = entries[index(hash)];
+        e.hash = hash;
+        e.atom = atom;
+    }
+};
+
 class PropertyName;
 
 }  /* namespace js */
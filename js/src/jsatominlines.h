@@ -180,6 +180,15 @@ AtomHasher::match(const AtomStateEntry& entry, const Lookup& lookup)
     return mozilla::PodEqual(keyChars, lookup.twoByteChars, lookup.length);
 }
 
+inline JSAtom*
+AtomizeCache::lookup(const AtomHasher::Lookup& lookup)
+{
+    Entry& e = entries[index(lookup.hash)];
+    if (e.atom && e.hash == lookup.hash && AtomHasher::match(AtomStateEntry(e.atom, false), lookup))
+        return e.atom;
+    return nullptr;
+}
+
 inline Handle<PropertyName*>
 TypeName(JSType type, const JSAtomState& names)
 {
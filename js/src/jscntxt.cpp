@@ -934,10 +934,28 @@ ExclusiveContext::ExclusiveContext(JSRuntime* rt, PerThreadData* pt, ContextKind
     contextKind_(kind),
     perThreadData(pt),
     arenas_(nullptr),
-    enterCompartmentDepth_(0)
+    enterCompartmentDepth_(0),
+    atomizeCache_(nullptr)
 {
 }
 
+ExclusiveContext::~ExclusiveContext()
+{
+    js_delete(atomizeCache_);
+}
+
+AtomizeCache*
+ExclusiveContext::maybeAtomizeCache()
+{
+    // The main thread's atoms may be collected by any GC, so only helper
+    // thread contexts can hold on to atom pointers this way.
+    if (isJSContext())
+        return nullptr;
+    if (!atomizeCache_)
+        atomizeCache_ = js_new<AtomizeCache>();
+    return atomizeCache_;
+}
+
 void
 ExclusiveContext::recoverFromOutOfMemory()
 {
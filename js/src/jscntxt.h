@@ -114,6 +114,7 @@ class ExclusiveContext : public ContextFriendFields,
     PerThreadData* perThreadData;
 
     ExclusiveContext(JSRuntime* rt, PerThreadData* pt, ContextKind kind);
+    ~ExclusiveContext();
 
     bool isJSContext() const {
         return contextKind_ == Context_JS;
@@ -237,6 +238,13 @@ class ExclusiveContext : public ContextFriendFields,
     void setHelperThread(HelperThread* helperThread);
     HelperThread* helperThread() const { return helperThread_; }
 
+  private:
+    // Lazily created, and only for contexts running off the main thread.
+    AtomizeCache* atomizeCache_;
+
+  public:
+    AtomizeCache* maybeAtomizeCache();
+
     // Threads with an ExclusiveContext may freely access any data in their
     // compartment and zone.
     JSCompartment* compartment() const {
@@ -1549,33 +1549,33 @@ JSFunction::createScriptForLazilyInterpretedFunction(JSContext* cx, HandleFuncti
     return cx->runtime()->cloneSelfHostedFunctionScript(cx, funName, fun);
 }
 
-void
+bool
 JSFunction::maybeRelazify(JSRuntime* rt)
 {
     // Try to relazify functions with a non-lazy script. Note: functions can be
     // marked as interpreted despite having no script yet at some points when
     // parsing.
     if (!hasScript() || !u.i.s.script_)
-        return;
+        return false;
 
     // Don't relazify functions in compartments that are active.
     JSCompartment* comp = compartment();
     if (comp->hasBeenEntered() && !rt->allowRelazificationForTesting)
-        return;
+        return false;
 
     // Don't relazify if the compartment is being debugged or is the
     // self-hosting compartment.
     if (comp->isDebuggee() || comp->isSelfHosting)
-        return;
+        return false;
 
     // Don't relazify functions with JIT code.
     if (!u.i.s.script_->isRelazifiable())
-        return;
+        return false;
 
     // To delazify self-hosted builtins we need the name of the function
     // to clone. This name is stored in the first extended slot.
     if (isSelfHostedBuiltin() && !isExtended())
-        return;
+        return false;
 
     JSScript* script = nonLazyScript();
 
@@ -1590,6 +1590,7 @@ JSFunction::maybeRelazify(JSRuntime* rt)
         MOZ_ASSERT(isExtended());
         MOZ_ASSERT(getExtendedSlot(LAZY_FUNCTION_NAME_SLOT).toString()->isAtom());
     }
+    return true;
 }
 
 /* ES5 15.3.4.5.1 and 15.3.4.5.2. */
@@ -349,7 +349,8 @@ class JSFunction : public js::NativeObject
     static inline size_t offsetOfAtom() { return offsetof(JSFunction, atom_); }
 
     static bool createScriptForLazilyInterpretedFunction(JSContext* cx, js::HandleFunction fun);
-    void maybeRelazify(JSRuntime* rt);
+    // Returns whether the function was relazified.
+    bool maybeRelazify(JSRuntime* rt);
 
     // Function Scripts
     //
@@ -224,6 +224,7 @@
 #include "proxy/DeadObjectProxy.h"
 #include "vm/Debugger.h"
 #include "vm/ProxyObject.h"
+#include "vm/RegExpObject.h"
 #include "vm/Shape.h"
 #include "vm/String.h"
 #include "vm/Symbol.h"
@@ -351,8 +352,7 @@ static const AllocKind IncrementalPhaseStrings[] = {
 };
 
 static const AllocKind IncrementalPhaseScripts[] = {
-    AllocKind::SCRIPT,
-    AllocKind::LAZY_SCRIPT
+    AllocKind::SCRIPT
 };
 
 static const AllocKind IncrementalPhaseJitCode[] = {
@@ -380,6 +380,16 @@ static const AllocKind BackgroundPhaseObjects[] = {
     AllocKind::OBJECT16_BACKGROUND
 };
 
+/*
+ * JSScript::finalize clears the script pointer of its LazyScript, so lazy
+ * scripts must outlive the foreground script phase. A zone group is only
+ * queued for background sweeping once all of its incrementally swept kinds
+ * have been finalized, which guarantees this.
+ */
+static const AllocKind BackgroundPhaseScripts[] = {
+    AllocKind::LAZY_SCRIPT
+};
+
 static const AllocKind BackgroundPhaseStringsAndSymbols[] = {
     AllocKind::FAT_INLINE_STRING,
     AllocKind::STRING,
@@ -395,6 +405,7 @@ static const AllocKind BackgroundPhaseShapes[] = {
 
 static const FinalizePhase BackgroundFinalizePhases[] = {
     PHASE(BackgroundPhaseObjects, gcstats::PHASE_SWEEP_OBJECT),
+    PHASE(BackgroundPhaseScripts, gcstats::PHASE_SWEEP_SCRIPT),
     PHASE(BackgroundPhaseStringsAndSymbols, gcstats::PHASE_SWEEP_STRING),
     PHASE(BackgroundPhaseShapes, gcstats::PHASE_SWEEP_SHAPE)
 };
@@ -1157,6 +1168,7 @@ GCRuntime::GCRuntime(JSRuntime* rt) :
     incrementalAllowed(true),
     generationalDisabled(0),
     compactingEnabled(true),
+    parallelUnmarkEnabled(false),
     compactingDisabledCount(0),
     manipulatingDeadZones(false),
     objectsMarkedInDeadZones(0),
@@ -1422,6 +1434,15 @@ GCRuntime::setParameter(JSGCParamKey key, uint32_t value)
       case JSGC_COMPACTING_ENABLED:
         compactingEnabled = value != 0;
         break;
+      case JSGC_PARALLEL_UNMARK_ENABLED:
+        parallelUnmarkEnabled = value != 0;
+        break;
+      case JSGC_NURSERY_GROW_THRESHOLD:
+        nursery.setGrowThreshold(value);
+        break;
+      case JSGC_NURSERY_SHRINK_THRESHOLD:
+        nursery.setShrinkThreshold(value);
+        break;
       default:
         tunables.setParameter(key, value);
         for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next()) {
@@ -1487,6 +1508,10 @@ GCSchedulingTunables::setParameter(JSGCParamKey key, uint32_t value)
             minEmptyChunkCount_ = maxEmptyChunkCount_;
         MOZ_ASSERT(maxEmptyChunkCount_ >= minEmptyChunkCount_);
         break;
+      case JSGC_COMPACTING_FREE_CELL_THRESHOLD:
+        MOZ_ASSERT(value <= 100);
+        compactingFreeCellThreshold_ = value;
+        break;
       default:
         MOZ_CRASH("Unknown GC parameter.");
     }
@@ -1542,8 +1567,16 @@ GCRuntime::getParameter(JSGCParamKey key, const AutoLockGC& lock)
         return tunables.minEmptyChunkCount();
       case JSGC_MAX_EMPTY_CHUNK_COUNT:
         return tunables.maxEmptyChunkCount();
+      case JSGC_COMPACTING_FREE_CELL_THRESHOLD:
+        return tunables.compactingFreeCellThreshold();
       case JSGC_COMPACTING_ENABLED:
         return compactingEnabled;
+      case JSGC_PARALLEL_UNMARK_ENABLED:
+        return parallelUnmarkEnabled;
+      case JSGC_NURSERY_GROW_THRESHOLD:
+        return nursery.growThreshold();
+      case JSGC_NURSERY_SHRINK_THRESHOLD:
+        return nursery.shrinkThreshold();
       default:
         MOZ_ASSERT(key == JSGC_NUMBER);
         return uint32_t(number);
@@ -1906,6 +1939,25 @@ CanRelocateAllocKind(AllocKind kind)
     return IsObjectAllocKind(kind);
 }
 
+void
+ArenaLists::countRelocatableCellBytes(size_t* freeBytes, size_t* totalBytes)
+{
+    *freeBytes = 0;
+    *totalBytes = 0;
+    for (auto i : AllAllocKinds()) {
+        if (!CanRelocateAllocKind(i))
+            continue;
+
+        MOZ_ASSERT(backgroundFinalizeState[i] == BFS_DONE);
+        size_t thingSize = Arena::thingSize(i);
+        size_t arenaBytes = Arena::thingsPerArena(thingSize) * thingSize;
+        for (ArenaHeader* aheader = arenaLists[i].head(); aheader; aheader = aheader->next) {
+            *freeBytes += aheader->countFreeCells() * thingSize;
+            *totalBytes += arenaBytes;
+        }
+    }
+}
+
 size_t ArenaHeader::countFreeCells()
 {
     size_t count = 0;
@@ -2661,6 +2713,8 @@ GCRuntime::updatePointersToRelocatedCells(Zone* zone)
     // TODO: Should possibly just call purgeRuntime() here.
     rt->newObjectCache.purge();
     rt->nativeIterCache.purge();
+    rt->propertyLookupCache.purge();
+    rt->lastSearchedRope = nullptr;
 
     // Call callbacks to get the rest of the system to fixup other untraced pointers.
     callWeakPointerCallbacks();
@@ -3198,6 +3252,33 @@ GCRuntime::maybeGC(Zone* zone)
     return false;
 }
 
+/*
+ * Schedule every zone whose relocatable arenas are mostly free space for a
+ * GC. Running a shrinking GC over just these zones compacts them without
+ * paying for a full GC. Returns whether any zone was scheduled.
+ */
+bool
+GCRuntime::prepareFragmentedZonesForGC()
+{
+    unsigned threshold = tunables.compactingFreeCellThreshold();
+    if (!threshold || !isCompactingGCEnabled() || isBackgroundSweeping())
+        return false;
+
+    bool anyScheduled = false;
+    for (ZonesIter zone(rt, SkipAtoms); !zone.done(); zone.next()) {
+        if (!CanRelocateZone(zone) || zone->usage.gcBytes() < 1024 * 1024)
+            continue;
+
+        size_t freeBytes, totalBytes;
+        zone->arenas.countRelocatableCellBytes(&freeBytes, &totalBytes);
+        if (totalBytes && freeBytes * 100 > totalBytes * threshold) {
+            PrepareZoneForGC(zone);
+            anyScheduled = true;
+        }
+    }
+    return anyScheduled;
+}
+
 void
 GCRuntime::maybePeriodicFullGC()
 {
@@ -3218,6 +3299,8 @@ GCRuntime::maybePeriodicFullGC()
         {
             JS::PrepareForFullGC(rt);
             startGC(GC_SHRINK, JS::gcreason::PERIODIC_FULL_GC);
+        } else if (prepareFragmentedZonesForGC()) {
+            startGC(GC_SHRINK, JS::gcreason::FRAGMENTED_ZONES);
         } else {
             nextFullGCTime = now + GC_IDLE_FULL_SPAN;
         }
@@ -3706,9 +3789,16 @@ GCRuntime::purgeRuntime()
     rt->scopeCoordinateNameCache.purge();
     rt->newObjectCache.purge();
     rt->nativeIterCache.purge();
+    rt->propertyLookupCache.purge();
+    rt->lastSearchedRope = nullptr;
     rt->uncompressedSourceCache.purge();
     rt->evalCache.clear();
 
+    if (invocationKind == GC_SHRINK) {
+        if (RegExpByteCodeCache* cache = rt->maybeGetRegExpByteCodeCache())
+            cache->purge();
+    }
+
     if (!rt->hasActiveCompilations())
         rt->parseMapPool().purgeAll();
 }
@@ -3724,8 +3814,13 @@ GCRuntime::shouldPreserveJITCode(JSCompartment* comp, int64_t currentTime,
         return true;
     if (comp->preserveJitCode())
         return true;
-    if (comp->lastAnimationTime + PRMJ_USEC_PER_SEC >= currentTime)
+    // A hidden page is idle even if it was animating up to a moment ago:
+    // discard its code so its functions can be relazified.
+    if (comp->lastAnimationTime + PRMJ_USEC_PER_SEC >= currentTime &&
+        reason != JS::gcreason::PAGE_HIDE)
+    {
         return true;
+    }
     if (reason == JS::gcreason::DEBUG_GC)
         return true;
 
@@ -3815,7 +3910,7 @@ GCRuntime::checkForCompartmentMismatches()
 #endif
 
 static void
-RelazifyFunctions(Zone* zone, AllocKind kind)
+RelazifyFunctions(Zone* zone, AllocKind kind, gcstats::Statistics& stats)
 {
     MOZ_ASSERT(kind == AllocKind::FUNCTION ||
                kind == AllocKind::FUNCTION_EXTENDED);
@@ -3824,9 +3919,103 @@ RelazifyFunctions(Zone* zone, AllocKind kind)
 
     for (ZoneCellIterUnderGC i(zone, kind); !i.done(); i.next()) {
         JSFunction* fun = &i.get<JSObject>()->as<JSFunction>();
-        if (fun->hasScript())
-            fun->maybeRelazify(rt);
+        if (fun->hasScript()) {
+            if (fun->maybeRelazify(rt)) {
+                stats.count(gcstats::STAT_RELAZIFIED_FUNCTIONS);
+                stats.count(gcstats::STAT_LAZY_FUNCTIONS);
+            } else {
+                stats.count(gcstats::STAT_COMPILED_FUNCTIONS);
+            }
+        } else if (fun->isInterpretedLazy()) {
+            stats.count(gcstats::STAT_LAZY_FUNCTIONS);
+        }
+    }
+}
+
+namespace js {
+namespace gc {
+
+/*
+ * Clears the mark bits of every |stride|th zone being collected, starting
+ * with the zone at |index|. Each arena owns a disjoint range of bitmap words,
+ * so tasks covering different zones never write to the same memory, even
+ * when their arenas share a chunk.
+ */
+class UnmarkZonesTask : public GCParallelTask
+{
+    // The zone list is collected on the main thread: the zone iterators use
+    // main-thread-only runtime accessors and must not be used from here.
+    const ZoneVector* zones_;
+    size_t index_;
+    size_t stride_;
+
+    virtual void run() override;
+
+  public:
+    UnmarkZonesTask() : zones_(nullptr), index_(0), stride_(1) {}
+    ~UnmarkZonesTask() override { join(); }
+
+    void init(const ZoneVector* zones, size_t index, size_t stride) {
+        zones_ = zones;
+        index_ = index;
+        stride_ = stride;
     }
+};
+
+/* virtual */ void
+UnmarkZonesTask::run()
+{
+    for (size_t i = index_; i < zones_->length(); i += stride_)
+        (*zones_)[i]->arenas.unmarkAll();
+}
+
+} // namespace gc
+} // namespace js
+
+/*
+ * Clear the mark bitmaps of the zones being collected using the helper
+ * threads. Time spent by each task is accounted to PHASE_UNMARK as parallel
+ * time when it is joined. Returns false, having done nothing, if we run out of
+ * memory building the zone list; the caller then unmarks on the main thread.
+ */
+bool
+GCRuntime::unmarkCollectedZonesParallel()
+{
+    ZoneVector zones;
+    for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
+        if (!zones.append(zone.get()))
+            return false;
+    }
+
+    const size_t maxTasks = 8;
+    size_t taskCount = Min(Max(HelperThreadState().threadCount, size_t(1)), maxTasks);
+
+    // The main thread takes the last share of zones itself.
+    size_t stride = taskCount + 1;
+    UnmarkZonesTask bgTasks[maxTasks];
+    UnmarkZonesTask fgTask;
+
+    {
+        AutoLockHelperThreadState lock;
+        for (size_t i = 0; i < taskCount; i++) {
+            bgTasks[i].init(&zones, i, stride);
+            startTask(bgTasks[i], gcstats::PHASE_UNMARK);
+        }
+    }
+
+    {
+        gcstats::AutoPhase ap(stats, gcstats::PHASE_UNMARK);
+        fgTask.init(&zones, taskCount, stride);
+        fgTask.runFromMainThread(rt);
+    }
+
+    {
+        AutoLockHelperThreadState lock;
+        for (size_t i = 0; i < taskCount; i++)
+            joinTask(bgTasks[i], gcstats::PHASE_UNMARK);
+    }
+
+    return true;
 }
 
 bool
@@ -3932,8 +4121,8 @@ GCRuntime::beginMarkPhase(JS::gcreason::Reason reason)
      */
     for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
         gcstats::AutoPhase ap(stats, gcstats::PHASE_RELAZIFY_FUNCTIONS);
-        RelazifyFunctions(zone, AllocKind::FUNCTION);
-        RelazifyFunctions(zone, AllocKind::FUNCTION_EXTENDED);
+        RelazifyFunctions(zone, AllocKind::FUNCTION, stats);
+        RelazifyFunctions(zone, AllocKind::FUNCTION_EXTENDED, stats);
     }
 
     startNumber = number;
@@ -3957,12 +4146,16 @@ GCRuntime::beginMarkPhase(JS::gcreason::Reason reason)
      */
     gcstats::AutoPhase ap1(stats, gcstats::PHASE_MARK);
 
+    /* Unmark everything in the zones being collected. */
+    bool unmarkInParallel = parallelUnmarkEnabled && CanUseExtraThreads() &&
+                            unmarkCollectedZonesParallel();
+
     {
         gcstats::AutoPhase ap(stats, gcstats::PHASE_UNMARK);
 
-        for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
-            /* Unmark everything in the zones being collected. */
-            zone->arenas.unmarkAll();
+        if (!unmarkInParallel) {
+            for (GCZonesIter zone(rt); !zone.done(); zone.next())
+                zone->arenas.unmarkAll();
         }
 
         for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
@@ -5088,6 +5281,8 @@ GCRuntime::beginSweepingZoneGroup()
     if (sweepingAtoms) {
         gcstats::AutoPhase ap(stats, gcstats::PHASE_SWEEP_SYMBOL_REGISTRY);
         rt->symbolRegistry().sweep();
+        if (RegExpByteCodeCache* cache = rt->maybeGetRegExpByteCodeCache())
+            cache->sweep();
     }
 
     // Rejoin our off-main-thread tasks.
@@ -5604,6 +5799,11 @@ GCRuntime::finishCollection(JS::gcreason::Reason reason)
         // Ensure excess chunks are returns to the system and free arenas
         // decommitted.
         shrinkBuffers();
+
+        // The nursery was evicted at the start of this GC, so drop it back
+        // to its smallest size unless something has allocated in it since.
+        // It will grow again if the runtime becomes active.
+        nursery.shrinkAllocableSpaceToMinimum();
     }
 
     lastGCTime = currentTime;
@@ -126,7 +126,7 @@ IsBackgroundFinalized(AllocKind kind)
         false,     /* AllocKind::OBJECT16 */
         true,      /* AllocKind::OBJECT16_BACKGROUND */
         false,     /* AllocKind::SCRIPT */
-        false,     /* AllocKind::LAZY_SCRIPT */
+        true,      /* AllocKind::LAZY_SCRIPT */
         true,      /* AllocKind::SHAPE */
         true,      /* AllocKind::ACCESSOR_SHAPE */
         true,      /* AllocKind::BASE_SHAPE */
@@ -677,6 +677,13 @@ class ArenaLists
         return true;
     }
 
+    /*
+     * Sum up the cell space of this zone's relocatable arenas and how much of
+     * it is free. Arenas that are currently being allocated from are counted
+     * as full.
+     */
+    void countRelocatableCellBytes(size_t* freeBytes, size_t* totalBytes);
+
     void unmarkAll() {
         for (auto i : AllAllocKinds()) {
             /* The background finalization must have stopped at this point. */
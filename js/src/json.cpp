@@ -131,16 +131,27 @@ namespace {
 class StringifyContext
 {
   public:
-    StringifyContext(JSContext* cx, StringBuffer& sb, const StringBuffer& gap,
-                     HandleObject replacer, const AutoIdVector& propertyList)
+    StringifyContext(JSContext* cx, StringBuffer& sb, SegmentedStringBuffer* segmented,
+                     const StringBuffer& gap, HandleObject replacer,
+                     const AutoIdVector& propertyList)
       : sb(sb),
+        segmented(segmented),
         gap(gap),
         replacer(cx, replacer),
         propertyList(propertyList),
         depth(0)
     {}
 
+    /*
+     * Called between array elements and object members, where the output
+     * written so far can be moved out of |sb| if it is segmented.
+     */
+    bool maybeFlushSegment() {
+        return !segmented || segmented->maybeFlushSegment();
+    }
+
     StringBuffer& sb;
+    SegmentedStringBuffer* const segmented;
     const StringBuffer& gap;
     RootedObject replacer;
     const AutoIdVector& propertyList;
@@ -151,6 +162,17 @@ class StringifyContext
 
 static bool Str(JSContext* cx, const Value& v, StringifyContext* scx);
 
+/* ES5 15.12.3 Str, step 9. */
+static inline bool
+WriteNumber(JSContext* cx, const Value& v, StringBuffer& sb)
+{
+    MOZ_ASSERT(v.isNumber());
+    if (v.isDouble() && !IsFinite(v.toDouble()))
+        return sb.append("null");
+
+    return NumberValueToStringBuffer(cx, v, sb);
+}
+
 static bool
 WriteIndent(JSContext* cx, StringifyContext* scx, uint32_t limit)
 {
@@ -379,7 +401,8 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
         if (!Quote(cx, scx->sb, s) ||
             !scx->sb.append(':') ||
             !(scx->gap.empty() || scx->sb.append(' ')) ||
-            !Str(cx, outputValue, scx))
+            !Str(cx, outputValue, scx) ||
+            !scx->maybeFlushSegment())
         {
             return false;
         }
@@ -391,6 +414,12 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
     return scx->sb.append('}');
 }
 
+static inline bool
+IsDenseNumberElement(ArrayObject& arr, uint32_t index)
+{
+    return index < arr.getDenseInitializedLength() && arr.getDenseElement(index).isNumber();
+}
+
 /* ES5 15.12.3 JA. */
 static bool
 JA(JSContext* cx, HandleObject obj, StringifyContext* scx)
@@ -429,27 +458,43 @@ JA(JSContext* cx, HandleObject obj, StringifyContext* scx)
         if (!WriteIndent(cx, scx, scx->depth))
             return false;
 
+        /*
+         * Numbers stored in the dense elements of an array have no toJSON
+         * method and need no preprocessing unless there is a replacer
+         * function, so they can be written out directly.
+         */
+        bool numberFastPath = obj->is<ArrayObject>() &&
+                              !(scx->replacer && scx->replacer->isCallable());
+
         /* Steps 7-10. */
         RootedValue outputValue(cx);
         for (uint32_t i = 0; i < length; i++) {
-            /*
-             * Steps 8a-8c.  Again note how the call to the spec's Str method
-             * is broken up into getting the property, running it past toJSON
-             * and the replacer and maybe unboxing, and interpreting some
-             * values as |null| in separate steps.
-             */
-            if (!GetElement(cx, obj, obj, i, &outputValue))
-                return false;
-            if (!PreprocessValue(cx, obj, i, &outputValue, scx))
-                return false;
-            if (IsFilteredValue(outputValue)) {
-                if (!scx->sb.append("null"))
+            if (numberFastPath && IsDenseNumberElement(obj->as<ArrayObject>(), i)) {
+                if (!WriteNumber(cx, obj->as<ArrayObject>().getDenseElement(i), scx->sb))
                     return false;
             } else {
-                if (!Str(cx, outputValue, scx))
+                /*
+                 * Steps 8a-8c.  Again note how the call to the spec's Str
+                 * method is broken up into getting the property, running it
+                 * past toJSON and the replacer and maybe unboxing, and
+                 * interpreting some values as |null| in separate steps.
+                 */
+                if (!GetElement(cx, obj, obj, i, &outputValue))
+                    return false;
+                if (!PreprocessValue(cx, obj, i, &outputValue, scx))
                     return false;
+                if (IsFilteredValue(outputValue)) {
+                    if (!scx->sb.append("null"))
+                        return false;
+                } else {
+                    if (!Str(cx, outputValue, scx))
+                        return false;
+                }
             }
 
+            if (!scx->maybeFlushSegment())
+                return false;
+
             /* Steps 3, 4, 10b(i). */
             if (i < length - 1) {
                 if (!scx->sb.append(','))
@@ -501,14 +546,8 @@ Str(JSContext* cx, const Value& v, StringifyContext* scx)
         return v.toBoolean() ? scx->sb.append("true") : scx->sb.append("false");
 
     /* Step 9. */
-    if (v.isNumber()) {
-        if (v.isDouble()) {
-            if (!IsFinite(v.toDouble()))
-                return scx->sb.append("null");
-        }
-
-        return NumberValueToStringBuffer(cx, v, scx->sb);
-    }
+    if (v.isNumber())
+        return WriteNumber(cx, v, scx->sb);
 
     /* Step 10. */
     MOZ_ASSERT(v.isObject());
@@ -525,9 +564,9 @@ Str(JSContext* cx, const Value& v, StringifyContext* scx)
 }
 
 /* ES5 15.12.3. */
-bool
-js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, Value space_,
-              StringBuffer& sb)
+static bool
+StringifyImpl(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, Value space_,
+              StringBuffer& sb, SegmentedStringBuffer* segmented)
 {
     RootedObject replacer(cx, replacer_);
     RootedValue space(cx, space_);
@@ -693,7 +732,7 @@ js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, Value s
         return false;
 
     /* Step 11. */
-    StringifyContext scx(cx, sb, gap, replacer, propertyList);
+    StringifyContext scx(cx, sb, segmented, gap, replacer, propertyList);
     if (!PreprocessValue(cx, wrapper, HandleId(emptyId), vp, &scx))
         return false;
     if (IsFilteredValue(vp))
@@ -702,6 +741,20 @@ js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, Value s
     return Str(cx, vp, &scx);
 }
 
+bool
+js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer, Value space,
+              StringBuffer& sb)
+{
+    return StringifyImpl(cx, vp, replacer, space, sb, nullptr);
+}
+
+bool
+js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer, Value space,
+              SegmentedStringBuffer& sb)
+{
+    return StringifyImpl(cx, vp, replacer, space, sb, &sb);
+}
+
 /* ES5 15.12.2 Walk. */
 static bool
 Walk(JSContext* cx, HandleObject holder, HandleId name, HandleValue reviver, MutableHandleValue vp)
@@ -888,7 +941,7 @@ json_stringify(JSContext* cx, unsigned argc, Value* vp)
     RootedValue value(cx, args.get(0));
     RootedValue space(cx, args.get(2));
 
-    StringBuffer sb(cx);
+    SegmentedStringBuffer sb(cx);
     if (!Stringify(cx, &value, replacer, space, sb))
         return false;
 
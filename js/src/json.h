@@ -14,6 +14,7 @@
 #include "js/RootingAPI.h"
 
 namespace js {
+class SegmentedStringBuffer;
 class StringBuffer;
 
 extern JSObject*
@@ -23,6 +24,14 @@ extern bool
 Stringify(JSContext* cx, js::MutableHandleValue vp, JSObject* replacer,
           Value space, StringBuffer& sb);
 
+/*
+ * As above, but the output is built up in segments, for callers that want the
+ * result as a JSString and may produce very long strings.
+ */
+extern bool
+Stringify(JSContext* cx, js::MutableHandleValue vp, JSObject* replacer,
+          Value space, SegmentedStringBuffer& sb);
+
 template <typename CharT>
 extern bool
 ParseJSONWithReviver(JSContext* cx, const mozilla::Range<const CharT> chars,
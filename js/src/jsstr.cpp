@@ -1397,7 +1397,7 @@ typedef Vector<JSLinearString*, 16, SystemAllocPolicy> LinearStringVector;
 template <typename TextChar, typename PatChar>
 static int
 RopeMatchImpl(const AutoCheckCannotGC& nogc, LinearStringVector& strings,
-              const PatChar* pat, size_t patLen)
+              const PatChar* pat, size_t patLen, size_t start)
 {
     /* Absolute offset from the beginning of the logical text string. */
     int pos = 0;
@@ -1407,6 +1407,19 @@ RopeMatchImpl(const AutoCheckCannotGC& nogc, LinearStringVector& strings,
         JSLinearString* outer = *outerp;
         const TextChar* chars = outer->chars<TextChar>(nogc);
         size_t len = outer->length();
+
+        /* Skip over the part of the text before |start|. */
+        if (size_t(pos) + len <= start) {
+            pos += len;
+            continue;
+        }
+        if (size_t(pos) < start) {
+            size_t skip = start - pos;
+            chars += skip;
+            len -= skip;
+            pos += skip;
+        }
+
         int matchResult = StringMatch(chars, len, pat, patLen);
         if (matchResult != -1) {
             /* Matched! */
@@ -1452,23 +1465,43 @@ RopeMatchImpl(const AutoCheckCannotGC& nogc, LinearStringVector& strings,
 }
 
 /*
- * RopeMatch takes the text to search and the pattern to search for in the text.
- * RopeMatch returns false on OOM and otherwise returns the match index through
- * the 'match' outparam (-1 for not found).
+ * RopeMatch takes the text to search and the pattern to search for in the text,
+ * and searches from index |start| on. RopeMatch returns false on OOM and
+ * otherwise returns the match index through the 'match' outparam (-1 for not
+ * found).
  */
 static bool
-RopeMatch(JSContext* cx, JSRope* text, JSLinearString* pat, int* match)
+RopeMatch(JSContext* cx, JSRope* text, JSLinearString* pat, size_t start, int* match)
 {
+    MOZ_ASSERT(start <= text->length());
+
     uint32_t patLen = pat->length();
     if (patLen == 0) {
-        *match = 0;
+        *match = start;
         return true;
     }
-    if (text->length() < patLen) {
+    if (text->length() - start < patLen) {
         *match = -1;
         return true;
     }
 
+    /*
+     * A rope that is searched more than once in a row is likely to be searched
+     * again (indexOf loops, repeated includes checks), so flatten it and let
+     * the later searches run over linear chars.
+     */
+    JSRuntime* rt = cx->runtime();
+    if (rt->lastSearchedRope == text) {
+        rt->lastSearchedRope = nullptr;
+        JSLinearString* linear = text->ensureLinear(cx);
+        if (!linear)
+            return false;
+
+        *match = StringMatch(linear, pat, start);
+        return true;
+    }
+    rt->lastSearchedRope = text;
+
     /*
      * List of leaf nodes in the rope. If we run out of memory when trying to
      * append to this list, we can still fall back to StringMatch, so use the
@@ -1501,7 +1534,7 @@ RopeMatch(JSContext* cx, JSRope* text, JSLinearString* pat, int* match)
                 if (!linear)
                     return false;
 
-                *match = StringMatch(linear, pat);
+                *match = StringMatch(linear, pat, start);
                 return true;
             }
             if (!r.popFront())
@@ -1512,19 +1545,30 @@ RopeMatch(JSContext* cx, JSRope* text, JSLinearString* pat, int* match)
     AutoCheckCannotGC nogc;
     if (text->hasLatin1Chars()) {
         if (pat->hasLatin1Chars())
-            *match = RopeMatchImpl<Latin1Char>(nogc, strings, pat->latin1Chars(nogc), patLen);
+            *match = RopeMatchImpl<Latin1Char>(nogc, strings, pat->latin1Chars(nogc), patLen, start);
         else
-            *match = RopeMatchImpl<Latin1Char>(nogc, strings, pat->twoByteChars(nogc), patLen);
+            *match = RopeMatchImpl<Latin1Char>(nogc, strings, pat->twoByteChars(nogc), patLen, start);
     } else {
         if (pat->hasLatin1Chars())
-            *match = RopeMatchImpl<char16_t>(nogc, strings, pat->latin1Chars(nogc), patLen);
+            *match = RopeMatchImpl<char16_t>(nogc, strings, pat->latin1Chars(nogc), patLen, start);
         else
-            *match = RopeMatchImpl<char16_t>(nogc, strings, pat->twoByteChars(nogc), patLen);
+            *match = RopeMatchImpl<char16_t>(nogc, strings, pat->twoByteChars(nogc), patLen, start);
     }
 
     return true;
 }
 
+/* Search |text| from |start| on, without flattening it if it is a rope. */
+static bool
+StringMatchAnyString(JSContext* cx, JSString* text, JSLinearString* pat, size_t start,
+                     int* match)
+{
+    if (text->isRope())
+        return RopeMatch(cx, &text->asRope(), pat, start, match);
+
+    *match = StringMatch(&text->asLinear(), pat, start);
+    return true;
+}
 
 /* ES6 draft rc4 21.1.3.7. */
 static bool
@@ -1575,11 +1619,11 @@ str_includes(JSContext* cx, unsigned argc, Value* vp)
     uint32_t start = Min(Max(pos, 0U), textLen);
 
     // Steps 13 and 14
-    JSLinearString* text = str->ensureLinear(cx);
-    if (!text)
+    int match;
+    if (!StringMatchAnyString(cx, str, searchStr, start, &match))
         return false;
 
-    args.rval().setBoolean(StringMatch(text, searchStr, start) != -1);
+    args.rval().setBoolean(match != -1);
     return true;
 }
 
@@ -1633,11 +1677,11 @@ js::str_indexOf(JSContext* cx, unsigned argc, Value* vp)
     uint32_t start = Min(Max(pos, 0U), textLen);
 
     // Steps 10 and 11
-    JSLinearString* text = str->ensureLinear(cx);
-    if (!text)
+    int match;
+    if (!StringMatchAnyString(cx, str, searchStr, start, &match))
         return false;
 
-    args.rval().setInt32(StringMatch(text, searchStr, start));
+    args.rval().setInt32(match);
     return true;
 }
 
@@ -2168,7 +2212,7 @@ class MOZ_STACK_CLASS StringRegExpGuard
          * long as possible.
          */
         if (text->isRope()) {
-            if (!RopeMatch(cx, &text->asRope(), fm.pat_, &fm.match_))
+            if (!RopeMatch(cx, &text->asRope(), fm.pat_, 0, &fm.match_))
                 return nullptr;
         } else {
             fm.match_ = StringMatch(&text->asLinear(), fm.pat_, 0);
@@ -5822,6 +5822,15 @@ SetRuntimeOptions(JSRuntime* rt, const OptionParser& op)
             return OptionFailure("ion-licm", str);
     }
 
+    if (const char* str = op.getStringOption("ion-lite")) {
+        if (strcmp(str, "on") == 0)
+            jit::js_JitOptions.ionLite = true;
+        else if (strcmp(str, "off") == 0)
+            jit::js_JitOptions.ionLite = false;
+        else
+            return OptionFailure("ion-lite", str);
+    }
+
     if (const char* str = op.getStringOption("ion-edgecase-analysis")) {
         if (strcmp(str, "on") == 0)
             jit::js_JitOptions.disableEdgeCaseAnalysis = false;
@@ -6174,6 +6183,9 @@ main(int argc, char** argv, char** envp)
                                "  on:  enable GVN (default)\n")
         || !op.addStringOption('\0', "ion-licm", "on/off",
                                "Loop invariant code motion (default: on, off to disable)")
+        || !op.addStringOption('\0', "ion-lite", "on/off",
+                               "Compile warm scripts with a fast, lightly optimizing tier before "
+                               "full Ion (default: off, on to enable)")
         || !op.addStringOption('\0', "ion-edgecase-analysis", "on/off",
                                "Find edge cases where Ion can avoid bailouts (default: on, off to disable)")
         || !op.addStringOption('\0', "ion-range-analysis", "on/off",
@@ -6201,6 +6213,8 @@ main(int argc, char** argv, char** envp)
                                "Specify Ion register allocation:\n"
                                "  backtracking: Priority based backtracking register allocation (default)\n"
                                "  testbed: Backtracking allocator with experimental features\n"
+                               "  linearscan: Single pass allocation over the backtracking allocator's\n"
+                               "              live ranges, faster to run but with more spills\n"
                                "  stupid: Simple block local register allocation")
         || !op.addBoolOption('\0', "ion-eager", "Always ion-compile methods (implies --baseline-eager)")
         || !op.addStringOption('\0', "ion-offthread-compile", "on/off",
@@ -753,18 +753,19 @@ GlobalHelperThreadState::pendingIonCompileHasSufficientPriority()
 bool
 GlobalHelperThreadState::canStartParseTask()
 {
-    // Don't allow simultaneous off thread parses, to reduce contention on the
-    // atoms table. Note that asm.js compilation depends on this to avoid
-    // stalling the helper thread, as off thread parse tasks can trigger and
-    // block on other off thread asm.js compilation tasks.
+    // Allow several off thread parses at once, up to one per core. Only one
+    // asm.js module is compiled in parallel at a time (others are compiled
+    // serially, see ParallelCompilationGuard), and maxParseThreads leaves
+    // threads free for the asm.js tasks that a parse task may block on.
     MOZ_ASSERT(isLocked());
     if (parseWorklist().empty())
         return false;
+    size_t numParseThreads = 0;
     for (size_t i = 0; i < threadCount; i++) {
         if (threads[i].parseTask)
-            return false;
+            numParseThreads++;
     }
-    return true;
+    return numParseThreads < maxParseThreads();
 }
 
 bool
@@ -100,6 +100,14 @@ class GlobalHelperThreadState
             return 2;
         return cpuCount;
     }
+    size_t maxParseThreads() const {
+        // Parse tasks validating asm.js modules block on asm.js compilation
+        // tasks, so there must always be helper threads left over for them.
+        // threadCount exceeds cpuCount, which guarantees this.
+        if (cpuCount < 2)
+            return 1;
+        return cpuCount;
+    }
 
     GlobalHelperThreadState();
 
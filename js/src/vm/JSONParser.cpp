@@ -10,11 +10,13 @@
 #include "mozilla/RangedPtr.h"
 
 #include <ctype.h>
+#include <string.h>
 
 #include "jsarray.h"
 #include "jscompartment.h"
 #include "jsnum.h"
 #include "jsprf.h"
+#include "jsstr.h"
 
 #include "vm/StringBuffer.h"
 
@@ -56,6 +58,11 @@ JSONParserBase::trace(JSTracer* trc)
             }
         }
     }
+
+    for (size_t i = 0; i < PropertyNameCacheSize; i++) {
+        if (propertyNameCache[i])
+            TraceRoot(trc, &propertyNameCache[i], "JSONParser property name cache");
+    }
 }
 
 template <typename CharT>
@@ -105,6 +112,65 @@ JSONParserBase::errorReturn()
     return errorHandling == NoError;
 }
 
+/*
+ * Return the number of characters at the start of [s, end) that can be
+ * copied into a string literal as is, that is, which are not a quote, a
+ * backslash or a control character. This tests a machine word worth of
+ * characters at a time, using the usual bit tricks for finding a lane that is
+ * zero or less than a constant, and leaves the last partial word (and the
+ * word containing the first special character) to the caller.
+ */
+template <typename CharT>
+static size_t
+CountPlainStringChars(const CharT* s, const CharT* end)
+{
+    typedef uintptr_t Word;
+    static const size_t CharsPerWord = sizeof(Word) / sizeof(CharT);
+    static const Word Ones = Word(-1) / ((Word(1) << (8 * sizeof(CharT))) - 1);
+    static const Word HighBits = Ones << (8 * sizeof(CharT) - 1);
+
+    const CharT* start = s;
+    while (size_t(end - s) >= CharsPerWord) {
+        Word w;
+        memcpy(&w, s, sizeof(w));
+        Word quote = w ^ (Ones * '"');
+        Word backslash = w ^ (Ones * '\\');
+        Word special = ((quote - Ones) & ~quote) |
+                       ((backslash - Ones) & ~backslash) |
+                       ((w - Ones * 0x20) & ~w);
+        if (special & HighBits)
+            break;
+        s += CharsPerWord;
+    }
+    return s - start;
+}
+
+template <typename CharT>
+JSAtom*
+JSONParser<CharT>::atomizePropertyName(const CharT* chars, size_t length)
+{
+    size_t index = length;
+    if (length)
+        index = length * 31 + chars[0] * 7 + chars[length - 1];
+    index %= PropertyNameCacheSize;
+
+    JSAtom* atom = propertyNameCache[index];
+    if (atom && atom->length() == length) {
+        JS::AutoCheckCannotGC nogc;
+        if (atom->hasLatin1Chars()
+            ? EqualChars(atom->latin1Chars(nogc), chars, length)
+            : EqualChars(atom->twoByteChars(nogc), chars, length))
+        {
+            return atom;
+        }
+    }
+
+    atom = AtomizeChars(cx, chars, length);
+    if (atom)
+        propertyNameCache[index] = atom;
+    return atom;
+}
+
 template <typename CharT>
 template <JSONParserBase::StringType ST>
 JSONParserBase::Token
@@ -128,12 +194,13 @@ JSONParser<CharT>::readString()
      * string directly from the source text.
      */
     CharPtr start = current;
+    current += CountPlainStringChars(current.get(), end.get());
     for (; current < end; current++) {
         if (*current == '"') {
             size_t length = current - start;
             current++;
             JSFlatString* str = (ST == JSONParser::PropertyName)
-                                ? AtomizeChars(cx, start.get(), length)
+                                ? atomizePropertyName(start.get(), length)
                                 : NewStringCopyN<CanGC>(cx, start.get(), length);
             if (!str)
                 return token(OOM);
@@ -230,6 +297,7 @@ JSONParser<CharT>::readString()
             return token(OOM);
 
         start = current;
+        current += CountPlainStringChars(current.get(), end.get());
         for (; current < end; current++) {
             if (*current == '"' || *current == '\\' || *current <= 0x001F)
                 break;
@@ -8,6 +8,7 @@
 #define vm_JSONParser_h
 
 #include "mozilla/Attributes.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/Range.h"
 
 #include "jspubtd.h"
@@ -103,6 +104,11 @@ class MOZ_STACK_CLASS JSONParserBase : private JS::AutoGCRooter
     Vector<ElementVector*, 5> freeElements;
     Vector<PropertyVector*, 5> freeProperties;
 
+    // Recently seen property names. Arrays of records repeat the same keys
+    // over and over, and this lets most of them skip the atoms table.
+    static const size_t PropertyNameCacheSize = 64;
+    JSAtom* propertyNameCache[PropertyNameCacheSize];
+
 #ifdef DEBUG
     Token lastToken;
 #endif
@@ -117,7 +123,9 @@ class MOZ_STACK_CLASS JSONParserBase : private JS::AutoGCRooter
 #ifdef DEBUG
       , lastToken(Error)
 #endif
-    {}
+    {
+        mozilla::PodArrayZero(propertyNameCache);
+    }
     ~JSONParserBase();
 
     Value numberValue() const {
@@ -215,6 +223,8 @@ class MOZ_STACK_CLASS JSONParser : public JSONParserBase
   private:
     template<StringType ST> Token readString();
 
+    JSAtom* atomizePropertyName(const CharT* chars, size_t length);
+
     Token readNumber();
 
     Token advance();
@@ -13,6 +13,7 @@
 
 #include "builtin/RegExp.h"
 #include "frontend/TokenStream.h"
+#include "irregexp/RegExpEngine.h"
 #include "irregexp/RegExpParser.h"
 #include "vm/MatchPairs.h"
 #include "vm/RegExpStatics.h"
@@ -623,6 +624,28 @@ RegExpShared::compile(JSContext* cx, HandleAtom pattern, HandleLinearString inpu
     if (!ignoreCase() && !StringHasRegExpMetaChars(pattern))
         canStringMatch = true;
 
+    RegExpCompilation& compilation = this->compilation(mode, input->hasLatin1Chars());
+
+    /* Bytecode compiled by another compartment can be reused as is. */
+    RegExpByteCodeCache* cache = nullptr;
+    RegExpByteCodeCache::Key key(pattern,
+                                 (ignoreCase() ? RegExpByteCodeCache::Key::IgnoreCase : 0) |
+                                 (multiline() ? RegExpByteCodeCache::Key::Multiline : 0) |
+                                 (mode == MatchOnly ? RegExpByteCodeCache::Key::MatchOnly : 0) |
+                                 (input->hasLatin1Chars() ? RegExpByteCodeCache::Key::Latin1 : 0));
+    if (force == ForceByteCode || !irregexp::IsNativeRegExpEnabled(cx)) {
+        cache = cx->runtime()->getRegExpByteCodeCache(cx);
+        if (!cache)
+            return false;
+
+        uint32_t cachedParenCount;
+        if (uint8_t* byteCode = cache->lookup(key, &cachedParenCount)) {
+            this->parenCount = cachedParenCount;
+            compilation.byteCode = byteCode;
+            return true;
+        }
+    }
+
     CompileOptions options(cx);
     TokenStream dummyTokenStream(cx, options, nullptr, 0, nullptr);
 
@@ -650,11 +673,13 @@ RegExpShared::compile(JSContext* cx, HandleAtom pattern, HandleLinearString inpu
     MOZ_ASSERT(!code.jitCode || !code.byteCode);
     MOZ_ASSERT_IF(force == ForceByteCode, code.byteCode);
 
-    RegExpCompilation& compilation = this->compilation(mode, input->hasLatin1Chars());
-    if (code.jitCode)
+    if (code.jitCode) {
         compilation.jitCode = code.jitCode;
-    else if (code.byteCode)
+    } else if (code.byteCode) {
         compilation.byteCode = code.byteCode;
+        if (cache)
+            cache->put(key, code.byteCode, code.byteCodeLength, parenCount);
+    }
 
     return true;
 }
@@ -890,6 +915,85 @@ RegExpCompartment::init(JSContext* cx)
     return true;
 }
 
+/* RegExpByteCodeCache */
+
+uint8_t*
+RegExpByteCodeCache::lookup(const Key& key, uint32_t* parenCount)
+{
+    Map::Ptr p = map_.lookup(key);
+    if (!p)
+        return nullptr;
+
+    const Entry& entry = p->value();
+    uint8_t* byteCode = js_pod_malloc<uint8_t>(entry.length);
+    if (!byteCode)
+        return nullptr;
+
+    mozilla::PodCopy(byteCode, entry.byteCode, entry.length);
+    *parenCount = entry.parenCount;
+    return byteCode;
+}
+
+void
+RegExpByteCodeCache::put(const Key& key, const uint8_t* byteCode, size_t length,
+                         uint32_t parenCount)
+{
+    if (size_ + length > MaxSize)
+        return;
+
+    Map::AddPtr p = map_.lookupForAdd(key);
+    if (p)
+        return;
+
+    Entry entry;
+    entry.byteCode = js_pod_malloc<uint8_t>(length);
+    if (!entry.byteCode)
+        return;
+    mozilla::PodCopy(entry.byteCode, byteCode, length);
+    entry.length = length;
+    entry.parenCount = parenCount;
+
+    if (!map_.add(p, key, entry)) {
+        js_free(entry.byteCode);
+        return;
+    }
+    size_ += length;
+}
+
+void
+RegExpByteCodeCache::sweep()
+{
+    for (Map::Enum e(map_); !e.empty(); e.popFront()) {
+        JSAtom* pattern = e.front().key().pattern;
+        if (IsAboutToBeFinalizedUnbarriered(&pattern)) {
+            size_ -= e.front().value().length;
+            js_free(e.front().value().byteCode);
+            e.removeFront();
+        }
+    }
+}
+
+void
+RegExpByteCodeCache::purge()
+{
+    if (!map_.initialized())
+        return;
+
+    for (Map::Range r = map_.all(); !r.empty(); r.popFront())
+        js_free(r.front().value().byteCode);
+    map_.clear();
+    size_ = 0;
+}
+
+size_t
+RegExpByteCodeCache::sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf)
+{
+    size_t n = mallocSizeOf(this) + map_.sizeOfExcludingThis(mallocSizeOf);
+    for (Map::Range r = map_.all(); !r.empty(); r.popFront())
+        n += mallocSizeOf(r.front().value().byteCode);
+    return n;
+}
+
 void
 RegExpCompartment::sweep(JSRuntime* rt)
 {
@@ -345,6 +345,79 @@ class RegExpCompartment
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 };
 
+/*
+ * Runtime-wide cache of irregexp bytecode, so that compartments compiling the
+ * same pattern (e.g. many same-origin iframes) only run the regexp parser and
+ * compiler once. Native regexp code is a GC thing in the zone that compiled
+ * it and contains absolute addresses, so only bytecode is shared, and every
+ * RegExpShared gets its own copy of it. Entries are keyed on the pattern atom,
+ * which is shared by all zones, and are swept along with the atoms.
+ */
+class RegExpByteCodeCache
+{
+  public:
+    struct Key {
+        JSAtom* pattern;
+        uint8_t flags;
+
+        enum {
+            IgnoreCase = 1 << 0,
+            Multiline  = 1 << 1,
+            MatchOnly  = 1 << 2,
+            Latin1     = 1 << 3
+        };
+
+        Key(JSAtom* pattern, uint8_t flags)
+          : pattern(pattern), flags(flags)
+        {}
+
+        typedef Key Lookup;
+        static HashNumber hash(const Lookup& l) {
+            return DefaultHasher<JSAtom*>::hash(l.pattern) ^ l.flags;
+        }
+        static bool match(const Key& k, const Lookup& l) {
+            return k.pattern == l.pattern && k.flags == l.flags;
+        }
+    };
+
+  private:
+    struct Entry {
+        uint8_t* byteCode;
+        size_t length;
+        uint32_t parenCount;
+    };
+
+    typedef HashMap<Key, Entry, Key, SystemAllocPolicy> Map;
+    Map map_;
+
+    /* Total size of the cached bytecode. */
+    size_t size_;
+
+  public:
+    /* Stop adding entries once this much bytecode is cached. */
+    static const size_t MaxSize = 4 * 1024 * 1024;
+
+    RegExpByteCodeCache() : size_(0) {}
+    ~RegExpByteCodeCache() { purge(); }
+
+    bool init() { return map_.init(); }
+
+    /*
+     * On a hit, return a copy of the cached bytecode, owned by the caller,
+     * and its paren count. Returns nullptr on a miss or on OOM; no error is
+     * reported either way.
+     */
+    uint8_t* lookup(const Key& key, uint32_t* parenCount);
+
+    /* Add a copy of |byteCode| to the cache. Failure is not an error. */
+    void put(const Key& key, const uint8_t* byteCode, size_t length, uint32_t parenCount);
+
+    void sweep();
+    void purge();
+
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf);
+};
+
 class RegExpObject : public NativeObject
 {
     static const unsigned LAST_INDEX_SLOT          = 0;
@@ -48,6 +48,7 @@
 #include "js/MemoryMetrics.h"
 #include "js/SliceBudget.h"
 #include "vm/Debugger.h"
+#include "vm/RegExpObject.h"
 
 #include "jscntxtinlines.h"
 #include "jsgcinlines.h"
@@ -205,6 +206,8 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
     numGrouping(0),
 #endif
     mathCache_(nullptr),
+    regExpByteCodeCache_(nullptr),
+    lastSearchedRope(nullptr),
     activeCompilations_(0),
     keepAtoms_(0),
     trustedPrincipals_(nullptr),
@@ -448,6 +451,7 @@ JSRuntime::~JSRuntime()
 
     js_free(defaultLocale);
     js_delete(mathCache_);
+    js_delete(regExpByteCodeCache_);
     js_delete(jitRuntime_);
 
     js_delete(ionPcScriptCache);
@@ -525,6 +529,10 @@ JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::Runtim
 
     rtSizes->mathCache += mathCache_ ? mathCache_->sizeOfIncludingThis(mallocSizeOf) : 0;
 
+    rtSizes->regExpByteCodeCache += regExpByteCodeCache_
+                                    ? regExpByteCodeCache_->sizeOfIncludingThis(mallocSizeOf)
+                                    : 0;
+
     rtSizes->uncompressedSourceCache += uncompressedSourceCache.sizeOfExcludingThis(mallocSizeOf);
 
     rtSizes->compressedSourceSet += compressedSourceSet.sizeOfExcludingThis(mallocSizeOf);
@@ -672,6 +680,23 @@ JSRuntime::createMathCache(JSContext* cx)
     return mathCache_;
 }
 
+RegExpByteCodeCache*
+JSRuntime::createRegExpByteCodeCache(JSContext* cx)
+{
+    MOZ_ASSERT(!regExpByteCodeCache_);
+    MOZ_ASSERT(cx->runtime() == this);
+
+    RegExpByteCodeCache* cache = js_new<RegExpByteCodeCache>();
+    if (!cache || !cache->init()) {
+        js_delete(cache);
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    regExpByteCodeCache_ = cache;
+    return regExpByteCodeCache_;
+}
+
 bool
 JSRuntime::setDefaultLocale(const char* locale)
 {
@@ -89,6 +89,7 @@ class ActivationIterator;
 class AsmJSActivation;
 class AsmJSModule;
 class MathCache;
+class RegExpByteCodeCache;
 
 namespace jit {
 class JitRuntime;
@@ -234,6 +235,56 @@ class NativeIterCache
     }
 };
 
+/*
+ * Cache of own property lookups, probed by JIT property accesses which have
+ * gone megamorphic before falling back to a full lookup. Maps a (shape, id)
+ * pair to the property with that id in the shape's lineage, or nullptr if
+ * there is none. Only shapes which are not in dictionary mode are cached:
+ * those never change, so an entry stays valid until the next GC purges the
+ * cache.
+ */
+class PropertyLookupCache
+{
+    static const size_t SIZE = size_t(1) << 8;
+
+    struct Entry
+    {
+        Shape* shape;
+        jsid id;
+        Shape* prop;
+    };
+
+    Entry entries[SIZE];
+
+    static size_t getIndex(Shape* shape, jsid id) {
+        return size_t((uintptr_t(shape) >> 3) ^ (JSID_BITS(id) >> 3)) % SIZE;
+    }
+
+  public:
+    PropertyLookupCache() {
+        purge();
+    }
+
+    void purge() {
+        mozilla::PodArrayZero(entries);
+    }
+
+    bool lookup(Shape* shape, jsid id, Shape** propp) const {
+        const Entry& entry = entries[getIndex(shape, id)];
+        if (entry.shape != shape || JSID_BITS(entry.id) != JSID_BITS(id))
+            return false;
+        *propp = entry.prop;
+        return true;
+    }
+
+    void fill(Shape* shape, jsid id, Shape* prop) {
+        Entry& entry = entries[getIndex(shape, id)];
+        entry.shape = shape;
+        entry.id = id;
+        entry.prop = prop;
+    }
+};
+
 /*
  * Cache for speeding up repetitive creation of objects in the VM.
  * When an object is created which matches the criteria in the 'key' section
@@ -1203,10 +1254,27 @@ struct JSRuntime : public JS::shadow::Runtime,
         return mathCache_;
     }
 
+  private:
+    js::RegExpByteCodeCache* regExpByteCodeCache_;
+    js::RegExpByteCodeCache* createRegExpByteCodeCache(JSContext* cx);
+  public:
+    js::RegExpByteCodeCache* getRegExpByteCodeCache(JSContext* cx) {
+        return regExpByteCodeCache_ ? regExpByteCodeCache_ : createRegExpByteCodeCache(cx);
+    }
+    js::RegExpByteCodeCache* maybeGetRegExpByteCodeCache() {
+        return regExpByteCodeCache_;
+    }
+
     js::GSNCache        gsnCache;
     js::ScopeCoordinateNameCache scopeCoordinateNameCache;
     js::NewObjectCache  newObjectCache;
     js::NativeIterCache nativeIterCache;
+    js::PropertyLookupCache propertyLookupCache;
+
+    // The last rope searched without flattening, compared by identity only.
+    // A rope that is searched again is flattened instead, since the flatten
+    // then pays for itself across the repeated searches. Cleared on GC.
+    JSString*           lastSearchedRope;
     js::UncompressedSourceCache uncompressedSourceCache;
     js::EvalCache       evalCache;
     js::LazyScriptCache lazyScriptCache;
@@ -7,6 +7,7 @@
 #include "vm/SelfHosting.h"
 
 #include "mozilla/ArrayUtils.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Casting.h"
 #include "mozilla/DebugOnly.h"
 
@@ -643,6 +644,31 @@ intrinsic_MoveTypedArrayElements(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+intrinsic_FillTypedArrayElements(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+
+    Rooted<TypedArrayObject*> tarray(cx, &args[0].toObject().as<TypedArrayObject>());
+    double value = args[1].toNumber();
+
+    // The bounds were computed with Math.min/max, so they may be doubles
+    // (for example -0) even though they're always integral.
+    uint32_t start = uint32_t(args[2].toNumber());
+    uint32_t end = uint32_t(args[3].toNumber());
+
+    // Conversions of the start and end arguments may have neutered the
+    // buffer or shrunk the view since the self-hosted caller read its length.
+    // Element sets past the end are no-ops, so just clamp.
+    end = Min(end, tarray->length());
+    if (start < end)
+        TypedArrayMethods<TypedArrayObject>::fill(tarray, value, start, end);
+
+    args.rval().setUndefined();
+    return true;
+}
+
 // Extract the TypedArrayObject* underlying |obj| and return it.  This method,
 // in a TOTALLY UNSAFE manner, completely violates the normal compartment
 // boundaries, returning an object not necessarily in the current compartment
@@ -1454,6 +1480,7 @@ static const JSFunctionSpec intrinsic_functions[] = {
                     IntrinsicTypedArrayLength),
 
     JS_FN("MoveTypedArrayElements",  intrinsic_MoveTypedArrayElements,  4,0),
+    JS_FN("FillTypedArrayElements",  intrinsic_FillTypedArrayElements,  4,0),
     JS_FN("SetFromTypedArrayApproach",intrinsic_SetFromTypedArrayApproach, 4, 0),
     JS_FN("SetOverlappingTypedElements",intrinsic_SetOverlappingTypedElements,3,0),
 
@@ -1605,6 +1632,63 @@ JSRuntime::createSelfHostingGlobal(JSContext* cx)
     return shg;
 }
 
+/*
+ * XDR-encoded form of the self-hosted top-level script. The first runtime in
+ * the process without a parent compiles the self-hosted sources and publishes
+ * the encoding here; every later parentless runtime (the main thread runtime
+ * of a second JS_NewRuntime, IndexedDB, PAC, ...) decodes it instead of
+ * decompressing, parsing and emitting all of the self-hosted code again.
+ * Once published the buffer is immutable, so it can be read from any thread
+ * without locking. It is freed in JS_ShutDown.
+ */
+struct SelfHostedXDR
+{
+    void* data;
+    uint32_t length;
+};
+
+static mozilla::Atomic<SelfHostedXDR*> gSelfHostedXDR;
+
+static void
+PublishSelfHostedXDR(JSContext* cx, HandleScript script)
+{
+    if (gSelfHostedXDR)
+        return;
+
+    uint32_t length;
+    void* data = JS_EncodeScript(cx, script, &length);
+    if (!data) {
+        // Failing to share the encoding isn't fatal: later runtimes will
+        // compile the self-hosted code themselves.
+        cx->clearPendingException();
+        return;
+    }
+
+    SelfHostedXDR* xdr = js_new<SelfHostedXDR>();
+    if (!xdr) {
+        js_free(data);
+        return;
+    }
+    xdr->data = data;
+    xdr->length = length;
+
+    // Another runtime may have raced us to publish; keep theirs.
+    if (!gSelfHostedXDR.compareExchange(nullptr, xdr)) {
+        js_free(data);
+        js_delete(xdr);
+    }
+}
+
+void
+js::FreeSelfHostedXDR()
+{
+    SelfHostedXDR* xdr = gSelfHostedXDR.exchange(nullptr);
+    if (xdr) {
+        js_free(xdr->data);
+        js_delete(xdr);
+    }
+}
+
 // This function is miscompiled by LTCG with MSVC, and results in a crash
 // when running xpcshell during the build.  See bug 915735.
 #ifdef _MSC_VER
@@ -1649,6 +1733,9 @@ JSRuntime::initSelfHosting(JSContext* cx)
         RootedScript script(cx);
         if (Compile(cx, options, filename, &script))
             ok = Execute(cx, script, *shg.get(), rv.address());
+    } else if (SelfHostedXDR* xdr = gSelfHostedXDR) {
+        RootedScript script(cx, JS_DecodeScript(cx, xdr->data, xdr->length));
+        ok = script && Execute(cx, script, *shg.get(), rv.address());
     } else {
         uint32_t srcLen = GetRawScriptsSize();
 
@@ -1661,7 +1748,16 @@ JSRuntime::initSelfHosting(JSContext* cx)
             ok = false;
         }
 
-        ok = ok && Evaluate(cx, options, src, srcLen, &rv);
+        RootedScript script(cx);
+        ok = ok && Compile(cx, options, src, srcLen, &script);
+
+        // Encode before running the script: executing it mutates singleton
+        // objects and type information that must not leak into the shared
+        // copy.
+        if (ok)
+            PublishSelfHostedXDR(cx, script);
+
+        ok = ok && Execute(cx, script, *shg.get(), rv.address());
     }
     JS_SetErrorReporter(cx->runtime(), oldReporter);
     return ok;
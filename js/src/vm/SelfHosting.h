@@ -23,6 +23,10 @@ bool IsSelfHostedFunctionWithName(JSFunction* fun, JSAtom* name);
 void
 FillSelfHostingCompileOptions(JS::CompileOptions& options);
 
+/* Free the process-wide encoding of the self-hosted script, if any. */
+void
+FreeSelfHostedXDR();
+
 } /* namespace js */
 
 #endif /* vm_SelfHosting_h_ */
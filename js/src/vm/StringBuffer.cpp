@@ -8,6 +8,8 @@
 
 #include "mozilla/Range.h"
 
+#include "jsstr.h"
+
 #include "jsobjinlines.h"
 
 #include "vm/String-inl.h"
@@ -49,6 +51,15 @@ StringBuffer::stealChars()
     return ExtractWellSized<char16_t>(cx, twoByteChars());
 }
 
+void
+StringBuffer::clear()
+{
+    cb.destroy();
+    cb.construct<Latin1CharBuffer>(cx);
+    hasEnsuredTwoByteChars_ = false;
+    reserved_ = 0;
+}
+
 bool
 StringBuffer::inflateChars()
 {
@@ -146,6 +157,43 @@ StringBuffer::finishAtom()
     return atom;
 }
 
+bool
+SegmentedStringBuffer::flushSegment()
+{
+    RootedString segment(cx, StringBuffer::finishString());
+    clear();
+    if (!segment)
+        return false;
+
+    if (!segments_) {
+        segments_ = segment;
+    } else {
+        JSString* rope = ConcatStrings<CanGC>(cx, segments_, segment);
+        if (!rope)
+            return false;
+        segments_ = rope;
+    }
+
+    // Avoid regrowing the buffer from its inline capacity for every segment.
+    return reserve(SegmentLength);
+}
+
+JSString*
+SegmentedStringBuffer::finishString()
+{
+    if (!segments_)
+        return StringBuffer::finishString();
+
+    RootedString segment(cx, StringBuffer::finishString());
+    clear();
+    if (!segment)
+        return nullptr;
+
+    RootedString segments(cx, segments_);
+    segments_ = nullptr;
+    return ConcatStrings<CanGC>(cx, segments, segment);
+}
+
 bool
 js::ValueToStringBufferSlow(JSContext* cx, const Value& arg, StringBuffer& sb)
 {
@@ -36,8 +36,10 @@ class StringBuffer
     typedef Vector<Latin1Char, 64> Latin1CharBuffer;
     typedef Vector<char16_t, 32> TwoByteCharBuffer;
 
+  protected:
     ExclusiveContext* cx;
 
+  private:
     /*
      * If Latin1 strings are enabled, cb starts out as a Latin1CharBuffer. When
      * a TwoByte char is appended, inflateChars() constructs a TwoByteCharBuffer
@@ -97,6 +99,12 @@ class StringBuffer
         return isLatin1() ? latin1Chars()[idx] : twoByteChars()[idx];
     }
 
+    /*
+     * Discards the buffer's contents. The buffer starts over with Latin1
+     * chars, as if it was newly constructed.
+     */
+    void clear();
+
     inline bool ensureTwoByteChars() {
         if (isLatin1() && !inflateChars())
             return false;
@@ -218,6 +226,45 @@ class StringBuffer
     char16_t* stealChars();
 };
 
+/*
+ * A StringBuffer for building very long strings, e.g. the result of
+ * JSON.stringify on a large object graph. The caller periodically calls
+ * maybeFlushSegment(), which moves the buffered characters into a flat string
+ * once there are at least SegmentLength of them, and finishString() returns
+ * the concatenation of all segments as a rope.
+ *
+ * A single buffer holding the whole string doubles its capacity as it grows,
+ * so building an n character string that way needs up to 3n characters of
+ * memory for the reallocation alone. Here the buffer never grows much past
+ * SegmentLength, and each segment is Latin1 unless it has TwoByte chars.
+ *
+ * Use empty() and finishString() only through this class, as they hide the
+ * StringBuffer versions.
+ */
+class SegmentedStringBuffer : public StringBuffer
+{
+    RootedString segments_;
+
+    bool flushSegment();
+
+  public:
+    static const size_t SegmentLength = 64 * 1024;
+
+    explicit SegmentedStringBuffer(JSContext* cx)
+      : StringBuffer(cx), segments_(cx)
+    {}
+
+    bool maybeFlushSegment() {
+        return length() < SegmentLength || flushSegment();
+    }
+
+    bool empty() const {
+        return !segments_ && StringBuffer::empty();
+    }
+
+    JSString* finishString();
+};
+
 inline bool
 StringBuffer::append(const char16_t* begin, const char16_t* end)
 {
@@ -251,6 +251,31 @@ class ElementSpecific
         return true;
     }
 
+    /*
+     * Store |value|, converted to the element type once, into |target[start]|
+     * through |target[end]| (exclusive).
+     */
+    static void
+    fill(Handle<SomeTypedArray*> target, double value, uint32_t start, uint32_t end)
+    {
+        MOZ_ASSERT(SpecificArray::ArrayTypeID() == target->type(),
+                   "calling wrong fill specialization");
+        MOZ_ASSERT(start <= end);
+        MOZ_ASSERT(end <= target->length());
+
+        T n = doubleToNative(value);
+        T* dest = static_cast<T*>(target->viewData()) + start;
+        uint32_t count = end - start;
+
+        if (sizeof(T) == 1) {
+            memset(dest, *reinterpret_cast<uint8_t*>(&n), count);
+            return;
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+            dest[i] = n;
+    }
+
     /*
      * Copy |source[0]| to |source[len]| (exclusive) elements into the typed
      * array |target|, starting at index |offset|.  |source| must not be a
@@ -735,6 +760,38 @@ class TypedArrayMethods
         return setFromNonTypedArray(cx, target, source, len, offset);
     }
 
+    /* Fill |target[start]| through |target[end]| (exclusive) with |value|. */
+    static void
+    fill(Handle<SomeTypedArray*> target, double value, uint32_t start, uint32_t end)
+    {
+        switch (target->type()) {
+          case Scalar::Int8:
+            return ElementSpecific<Int8ArrayType>::fill(target, value, start, end);
+          case Scalar::Uint8:
+            return ElementSpecific<Uint8ArrayType>::fill(target, value, start, end);
+          case Scalar::Int16:
+            return ElementSpecific<Int16ArrayType>::fill(target, value, start, end);
+          case Scalar::Uint16:
+            return ElementSpecific<Uint16ArrayType>::fill(target, value, start, end);
+          case Scalar::Int32:
+            return ElementSpecific<Int32ArrayType>::fill(target, value, start, end);
+          case Scalar::Uint32:
+            return ElementSpecific<Uint32ArrayType>::fill(target, value, start, end);
+          case Scalar::Float32:
+            return ElementSpecific<Float32ArrayType>::fill(target, value, start, end);
+          case Scalar::Float64:
+            return ElementSpecific<Float64ArrayType>::fill(target, value, start, end);
+          case Scalar::Uint8Clamped:
+            return ElementSpecific<Uint8ClampedArrayType>::fill(target, value, start, end);
+          case Scalar::Float32x4:
+          case Scalar::Int32x4:
+          case Scalar::MaxTypedArrayViewType:
+            break;
+        }
+
+        MOZ_CRASH("bad target array type");
+    }
+
   private:
     static bool
     setFromAnyTypedArray(JSContext* cx, Handle<SomeTypedArray*> target, HandleObject source,
@@ -1744,10 +1744,11 @@ CallMethodHelper::InitializeDispatchParams()
     }
 
     // iterate through the params to clear flags (for safe cleanup later)
-    for (uint8_t i = 0; i < paramCount + wantsJSContext + wantsOptArgc; i++) {
-        nsXPTCVariant* dp = mDispatchParams.AppendElement();
-        dp->ClearFlags();
-        dp->val.p = nullptr;
+    const uint32_t dispatchCount = paramCount + wantsJSContext + wantsOptArgc;
+    nsXPTCVariant* params = mDispatchParams.AppendElements(dispatchCount);
+    for (uint32_t i = 0; i < dispatchCount; i++) {
+        params[i].ClearFlags();
+        params[i].val.p = nullptr;
     }
 
     // Fill in the JSContext argument
@@ -349,6 +349,15 @@ public:
     PostRestyleEventInternal(true);
   }
 
+  /**
+   * Called when the style sheets or rules of our document change, which
+   * may destroy nsCSSSelectors referenced by pending
+   * eRestyle_SomeDescendants restyles.  Those become eRestyle_Subtree.
+   */
+  void ClearSelectors() {
+    mPendingRestyles.ClearSelectors();
+  }
+
   void FlushOverflowChangedTracker()
   {
     mOverflowChangedTracker.Flush();
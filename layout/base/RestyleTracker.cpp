@@ -184,6 +184,25 @@ CollectRestyles(nsISupports* aElement,
   return PL_DHASH_NEXT;
 }
 
+void
+RestyleTracker::ClearSelectors()
+{
+  if (!mHaveSelectors) {
+    return;
+  }
+  for (auto it = mPendingRestyles.Iter(); !it.Done(); it.Next()) {
+    RestyleData* data = it.Data();
+    if (data->mRestyleHint & eRestyle_SomeDescendants) {
+      data->mRestyleHint =
+        (data->mRestyleHint & ~eRestyle_SomeDescendants) | eRestyle_Subtree;
+      data->mRestyleHintData.mSelectorsForDescendants.Clear();
+    } else {
+      MOZ_ASSERT(data->mRestyleHintData.mSelectorsForDescendants.IsEmpty());
+    }
+  }
+  mHaveSelectors = false;
+}
+
 inline void
 RestyleTracker::ProcessOneRestyle(Element* aElement,
                                   nsRestyleHint aRestyleHint,
@@ -393,6 +412,7 @@ RestyleTracker::DoProcessRestyles()
 
         // Clear the hashtable now that we don't need it anymore
         mPendingRestyles.Clear();
+        mHaveSelectors = false;
 
 #ifdef RESTYLE_LOGGING
         uint32_t index = 0;
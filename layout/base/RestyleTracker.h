@@ -230,6 +230,7 @@ public:
   explicit RestyleTracker(Element::FlagsType aRestyleBits)
     : mRestyleBits(aRestyleBits)
     , mHaveLaterSiblingRestyles(false)
+    , mHaveSelectors(false)
   {
     NS_PRECONDITION((mRestyleBits & ~ELEMENT_ALL_RESTYLE_FLAGS) == 0,
                     "Why do we have these bits set?");
@@ -266,6 +267,13 @@ public:
    */
   void DoProcessRestyles();
 
+  /**
+   * Turn any eRestyle_SomeDescendants hints we have into eRestyle_Subtree
+   * ones and drop their selectors.  Must be called before the
+   * nsCSSSelectors they point to might be destroyed.
+   */
+  void ClearSelectors();
+
   // Return our ELEMENT_HAS_PENDING_(ANIMATION_)RESTYLE bit
   uint32_t RestyleBit() const {
     return mRestyleBits & ELEMENT_PENDING_RESTYLE_FLAGS;
@@ -392,6 +400,10 @@ private:
   // flag.  We need this to avoid enumerating the hashtable looking
   // for such entries when we can't possibly have any.
   bool mHaveLaterSiblingRestyles;
+  // True if we have some entries with selectors in the restyle hint data.
+  // Like mHaveLaterSiblingRestyles, this lets ClearSelectors avoid
+  // enumerating the hashtable.
+  bool mHaveSelectors;
 };
 
 inline bool
@@ -402,6 +414,11 @@ RestyleTracker::AddPendingRestyleToTable(Element* aElement,
 {
   RestyleData* existingData;
 
+  if (aRestyleHintData &&
+      !aRestyleHintData->mSelectorsForDescendants.IsEmpty()) {
+    mHaveSelectors = true;
+  }
+
   // Check the RestyleBit() flag before doing the hashtable Get, since
   // it's possible that the data in the hashtable isn't actually
   // relevant anymore (if the flag is not set).
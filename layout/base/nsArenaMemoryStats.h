@@ -43,6 +43,7 @@ struct nsArenaMemoryStats {
   macro(Style, mRuleNodes) \
   macro(Style, mStyleContexts) \
   macro(Style, mStyleStructs) \
+  macro(Other, mFreeObjects) \
   macro(Other, mOther)
 
   nsArenaMemoryStats()
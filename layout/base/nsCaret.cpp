@@ -538,9 +538,20 @@ nsCaret::CheckSelectionLanguageChange()
 
 nsIFrame*
 nsCaret::GetPaintGeometry(nsRect* aRect)
+{
+  // Return null if we're blinked off.
+  if (!mIsBlinkOn) {
+    return nullptr;
+  }
+
+  return GetPaintGeometryIgnoringBlink(aRect);
+}
+
+nsIFrame*
+nsCaret::GetPaintGeometryIgnoringBlink(nsRect* aRect)
 {
   // Return null if we should not be visible.
-  if (!IsVisible() || !mIsBlinkOn) {
+  if (!IsVisible()) {
     return nullptr;
   }
 
@@ -980,7 +991,16 @@ void nsCaret::CaretBlinkCallback(nsITimer* aTimer, void* aClosure)
     return;
   }
   theCaret->mIsBlinkOn = !theCaret->mIsBlinkOn;
-  theCaret->SchedulePaint();
+
+  // Blinking a caret that has been scrolled out of view doesn't change
+  // anything on the screen, so don't rebuild the display list for it.  The
+  // paint that scrolls it back into view will use the current blink state.
+  nsRect caretRect;
+  nsIFrame* caretFrame = theCaret->GetPaintGeometryIgnoringBlink(&caretRect);
+  if (caretFrame &&
+      nsLayoutUtils::IsRectVisibleInScrollFrames(caretFrame, caretRect)) {
+    theCaret->SchedulePaint();
+  }
 
   // mBlinkCount of -1 means blink count is not enabled.
   if (theCaret->mBlinkCount == -1) {
@@ -179,6 +179,10 @@ protected:
     void          ResetBlinking();
     void          StopBlinking();
 
+    // Like GetPaintGeometry, but returns the geometry even while the caret
+    // is blinked off.
+    nsIFrame*     GetPaintGeometryIgnoringBlink(nsRect* aRect);
+
     mozilla::dom::Selection* GetSelectionInternal();
 
     struct Metrics {
@@ -3703,6 +3703,11 @@ RequiredLayerStateForChildren(nsDisplayListBuilder* aBuilder,
         }
       }
     }
+    // Nothing below can raise the result any further, so don't bother
+    // computing the layer state of the remaining items.
+    if (result == LAYER_ACTIVE_FORCE) {
+      break;
+    }
   }
   return result;
 }
@@ -147,12 +147,16 @@ nsPresArena::AddSizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf,
   for (auto iter = mFreeLists.Iter(); !iter.Done(); iter.Next()) {
     FreeList* entry = iter.Get();
 
-    // Note that we're not measuring the size of the entries on the free
-    // list here.  The free list knows how many objects we've allocated
-    // ever (which includes any objects that may be on the FreeList's
-    // |mEntries| at this point) and we're using that to determine the
-    // total size of objects allocated with a given ID.
-    size_t totalSize = entry->mEntrySize * entry->mEntriesEverAllocated;
+    // The free list knows how many objects we've allocated ever (which
+    // includes any objects that are on the FreeList's |mEntries| at this
+    // point).  Objects on |mEntries| are dead and only kept for reuse by
+    // objects with the same ID, so report them separately from the live
+    // objects of each type.
+    size_t freeSize = entry->mEntrySize * entry->mEntries.Length();
+    size_t totalSize =
+      entry->mEntrySize * entry->mEntriesEverAllocated - freeSize;
+    aArenaStats->mFreeObjects += freeSize;
+    totalSizeInFreeLists += freeSize;
     size_t* p;
 
     switch (NS_PTR_TO_INT32(entry->mKey)) {
@@ -4452,6 +4452,11 @@ PresShell::RecordStyleSheetChange(nsIStyleSheet* aStyleSheet)
   // too bad we can't check that the update is UPDATE_STYLE
   NS_ASSERTION(mUpdateCount != 0, "must be in an update");
 
+  // The change may destroy selectors that pending restyles point to.
+  if (RestyleManager* restyleManager = mPresContext->RestyleManager()) {
+    restyleManager->ClearSelectors();
+  }
+
   if (mStylesHaveChanged)
     return;
 
@@ -77,10 +77,14 @@ using namespace mozilla::layout;
 
 static PRLogModuleInfo *gLog = nullptr;
 #define LOG(...) MOZ_LOG(gLog, mozilla::LogLevel::Debug, (__VA_ARGS__))
+#define LOG_ENABLED() MOZ_LOG_TEST(gLog, mozilla::LogLevel::Debug)
 
 #define DEFAULT_FRAME_RATE 60
 #define DEFAULT_THROTTLED_FRAME_RATE 1
 #define DEFAULT_RECOMPUTE_VISIBILITY_INTERVAL_MS 1000
+// after this many ticks in a row overrun the frame budget, start deferring
+// noncritical work
+#define OVER_BUDGET_TICKS_BEFORE_DEFERRING 3
 // after 10 minutes, stop firing off inactive timers
 #define DEFAULT_INACTIVE_TIMER_DISABLE_SECONDS 600
 
@@ -1032,6 +1036,7 @@ nsRefreshDriver::nsRefreshDriver(nsPresContext* aPresContext)
     mPendingTransaction(0),
     mCompletedTransaction(0),
     mFreezeCount(0),
+    mOverBudgetTickCount(0),
     mThrottledFrameRequestInterval(TimeDuration::FromMilliseconds(
                                      GetThrottledTimerInterval())),
     mMinRecomputeVisibilityInterval(GetMinRecomputeVisibilityInterval()),
@@ -1578,6 +1583,12 @@ nsRefreshDriver::RunFrameRequestCallbacks(TimeStamp aNowTime)
     if (!tickThrottledFrameRequests &&
         aNowTime >= mNextThrottledFrameRequestTick) {
       mNextThrottledFrameRequestTick = aNowTime + mThrottledFrameRequestInterval;
+      // Callbacks of throttled documents aren't visible, so when we keep
+      // missing frames, run them at half their usual rate to leave more of
+      // the frame to the documents the user is looking at.
+      if (IsOverFrameBudget()) {
+        mNextThrottledFrameRequestTick += mThrottledFrameRequestInterval;
+      }
       tickThrottledFrameRequests = true;
     }
 
@@ -1739,6 +1750,7 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
       if (mPresContext && mPresContext->GetPresShell()) {
         bool tracingStyleFlush = false;
+        TimeStamp styleFlushStart;
         nsAutoTArray<nsIPresShell*, 16> observers;
         observers.AppendElements(mStyleFlushObservers);
         for (uint32_t j = observers.Length();
@@ -1751,6 +1763,9 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
           if (!tracingStyleFlush) {
             tracingStyleFlush = true;
+            if (LOG_ENABLED()) {
+              styleFlushStart = TimeStamp::Now();
+            }
             profiler_tracing("Paint", "Styles", mStyleCause, TRACING_INTERVAL_START);
             mStyleCause = nullptr;
           }
@@ -1773,6 +1788,10 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
         if (tracingStyleFlush) {
           profiler_tracing("Paint", "Styles", TRACING_INTERVAL_END);
+          if (!styleFlushStart.IsNull()) {
+            LOG("[%p] style flush took %f ms", this,
+                (TimeStamp::Now() - styleFlushStart).ToMilliseconds());
+          }
         }
 
         if (!nsLayoutUtils::AreAsyncAnimationsEnabled()) {
@@ -1782,6 +1801,7 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
     } else if  (i == 1) {
       // This is the Flush_Layout case.
       bool tracingLayoutFlush = false;
+      TimeStamp layoutFlushStart;
       nsAutoTArray<nsIPresShell*, 16> observers;
       observers.AppendElements(mLayoutFlushObservers);
       for (uint32_t j = observers.Length();
@@ -1794,6 +1814,9 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
         if (!tracingLayoutFlush) {
           tracingLayoutFlush = true;
+          if (LOG_ENABLED()) {
+            layoutFlushStart = TimeStamp::Now();
+          }
           profiler_tracing("Paint", "Reflow", mReflowCause, TRACING_INTERVAL_START);
           mReflowCause = nullptr;
         }
@@ -1819,6 +1842,10 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
       if (tracingLayoutFlush) {
         profiler_tracing("Paint", "Reflow", TRACING_INTERVAL_END);
+        if (!layoutFlushStart.IsNull()) {
+          LOG("[%p] layout flush took %f ms", this,
+              (TimeStamp::Now() - layoutFlushStart).ToMilliseconds());
+        }
       }
     }
 
@@ -1892,7 +1919,15 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
 
     mViewManagerFlushIsPending = false;
     nsRefPtr<nsViewManager> vm = mPresContext->GetPresShell()->GetViewManager();
+    TimeStamp paintStart;
+    if (LOG_ENABLED()) {
+      paintStart = TimeStamp::Now();
+    }
     vm->ProcessPendingUpdates();
+    if (!paintStart.IsNull()) {
+      LOG("[%p] paint took %f ms", this,
+          (TimeStamp::Now() - paintStart).ToMilliseconds());
+    }
 #ifdef MOZ_DUMP_PAINTING
     if (nsLayoutUtils::InvalidationDebuggingIsEnabled()) {
       printf_stderr("Ending ProcessPendingUpdates\n");
@@ -1912,6 +1947,8 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
   mozilla::Telemetry::AccumulateTimeDelta(mozilla::Telemetry::REFRESH_DRIVER_TICK, mTickStart);
 #endif
 
+  UpdateFrameBudget();
+
   nsTObserverArray<nsAPostRefreshObserver*>::ForwardIterator iter(mPostRefreshObservers);
   while (iter.HasMore()) {
     nsAPostRefreshObserver* observer = iter.GetNext();
@@ -1924,6 +1961,37 @@ nsRefreshDriver::Tick(int64_t aNowEpoch, TimeStamp aNowTime)
   NS_ASSERTION(mInRefresh, "Still in refresh");
 }
 
+void
+nsRefreshDriver::UpdateFrameBudget()
+{
+  // Throttled refresh drivers tick far less often than once a frame, so
+  // there's no budget to speak of.
+  if (mThrottled || mTestControllingRefreshes) {
+    mOverBudgetTickCount = 0;
+    return;
+  }
+
+  double tickMs = (TimeStamp::Now() - mTickStart).ToMilliseconds();
+  bool overBudget = tickMs > GetRegularTimerInterval();
+
+  if (!overBudget) {
+    mOverBudgetTickCount = 0;
+    return;
+  }
+
+  if (++mOverBudgetTickCount == OVER_BUDGET_TICKS_BEFORE_DEFERRING) {
+    LOG("[%p] tick overran its frame budget %u times, deferring work",
+        this, mOverBudgetTickCount);
+    profiler_tracing("Paint", "RDOverBudget", TRACING_EVENT);
+  }
+}
+
+bool
+nsRefreshDriver::IsOverFrameBudget() const
+{
+  return mOverBudgetTickCount >= OVER_BUDGET_TICKS_BEFORE_DEFERRING;
+}
+
 void
 nsRefreshDriver::BeginRefreshingImages(RequestTable& aEntries,
                                        ImageRequestParameters* aParms)
@@ -353,6 +353,13 @@ private:
 
   static mozilla::TimeDuration GetMinRecomputeVisibilityInterval();
 
+  // Record whether the tick that started at mTickStart took longer than a
+  // frame.
+  void UpdateFrameBudget();
+  // True if enough consecutive ticks overran their frame budget that we
+  // should start deferring noncritical work.
+  bool IsOverFrameBudget() const;
+
   bool HaveFrameRequestCallbacks() const {
     return mFrameRequestCallbackDocs.Length() != 0;
   }
@@ -377,6 +384,9 @@ private:
 
   uint32_t mFreezeCount;
 
+  // The number of consecutive ticks that took longer than a frame.
+  uint32_t mOverBudgetTickCount;
+
   // How long we wait between ticks for throttled (which generally means
   // non-visible) documents registered with a non-throttled refresh driver.
   const mozilla::TimeDuration mThrottledFrameRequestInterval;
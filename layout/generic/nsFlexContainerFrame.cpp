@@ -1494,6 +1494,44 @@ nsFlexContainerFrame::
   }
 }
 
+/**
+ * The result of a flex item's most recent measuring reflow, cached on the
+ * item so that its next measuring reflow can be skipped when the item
+ * isn't dirty and would be measured under the same constraints.
+ */
+class CachedMeasuringReflowResult
+{
+public:
+  CachedMeasuringReflowResult(const nsHTMLReflowState& aReflowState,
+                              nscoord aHeight, nscoord aAscent)
+    : mAvailableWidth(aReflowState.AvailableWidth())
+    , mComputedWidth(aReflowState.ComputedWidth())
+    , mComputedHeight(aReflowState.ComputedHeight())
+    , mHeight(aHeight)
+    , mAscent(aAscent)
+  {}
+
+  bool IsValidFor(const nsHTMLReflowState& aReflowState) const
+  {
+    return mAvailableWidth == aReflowState.AvailableWidth() &&
+           mComputedWidth == aReflowState.ComputedWidth() &&
+           mComputedHeight == aReflowState.ComputedHeight();
+  }
+
+  nscoord Height() const { return mHeight; }
+  nscoord Ascent() const { return mAscent; }
+
+private:
+  const nscoord mAvailableWidth;
+  const nscoord mComputedWidth;
+  const nscoord mComputedHeight;
+  const nscoord mHeight;
+  const nscoord mAscent;
+};
+
+NS_DECLARE_FRAME_PROPERTY(CachedFlexMeasuringReflow,
+                          DeleteValue<CachedMeasuringReflowResult>)
+
 nscoord
 nsFlexContainerFrame::
   MeasureFlexItemContentHeight(nsPresContext* aPresContext,
@@ -1521,6 +1559,27 @@ nsFlexContainerFrame::
     childRSForMeasuringHeight.SetVResize(true);
   }
 
+  // If nothing in the item's subtree has changed since we last measured it
+  // under the same constraints, reuse that measurement instead of reflowing.
+  // (Nested flex containers would otherwise remeasure their whole subtree on
+  // every reflow.)  Note that we don't call SetHadMeasuringReflow() in that
+  // case, since the item keeps the size from its last final reflow.
+  bool measuringHeightNeedsAscent =
+    aFlexItem.Frame() == mFrames.FirstChild() ||
+    aFlexItem.GetAlignSelf() == NS_STYLE_ALIGN_ITEMS_BASELINE;
+  FrameProperties props = aFlexItem.Frame()->Properties();
+  CachedMeasuringReflowResult* cachedResult =
+    static_cast<CachedMeasuringReflowResult*>(
+      props.Get(CachedFlexMeasuringReflow()));
+  if (cachedResult && !NS_SUBTREE_DIRTY(aFlexItem.Frame()) &&
+      !(GetStateBits() & NS_FRAME_IS_DIRTY) &&
+      cachedResult->IsValidFor(childRSForMeasuringHeight)) {
+    if (measuringHeightNeedsAscent) {
+      aFlexItem.SetAscent(cachedResult->Ascent());
+    }
+    return cachedResult->Height();
+  }
+
   nsHTMLReflowMetrics childDesiredSize(childRSForMeasuringHeight);
   nsReflowStatus childReflowStatus;
   const uint32_t flags = NS_FRAME_NO_MOVE_FRAME;
@@ -1541,8 +1600,7 @@ nsFlexContainerFrame::
   // If this is the first child, save its ascent, since it may be what
   // establishes the container's baseline. Also save the ascent if this child
   // needs to be baseline-aligned. (Else, we don't care about ascent/baseline.)
-  if (aFlexItem.Frame() == mFrames.FirstChild() ||
-      aFlexItem.GetAlignSelf() == NS_STYLE_ALIGN_ITEMS_BASELINE) {
+  if (measuringHeightNeedsAscent) {
     aFlexItem.SetAscent(childDesiredSize.BlockStartAscent());
   }
 
@@ -1550,8 +1608,14 @@ nsFlexContainerFrame::
   // the effective computed value of the "height" property.
   nscoord childDesiredHeight = childDesiredSize.Height() -
     childRSForMeasuringHeight.ComputedPhysicalBorderPadding().TopBottom();
+  childDesiredHeight = std::max(0, childDesiredHeight);
 
-  return std::max(0, childDesiredHeight);
+  props.Set(CachedFlexMeasuringReflow(),
+            new CachedMeasuringReflowResult(childRSForMeasuringHeight,
+                                            childDesiredHeight,
+                                            childDesiredSize.BlockStartAscent()));
+
+  return childDesiredHeight;
 }
 
 FlexItem::FlexItem(nsHTMLReflowState& aFlexItemReflowState,
@@ -3891,6 +3955,24 @@ nsFlexContainerFrame::DoFlexLayout(nsPresContext*           aPresContext,
           }
         }
       }
+      if (itemNeedsReflow && aPresContext->HasPendingInterrupt() &&
+          !(item->Frame()->GetStateBits() & NS_FRAME_FIRST_REFLOW)) {
+        // The reflow is being interrupted, so don't spend time on this
+        // item's final reflow; just put it in its new position for now.
+        // CheckForInterrupt makes sure we get reflowed again after the
+        // interrupt, and the dirty bit makes sure that reflow reaches the
+        // item (like nsAbsoluteContainingBlock::Reflow does).
+        itemNeedsReflow = false;
+        MoveFlexItemToFinalPosition(aReflowState, *item, framePos,
+                                    containerSize);
+        if (aPresContext->CheckForInterrupt(this)) {
+          if (GetStateBits() & NS_FRAME_IS_DIRTY) {
+            item->Frame()->AddStateBits(NS_FRAME_IS_DIRTY);
+          } else {
+            item->Frame()->AddStateBits(NS_FRAME_HAS_DIRTY_CHILDREN);
+          }
+        }
+      }
       if (itemNeedsReflow) {
         ReflowFlexItem(aPresContext, aAxisTracker, aReflowState,
                        *item, framePos, containerSize);
@@ -1163,6 +1163,21 @@ nsGridContainerFrame::ReflowChildren(GridItemCSSOrderIterator&  aIter,
   nsPresContext* pc = PresContext();
   for (; !aIter.AtEnd(); aIter.Next()) {
     nsIFrame* child = *aIter;
+    if (pc->HasPendingInterrupt() &&
+        !(child->GetStateBits() & NS_FRAME_FIRST_REFLOW)) {
+      // The reflow is being interrupted; leave this child where it is and
+      // make sure the reflow that continues this one reaches it (see
+      // nsAbsoluteContainingBlock::Reflow).
+      if (pc->CheckForInterrupt(this)) {
+        if (GetStateBits() & NS_FRAME_IS_DIRTY) {
+          child->AddStateBits(NS_FRAME_IS_DIRTY);
+        } else {
+          child->AddStateBits(NS_FRAME_HAS_DIRTY_CHILDREN);
+        }
+      }
+      ConsiderChildOverflow(aDesiredSize.mOverflowAreas, child);
+      continue;
+    }
     const bool isGridItem = child->GetType() != nsGkAtoms::placeholderFrame;
     LogicalRect cb(wm);
     if (MOZ_LIKELY(isGridItem)) {
@@ -1474,14 +1474,17 @@ void BuildTextRunsScanner::FlushFrames(bool aFlushLineBreaks, bool aSuppressTrai
 {
   gfxTextRun* textRun = nullptr;
   if (!mMappedFlows.IsEmpty()) {
-    if (!mSkipIncompleteTextRuns && mCurrentFramesAllSameTextRun &&
+    if (mCurrentFramesAllSameTextRun &&
         ((mCurrentFramesAllSameTextRun->GetFlags() & nsTextFrameUtils::TEXT_INCOMING_WHITESPACE) != 0) ==
         ((mCurrentRunContextInfo & nsTextFrameUtils::INCOMING_WHITESPACE) != 0) &&
         ((mCurrentFramesAllSameTextRun->GetFlags() & gfxTextRunFactory::TEXT_INCOMING_ARABICCHAR) != 0) ==
         ((mCurrentRunContextInfo & nsTextFrameUtils::INCOMING_ARABICCHAR) != 0) &&
         IsTextRunValidForMappedFlows(mCurrentFramesAllSameTextRun)) {
-      // Optimization: We do not need to (re)build the textrun.
+      // Optimization: We do not need to (re)build the textrun.  This also
+      // applies to incomplete textruns that are only needed to give the
+      // linebreaker context, which would be shaped and then thrown away.
       textRun = mCurrentFramesAllSameTextRun;
+      bool isIncomplete = mSkipIncompleteTextRuns;
 
       // Feed this run's text into the linebreaker to provide context.
       if (!SetupLineBreakerContext(textRun)) {
@@ -1496,6 +1499,12 @@ void BuildTextRunsScanner::FlushFrames(bool aFlushLineBreaks, bool aSuppressTrai
       if (textRun->GetFlags() & gfxTextRunFactory::TEXT_TRAILING_ARABICCHAR) {
         mNextRunContextInfo |= nsTextFrameUtils::INCOMING_ARABICCHAR;
       }
+
+      if (isIncomplete) {
+        // Like BuildTextRunForFrames, don't let an incomplete run be
+        // treated as the textrun we just built.
+        textRun = nullptr;
+      }
     } else {
       AutoFallibleTArray<uint8_t,BIG_TEXT_NODE_SIZE> buffer;
       uint32_t bufferSize = mMaxTextLength*(mDoubleByteText ? 2 : 1);
@@ -2372,6 +2381,13 @@ BuildTextRunsScanner::SetupLineBreakerContext(gfxTextRun *aTextRun)
   }
   SetupBreakSinksForTextRun(aTextRun, buffer.Elements(), flags);
 
+  if (mSkipIncompleteTextRuns) {
+    mSkipIncompleteTextRuns =
+      !TextContainsLineBreakerWhiteSpace(buffer.Elements(),
+                                         aTextRun->GetLength(),
+                                         mDoubleByteText);
+  }
+
   DestroyUserData(userDataToDestroy);
 
   return true;
@@ -19,6 +19,8 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/LoadInfo.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/StaticPtr.h"
 
 #include "mozilla/css/Loader.h"
 #include "nsIRunnable.h"
@@ -37,6 +39,9 @@
 #include "nsIScriptSecurityManager.h"
 #include "nsContentPolicyUtils.h"
 #include "nsIHttpChannel.h"
+#include "nsILoadGroup.h"
+#include "nsIMemoryReporter.h"
+#include "nsICacheInfoChannel.h"
 #include "nsIClassOfService.h"
 #include "nsIScriptError.h"
 #include "nsMimeTypes.h"
@@ -50,6 +55,8 @@
 #include "nsIThreadInternal.h"
 #include "nsCORSListenerProxy.h"
 #include "nsINetworkPredictor.h"
+#include "nsClassHashtable.h"
+#include "prtime.h"
 #include "mozilla/dom/ShadowRoot.h"
 #include "mozilla/dom/URL.h"
 
@@ -228,6 +235,15 @@ public:
   // async observer notification for an already-complete sheet.
   bool                       mSheetAlreadyComplete : 1;
 
+  // mCharsetFromSheet is true if the charset was determined by the sheet
+  // itself or its transport (BOM, channel or @charset rule) rather than by
+  // anything specific to the document that loaded it.
+  bool                       mCharsetFromSheet : 1;
+
+  // The time (in seconds since the epoch) at which the network cache entry
+  // we were loaded from expires, or 0 if unknown.
+  uint32_t                   mExpirationTime;
+
   // This is the element that imported the sheet.  Needed to get the
   // charset set on it and to fire load/error events.
   nsCOMPtr<nsIStyleSheetLinkingElement> mOwningElement;
@@ -336,6 +352,8 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mAllowUnsafeRules(false),
     mUseSystemPrincipal(false),
     mSheetAlreadyComplete(false),
+    mCharsetFromSheet(false),
+    mExpirationTime(0),
     mOwningElement(aOwningElement),
     mObserver(aObserver),
     mLoaderPrincipal(aLoaderPrincipal),
@@ -367,6 +385,8 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mAllowUnsafeRules(false),
     mUseSystemPrincipal(false),
     mSheetAlreadyComplete(false),
+    mCharsetFromSheet(false),
+    mExpirationTime(0),
     mOwningElement(nullptr),
     mObserver(aObserver),
     mLoaderPrincipal(aLoaderPrincipal),
@@ -410,6 +430,8 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mAllowUnsafeRules(aAllowUnsafeRules),
     mUseSystemPrincipal(aUseSystemPrincipal),
     mSheetAlreadyComplete(false),
+    mCharsetFromSheet(false),
+    mExpirationTime(0),
     mOwningElement(nullptr),
     mObserver(aObserver),
     mLoaderPrincipal(aLoaderPrincipal),
@@ -507,6 +529,189 @@ SheetLoadData::ScheduleLoadEventIfNeeded(nsresult aStatus)
   }
 }
 
+/****************************************
+ * Sheets shared between all documents *
+ ****************************************/
+
+// Complete, unmodified sheets loaded over HTTP are kept here so that other
+// documents loading the same sheet with the same principal, CORS mode and
+// referrer policy can clone it instead of waiting on the network and parsing
+// it again.  Entries are only used until the network cache entry they were
+// loaded from expires.
+struct SharedSheet
+{
+  nsRefPtr<CSSStyleSheet> mSheet;
+  uint32_t mExpirationTime;
+};
+
+typedef nsClassHashtable<URIPrincipalReferrerPolicyAndCORSModeHashKey,
+                         SharedSheet> SharedSheetTable;
+
+static StaticAutoPtr<SharedSheetTable> gSharedSheets;
+
+static const uint32_t kMaxSharedSheets = 64;
+
+MOZ_DEFINE_MALLOC_SIZE_OF(SharedSheetsMallocSizeOf)
+
+class SharedSheetsReporter final : public nsIMemoryReporter
+{
+  ~SharedSheetsReporter() {}
+
+public:
+  NS_DECL_ISUPPORTS
+
+  NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
+                            nsISupports* aData, bool aAnonymize) override
+  {
+    size_t n = 0;
+    if (gSharedSheets) {
+      n += gSharedSheets->ShallowSizeOfIncludingThis(SharedSheetsMallocSizeOf);
+      for (auto iter = gSharedSheets->Iter(); !iter.Done(); iter.Next()) {
+        n += SharedSheetsMallocSizeOf(iter.Data());
+        n += iter.Data()->mSheet->SizeOfIncludingThis(SharedSheetsMallocSizeOf);
+      }
+    }
+
+    return MOZ_COLLECT_REPORT(
+      "explicit/layout/style-sheet-cache/shared", KIND_HEAP, UNITS_BYTES, n,
+      "Memory used for parsed style sheets shared between documents.");
+  }
+};
+
+NS_IMPL_ISUPPORTS(SharedSheetsReporter, nsIMemoryReporter)
+
+static uint32_t
+SecondsSinceEpoch()
+{
+  return uint32_t(PR_Now() / PR_USEC_PER_SEC);
+}
+
+// Whether the document is being loaded in a way that asks for subresources to
+// be revalidated or reloaded (a reload or shift-reload), or only taken from the
+// cache (e.g. session history).  Those loads go through the network cache,
+// which knows how to honor them; the shared sheets don't.
+static bool
+DocumentLoadFlagsForbidSharing(nsIDocument* aDocument)
+{
+  const nsLoadFlags kFlags = nsIRequest::LOAD_BYPASS_CACHE |
+                             nsIRequest::VALIDATE_ALWAYS |
+                             nsIRequest::LOAD_FROM_CACHE;
+
+  nsLoadFlags flags;
+  nsCOMPtr<nsILoadGroup> loadGroup = aDocument->GetDocumentLoadGroup();
+  if (loadGroup && NS_SUCCEEDED(loadGroup->GetLoadFlags(&flags)) &&
+      (flags & kFlags)) {
+    return true;
+  }
+
+  nsIChannel* channel = aDocument->GetChannel();
+  if (channel && NS_SUCCEEDED(channel->GetLoadFlags(&flags)) &&
+      (flags & kFlags)) {
+    return true;
+  }
+
+  return false;
+}
+
+static bool
+CanShareSheetsForDocument(nsIDocument* aDocument, nsIURI* aURI)
+{
+  if (!aDocument || nsContentUtils::IsInPrivateBrowsing(aDocument) ||
+      DocumentLoadFlagsForbidSharing(aDocument)) {
+    return false;
+  }
+
+  bool isHTTP = false, isHTTPS = false;
+  aURI->SchemeIs("http", &isHTTP);
+  aURI->SchemeIs("https", &isHTTPS);
+  return isHTTP || isHTTPS;
+}
+
+static already_AddRefed<CSSStyleSheet>
+GetSharedSheet(URIPrincipalReferrerPolicyAndCORSModeHashKey* aKey)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!gSharedSheets) {
+    return nullptr;
+  }
+
+  SharedSheet* entry = gSharedSheets->Get(aKey);
+  if (!entry) {
+    return nullptr;
+  }
+
+  if (entry->mExpirationTime <= SecondsSinceEpoch() ||
+      entry->mSheet->IsModified()) {
+    gSharedSheets->Remove(aKey);
+    return nullptr;
+  }
+
+  nsRefPtr<CSSStyleSheet> sheet = entry->mSheet;
+  return sheet.forget();
+}
+
+static void
+PutSharedSheet(URIPrincipalReferrerPolicyAndCORSModeHashKey* aKey,
+               CSSStyleSheet* aSheet,
+               uint32_t aExpirationTime)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  uint32_t now = SecondsSinceEpoch();
+  if (aExpirationTime <= now) {
+    return;
+  }
+
+  if (!gSharedSheets) {
+    gSharedSheets = new SharedSheetTable();
+    ClearOnShutdown(&gSharedSheets);
+    RegisterStrongMemoryReporter(new SharedSheetsReporter());
+  }
+
+  if (gSharedSheets->Count() >= kMaxSharedSheets) {
+    for (auto iter = gSharedSheets->Iter(); !iter.Done(); iter.Next()) {
+      if (iter.Data()->mExpirationTime <= now) {
+        iter.Remove();
+      }
+    }
+    if (gSharedSheets->Count() >= kMaxSharedSheets) {
+      // Nothing has expired; make room by dropping an arbitrary entry.
+      auto iter = gSharedSheets->Iter();
+      iter.Remove();
+    }
+  }
+
+  // Cache a clone, so that CSSOM changes made through the sheet the
+  // document is using are never seen by other documents.
+  nsRefPtr<CSSStyleSheet> clone = aSheet->Clone(nullptr, nullptr,
+                                                nullptr, nullptr);
+  if (!clone) {
+    return;
+  }
+
+  SharedSheet* entry = new SharedSheet();
+  entry->mSheet = clone.forget();
+  entry->mExpirationTime = aExpirationTime;
+  gSharedSheets->Put(aKey, entry);
+}
+
+static void
+RemoveSharedSheetsWithURI(nsIURI* aURI)
+{
+  if (!gSharedSheets) {
+    return;
+  }
+
+  for (auto iter = gSharedSheets->Iter(); !iter.Done(); iter.Next()) {
+    bool areEqual;
+    nsresult rv = iter.Key()->GetURI()->Equals(aURI, &areEqual);
+    if (NS_SUCCEEDED(rv) && areEqual) {
+      iter.Remove();
+    }
+  }
+}
+
 /*************************
  * Loader Implementation *
  *************************/
@@ -675,6 +880,7 @@ SheetLoadData::OnDetermineCharset(nsIUnicharStreamLoader* aLoader,
     // aCharset is now either "UTF-16BE", "UTF-16BE" or "UTF-8"
     // which will swallow the BOM.
     mCharset.Assign(aCharset);
+    mCharsetFromSheet = true;
     LOG(("  Setting from BOM to: %s", PromiseFlatCString(aCharset).get()));
     return NS_OK;
   }
@@ -686,6 +892,7 @@ SheetLoadData::OnDetermineCharset(nsIUnicharStreamLoader* aLoader,
     channel->GetContentCharset(specified);
     if (EncodingUtils::FindEncodingForLabel(specified, aCharset)) {
       mCharset.Assign(aCharset);
+      mCharsetFromSheet = true;
       LOG(("  Setting from HTTP to: %s", PromiseFlatCString(aCharset).get()));
       return NS_OK;
     }
@@ -707,6 +914,7 @@ SheetLoadData::OnDetermineCharset(nsIUnicharStreamLoader* aLoader,
         aCharset.AssignLiteral("UTF-8");
       }
       mCharset.Assign(aCharset);
+      mCharsetFromSheet = true;
       LOG(("  Setting from @charset rule to: %s",
           PromiseFlatCString(aCharset).get()));
       return NS_OK;
@@ -951,6 +1159,14 @@ SheetLoadData::OnStreamComplete(nsIUnicharStreamLoader* aLoader,
     return NS_OK;
   }
 
+  nsCOMPtr<nsICacheInfoChannel> cacheInfo(do_QueryInterface(channel));
+  if (cacheInfo) {
+    uint32_t expirationTime;
+    if (NS_SUCCEEDED(cacheInfo->GetCacheTokenExpirationTime(&expirationTime))) {
+      mExpirationTime = expirationTime;
+    }
+  }
+
   // Enough to set the URIs on mSheet, since any sibling datas we have share
   // the same mInner as mSheet and will thus get the same URI.
   mSheet->SetURIs(channelURI, originalURI, channelURI);
@@ -1009,6 +1225,7 @@ Loader::ObsoleteSheet(nsIURI* aURI)
     return NS_ERROR_INVALID_ARG;
   }
   mSheets->mCompleteSheets.Enumerate(RemoveEntriesWithURI, aURI);
+  RemoveSharedSheetsWithURI(aURI);
   return NS_OK;
 }
 
@@ -1128,6 +1345,14 @@ Loader::CreateSheet(nsIURI* aURI,
       LOG(("  From completed: %p", sheet.get()));
 
       fromCompleteSheets = !!sheet;
+
+      // Then the sheets shared between documents.  Sheets with integrity
+      // metadata always go to the network so the load is checked.
+      if (!sheet && !aSyncLoad && aIntegrity.IsEmpty() &&
+          CanShareSheetsForDocument(mDocument, aURI)) {
+        sheet = GetSharedSheet(&key);
+        LOG(("  From shared: %p", sheet.get()));
+      }
     }
 
     if (sheet) {
@@ -1928,6 +2153,17 @@ Loader::DoSheetComplete(SheetLoadData* aLoadData, nsresult aStatus,
       NS_ASSERTION(sheet->IsComplete(),
                    "Should only be caching complete sheets");
       mSheets->mCompleteSheets.Put(&key, sheet);
+
+      // Only share top-level sheets whose contents don't depend on the
+      // document that loaded them.  @import children may expire
+      // independently of their parent, so sheets with children aren't
+      // shared either.
+      if (!aLoadData->mParentData && !aLoadData->mIsNonDocumentSheet &&
+          aLoadData->mCharsetFromSheet &&
+          sheet->GetIntegrity().IsEmpty() && sheet->StyleSheetCount() == 0 &&
+          CanShareSheetsForDocument(mDocument, aLoadData->mURI)) {
+        PutSharedSheet(&key, sheet, aLoadData->mExpirationTime);
+      }
 #ifdef MOZ_XUL
     }
 #endif
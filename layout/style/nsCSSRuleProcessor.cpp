@@ -52,6 +52,7 @@
 #include "mozilla/EventStates.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/LookAndFeel.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Likely.h"
 #include "mozilla/TypedEnumBits.h"
 #include "RuleProcessorCache.h"
@@ -87,6 +88,36 @@ struct RuleSelectorPair {
 #define NS_IS_ANCESTOR_OPERATOR(ch) \
   ((ch) == char16_t(' ') || (ch) == char16_t('>'))
 
+/**
+ * Returns the hash that an atom for the ASCII-lowercased version of aAtom
+ * would have.  This is aAtom's own hash when it contains no ASCII uppercase
+ * characters.  Used to put ids and classes into the ancestor filter in a way
+ * that quirks mode (which matches them ASCII-case-insensitively) can use.
+ */
+static uint32_t
+ASCIILowercaseAtomHash(nsIAtom* aAtom)
+{
+  const char16_t* str = aAtom->GetUTF16String();
+  uint32_t length = aAtom->GetLength();
+  uint32_t i = 0;
+  while (i < length && !(str[i] >= 'A' && str[i] <= 'Z')) {
+    ++i;
+  }
+  if (i == length) {
+    return aAtom->hash();
+  }
+
+  uint32_t hash = 0;
+  for (i = 0; i < length; ++i) {
+    char16_t c = str[i];
+    if (c >= 'A' && c <= 'Z') {
+      c += 'a' - 'A';
+    }
+    hash = AddToHash(hash, c);
+  }
+  return hash;
+}
+
 /**
  * A struct representing a particular rule in an ordered list of rules
  * (the ordering depending on the weight of mSelector and the order of
@@ -97,7 +128,7 @@ struct RuleValue : RuleSelectorPair {
     eMaxAncestorHashes = 4
   };
 
-  RuleValue(const RuleSelectorPair& aRuleSelectorPair, int32_t aIndex,
+  RuleValue(const RuleSelectorPair& aRuleSelectorPair, uint64_t aIndex,
             bool aQuirksMode) :
     RuleSelectorPair(aRuleSelectorPair),
     mIndex(aIndex)
@@ -105,7 +136,14 @@ struct RuleValue : RuleSelectorPair {
     CollectAncestorHashes(aQuirksMode);
   }
 
-  int32_t mIndex; // High index means high weight/order.
+  // Builds an index from a selector weight and a sequence number that grows
+  // in rule order, so indices sort by weight first and by order second no
+  // matter in which order rules are added.
+  static uint64_t MakeIndex(int32_t aWeight, uint32_t aSequence) {
+    return (uint64_t(uint32_t(aWeight)) << 32) | aSequence;
+  }
+
+  uint64_t mIndex; // High index means high weight/order.
   uint32_t mAncestorSelectorHashes[eMaxAncestorHashes];
 
 private:
@@ -126,26 +164,27 @@ private:
 
       // Now sel is supposed to select one of our ancestors.  Grab
       // whatever info we can from it into mAncestorSelectorHashes.
-      // But in qurks mode, don't grab IDs and classes because those
-      // need to be matched case-insensitively.
-      if (!aQuirksMode) {
-        nsAtomList* ids = sel->mIDList;
-        while (ids) {
-          mAncestorSelectorHashes[hashIndex++] = ids->mAtom->hash();
-          if (hashIndex == eMaxAncestorHashes) {
-            return;
-          }
-          ids = ids->mNext;
+      // In quirks mode IDs and classes need to be matched
+      // case-insensitively, so use the hashes of their lowercased
+      // versions, which AncestorFilter::PushAncestor also adds.
+      nsAtomList* ids = sel->mIDList;
+      while (ids) {
+        mAncestorSelectorHashes[hashIndex++] = aQuirksMode ?
+          ASCIILowercaseAtomHash(ids->mAtom) : ids->mAtom->hash();
+        if (hashIndex == eMaxAncestorHashes) {
+          return;
         }
+        ids = ids->mNext;
+      }
 
-        nsAtomList* classes = sel->mClassList;
-        while (classes) {
-          mAncestorSelectorHashes[hashIndex++] = classes->mAtom->hash();
-          if (hashIndex == eMaxAncestorHashes) {
-            return;
-          }
-          classes = classes->mNext;
+      nsAtomList* classes = sel->mClassList;
+      while (classes) {
+        mAncestorSelectorHashes[hashIndex++] = aQuirksMode ?
+          ASCIILowercaseAtomHash(classes->mAtom) : classes->mAtom->hash();
+        if (hashIndex == eMaxAncestorHashes) {
+          return;
         }
+        classes = classes->mNext;
       }
 
       // Only put in the tag name if it's all-lowercase.  Otherwise we run into
@@ -183,6 +222,30 @@ struct RuleHashTagTableEntry : public RuleHashTableEntry {
   nsCOMPtr<nsIAtom> mTag;
 };
 
+// Inserts aValue into aRules, which is sorted by mIndex.  When a cascade is
+// built from scratch rules come in increasing index order and are simply
+// appended; rules of sheets appended to an existing cascade may fall in
+// between.
+static void
+InsertRuleValue(nsTArray<RuleValue>& aRules, const RuleValue& aValue)
+{
+  if (aRules.IsEmpty() || aRules.LastElement().mIndex < aValue.mIndex) {
+    aRules.AppendElement(aValue);
+    return;
+  }
+
+  size_t low = 0, high = aRules.Length();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (aRules[mid].mIndex < aValue.mIndex) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  aRules.InsertElementAt(low, aValue);
+}
+
 static PLDHashNumber
 RuleHash_CIHashKey(PLDHashTable *table, const void *key)
 {
@@ -437,7 +500,7 @@ class RuleHash {
 public:
   explicit RuleHash(bool aQuirksMode);
   ~RuleHash();
-  void AppendRule(const RuleSelectorPair &aRuleInfo);
+  void AppendRule(const RuleSelectorPair &aRuleInfo, int32_t aWeight);
   void EnumerateAllRules(Element* aElement, ElementDependentRuleProcessorData* aData,
                          NodeMatchContext& aNodeMatchContext);
 
@@ -447,10 +510,11 @@ public:
 protected:
   typedef nsTArray<RuleValue> RuleValueList;
   void AppendRuleToTable(PLDHashTable* aTable, const void* aKey,
-                         const RuleSelectorPair& aRuleInfo);
-  void AppendUniversalRule(const RuleSelectorPair& aRuleInfo);
+                         const RuleValue& aRuleValue);
+  void AppendUniversalRule(const RuleValue& aRuleValue);
 
-  int32_t     mRuleCount;
+  // Sequence number of the next rule added, see RuleValue::MakeIndex.
+  uint32_t    mRuleCount;
 
   PLDHashTable mIdTable;
   PLDHashTable mClassTable;
@@ -562,13 +626,13 @@ RuleHash::~RuleHash()
 }
 
 void RuleHash::AppendRuleToTable(PLDHashTable* aTable, const void* aKey,
-                                 const RuleSelectorPair& aRuleInfo)
+                                 const RuleValue& aRuleValue)
 {
   // Get a new or existing entry.
   auto entry = static_cast<RuleHashTableEntry*>(aTable->Add(aKey, fallible));
   if (!entry)
     return;
-  entry->mRules.AppendElement(RuleValue(aRuleInfo, mRuleCount++, mQuirksMode));
+  InsertRuleValue(entry->mRules, aRuleValue);
 }
 
 static void
@@ -580,30 +644,31 @@ AppendRuleToTagTable(PLDHashTable* aTable, nsIAtom* aKey,
   if (!entry)
     return;
 
-  entry->mRules.AppendElement(aRuleInfo);
+  InsertRuleValue(entry->mRules, aRuleInfo);
 }
 
-void RuleHash::AppendUniversalRule(const RuleSelectorPair& aRuleInfo)
+void RuleHash::AppendUniversalRule(const RuleValue& aRuleValue)
 {
-  mUniversalRules.AppendElement(RuleValue(aRuleInfo, mRuleCount++, mQuirksMode));
+  InsertRuleValue(mUniversalRules, aRuleValue);
 }
 
-void RuleHash::AppendRule(const RuleSelectorPair& aRuleInfo)
+void RuleHash::AppendRule(const RuleSelectorPair& aRuleInfo, int32_t aWeight)
 {
   nsCSSSelector *selector = aRuleInfo.mSelector;
   if (selector->IsPseudoElement()) {
     selector = selector->mNext;
   }
+  RuleValue ruleValue(aRuleInfo, RuleValue::MakeIndex(aWeight, mRuleCount++),
+                      mQuirksMode);
   if (nullptr != selector->mIDList) {
-    AppendRuleToTable(&mIdTable, selector->mIDList->mAtom, aRuleInfo);
+    AppendRuleToTable(&mIdTable, selector->mIDList->mAtom, ruleValue);
     RULE_HASH_STAT_INCREMENT(mIdSelectors);
   }
   else if (nullptr != selector->mClassList) {
-    AppendRuleToTable(&mClassTable, selector->mClassList->mAtom, aRuleInfo);
+    AppendRuleToTable(&mClassTable, selector->mClassList->mAtom, ruleValue);
     RULE_HASH_STAT_INCREMENT(mClassSelectors);
   }
   else if (selector->mLowercaseTag) {
-    RuleValue ruleValue(aRuleInfo, mRuleCount++, mQuirksMode);
     AppendRuleToTagTable(&mTagTable, selector->mLowercaseTag, ruleValue);
     RULE_HASH_STAT_INCREMENT(mTagSelectors);
     if (selector->mCasedTag &&
@@ -614,11 +679,11 @@ void RuleHash::AppendRule(const RuleSelectorPair& aRuleInfo)
   }
   else if (kNameSpaceID_Unknown != selector->mNameSpace) {
     AppendRuleToTable(&mNameSpaceTable,
-                      NS_INT32_TO_PTR(selector->mNameSpace), aRuleInfo);
+                      NS_INT32_TO_PTR(selector->mNameSpace), ruleValue);
     RULE_HASH_STAT_INCREMENT(mNameSpaceSelectors);
   }
   else {  // universal tag selector
-    AppendUniversalRule(aRuleInfo);
+    AppendUniversalRule(ruleValue);
     RULE_HASH_STAT_INCREMENT(mUniversalSelectors);
   }
 }
@@ -715,9 +780,9 @@ void RuleHash::EnumerateAllRules(Element* aElement, ElementDependentRuleProcesso
     // Merge the lists while there are still multiple lists to merge.
     while (valueCount > 1) {
       int32_t valueIndex = 0;
-      int32_t lowestRuleIndex = mEnumList[valueIndex].mCurValue->mIndex;
+      uint64_t lowestRuleIndex = mEnumList[valueIndex].mCurValue->mIndex;
       for (int32_t index = 1; index < valueCount; ++index) {
-        int32_t ruleIndex = mEnumList[index].mCurValue->mIndex;
+        uint64_t ruleIndex = mEnumList[index].mCurValue->mIndex;
         if (ruleIndex < lowestRuleIndex) {
           valueIndex = index;
           lowestRuleIndex = ruleIndex;
@@ -894,6 +959,7 @@ struct RuleCascadeData {
       mCounterStyleRuleTable(),
       mCacheKey(aMedium),
       mNext(nullptr),
+      mPseudoRuleCount(0),
       mQuirksMode(aQuirksMode)
   {
     memset(mPseudoElementRuleHashes, 0, sizeof(mPseudoElementRuleHashes));
@@ -939,6 +1005,10 @@ struct RuleCascadeData {
   nsMediaQueryResultCacheKey mCacheKey;
   RuleCascadeData*  mNext; // for a different medium
 
+  // Sequence number of the next rule added to mAnonBoxRules or
+  // mXULTreeRules, see RuleValue::MakeIndex.
+  uint32_t mPseudoRuleCount;
+
   const bool mQuirksMode;
 };
 
@@ -1020,6 +1090,9 @@ nsCSSRuleProcessor::nsCSSRuleProcessor(const sheet_array_type& aSheets,
                                        bool aIsShared)
   : mSheets(aSheets)
   , mRuleCascades(nullptr)
+  , mAppendBaseCascade(nullptr)
+  , mAppendBasePresContext(nullptr)
+  , mAppendBaseSheetCount(0)
   , mPreviousCacheKey(aPreviousCSSRuleProcessor
                        ? aPreviousCSSRuleProcessor->CloneMQCacheKey()
                        : UniquePtr<nsMediaQueryResultCacheKey>())
@@ -1040,6 +1113,10 @@ nsCSSRuleProcessor::nsCSSRuleProcessor(const sheet_array_type& aSheets,
   for (sheet_array_type::size_type i = mSheets.Length(); i-- != 0; ) {
     mSheets[i]->AddRuleProcessor(this);
   }
+
+  if (aPreviousCSSRuleProcessor) {
+    TakeCascadeForAppendedSheets(aPreviousCSSRuleProcessor);
+  }
 }
 
 nsCSSRuleProcessor::~nsCSSRuleProcessor()
@@ -1051,6 +1128,53 @@ nsCSSRuleProcessor::~nsCSSRuleProcessor()
   MOZ_ASSERT(mStyleSetRefCnt == 0);
   ClearSheets();
   ClearRuleCascades();
+  DropAppendBaseCascade();
+}
+
+void
+nsCSSRuleProcessor::TakeCascadeForAppendedSheets(nsCSSRuleProcessor* aPrevious)
+{
+  // Shared rule processors can be in use by other style sets, and need
+  // their document rules gathered from all sheets.  Scoped ones are rare.
+  if (mIsShared || aPrevious->mIsShared || mScopeElement ||
+      aPrevious->mScopeElement || mSheetType != aPrevious->mSheetType) {
+    return;
+  }
+
+  RuleCascadeData* cascade = aPrevious->mRuleCascades;
+  uint32_t baseSheetCount = aPrevious->mSheets.Length();
+  if (!cascade || !aPrevious->mLastPresContext ||
+      baseSheetCount == 0 || baseSheetCount >= mSheets.Length()) {
+    return;
+  }
+  for (uint32_t i = 0; i < baseSheetCount; ++i) {
+    if (aPrevious->mSheets[i] != mSheets[i]) {
+      return;
+    }
+  }
+
+  // Leave aPrevious in the state it would be in after ClearRuleCascades if
+  // this was its only cascade; it'll rebuild if it is used again.
+  aPrevious->mRuleCascades = cascade->mNext;
+  cascade->mNext = nullptr;
+  if (!aPrevious->mRuleCascades && !aPrevious->mPreviousCacheKey &&
+      cascade->mCacheKey.HasFeatureConditions()) {
+    aPrevious->mPreviousCacheKey =
+      MakeUnique<nsMediaQueryResultCacheKey>(cascade->mCacheKey);
+  }
+
+  mAppendBaseCascade = cascade;
+  mAppendBasePresContext = aPrevious->mLastPresContext;
+  mAppendBaseSheetCount = baseSheetCount;
+}
+
+void
+nsCSSRuleProcessor::DropAppendBaseCascade()
+{
+  delete mAppendBaseCascade;
+  mAppendBaseCascade = nullptr;
+  mAppendBasePresContext = nullptr;
+  mAppendBaseSheetCount = 0;
 }
 
 NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(nsCSSRuleProcessor)
@@ -1844,7 +1968,10 @@ static bool SelectorMatches(Element* aElement,
             //   :-moz-empty-except-children-with-localname() ~ E
             // because we don't know to restyle the grandparent of the
             // inserted/removed element (as in bug 534804 for :empty).
-            aElement->SetFlags(NODE_HAS_SLOW_SELECTOR);
+            // NODE_HAS_EMPTY_SELECTOR also tells the style sharing cache
+            // that this element's style depends on its children.
+            aElement->SetFlags(NODE_HAS_SLOW_SELECTOR |
+                               NODE_HAS_EMPTY_SELECTOR);
           do {
             child = aElement->GetChildAt(++index);
           } while (child &&
@@ -2773,12 +2900,69 @@ nsCSSRuleProcessor::HasDocumentStateDependentStyle(StateRuleProcessorData* aData
   return cascade && cascade->mSelectorDocumentStates.HasAtLeastOneOfStates(aData->mStateMask);
 }
 
+static nsRestyleHint
+RestyleHintForSelectorWithAttributeChange(nsRestyleHint aCurrentHint,
+                                          nsCSSSelector* aSelector,
+                                          nsCSSSelector* aRightmostSelector)
+{
+  MOZ_ASSERT(aSelector);
+
+  char16_t oper = aSelector->mOperator;
+
+  if (oper == char16_t('+') || oper == char16_t('~')) {
+    return eRestyle_LaterSiblings;
+  }
+
+  if (oper == char16_t(':')) {
+    return eRestyle_Subtree;
+  }
+
+  if (oper != char16_t(0)) {
+    // Check whether the selector is in a form that supports
+    // eRestyle_SomeDescendants.  If it isn't, return eRestyle_Subtree.
+
+    if (aCurrentHint & eRestyle_Subtree) {
+      // No point checking, since we'll end up restyling the whole
+      // subtree anyway.
+      return eRestyle_Subtree;
+    }
+
+    if (!aRightmostSelector) {
+      // aSelector was in a :not(), so we don't know which top-level
+      // selector it belongs to.
+      return eRestyle_Subtree;
+    }
+
+    MOZ_ASSERT(aSelector != aRightmostSelector,
+               "if aSelector == aRightmostSelector then we should have "
+               "no operator");
+
+    // Check that aRightmostSelector can be passed to
+    // RestrictedSelectorMatches, and that none of the selectors between it
+    // and aSelector select a pseudo-element.
+    for (nsCSSSelector* sel = aRightmostSelector;
+         sel != aSelector;
+         sel = sel->mNext) {
+      MOZ_ASSERT(sel, "aSelector must be reachable from aRightmostSelector");
+      if (sel->PseudoType() != nsCSSPseudoElements::ePseudo_NotPseudoElement) {
+        return eRestyle_Subtree;
+      }
+    }
+
+    return eRestyle_SomeDescendants;
+  }
+
+  return eRestyle_Self;
+}
+
 struct AttributeEnumData {
-  explicit AttributeEnumData(AttributeRuleProcessorData *aData)
-    : data(aData), change(nsRestyleHint(0)) {}
+  AttributeEnumData(AttributeRuleProcessorData *aData,
+                    RestyleHintData& aRestyleHintData)
+    : data(aData), change(nsRestyleHint(0)), hintData(aRestyleHintData) {}
 
   AttributeRuleProcessorData *data;
   nsRestyleHint change;
+  RestyleHintData& hintData;
 };
 
 
@@ -2796,18 +2980,26 @@ AttributeEnumFunc(nsCSSSelector* aSelector,
     return;
   }
 
-  nsRestyleHint possibleChange = RestyleHintForOp(aSelector->mOperator);
+  nsRestyleHint possibleChange =
+    RestyleHintForSelectorWithAttributeChange(aData->change,
+                                              aSelector, aRightmostSelector);
 
-  // If enumData->change already includes all the bits of possibleChange, don't
-  // bother calling SelectorMatches, since even if it returns false
-  // enumData->change won't change.
+  // If, ignoring eRestyle_SomeDescendants, enumData->change already includes
+  // all the bits of possibleChange, don't bother calling SelectorMatches, since
+  // even if it returns false enumData->change won't change.  If possibleChange
+  // has eRestyle_SomeDescendants, we need to call SelectorMatches(Tree)
+  // regardless as it might give us new selectors to append to
+  // mSelectorsForDescendants.
   NodeMatchContext nodeContext(EventStates(), false);
-  if ((possibleChange & ~(aData->change)) &&
+  if (((possibleChange & (~(aData->change) | eRestyle_SomeDescendants))) &&
       SelectorMatches(data->mElement, aSelector, nodeContext,
                       data->mTreeMatchContext, SelectorMatchesFlags::UNKNOWN) &&
       SelectorMatchesTree(data->mElement, aSelector->mNext,
                           data->mTreeMatchContext, false)) {
     aData->change = nsRestyleHint(aData->change | possibleChange);
+    if (possibleChange & eRestyle_SomeDescendants) {
+      aData->hintData.mSelectorsForDescendants.AppendElement(aRightmostSelector);
+    }
   }
 }
 
@@ -2837,7 +3029,7 @@ nsCSSRuleProcessor::HasAttributeDependentStyle(AttributeRuleProcessorData* aData
   //  We could try making use of aData->mModType, but :not rules make it a bit
   //  of a pain to do so...  So just ignore it for now.
 
-  AttributeEnumData data(aData);
+  AttributeEnumData data(aData, aData->mRestyleHintData);
 
   // Don't do our special handling of certain attributes if the attr
   // hasn't changed yet.
@@ -3128,6 +3320,8 @@ nsCSSRuleProcessor::ClearRuleCascades()
     delete data;
     data = next;
   }
+  // A sheet covered by a taken-over cascade may have changed too.
+  DropAppendBaseCascade();
   return NS_OK;
 }
 
@@ -3275,14 +3469,15 @@ AddSelector(RuleCascadeData* aCascade,
 }
 
 static bool
-AddRule(RuleSelectorPair* aRuleInfo, RuleCascadeData* aCascade)
+AddRule(RuleSelectorPair* aRuleInfo, int32_t aWeight,
+        RuleCascadeData* aCascade)
 {
   RuleCascadeData * const cascade = aCascade;
 
   // Build the rule hash.
   nsCSSPseudoElements::Type pseudoType = aRuleInfo->mSelector->PseudoType();
   if (MOZ_LIKELY(pseudoType == nsCSSPseudoElements::ePseudo_NotPseudoElement)) {
-    cascade->mRuleHash.AppendRule(*aRuleInfo);
+    cascade->mRuleHash.AppendRule(*aRuleInfo, aWeight);
   } else if (pseudoType < nsCSSPseudoElements::ePseudo_PseudoElementCount) {
     RuleHash*& ruleHash = cascade->mPseudoElementRuleHashes[pseudoType];
     if (!ruleHash) {
@@ -3296,7 +3491,7 @@ AddRule(RuleSelectorPair* aRuleInfo, RuleCascadeData* aCascade)
                  "Must have mNext; parser screwed up");
     NS_ASSERTION(aRuleInfo->mSelector->mNext->mOperator == ':',
                  "Unexpected mNext combinator");
-    ruleHash->AppendRule(*aRuleInfo);
+    ruleHash->AppendRule(*aRuleInfo, aWeight);
   } else if (pseudoType == nsCSSPseudoElements::ePseudo_AnonBox) {
     NS_ASSERTION(!aRuleInfo->mSelector->mCasedTag &&
                  !aRuleInfo->mSelector->mIDList &&
@@ -3308,20 +3503,26 @@ AddRule(RuleSelectorPair* aRuleInfo, RuleCascadeData* aCascade)
                  aRuleInfo->mSelector->mNameSpace == kNameSpaceID_Unknown,
                  "Parser messed up with anon box selector");
 
-    // Index doesn't matter here, since we'll just be walking these
-    // rules in order; just pass 0.
+    // We'll just be walking these rules in order; the index only keeps
+    // them in that order.
     AppendRuleToTagTable(&cascade->mAnonBoxRules,
                          aRuleInfo->mSelector->mLowercaseTag,
-                         RuleValue(*aRuleInfo, 0, aCascade->mQuirksMode));
+                         RuleValue(*aRuleInfo,
+                                   RuleValue::MakeIndex(aWeight,
+                                     cascade->mPseudoRuleCount++),
+                                   aCascade->mQuirksMode));
   } else {
 #ifdef MOZ_XUL
     NS_ASSERTION(pseudoType == nsCSSPseudoElements::ePseudo_XULTree,
                  "Unexpected pseudo type");
-    // Index doesn't matter here, since we'll just be walking these
-    // rules in order; just pass 0.
+    // We'll just be walking these rules in order; the index only keeps
+    // them in that order.
     AppendRuleToTagTable(&cascade->mXULTreeRules,
                          aRuleInfo->mSelector->mLowercaseTag,
-                         RuleValue(*aRuleInfo, 0, aCascade->mQuirksMode));
+                         RuleValue(*aRuleInfo,
+                                   RuleValue::MakeIndex(aWeight,
+                                     cascade->mPseudoRuleCount++),
+                                   aCascade->mQuirksMode));
 #else
     NS_NOTREACHED("Unexpected pseudo type");
 #endif
@@ -3710,10 +3911,29 @@ nsCSSRuleProcessor::RefreshRuleCascade(nsPresContext* aPresContext)
   // the last time we had rule cascades.
   mPreviousCacheKey = nullptr;
 
+  const bool quirksMode =
+    eCompatibility_NavQuirks == aPresContext->CompatibilityMode();
+
+  // Start from the cascade taken over from our previous rule processor, if
+  // it was built for the same conditions, rather than cascading all sheets
+  // again.
+  nsAutoPtr<RuleCascadeData> newCascade;
+  uint32_t firstNewSheet = 0;
+  if (mAppendBaseCascade) {
+    if (aPresContext == mAppendBasePresContext &&
+        mAppendBaseCascade->mQuirksMode == quirksMode &&
+        mAppendBaseCascade->mCacheKey.Matches(aPresContext)) {
+      newCascade = mAppendBaseCascade;
+      firstNewSheet = mAppendBaseSheetCount;
+      mAppendBaseCascade = nullptr;
+    }
+    DropAppendBaseCascade();
+  }
+
   if (mSheets.Length() != 0) {
-    nsAutoPtr<RuleCascadeData> newCascade(
-      new RuleCascadeData(aPresContext->Medium(),
-                          eCompatibility_NavQuirks == aPresContext->CompatibilityMode()));
+    if (!newCascade) {
+      newCascade = new RuleCascadeData(aPresContext->Medium(), quirksMode);
+    }
     if (newCascade) {
       CascadeEnumData data(aPresContext, newCascade->mFontFaceRules,
                            newCascade->mKeyframesRules,
@@ -3726,7 +3946,12 @@ nsCSSRuleProcessor::RefreshRuleCascade(nsPresContext* aPresContext)
                            mSheetType,
                            mMustGatherDocumentRules);
 
-      for (uint32_t i = 0; i < mSheets.Length(); ++i) {
+      // The tables below are only extended with the rules gathered now.
+      uint32_t firstNewKeyframesRule = newCascade->mKeyframesRules.Length();
+      uint32_t firstNewCounterStyleRule =
+        newCascade->mCounterStyleRules.Length();
+
+      for (uint32_t i = firstNewSheet; i < mSheets.Length(); ++i) {
         if (!CascadeSheet(mSheets.ElementAt(i), &data))
           return; /* out of memory */
       }
@@ -3750,20 +3975,21 @@ nsCSSRuleProcessor::RefreshRuleCascade(nsPresContext* aPresContext)
         for (PerWeightDataListItem *cur = weightArray[i].mRuleSelectorPairs;
              cur;
              cur = cur->mNext) {
-          if (!AddRule(cur, newCascade))
+          if (!AddRule(cur, weightArray[i].mWeight, newCascade))
             return; /* out of memory */
         }
       }
 
       // Build mKeyframesRuleTable.
-      for (nsTArray<nsCSSKeyframesRule*>::size_type i = 0,
+      for (nsTArray<nsCSSKeyframesRule*>::size_type i = firstNewKeyframesRule,
              iEnd = newCascade->mKeyframesRules.Length(); i < iEnd; ++i) {
         nsCSSKeyframesRule* rule = newCascade->mKeyframesRules[i];
         newCascade->mKeyframesRuleTable.Put(rule->GetName(), rule);
       }
 
       // Build mCounterStyleRuleTable
-      for (nsTArray<nsCSSCounterStyleRule*>::size_type i = 0,
+      for (nsTArray<nsCSSCounterStyleRule*>::size_type i =
+             firstNewCounterStyleRule,
            iEnd = newCascade->mCounterStyleRules.Length(); i < iEnd; ++i) {
         nsCSSCounterStyleRule* rule = newCascade->mCounterStyleRules[i];
         newCascade->mCounterStyleRuleTable.Put(rule->GetName(), rule);
@@ -3944,15 +4170,18 @@ AncestorFilter::PushAncestor(Element *aElement)
   mElements.AppendElement(aElement);
 #endif
   mHashes.AppendElement(aElement->NodeInfo()->NameAtom()->hash());
+  // For ids and classes with uppercase characters, also add the hash of the
+  // lowercased name, which is what quirks mode rules test against.  We don't
+  // know here which kind of rules this filter will be used with.
   nsIAtom *id = aElement->GetID();
   if (id) {
-    mHashes.AppendElement(id->hash());
+    AppendIDOrClassHashes(id);
   }
   const nsAttrValue *classes = aElement->GetClasses();
   if (classes) {
     uint32_t classCount = classes->GetAtomCount();
     for (uint32_t i = 0; i < classCount; ++i) {
-      mHashes.AppendElement(classes->AtomAt(i)->hash());
+      AppendIDOrClassHashes(classes->AtomAt(i));
     }
   }
 
@@ -3962,6 +4191,17 @@ AncestorFilter::PushAncestor(Element *aElement)
   }
 }
 
+void
+AncestorFilter::AppendIDOrClassHashes(nsIAtom *aAtom)
+{
+  uint32_t hash = aAtom->hash();
+  mHashes.AppendElement(hash);
+  uint32_t lowercaseHash = ASCIILowercaseAtomHash(aAtom);
+  if (lowercaseHash != hash) {
+    mHashes.AppendElement(lowercaseHash);
+  }
+}
+
 void
 AncestorFilter::PopAncestor()
 {
@@ -235,12 +235,25 @@ private:
 
   void ClearSheets();
 
+  // Takes aPrevious's active rule cascade if our sheets are its sheets with
+  // more appended, so RefreshRuleCascade only has to add the rules of the
+  // appended sheets.
+  void TakeCascadeForAppendedSheets(nsCSSRuleProcessor* aPrevious);
+  void DropAppendBaseCascade();
+
   // The sheet order here is the same as in nsStyleSet::mSheets
   sheet_array_type mSheets;
 
   // active first, then cached (most recent first)
   RuleCascadeData* mRuleCascades;
 
+  // A cascade taken over from the rule processor we replaced, covering the
+  // first mAppendBaseSheetCount of mSheets for mAppendBasePresContext.
+  // Consumed by the next RefreshRuleCascade.
+  RuleCascadeData* mAppendBaseCascade;
+  nsPresContext* mAppendBasePresContext;
+  uint32_t mAppendBaseSheetCount;
+
   // If we cleared our mRuleCascades or replaced a previous rule
   // processor, this is the media query result cache key that was used
   // before we lost the old rule cascades.
@@ -17,6 +17,7 @@
 #include "mozilla/Likely.h"
 #include "mozilla/LookAndFeel.h"
 
+#include "MainThreadUtils.h"
 #include "nsAlgorithm.h" // for clamped()
 #include "nsRuleNode.h"
 #include "nscore.h"
@@ -1521,6 +1522,12 @@ nsRuleNode*
 nsRuleNode::Transition(nsIStyleRule* aRule, uint8_t aLevel,
                        bool aIsImportantRule)
 {
+  // The rule tree, like the style contexts and frames pointing into it,
+  // is not thread-safe; children are added without any locking and rule
+  // nodes are allocated from the pres shell's arena.
+  MOZ_ASSERT(NS_IsMainThread(), "rule tree must only be walked on the "
+                                "main thread");
+
   nsRuleNode* next = nullptr;
   nsRuleNode::Key key(aRule, aLevel, aIsImportantRule);
 
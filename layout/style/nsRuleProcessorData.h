@@ -26,6 +26,7 @@
 class nsIAtom;
 class nsIContent;
 class nsICSSPseudoComparator;
+class nsStyleContext;
 struct TreeMatchContext;
 
 /**
@@ -62,6 +63,8 @@ class MOZ_STACK_CLASS AncestorFilter {
 #endif
   
  private:
+  void AppendIDOrClassHashes(nsIAtom *aAtom);
+
   // Using 2^12 slots makes the Bloom filter a nice round page in
   // size, so let's do that.  We get a false positive rate of 1% or
   // less even with several hundred things in the filter.  Note that
@@ -84,6 +87,47 @@ class MOZ_STACK_CLASS AncestorFilter {
 #endif
 };
 
+/**
+ * A StyleSharingCache remembers the style contexts most recently resolved
+ * by nsStyleSet::ResolveStyleFor during one styling operation, so that a
+ * later sibling whose selector matching inputs are the same (tag,
+ * attributes, state, parent style) can reuse the rule nodes found for the
+ * earlier one instead of running selector matching again.  Siblings whose
+ * style may depend on their position among their siblings or on their
+ * children never share.
+ */
+class MOZ_STACK_CLASS StyleSharingCache {
+ public:
+  StyleSharingCache();
+  ~StyleSharingCache();
+
+  /* Whether aElement's style can be cached or taken from the cache at all */
+  static bool CanShareStyle(mozilla::dom::Element* aElement);
+
+  /* Returns a style context, resolved with the given parent context and
+     nsStyleSet::GetContext flags for a sibling of aElement, that aElement
+     would have matched the same rules as; or null if there is none.  On
+     success, the selector flags matching set on that sibling are copied
+     to aElement. */
+  nsStyleContext* Lookup(mozilla::dom::Element* aElement,
+                         nsStyleContext* aParentContext,
+                         uint32_t aFlags) const;
+
+  void Insert(mozilla::dom::Element* aElement, nsStyleContext* aStyle,
+              uint32_t aFlags);
+
+ private:
+  static const uint32_t kMaxEntries = 8;
+
+  struct Entry {
+    nsRefPtr<mozilla::dom::Element> mElement;
+    nsRefPtr<nsStyleContext> mStyle;
+    uint32_t mFlags;
+  };
+
+  nsTArray<Entry> mEntries;
+};
+
 /**
  * A |TreeMatchContext| has data about a matching operation.  The
  * data are not node-specific but are invariants of the DOM tree the
@@ -359,6 +403,10 @@ struct MOZ_STACK_CLASS TreeMatchContext {
   // An ancestor filter
   AncestorFilter mAncestorFilter;
 
+  // Style contexts of recently styled elements that siblings may share;
+  // only used when mForStyling.
+  StyleSharingCache mStyleSharingCache;
+
   // Whether this document is using PB mode
   bool mUsingPrivateBrowsing;
 
@@ -575,13 +623,15 @@ struct MOZ_STACK_CLASS AttributeRuleProcessorData :
                              int32_t aModType,
                              bool aAttrHasChanged,
                              const nsAttrValue* aOtherValue,
-                             TreeMatchContext& aTreeMatchContext)
+                             TreeMatchContext& aTreeMatchContext,
+                             mozilla::RestyleHintData& aRestyleHintData)
     : ElementDependentRuleProcessorData(aPresContext, aElement, nullptr,
                                         aTreeMatchContext),
       mAttribute(aAttribute),
       mOtherValue(aOtherValue),
       mModType(aModType),
-      mAttrHasChanged(aAttrHasChanged)
+      mAttrHasChanged(aAttrHasChanged),
+      mRestyleHintData(aRestyleHintData)
   {
     NS_PRECONDITION(!aTreeMatchContext.mForStyling, "Not styling here!");
   }
@@ -590,6 +640,9 @@ struct MOZ_STACK_CLASS AttributeRuleProcessorData :
   const nsAttrValue* mOtherValue;
   int32_t mModType;    // The type of modification (see nsIDOMMutationEvent).
   bool mAttrHasChanged; // Whether the attribute has already changed.
+  // Out parameter: selectors for the descendants to restyle, for rule
+  // processors that return eRestyle_SomeDescendants.
+  mozilla::RestyleHintData& mRestyleHintData;
 };
 
 #endif /* !defined(nsRuleProcessorData_h_) */
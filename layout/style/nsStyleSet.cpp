@@ -24,6 +24,7 @@
 #include "nsCSSPseudoElements.h"
 #include "nsCSSRuleProcessor.h"
 #include "nsDataHashtable.h"
+#include "nsAttrName.h"
 #include "nsIContent.h"
 #include "nsRuleData.h"
 #include "nsRuleProcessorData.h"
@@ -385,6 +386,16 @@ SortStyleSheetsByScope(nsTArray<CSSStyleSheet*>& aSheets)
 nsresult
 nsStyleSet::GatherRuleProcessors(sheetType aType)
 {
+  // We might be here because a sheet is being dropped, which destroys its
+  // nsCSSSelectors.  Tell the RestyleManager, so that it can stop pointing
+  // to them from eRestyle_SomeDescendants restyles.
+  if (mRuleTree && IsCSSSheetType(aType)) {
+    RestyleManager* restyleManager = PresContext()->RestyleManager();
+    if (restyleManager) {
+      restyleManager->ClearSelectors();
+    }
+  }
+
   nsCOMPtr<nsIStyleRuleProcessor> oldRuleProcessor(mRuleProcessors[aType]);
   nsTArray<nsCOMPtr<nsIStyleRuleProcessor>> oldScopedDocRuleProcessors;
   if (aType == eAgentSheet || aType == eUserSheet) {
@@ -1315,6 +1326,125 @@ InitStyleScopes(TreeMatchContext& aTreeContext, Element* aElement)
   }
 }
 
+StyleSharingCache::StyleSharingCache()
+{
+}
+
+StyleSharingCache::~StyleSharingCache()
+{
+}
+
+/* static */ bool
+StyleSharingCache::CanShareStyle(Element* aElement)
+{
+  // Only HTML elements: SVG elements have per-element content style rules
+  // and SMIL override style.  The body element has a per-element rule too.
+  // Links depend on their visitedness, animations and transitions add
+  // per-element rules, and scoped style sheets, XBL bindings and shadow
+  // roots can make rules apply to only one of two similar siblings.
+  return aElement->IsHTMLElement() &&
+         !aElement->IsHTMLElement(nsGkAtoms::body) &&
+         aElement->GetParent() &&
+         !nsCSSRuleProcessor::IsLink(aElement) &&
+         !aElement->MayHaveAnimations() &&
+         !aElement->IsElementInStyleScope() &&
+         !aElement->GetXBLBinding() &&
+         !aElement->GetShadowRoot() &&
+         !aElement->HasAttr(kNameSpaceID_None, nsGkAtoms::style);
+}
+
+static bool
+HaveSameAttributes(Element* aElement1, Element* aElement2)
+{
+  uint32_t count = aElement1->GetAttrCount();
+  if (count != aElement2->GetAttrCount()) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const nsAttrName* name = aElement1->GetAttrNameAt(i);
+    nsAttrInfo info1 =
+      aElement1->GetAttrInfo(name->NamespaceID(), name->LocalName());
+    nsAttrInfo info2 =
+      aElement2->GetAttrInfo(name->NamespaceID(), name->LocalName());
+    if (!info2.mValue || !info1.mValue->Equals(*info2.mValue)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+nsStyleContext*
+StyleSharingCache::Lookup(Element* aElement,
+                          nsStyleContext* aParentContext,
+                          uint32_t aFlags) const
+{
+  nsIContent* parent = aElement->GetParent();
+
+  // Selector matching sets these flags on the parent while matching an
+  // earlier sibling against a selector that depends on the position among
+  // siblings (:nth-child(), :first-child, sibling combinators, etc.).
+  if (parent->HasFlag(NODE_HAS_SLOW_SELECTOR |
+                      NODE_HAS_EDGE_CHILD_SELECTOR |
+                      NODE_HAS_SLOW_SELECTOR_LATER_SIBLINGS)) {
+    return nullptr;
+  }
+
+  for (uint32_t i = mEntries.Length(); i-- != 0; ) {
+    const Entry& entry = mEntries[i];
+    Element* candidate = entry.mElement;
+    if (entry.mStyle->GetParent() != aParentContext ||
+        entry.mFlags != aFlags ||
+        candidate->GetParent() != parent ||
+        candidate->NodeInfo() != aElement->NodeInfo()) {
+      continue;
+    }
+
+    // The candidate may have started an animation, or matched a selector
+    // that depends on its children (:empty and friends), while it was
+    // styled.
+    if (candidate->MayHaveAnimations() ||
+        candidate->HasFlag(NODE_HAS_EMPTY_SELECTOR)) {
+      continue;
+    }
+
+    if (candidate->StyleState() != aElement->StyleState() ||
+        candidate->GetBindingParent() != aElement->GetBindingParent() ||
+        candidate->IsRootOfNativeAnonymousSubtree() !=
+          aElement->IsRootOfNativeAnonymousSubtree() ||
+        !HaveSameAttributes(candidate, aElement)) {
+      continue;
+    }
+
+    // aElement skips selector matching, so give it the flags that matching
+    // set on the candidate itself; the parent's flags are already shared.
+    // Without NodeHasRelevantHoverRules, hovering aElement would not
+    // restyle it.
+    if (candidate->HasRelevantHoverRules()) {
+      aElement->SetHasRelevantHoverRules();
+    }
+
+    return entry.mStyle;
+  }
+
+  return nullptr;
+}
+
+void
+StyleSharingCache::Insert(Element* aElement, nsStyleContext* aStyle,
+                          uint32_t aFlags)
+{
+  if (mEntries.Length() == kMaxEntries) {
+    mEntries.RemoveElementAt(0);
+  }
+
+  Entry* entry = mEntries.AppendElement();
+  entry->mElement = aElement;
+  entry->mStyle = aStyle;
+  entry->mFlags = aFlags;
+}
+
 already_AddRefed<nsStyleContext>
 nsStyleSet::ResolveStyleFor(Element* aElement,
                             nsStyleContext* aParentContext)
@@ -1333,6 +1463,39 @@ nsStyleSet::ResolveStyleFor(Element* aElement,
   NS_ENSURE_FALSE(mInShutdown, nullptr);
   NS_ASSERTION(aElement, "aElement must not be null");
 
+  uint32_t flags = eDoAnimation;
+  if (nsCSSRuleProcessor::IsLink(aElement)) {
+    flags |= eIsLink;
+  }
+  if (nsCSSRuleProcessor::GetContentState(aElement, aTreeMatchContext).
+                            HasState(NS_EVENT_STATE_VISITED)) {
+    flags |= eIsVisitedLink;
+  }
+  if (aTreeMatchContext.mSkippingParentDisplayBasedStyleFixup) {
+    flags |= eSkipParentDisplayBasedStyleFixup;
+  }
+
+  // Siblings with the same tag, attributes and state (rows of a table,
+  // items of a list) usually match exactly the same rules, so try to skip
+  // selector matching by using the rule nodes of one we styled before.
+  // Only do this when styling, since the selector flags set on the parent
+  // while matching the earlier sibling are what tell us whether matching
+  // could have depended on its position.
+  bool canShare = aTreeMatchContext.mForStyling && aParentContext &&
+                  StyleSharingCache::CanShareStyle(aElement);
+  if (canShare) {
+    nsStyleContext* shared =
+      aTreeMatchContext.mStyleSharingCache.Lookup(aElement, aParentContext,
+                                                  flags);
+    if (shared) {
+      nsStyleContext* sharedIfVisited = shared->GetStyleIfVisited();
+      return GetContext(aParentContext, shared->RuleNode(),
+                        sharedIfVisited ? sharedIfVisited->RuleNode() : nullptr,
+                        nullptr, nsCSSPseudoElements::ePseudo_NotPseudoElement,
+                        aElement, flags);
+    }
+  }
+
   nsRuleWalker ruleWalker(mRuleTree, mAuthorStyleDisabled);
   aTreeMatchContext.ResetForUnvisitedMatching();
   ElementRuleProcessorData data(PresContext(), aElement, &ruleWalker,
@@ -1352,21 +1515,16 @@ nsStyleSet::ResolveStyleFor(Element* aElement,
     visitedRuleNode = ruleWalker.CurrentNode();
   }
 
-  uint32_t flags = eDoAnimation;
-  if (nsCSSRuleProcessor::IsLink(aElement)) {
-    flags |= eIsLink;
-  }
-  if (nsCSSRuleProcessor::GetContentState(aElement, aTreeMatchContext).
-                            HasState(NS_EVENT_STATE_VISITED)) {
-    flags |= eIsVisitedLink;
-  }
-  if (aTreeMatchContext.mSkippingParentDisplayBasedStyleFixup) {
-    flags |= eSkipParentDisplayBasedStyleFixup;
+  nsRefPtr<nsStyleContext> result =
+    GetContext(aParentContext, ruleNode, visitedRuleNode,
+               nullptr, nsCSSPseudoElements::ePseudo_NotPseudoElement,
+               aElement, flags);
+
+  if (canShare && result) {
+    aTreeMatchContext.mStyleSharingCache.Insert(aElement, result, flags);
   }
 
-  return GetContext(aParentContext, ruleNode, visitedRuleNode,
-                    nullptr, nsCSSPseudoElements::ePseudo_NotPseudoElement,
-                    aElement, flags);
+  return result.forget();
 }
 
 already_AddRefed<nsStyleContext>
@@ -2364,9 +2522,11 @@ struct MOZ_STACK_CLASS AttributeData : public AttributeRuleProcessorData {
   AttributeData(nsPresContext* aPresContext,
                 Element* aElement, nsIAtom* aAttribute, int32_t aModType,
                 bool aAttrHasChanged, const nsAttrValue* aOtherValue,
-                TreeMatchContext& aTreeMatchContext)
+                TreeMatchContext& aTreeMatchContext,
+                RestyleHintData& aRestyleHintData)
     : AttributeRuleProcessorData(aPresContext, aElement, aAttribute, aModType,
-                                 aAttrHasChanged, aOtherValue, aTreeMatchContext),
+                                 aAttrHasChanged, aOtherValue, aTreeMatchContext,
+                                 aRestyleHintData),
       mHint(nsRestyleHint(0))
   {}
   nsRestyleHint   mHint;
@@ -2387,13 +2547,15 @@ nsStyleSet::HasAttributeDependentStyle(Element*       aElement,
                                        nsIAtom*       aAttribute,
                                        int32_t        aModType,
                                        bool           aAttrHasChanged,
-                                       const nsAttrValue* aOtherValue)
+                                       const nsAttrValue* aOtherValue,
+                                       RestyleHintData& aRestyleHintDataResult)
 {
   TreeMatchContext treeContext(false, nsRuleWalker::eLinksVisitedOrUnvisited,
                                aElement->OwnerDoc());
   InitStyleScopes(treeContext, aElement);
   AttributeData data(PresContext(), aElement, aAttribute,
-                     aModType, aAttrHasChanged, aOtherValue, treeContext);
+                     aModType, aAttrHasChanged, aOtherValue, treeContext,
+                     aRestyleHintDataResult);
   WalkRuleProcessors(SheetHasAttributeStyle, &data, false);
   return data.mHint;
 }
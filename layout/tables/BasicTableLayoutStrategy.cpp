@@ -250,9 +250,30 @@ GetWidthInfo(nsRenderingContext *aRenderingContext,
 
 static inline CellWidthInfo
 GetCellWidthInfo(nsRenderingContext *aRenderingContext,
-                 nsTableCellFrame *aCellFrame)
+                 nsTableCellFrame *aCellFrame, bool aIsBorderCollapse)
 {
-    return GetWidthInfo(aRenderingContext, aCellFrame, true);
+    // Computing this requires the cell's intrinsic isizes, which aren't
+    // cached, so remember the result until the cell's intrinsic isizes are
+    // marked dirty.  That way a large table whose rows are appended to or
+    // changed doesn't have to measure all its other cells again.  Collapsed
+    // borders can change when a neighbouring cell changes, without this
+    // cell being marked dirty, so don't cache in that case.
+    if (aIsBorderCollapse) {
+        return GetWidthInfo(aRenderingContext, aCellFrame, true);
+    }
+    const nsTableCellFrame::ColumnISizeContribution* cached =
+        aCellFrame->GetCachedColumnISizeContribution();
+    if (cached) {
+        return CellWidthInfo(cached->mMinCoord, cached->mPrefCoord,
+                             cached->mPrefPercent, cached->mHasSpecifiedISize);
+    }
+
+    CellWidthInfo info = GetWidthInfo(aRenderingContext, aCellFrame, true);
+    nsTableCellFrame::ColumnISizeContribution contribution =
+        { info.minCoord, info.prefCoord, info.prefPercent,
+          info.hasSpecifiedWidth };
+    aCellFrame->SetCachedColumnISizeContribution(contribution);
+    return info;
 }
 
 static inline CellWidthInfo
@@ -277,6 +298,7 @@ BasicTableLayoutStrategy::ComputeColumnIntrinsicISizes(nsRenderingContext* aRend
 
     mozilla::AutoStackArena arena;
     SpanningCellSorter spanningCells;
+    bool isBorderCollapse = tableFrame->IsBorderCollapse();
 
     // Loop over the columns to consider the columns and cells *without*
     // a colspan.
@@ -323,7 +345,8 @@ BasicTableLayoutStrategy::ComputeColumnIntrinsicISizes(nsRenderingContext* aRend
                 continue;
             }
 
-            CellWidthInfo info = GetCellWidthInfo(aRenderingContext, cellFrame);
+            CellWidthInfo info = GetCellWidthInfo(aRenderingContext, cellFrame,
+                                                  isBorderCollapse);
 
             colFrame->AddCoords(info.minCoord, info.prefCoord,
                                 info.hasSpecifiedWidth);
@@ -374,7 +397,8 @@ BasicTableLayoutStrategy::ComputeColumnIntrinsicISizes(nsRenderingContext* aRend
             nsTableCellFrame *cellFrame = cellData->GetCellFrame();
             NS_ASSERTION(cellFrame, "bogus result from spanning cell sorter");
 
-            CellWidthInfo info = GetCellWidthInfo(aRenderingContext, cellFrame);
+            CellWidthInfo info = GetCellWidthInfo(aRenderingContext, cellFrame,
+                                                  isBorderCollapse);
 
             if (info.prefPercent > 0.0f) {
                 DistributePctWidthToColumns(info.prefPercent,
@@ -49,6 +49,7 @@ nsTableCellFrame::nsTableCellFrame(nsStyleContext* aContext,
 {
   mColIndex = 0;
   mPriorAvailISize = 0;
+  mHasColumnISizeContribution = false;
 
   SetContentEmpty(false);
   SetHasPctOverBSize(false);
@@ -768,6 +769,13 @@ int32_t nsTableCellFrame::GetColSpan()
   return colSpan;
 }
 
+/* virtual */ void
+nsTableCellFrame::MarkIntrinsicISizesDirty()
+{
+  mHasColumnISizeContribution = false;
+  nsContainerFrame::MarkIntrinsicISizesDirty();
+}
+
 /* virtual */ nscoord
 nsTableCellFrame::GetMinISize(nsRenderingContext *aRenderingContext)
 {
@@ -118,6 +118,30 @@ public:
   virtual nscoord GetMinISize(nsRenderingContext *aRenderingContext) override;
   virtual nscoord GetPrefISize(nsRenderingContext *aRenderingContext) override;
   virtual IntrinsicISizeOffsetData IntrinsicISizeOffsets() override;
+  virtual void MarkIntrinsicISizesDirty() override;
+
+  /**
+   * This cell's contribution to the intrinsic isizes of its column(s), as
+   * computed by BasicTableLayoutStrategy.  It's cached on the cell so that
+   * recomputing a large table's column isizes only has to query the cells
+   * that changed; MarkIntrinsicISizesDirty() discards it.
+   */
+  struct ColumnISizeContribution {
+    nscoord mMinCoord;
+    nscoord mPrefCoord;
+    float mPrefPercent;
+    bool mHasSpecifiedISize;
+  };
+
+  const ColumnISizeContribution* GetCachedColumnISizeContribution() const
+  {
+    return mHasColumnISizeContribution ? &mColumnISizeContribution : nullptr;
+  }
+  void SetCachedColumnISizeContribution(const ColumnISizeContribution& aValue)
+  {
+    mColumnISizeContribution = aValue;
+    mHasColumnISizeContribution = true;
+  }
 
   virtual void Reflow(nsPresContext*      aPresContext,
                       nsHTMLReflowMetrics& aDesiredSize,
@@ -260,6 +284,9 @@ protected:
 
   nscoord      mPriorAvailISize;      // the avail isize during the last reflow
   mozilla::LogicalSize mDesiredSize;  // the last desired inline and block size
+
+  ColumnISizeContribution mColumnISizeContribution;
+  bool mHasColumnISizeContribution;
 };
 
 inline nscoord nsTableCellFrame::GetPriorAvailISize()
@@ -0,0 +1,40 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* compile-time tests for whether to use AltiVec/VMX instructions */
+
+#ifndef mozilla_ppc_h_
+#define mozilla_ppc_h_
+
+/* This is patterned after SSE.h and arm.h, but only provides VMX detection.
+   --enable-altivec builds everything with -maltivec, so there is no runtime
+   detection: if the compiler targets VMX, every CPU we run on supports it.
+   Code using VMX intrinsics should still live in its own compilation unit,
+   like the SSE2 and NEON code, and be guarded like this:
+
+     #ifdef MOZILLA_MAY_SUPPORT_VMX
+       if (mozilla::supports_vmx()) {
+         mozilla::VMX::foo(); // in a separate file
+         return;
+       }
+     #endif
+ */
+
+#if (defined(__powerpc__) || defined(__POWERPC__)) \
+    && (defined(__ALTIVEC__) || defined(__APPLE_ALTIVEC__))
+#  define MOZILLA_PRESUME_VMX 1
+#endif
+
+namespace mozilla {
+
+#if defined(MOZILLA_PRESUME_VMX)
+#  define MOZILLA_MAY_SUPPORT_VMX 1
+  inline bool supports_vmx() { return true; }
+#else
+  inline bool supports_vmx() { return false; }
+#endif
+
+} // namespace mozilla
+
+#endif /* !defined(mozilla_ppc_h_) */
@@ -643,8 +643,11 @@ BackgroundFileSaver::ProcessStateChange()
   {
     MutexAutoLock lock(mLock);
 
+    // Copy in chunks as large as the output buffer, so that each pass of the
+    // copier moves a full write batch rather than a single pipe segment.
     rv = NS_AsyncCopy(mPipeInputStream, outputStream, mWorkerThread,
-                      NS_ASYNCCOPY_VIA_READSEGMENTS, 4096, AsyncCopyCallback,
+                      NS_ASYNCCOPY_VIA_READSEGMENTS, BUFFERED_IO_SIZE,
+                      AsyncCopyCallback,
                       this, false, true, getter_AddRefs(mAsyncCopyContext),
                       GetProgressCallback());
     if (NS_FAILED(rv)) {
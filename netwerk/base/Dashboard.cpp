@@ -473,6 +473,8 @@ Dashboard::GetHttpConnections(HttpData *aHttpData)
         connection.mPort = httpData->mData[i].port;
         connection.mSpdy = httpData->mData[i].spdy;
         connection.mSsl = httpData->mData[i].ssl;
+        connection.mSpeculativeCreated = httpData->mData[i].speculativeCreated;
+        connection.mSpeculativeUsed = httpData->mData[i].speculativeUsed;
 
         connection.mActive.Construct();
         connection.mIdle.Construct();
@@ -52,6 +52,8 @@ struct HttpRetParams
     nsTArray<HttpConnInfo>   idle;
     nsTArray<HalfOpenSockets> halfOpens;
     uint32_t  counter;
+    uint32_t  speculativeCreated;
+    uint32_t  speculativeUsed;
     uint16_t  port;
     bool      spdy;
     bool      ssl;
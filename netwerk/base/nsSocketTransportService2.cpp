@@ -42,6 +42,7 @@ PRThread                 *gSocketThread           = nullptr;
 #define SOCKET_LIMIT_TARGET 550U
 #define SOCKET_LIMIT_MIN     50U
 #define BLIP_INTERVAL_PREF "network.activity.blipIntervalMilliseconds"
+#define MAX_TIME_BETWEEN_TWO_POLLS "network.sts.max_time_for_events_between_two_polls"
 
 uint32_t nsSocketTransportService::gMaxCount;
 PRCallOnceType nsSocketTransportService::gMaxCountInitOnce;
@@ -69,6 +70,7 @@ nsSocketTransportService::nsSocketTransportService()
     , mKeepaliveRetryIntervalS(1)
     , mKeepaliveProbeCount(kDefaultTCPKeepCount)
     , mKeepaliveEnabledPref(false)
+    , mMaxTimeForEventsBetweenTwoPolls(PR_MillisecondsToInterval(100))
     , mProbedMaxCount(false)
 {
     gSocketTransportLog = PR_NewLogModule("nsSocketTransport");
@@ -491,6 +493,7 @@ nsSocketTransportService::Init()
         tmpPrefService->AddObserver(KEEPALIVE_IDLE_TIME_PREF, this, false);
         tmpPrefService->AddObserver(KEEPALIVE_RETRY_INTERVAL_PREF, this, false);
         tmpPrefService->AddObserver(KEEPALIVE_PROBE_COUNT_PREF, this, false);
+        tmpPrefService->AddObserver(MAX_TIME_BETWEEN_TWO_POLLS, this, false);
     }
     UpdatePrefs();
 
@@ -771,10 +774,17 @@ nsSocketTransportService::Run()
             if (!pendingEvents)
                 thread->HasPendingEvents(&pendingEvents);
 
+            // Process events until the queue is empty or the time budget is
+            // spent, then go back to polling the sockets.
             if (pendingEvents) {
-                NS_ProcessNextEvent(thread);
-                pendingEvents = false;
-                thread->HasPendingEvents(&pendingEvents);
+                PRIntervalTime eventQueueStart = PR_IntervalNow();
+                do {
+                    NS_ProcessNextEvent(thread);
+                    pendingEvents = false;
+                    thread->HasPendingEvents(&pendingEvents);
+                } while (pendingEvents &&
+                         (PRIntervalTime)(PR_IntervalNow() - eventQueueStart) <
+                             mMaxTimeForEventsBetweenTwoPolls);
             }
         } while (pendingEvents);
 
@@ -1024,6 +1034,14 @@ nsSocketTransportService::UpdatePrefs()
             mKeepaliveEnabledPref = keepaliveEnabled;
             OnKeepaliveEnabledPrefChange();
         }
+
+        int32_t maxTimePref;
+        rv = tmpPrefService->GetIntPref(MAX_TIME_BETWEEN_TWO_POLLS,
+                                        &maxTimePref);
+        if (NS_SUCCEEDED(rv) && maxTimePref >= 0) {
+            mMaxTimeForEventsBetweenTwoPolls =
+                PR_MillisecondsToInterval(maxTimePref);
+        }
     }
     
     return NS_OK;
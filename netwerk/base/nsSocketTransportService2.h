@@ -16,6 +16,7 @@
 #include "prinit.h"
 #include "nsIObserver.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/net/DashboardTypes.h"
 
 class nsASocketHandler;
@@ -226,6 +227,10 @@ private:
     int32_t     mKeepaliveProbeCount;
     // True if TCP keepalive is enabled globally.
     bool        mKeepaliveEnabledPref;
+    // How long pending events may be processed before the sockets are
+    // polled again. Polling is O(n) in the number of attached sockets, so
+    // it isn't done after every single event.
+    mozilla::Atomic<PRIntervalTime, mozilla::Relaxed> mMaxTimeForEventsBetweenTwoPolls;
 
     void OnKeepaliveEnabledPrefChange();
     void NotifyKeepaliveEnabledPrefChange(SocketContext *sock);
@@ -38,6 +38,9 @@ using namespace mozilla;
 
 static NS_DEFINE_CID(kSocketTransportServiceCID, NS_SOCKETTRANSPORTSERVICE_CID);
 static const uint32_t UDP_PACKET_CHUNK_SIZE = 1400;
+// Upper bound of the datagrams read per poll wakeup, so one busy socket
+// can't starve the others on the socket thread.
+static const uint32_t UDP_MAX_DATAGRAMS_PER_WAKEUP = 32;
 
 //-----------------------------------------------------------------------------
 
@@ -559,15 +562,25 @@ namespace {
 //-----------------------------------------------------------------------------
 // UDPMessageProxy
 //-----------------------------------------------------------------------------
+// The stream for replying to the sender is only set up once the listener asks
+// for it; most listeners never do, and a pipe plus an async copier per
+// received datagram is expensive. The message may be handed to more than one
+// thread, so mOutputStreamLock guards setting the stream up.
 class UDPMessageProxy final : public nsIUDPMessage
 {
 public:
-  UDPMessageProxy(NetAddr* aAddr,
-                  nsIOutputStream* aOutputStream,
+  UDPMessageProxy(nsUDPSocket* aSocket,
+                  PRFileDesc* aFD,
+                  nsIEventTarget* aSts,
+                  const PRNetAddr& aPRAddr,
                   FallibleTArray<uint8_t>& aData)
-  : mOutputStream(aOutputStream)
+  : mSocket(aSocket)
+  , mFD(aFD)
+  , mSts(aSts)
+  , mPRAddr(aPRAddr)
+  , mOutputStreamLock("UDPMessageProxy.mOutputStreamLock")
   {
-    memcpy(&mAddr, aAddr, sizeof(mAddr));
+    PRNetAddrToNetAddr(&mPRAddr, &mAddr);
     aData.SwapElements(mData);
   }
 
@@ -577,7 +590,12 @@ public:
 private:
   ~UDPMessageProxy() {}
 
+  nsRefPtr<nsUDPSocket> mSocket;
+  PRFileDesc* mFD;
+  nsCOMPtr<nsIEventTarget> mSts;
+  PRNetAddr mPRAddr;
   NetAddr mAddr;
+  Mutex mOutputStreamLock;
   nsCOMPtr<nsIOutputStream> mOutputStream;
   FallibleTArray<uint8_t> mData;
 };
@@ -619,7 +637,29 @@ NS_IMETHODIMP
 UDPMessageProxy::GetOutputStream(nsIOutputStream * *aOutputStream)
 {
   NS_ENSURE_ARG_POINTER(aOutputStream);
-  NS_IF_ADDREF(*aOutputStream = mOutputStream);
+
+  MutexAutoLock lock(mOutputStreamLock);
+  if (!mOutputStream) {
+    nsCOMPtr<nsIAsyncInputStream> pipeIn;
+    nsCOMPtr<nsIAsyncOutputStream> pipeOut;
+
+    uint32_t segsize = UDP_PACKET_CHUNK_SIZE;
+    uint32_t segcount = 0;
+    net_ResolveSegmentParams(segsize, segcount);
+    nsresult rv = NS_NewPipe2(getter_AddRefs(pipeIn), getter_AddRefs(pipeOut),
+                              true, true, segsize, segcount);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    nsRefPtr<nsUDPOutputStream> os =
+      new nsUDPOutputStream(mSocket, mFD, mPRAddr);
+    rv = NS_AsyncCopy(pipeIn, os, mSts,
+                      NS_ASYNCCOPY_VIA_READSEGMENTS, UDP_PACKET_CHUNK_SIZE);
+    NS_ENSURE_SUCCESS(rv, rv);
+
+    mOutputStream = pipeOut;
+  }
+
+  NS_ADDREF(*aOutputStream = mOutputStream);
   return NS_OK;
 }
 
@@ -643,50 +683,45 @@ nsUDPSocket::OnSocketReady(PRFileDesc *fd, int16_t outFlags)
     return;
   }
 
-  PRNetAddr prClientAddr;
-  uint32_t count;
+  // Drain the datagrams already queued on the socket instead of going back
+  // through the poll loop for each of them.
   char buff[1500];
-  count = PR_RecvFrom(mFD, buff, sizeof(buff), 0, &prClientAddr, PR_INTERVAL_NO_WAIT);
-
-  if (count < 1) {
-    NS_WARNING("error of recvfrom on UDP socket");
-    mCondition = NS_ERROR_UNEXPECTED;
-    return;
-  }
-  mByteReadCount += count;
-  SaveNetworkStats(false);
-
-  FallibleTArray<uint8_t> data;
-  if (!data.AppendElements(buff, count, fallible)) {
-    mCondition = NS_ERROR_UNEXPECTED;
-    return;
-  }
+  uint32_t bytesRead = 0;
+  for (uint32_t i = 0; i < UDP_MAX_DATAGRAMS_PER_WAKEUP; ++i) {
+    PRNetAddr prClientAddr;
+    int32_t count = PR_RecvFrom(mFD, buff, sizeof(buff), 0, &prClientAddr,
+                                PR_INTERVAL_NO_WAIT);
+
+    if (count < 1) {
+      if (i > 0 && PR_GetError() == PR_WOULD_BLOCK_ERROR) {
+        break;
+      }
+      NS_WARNING("error of recvfrom on UDP socket");
+      mCondition = NS_ERROR_UNEXPECTED;
+      break;
+    }
+    bytesRead += count;
 
-  nsCOMPtr<nsIAsyncInputStream> pipeIn;
-  nsCOMPtr<nsIAsyncOutputStream> pipeOut;
+    FallibleTArray<uint8_t> data;
+    if (!data.AppendElements(buff, count, fallible)) {
+      mCondition = NS_ERROR_UNEXPECTED;
+      break;
+    }
 
-  uint32_t segsize = UDP_PACKET_CHUNK_SIZE;
-  uint32_t segcount = 0;
-  net_ResolveSegmentParams(segsize, segcount);
-  nsresult rv = NS_NewPipe2(getter_AddRefs(pipeIn), getter_AddRefs(pipeOut),
-                true, true, segsize, segcount);
+    nsCOMPtr<nsIUDPMessage> message =
+      new UDPMessageProxy(this, mFD, mSts, prClientAddr, data);
+    mListener->OnPacketReceived(this, message);
 
-  if (NS_FAILED(rv)) {
-    return;
+    // The listener may have closed the socket.
+    if (!mFD || NS_FAILED(mCondition)) {
+      break;
+    }
   }
 
-  nsRefPtr<nsUDPOutputStream> os = new nsUDPOutputStream(this, mFD, prClientAddr);
-  rv = NS_AsyncCopy(pipeIn, os, mSts,
-                    NS_ASYNCCOPY_VIA_READSEGMENTS, UDP_PACKET_CHUNK_SIZE);
-
-  if (NS_FAILED(rv)) {
-    return;
+  if (bytesRead) {
+    mByteReadCount += bytesRead;
+    SaveNetworkStats(false);
   }
-
-  NetAddr netAddr;
-  PRNetAddrToNetAddr(&prClientAddr, &netAddr);
-  nsCOMPtr<nsIUDPMessage> message = new UDPMessageProxy(&netAddr, pipeOut, data);
-  mListener->OnPacketReceived(this, message);
 }
 
 void
@@ -8,6 +8,7 @@
 #include "CacheObserver.h"
 #include "CacheFileUtils.h"
 #include "CacheIndex.h"
+#include "CacheHashUtils.h"
 
 #include "nsIInputStream.h"
 #include "nsIOutputStream.h"
@@ -180,6 +181,7 @@ CacheEntry::CacheEntry(const nsACString& aStorageID,
 , mRegistration(NEVERREGISTERED)
 , mWriter(nullptr)
 , mPredictedDataSize(0)
+, mKeyHash(0)
 , mUseCount(0)
 , mReleaseThread(NS_GetCurrentThread())
 {
@@ -187,6 +189,11 @@ CacheEntry::CacheEntry(const nsACString& aStorageID,
 
   mService = CacheStorageService::Self();
 
+  nsAutoCString key;
+  if (NS_SUCCEEDED(HashingKeyWithStorage(key))) {
+    mKeyHash = CacheHash::Hash(key.get(), key.Length());
+  }
+
   CacheStorageService::Self()->RecordMemoryOnlyEntry(
     this, !aUseDisk, true /* overwrite */);
 }
@@ -277,6 +284,10 @@ void CacheEntry::AsyncOpen(nsICacheEntryOpenCallback* aCallback, uint32_t aFlags
 
   Callback callback(this, aCallback, readonly, multithread, secret);
 
+  if (!secret) {
+    mService->RecordEntryRequest(mKeyHash);
+  }
+
   if (!Open(callback, truncate, priority, bypassIfBusy)) {
     // We get here when the callback wants to bypass cache when it's busy.
     LOG(("  writing or revalidating, callback wants to bypass cache"));
@@ -1139,6 +1150,15 @@ NS_IMETHODIMP CacheEntry::SetPredictedDataSize(int64_t aPredictedDataSize)
     return NS_ERROR_FILE_TOO_BIG;
   }
 
+  if (CacheObserver::EntryNeedsAdmission(0, mPredictedDataSize, mUseDisk) &&
+      !mService->ShouldAdmitEntry(mKeyHash)) {
+    LOG(("CacheEntry::SetPredictedDataSize [this=%p] big and not requested "
+         "often enough, dooming", this));
+    AsyncDoom(nullptr);
+
+    return NS_ERROR_FILE_TOO_BIG;
+  }
+
   return NS_OK;
 }
 
@@ -347,6 +347,8 @@ private:
 
   nsCOMPtr<nsISupports> mSecurityInfo;
   int64_t mPredictedDataSize;
+  // CacheHash of HashingKeyWithStorage(), used by the admission filter.
+  uint32_t mKeyHash;
   mozilla::TimeStamp mLoadStart;
   uint32_t mUseCount;
   nsCOMPtr<nsIThread> mReleaseThread;
@@ -1134,7 +1134,8 @@ CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
     // Read the chunk from the disk
     rv = chunk->Read(mHandle, std::min(static_cast<uint32_t>(mDataSize - off),
                      static_cast<uint32_t>(kChunkSize)),
-                     mMetadata->GetHash(aIndex), this);
+                     mMetadata->GetHash(aIndex), this,
+                     aCaller == PRELOADER);
     if (NS_WARN_IF(NS_FAILED(rv))) {
       RemoveChunkInternal(chunk, false);
       return rv;
@@ -167,7 +167,8 @@ CacheFileChunk::InitNew()
 nsresult
 CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
                      CacheHash::Hash16_t aHash,
-                     CacheFileChunkListener *aCallback)
+                     CacheFileChunkListener *aCallback,
+                     bool aReadAhead)
 {
   mFile->AssertOwnsLock();
 
@@ -201,7 +202,7 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
   DoMemoryReport(MemorySize());
 
   rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize, mRWBuf, aLen,
-                                this);
+                                this, aReadAhead);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     rv = mIndex ? NS_ERROR_FILE_CORRUPTED : NS_ERROR_FILE_NOT_FOUND;
     SetError(rv);
@@ -75,7 +75,8 @@ public:
   void     InitNew();
   nsresult Read(CacheFileHandle *aHandle, uint32_t aLen,
                 CacheHash::Hash16_t aHash,
-                CacheFileChunkListener *aCallback);
+                CacheFileChunkListener *aCallback,
+                bool aReadAhead = false);
   nsresult Write(CacheFileHandle *aHandle, CacheFileChunkListener *aCallback);
   void     WaitForUpdate(CacheFileChunkListener *aCallback);
   nsresult CancelWait(CacheFileChunkListener *aCallback);
@@ -1743,10 +1743,12 @@ CacheFileIOManager::CloseHandleInternal(CacheFileHandle *aHandle)
 nsresult
 CacheFileIOManager::Read(CacheFileHandle *aHandle, int64_t aOffset,
                          char *aBuf, int32_t aCount,
-                         CacheFileIOListener *aCallback)
+                         CacheFileIOListener *aCallback,
+                         bool aReadAhead)
 {
   LOG(("CacheFileIOManager::Read() [handle=%p, offset=%lld, count=%d, "
-       "listener=%p]", aHandle, aOffset, aCount, aCallback));
+       "listener=%p, readAhead=%d]", aHandle, aOffset, aCount, aCallback,
+       aReadAhead));
 
   nsresult rv;
   nsRefPtr<CacheFileIOManager> ioMan = gInstance;
@@ -1757,9 +1759,15 @@ CacheFileIOManager::Read(CacheFileHandle *aHandle, int64_t aOffset,
 
   nsRefPtr<ReadEvent> ev = new ReadEvent(aHandle, aOffset, aBuf, aCount,
                                          aCallback);
-  rv = ioMan->mIOThread->Dispatch(ev, aHandle->IsPriority()
-    ? CacheIOThread::READ_PRIORITY
-    : CacheIOThread::READ);
+  // Read-ahead for a priority handle still goes before demanded reads of
+  // normal handles, but never before demanded reads of other priority ones.
+  uint32_t level;
+  if (aHandle->IsPriority()) {
+    level = aReadAhead ? CacheIOThread::READ : CacheIOThread::READ_PRIORITY;
+  } else {
+    level = aReadAhead ? CacheIOThread::READ_AHEAD : CacheIOThread::READ;
+  }
+  rv = ioMan->mIOThread->Dispatch(ev, level);
   NS_ENSURE_SUCCESS(rv, rv);
 
   return NS_OK;
@@ -7,6 +7,9 @@
 
 #include "CacheFile.h"
 #include "CacheEntry.h"
+#include "CacheHashUtils.h"
+#include "CacheObserver.h"
+#include "CacheStorageService.h"
 #include "nsStreamUtils.h"
 #include "nsThreadUtils.h"
 #include "mozilla/DebugOnly.h"
@@ -103,6 +106,20 @@ CacheFileOutputStream::Write(const char * aBuf, uint32_t aCount,
     return NS_ERROR_FILE_TOO_BIG;
   }
 
+  if (CacheObserver::EntryNeedsAdmission(mPos, mPos + aCount,
+                                         !mFile->mMemoryOnly)) {
+    CacheStorageService* service = CacheStorageService::Self();
+    if (service && !service->ShouldAdmitEntry(
+          CacheHash::Hash(mFile->mKey.get(), mFile->mKey.Length()))) {
+      LOG(("CacheFileOutputStream::Write() - Entry is big and wasn't requested "
+           "often enough, failing and dooming the entry. [this=%p]", this));
+
+      mFile->DoomLocked(nullptr);
+      CloseWithStatusLocked(NS_ERROR_FILE_TOO_BIG);
+      return NS_ERROR_FILE_TOO_BIG;
+    }
+  }
+
   *_retval = aCount;
 
   while (aCount) {
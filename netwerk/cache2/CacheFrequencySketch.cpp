@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "CacheFrequencySketch.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace mozilla {
+namespace net {
+
+// Odd multipliers used to derive an independent index for every row from
+// a single key hash.
+static uint32_t const kRowSeeds[] = {
+  0x9e3779b1, 0x85ebca77, 0xc2b2ae3d, 0x27d4eb2f
+};
+
+CacheFrequencySketch::CacheFrequencySketch()
+: mLock("CacheFrequencySketch.mLock")
+, mRecorded(0)
+{
+  static_assert(sizeof(kRowSeeds) / sizeof(kRowSeeds[0]) == kDepth,
+                "Need a seed for every row");
+  memset(mCounters, 0, sizeof(mCounters));
+}
+
+uint32_t
+CacheFrequencySketch::Index(uint32_t aKeyHash, uint32_t aRow) const
+{
+  uint32_t h = aKeyHash * kRowSeeds[aRow];
+  h ^= h >> 16;
+  return h & (kWidth - 1);
+}
+
+void
+CacheFrequencySketch::Record(uint32_t aKeyHash)
+{
+  mozilla::MutexAutoLock lock(mLock);
+
+  for (uint32_t row = 0; row < kDepth; ++row) {
+    uint8_t& counter = mCounters[row][Index(aKeyHash, row)];
+    if (counter < kMaxCount) {
+      ++counter;
+    }
+  }
+
+  if (++mRecorded >= kSampleSize) {
+    Age();
+  }
+}
+
+uint32_t
+CacheFrequencySketch::Estimate(uint32_t aKeyHash)
+{
+  mozilla::MutexAutoLock lock(mLock);
+
+  uint32_t estimate = kMaxCount;
+  for (uint32_t row = 0; row < kDepth; ++row) {
+    estimate = std::min<uint32_t>(estimate,
+                                  mCounters[row][Index(aKeyHash, row)]);
+  }
+
+  return estimate;
+}
+
+void
+CacheFrequencySketch::Clear()
+{
+  mozilla::MutexAutoLock lock(mLock);
+
+  memset(mCounters, 0, sizeof(mCounters));
+  mRecorded = 0;
+}
+
+void
+CacheFrequencySketch::Age()
+{
+  mLock.AssertCurrentThreadOwns();
+
+  for (uint32_t row = 0; row < kDepth; ++row) {
+    for (uint32_t i = 0; i < kWidth; ++i) {
+      mCounters[row][i] >>= 1;
+    }
+  }
+
+  mRecorded /= 2;
+}
+
+} // namespace net
+} // namespace mozilla
@@ -0,0 +1,51 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef CacheFrequencySketch__h__
+#define CacheFrequencySketch__h__
+
+#include "mozilla/Mutex.h"
+
+namespace mozilla {
+namespace net {
+
+/**
+ * Approximate counter of how often an entry was requested recently.
+ *
+ * This is a count-min sketch over hashes of entry keys with small saturating
+ * counters.  Once the number of recorded requests reaches the sample size, all
+ * counters are halved, so old popularity fades away.  The memory used doesn't
+ * depend on the number of entries, and collisions can only make the estimate
+ * higher.
+ *
+ * Thread-safe.
+ */
+class CacheFrequencySketch
+{
+public:
+  CacheFrequencySketch();
+
+  void Record(uint32_t aKeyHash);
+  uint32_t Estimate(uint32_t aKeyHash);
+  void Clear();
+
+  static uint32_t const kMaxCount = 15;
+
+private:
+  static uint32_t const kDepth = 4;
+  static uint32_t const kWidth = 1 << 12;
+  static uint32_t const kSampleSize = 10 * kWidth;
+
+  uint32_t Index(uint32_t aKeyHash, uint32_t aRow) const;
+  void Age();
+
+  mozilla::Mutex mLock;
+  uint8_t mCounters[kDepth][kWidth];
+  uint32_t mRecorded;
+};
+
+} // namespace net
+} // namespace mozilla
+
+#endif
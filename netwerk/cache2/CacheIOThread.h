@@ -33,6 +33,10 @@ public:
     READ_PRIORITY,
     OPEN,
     READ,
+    // Speculative chunk reads scheduled by CacheFile::PreloadChunks ahead of
+    // the consumer. Kept below reads someone is actually waiting for, but
+    // above writes, index updates and eviction.
+    READ_AHEAD,
     MANAGEMENT,
     WRITE,
     CLOSE,
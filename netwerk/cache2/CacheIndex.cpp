@@ -33,6 +33,8 @@
 #define INDEX_NAME      "index"
 #define TEMP_INDEX_NAME "index.tmp"
 #define JOURNAL_NAME    "index.log"
+#define CHANGES_NAME    "index.changes"
+#define TEMP_CHANGES_NAME "index.changes.tmp"
 
 namespace mozilla {
 namespace net {
@@ -48,6 +50,7 @@ public:
     : mIndex(aIndex)
     , mOldRecord(nullptr)
     , mOldFrecency(0)
+    , mWasDirty(false)
     , mDoNotSearchInIndex(false)
     , mDoNotSearchInUpdates(false)
   {
@@ -56,6 +59,7 @@ public:
     mHash = aHash;
     const CacheIndexEntry *entry = FindEntry();
     mIndex->mIndexStats.BeforeChange(entry);
+    mWasDirty = entry && entry->IsDirty();
     if (entry && entry->IsInitialized() && !entry->IsRemoved()) {
       mOldRecord = entry->mRec;
       mOldFrecency = entry->mRec->mFrecency;
@@ -68,6 +72,9 @@ public:
 
     const CacheIndexEntry *entry = FindEntry();
     mIndex->mIndexStats.AfterChange(entry);
+    if (entry && entry->IsDirty() && !mWasDirty) {
+      mIndex->AppendToChangeLog(mHash);
+    }
     if (!entry || !entry->IsInitialized() || entry->IsRemoved()) {
       entry = nullptr;
     }
@@ -142,6 +149,7 @@ private:
   nsRefPtr<CacheIndex> mIndex;
   CacheIndexRecord    *mOldRecord;
   uint32_t             mOldFrecency;
+  bool                 mWasDirty;
   bool                 mDoNotSearchInIndex;
   bool                 mDoNotSearchInUpdates;
 };
@@ -241,6 +249,11 @@ CacheIndex::CacheIndex()
   , mRWBufSize(0)
   , mRWBufPos(0)
   , mJournalReadSuccessfully(false)
+  , mChangeLog(nullptr)
+  , mChangeLogFlushPending(false)
+  , mWriteTimeStamp(0)
+  , mChangeLogRead(false)
+  , mUpdateFromChangeLog(false)
 {
   LOG(("CacheIndex::CacheIndex [this=%p]", this));
   MOZ_COUNT_CTOR(CacheIndex);
@@ -253,6 +266,10 @@ CacheIndex::~CacheIndex()
   MOZ_COUNT_DTOR(CacheIndex);
 
   ReleaseBuffer();
+
+  if (mChangeLog) {
+    PR_Close(mChangeLog);
+  }
 }
 
 void
@@ -408,6 +425,11 @@ CacheIndex::PreShutdownInternal()
 
   // We should end up in READY state
   MOZ_ASSERT(mState == READY);
+
+  // The index is either marked clean in Shutdown() or it will be updated on
+  // the next start without the change log, so it is not needed anymore.
+  // Remove it here, while we're still on the IO thread.
+  CloseChangeLog(true);
 }
 
 // static
@@ -443,6 +465,12 @@ CacheIndex::Shutdown()
          "PreShutdownInternal() fail?"));
   }
 
+  // PreShutdownInternal() has removed the change log already, unless it
+  // couldn't be posted.
+  if (index->mChangeLog) {
+    index->CloseChangeLog(true);
+  }
+
   switch (oldState) {
     case WRITING:
       index->FinishWrite(false);
@@ -1079,6 +1107,8 @@ CacheIndex::RemoveAll()
     index->mIndexStats.Clear();
     index->mFrecencyArray.Clear();
     index->mIndex.Clear();
+
+    index->CloseChangeLog(true);
   }
 
   if (file) {
@@ -1585,8 +1615,8 @@ CacheIndex::WriteIndexToDisk()
 
   CacheIndexHeader *hdr = reinterpret_cast<CacheIndexHeader *>(mRWBuf);
   NetworkEndian::writeUint32(&hdr->mVersion, kIndexVersion);
-  NetworkEndian::writeUint32(&hdr->mTimeStamp,
-                             static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC));
+  mWriteTimeStamp = static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC);
+  NetworkEndian::writeUint32(&hdr->mTimeStamp, mWriteTimeStamp);
   NetworkEndian::writeUint32(&hdr->mIsDirty, 1);
 
   mRWBufPos = sizeof(CacheIndexHeader);
@@ -1733,6 +1763,12 @@ CacheIndex::FinishWrite(bool aSucceeded)
   ProcessPendingOperations();
   mIndexStats.Log();
 
+  if (aSucceeded) {
+    // Entries that are dirty now are exactly the changes missing in the index
+    // file we've just written.
+    RewriteChangeLog();
+  }
+
   if (mState == WRITING) {
     ChangeState(READY);
     mLastDumpTime = TimeStamp::NowLoRes();
@@ -1791,6 +1827,8 @@ CacheIndex::RemoveIndexFromDisk()
   RemoveFile(NS_LITERAL_CSTRING(INDEX_NAME));
   RemoveFile(NS_LITERAL_CSTRING(TEMP_INDEX_NAME));
   RemoveFile(NS_LITERAL_CSTRING(JOURNAL_NAME));
+  RemoveFile(NS_LITERAL_CSTRING(CHANGES_NAME));
+  RemoveFile(NS_LITERAL_CSTRING(TEMP_CHANGES_NAME));
 }
 
 class WriteLogHelper
@@ -1962,6 +2000,263 @@ CacheIndex::WriteLogToDisk()
   return NS_OK;
 }
 
+void
+CacheIndex::ReadChangeLog(uint32_t aTimeStamp)
+{
+  LOG(("CacheIndex::ReadChangeLog() [timeStamp=%u]", aTimeStamp));
+
+  nsresult rv;
+
+  MOZ_ASSERT(!mChangeLog);
+  MOZ_ASSERT(!mChangeLogRead);
+  MOZ_ASSERT(mChangeLogHashes.IsEmpty());
+
+  nsCOMPtr<nsIFile> file;
+  rv = GetFile(NS_LITERAL_CSTRING(CHANGES_NAME), getter_AddRefs(file));
+  if (NS_FAILED(rv)) {
+    return;
+  }
+
+  PRFileDesc *fd = nullptr;
+  rv = file->OpenNSPRFileDesc(PR_RDONLY, 0600, &fd);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::ReadChangeLog() - Cannot open change log [rv=0x%08x]",
+         rv));
+    return;
+  }
+
+  int64_t fileSize = PR_Available64(fd);
+  int64_t hashesSize = fileSize - static_cast<int64_t>(sizeof(uint32_t));
+  uint32_t timeStamp = 0;
+
+  if (hashesSize >= 0 && hashesSize <= INT32_MAX &&
+      hashesSize % sizeof(SHA1Sum::Hash) == 0 &&
+      PR_Read(fd, &timeStamp, sizeof(uint32_t)) == sizeof(uint32_t) &&
+      NetworkEndian::readUint32(&timeStamp) == aTimeStamp &&
+      mChangeLogHashes.SetLength(static_cast<uint32_t>(hashesSize), fallible) &&
+      PR_Read(fd, mChangeLogHashes.Elements(),
+              static_cast<int32_t>(hashesSize)) == hashesSize) {
+    mChangeLogRead = true;
+  } else {
+    LOG(("CacheIndex::ReadChangeLog() - Change log doesn't belong to the index "
+         "or is corrupted [size=%lld]", fileSize));
+    mChangeLogHashes.Clear();
+  }
+
+  PR_Close(fd);
+
+  // The log is written again once the index is written. Until then it must
+  // not be used on the next start.
+  file->Remove(false);
+
+  LOG(("CacheIndex::ReadChangeLog() - [read=%d, entries=%u]", mChangeLogRead,
+       static_cast<uint32_t>(mChangeLogHashes.Length() /
+                             sizeof(SHA1Sum::Hash))));
+}
+
+void
+CacheIndex::RewriteChangeLog()
+{
+  LOG(("CacheIndex::RewriteChangeLog()"));
+
+  nsresult rv;
+
+  AssertOwnsLock();
+  MOZ_ASSERT(CacheFileIOManager::IsOnIOThread());
+  MOZ_ASSERT(mState == WRITING);
+
+  CloseChangeLog(false);
+
+  nsCOMPtr<nsIFile> tmpFile;
+  rv = GetFile(NS_LITERAL_CSTRING(TEMP_CHANGES_NAME), getter_AddRefs(tmpFile));
+  if (NS_FAILED(rv)) {
+    CloseChangeLog(true);
+    return;
+  }
+
+  PRFileDesc *fd = nullptr;
+  rv = tmpFile->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE, 0600,
+                                 &fd);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::RewriteChangeLog() - Cannot open file [rv=0x%08x]", rv));
+    CloseChangeLog(true);
+    return;
+  }
+
+  nsTArray<uint8_t> buf;
+  buf.SetLength(sizeof(uint32_t));
+  NetworkEndian::writeUint32(buf.Elements(), mWriteTimeStamp);
+
+  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+    CacheIndexEntry* entry = iter.Get();
+    if (entry->IsDirty()) {
+      buf.AppendElements(reinterpret_cast<const uint8_t *>(entry->Hash()),
+                         sizeof(SHA1Sum::Hash));
+    }
+  }
+
+  int32_t bytesWritten = PR_Write(fd, buf.Elements(), buf.Length());
+  PR_Close(fd);
+  if (bytesWritten != static_cast<int32_t>(buf.Length())) {
+    LOG(("CacheIndex::RewriteChangeLog() - Cannot write change log."));
+    tmpFile->Remove(false);
+    CloseChangeLog(true);
+    return;
+  }
+
+  // Remove the old log first, renaming over an existing file fails on some
+  // platforms.
+  CloseChangeLog(true);
+
+  rv = tmpFile->MoveToNative(nullptr, NS_LITERAL_CSTRING(CHANGES_NAME));
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::RewriteChangeLog() - Cannot rename change log "
+         "[rv=0x%08x]", rv));
+    tmpFile->Remove(false);
+    return;
+  }
+
+  nsCOMPtr<nsIFile> file;
+  rv = GetFile(NS_LITERAL_CSTRING(CHANGES_NAME), getter_AddRefs(file));
+  if (NS_SUCCEEDED(rv)) {
+    rv = file->OpenNSPRFileDesc(PR_WRONLY | PR_APPEND, 0600, &mChangeLog);
+  }
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::RewriteChangeLog() - Cannot reopen change log "
+         "[rv=0x%08x]", rv));
+    mChangeLog = nullptr;
+    CloseChangeLog(true);
+  }
+}
+
+void
+CacheIndex::AppendToChangeLog(const SHA1Sum::Hash *aHash)
+{
+  AssertOwnsLock();
+
+  if (!mChangeLog) {
+    return;
+  }
+
+  // This is called from CacheIndexEntryAutoManage on any thread and with the
+  // lock held, so leave the writing to the IO thread.
+  mPendingChangeLogHashes.AppendElements(
+    reinterpret_cast<const uint8_t *>(aHash), sizeof(SHA1Sum::Hash));
+
+  if (mChangeLogFlushPending) {
+    return;
+  }
+
+  nsRefPtr<CacheIOThread> ioThread = CacheFileIOManager::IOThread();
+  if (!ioThread) {
+    // We're shutting down and the change log is going to be removed.
+    return;
+  }
+
+  nsCOMPtr<nsIRunnable> event =
+    NS_NewRunnableMethod(this, &CacheIndex::FlushChangeLog);
+  nsresult rv = ioThread->Dispatch(event, CacheIOThread::INDEX);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::AppendToChangeLog() - Can't dispatch flush event "
+         "[rv=0x%08x]", rv));
+    return;
+  }
+
+  mChangeLogFlushPending = true;
+}
+
+void
+CacheIndex::FlushChangeLog()
+{
+  MOZ_ASSERT(CacheFileIOManager::IsOnIOThread());
+
+  CacheIndexAutoLock lock(this);
+
+  mChangeLogFlushPending = false;
+
+  if (!mChangeLog || mPendingChangeLogHashes.IsEmpty()) {
+    return;
+  }
+
+  LOG(("CacheIndex::FlushChangeLog() [entries=%u]",
+       static_cast<uint32_t>(mPendingChangeLogHashes.Length() /
+                             sizeof(SHA1Sum::Hash))));
+
+  nsTArray<uint8_t> hashes;
+  hashes.SwapElements(mPendingChangeLogHashes);
+  PRFileDesc *fd = mChangeLog;
+
+  int32_t bytesWritten;
+  {
+    // mChangeLog is only opened and closed on this thread, so the descriptor
+    // stays valid while the lock is released.
+    CacheIndexAutoUnlock unlock(this);
+    bytesWritten = PR_Write(fd, hashes.Elements(), hashes.Length());
+  }
+
+  if (bytesWritten != static_cast<int32_t>(hashes.Length())) {
+    // A log with missing changes is worse than no log at all.
+    LOG(("CacheIndex::FlushChangeLog() - Write failed, removing change log."));
+    CloseChangeLog(true);
+  }
+}
+
+void
+CacheIndex::CloseChangeLog(bool aRemove)
+{
+  LOG(("CacheIndex::CloseChangeLog() [remove=%d]", aRemove));
+
+  mPendingChangeLogHashes.Clear();
+
+  if (mChangeLog) {
+    PR_Close(mChangeLog);
+    mChangeLog = nullptr;
+  }
+
+  if (aRemove) {
+    nsCOMPtr<nsIFile> file;
+    nsresult rv = GetFile(NS_LITERAL_CSTRING(CHANGES_NAME),
+                          getter_AddRefs(file));
+    if (NS_SUCCEEDED(rv)) {
+      // Ignore the result. The file might not exist.
+      file->Remove(false);
+    }
+  }
+}
+
+nsresult
+CacheIndex::GetNextChangedFile(nsIFile **_retval)
+{
+  nsresult rv;
+
+  uint32_t length = mChangeLogHashes.Length();
+  if (length < sizeof(SHA1Sum::Hash)) {
+    *_retval = nullptr;
+    return NS_OK;
+  }
+
+  SHA1Sum::Hash hash;
+  memcpy(&hash, mChangeLogHashes.Elements() + length - sizeof(SHA1Sum::Hash),
+         sizeof(SHA1Sum::Hash));
+  mChangeLogHashes.SetLength(length - sizeof(SHA1Sum::Hash));
+
+  nsCOMPtr<nsIFile> file;
+  rv = mCacheDirectory->Clone(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  rv = file->AppendNative(NS_LITERAL_CSTRING(ENTRIES_DIR));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsAutoCString leafName;
+  CacheFileIOManager::HashToStr(&hash, leafName);
+
+  rv = file->AppendNative(leafName);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  file.swap(*_retval);
+  return NS_OK;
+}
+
 void
 CacheIndex::ReadIndexFromDisk()
 {
@@ -2081,7 +2376,15 @@ CacheIndex::ParseRecords()
         mJournalHandle = nullptr;
       }
       free(hdr);
+
+      // We didn't shut down cleanly, find out which entries changed after the
+      // index was written.
+      ReadChangeLog(mIndexTimeStamp);
     } else {
+      // A change log left behind doesn't belong to this index. Remove it
+      // before the index is marked dirty.
+      CloseChangeLog(true);
+
       NetworkEndian::writeUint32(&hdr->mIsDirty, 1);
 
       // Mark index dirty. The buffer is freed by CacheFileIOManager when
@@ -2403,6 +2706,14 @@ CacheIndex::FinishRead(bool aSucceeded)
   mRWHash = nullptr;
   ReleaseBuffer();
 
+  // The change log is used only when updating the index it belongs to.
+  bool changeLogRead = mChangeLogRead;
+  mChangeLogRead = false;
+  if (mState == SHUTDOWN || !mIndexOnDiskIsValid || mJournalReadSuccessfully) {
+    changeLogRead = false;
+    mChangeLogHashes.Clear();
+  }
+
   if (mState == SHUTDOWN) {
     return;
   }
@@ -2421,6 +2732,7 @@ CacheIndex::FinishRead(bool aSucceeded)
     mTmpJournal.Clear();
     EnsureNoFreshEntry();
     ProcessPendingOperations();
+    mUpdateFromChangeLog = changeLogRead;
     StartUpdatingIndex(false);
     return;
   }
@@ -2802,7 +3114,7 @@ CacheIndex::UpdateIndex()
 
   nsresult rv;
 
-  if (!mDirEnumerator) {
+  if (!mDirEnumerator && !mUpdateFromChangeLog) {
     {
       // Do not do IO under the lock.
       CacheIndexAutoUnlock unlock(this);
@@ -2829,7 +3141,12 @@ CacheIndex::UpdateIndex()
     }
 
     nsCOMPtr<nsIFile> file;
-    {
+    if (mUpdateFromChangeLog) {
+      // Only entries listed in the change log might differ from the index on
+      // the disk. A missing file fails in SyncReadMetadata() below and the
+      // entry is removed.
+      rv = GetNextChangedFile(getter_AddRefs(file));
+    } else {
       // Do not do IO under the lock.
       CacheIndexAutoUnlock unlock(this);
       rv = mDirEnumerator->GetNextFile(getter_AddRefs(file));
@@ -2988,6 +3305,10 @@ CacheIndex::FinishUpdate(bool aSucceeded)
     }
   }
 
+  bool updateFromChangeLog = mUpdateFromChangeLog;
+  mUpdateFromChangeLog = false;
+  mChangeLogHashes.Clear();
+
   if (!aSucceeded) {
     mDontMarkIndexClean = true;
   }
@@ -2997,10 +3318,16 @@ CacheIndex::FinishUpdate(bool aSucceeded)
   }
 
   if (mState == UPDATING && aSucceeded) {
-    // If we've iterated over all entries successfully then all entries that
-    // really exist on the disk are now marked as fresh. All non-fresh entries
-    // don't exist anymore and must be removed from the index.
-    RemoveNonFreshEntries();
+    if (updateFromChangeLog) {
+      // We've checked all entries that changed after the index was written.
+      // The rest of the entries in the index is up to date.
+      MarkNonFreshEntriesFresh();
+    } else {
+      // If we've iterated over all entries successfully then all entries that
+      // really exist on the disk are now marked as fresh. All non-fresh
+      // entries don't exist anymore and must be removed from the index.
+      RemoveNonFreshEntries();
+    }
   }
 
   // Make sure we won't start update. If the build or update failed, there is no
@@ -3032,6 +3359,20 @@ CacheIndex::RemoveNonFreshEntries()
   }
 }
 
+void
+CacheIndex::MarkNonFreshEntriesFresh()
+{
+  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+    CacheIndexEntry* entry = iter.Get();
+    if (entry->IsFresh()) {
+      continue;
+    }
+
+    CacheIndexEntryAutoManage emng(entry->Hash(), this);
+    entry->MarkFresh();
+  }
+}
+
 // static
 char const *
 CacheIndex::StateString(EState aState)
@@ -756,6 +756,32 @@ private:
   // Writes journal to the disk and clears dirty flag in index header.
   nsresult WriteLogToDisk();
 
+  // Following methods maintain the change log. It is an append-only file that
+  // starts with the timestamp of the index file it belongs to and then lists
+  // hashes of all entries that became dirty since that index was written. It
+  // is rewritten after every successful write of the index, so after a crash
+  // only the listed entries need to be checked instead of the whole entries
+  // directory. The file is only opened, written and closed on the IO thread,
+  // and never while the index lock is held.
+  //
+  // Reads the change log into mChangeLogHashes if it belongs to the index with
+  // aTimeStamp and removes it from the disk.
+  void ReadChangeLog(uint32_t aTimeStamp);
+  // Replaces the change log with a new one containing all dirty entries and
+  // keeps it open for appending.
+  void RewriteChangeLog();
+  // Queues a hash for the change log if it is open. The hashes are written by
+  // FlushChangeLog().
+  void AppendToChangeLog(const SHA1Sum::Hash *aHash);
+  // Writes the queued hashes to the change log. Runs on the IO thread.
+  void FlushChangeLog();
+  // Closes the change log, drops the queued hashes and optionally removes the
+  // log from the disk.
+  void CloseChangeLog(bool aRemove);
+  // Returns the file of the next entry from mChangeLogHashes or nullptr when
+  // there is no other entry to check.
+  nsresult GetNextChangedFile(nsIFile **_retval);
+
   // Following methods perform reading of the index from the disk.
   //
   // Index is read at startup just after initializing the CacheIndex. There are
@@ -840,6 +866,9 @@ private:
   void FinishUpdate(bool aSucceeded);
 
   void RemoveNonFreshEntries();
+  // Marks all entries that weren't listed in the change log as fresh after
+  // the update from the change log finished.
+  void MarkNonFreshEntriesFresh();
 
   enum EState {
     // Initial state in which the index is not usable
@@ -988,6 +1017,23 @@ private:
   // Directory enumerator used when building and updating index.
   nsCOMPtr<nsIDirectoryEnumerator> mDirEnumerator;
 
+  // Change log opened for appending, see RewriteChangeLog().
+  PRFileDesc                      *mChangeLog;
+  // Hashes waiting to be appended to the change log, stored one after
+  // another.
+  nsTArray<uint8_t>                mPendingChangeLogHashes;
+  // True when FlushChangeLog() has been posted to the IO thread.
+  bool                             mChangeLogFlushPending;
+  // Timestamp written to the header of the index that is being written.
+  uint32_t                         mWriteTimeStamp;
+  // Hashes read from the change log that still need to be checked, stored
+  // one after another.
+  nsTArray<uint8_t>                mChangeLogHashes;
+  // True when a valid change log was read together with a dirty index.
+  bool                             mChangeLogRead;
+  // True when the running update checks only entries from the change log.
+  bool                             mUpdateFromChangeLog;
+
   // Main index hashtable.
   nsTHashtable<CacheIndexEntry> mIndex;
 
@@ -69,6 +69,18 @@ uint32_t CacheObserver::sMaxMemoryEntrySize = kDefaultMaxMemoryEntrySize;
 static uint32_t const kDefaultMaxDiskEntrySize = 50 * 1024; // 50 MB
 uint32_t CacheObserver::sMaxDiskEntrySize = kDefaultMaxDiskEntrySize;
 
+// Entries bigger than this are kept only when they were requested repeatedly,
+// see CacheStorageService::ShouldAdmitEntry().  0 disables the check, which is
+// the default until the thresholds have been tuned against real browsing.
+static uint32_t const kDefaultDiskAdmissionSize = 0;
+uint32_t CacheObserver::sDiskAdmissionSize = kDefaultDiskAdmissionSize;
+
+static uint32_t const kDefaultMemoryAdmissionSize = 0;
+uint32_t CacheObserver::sMemoryAdmissionSize = kDefaultMemoryAdmissionSize;
+
+static uint32_t const kDefaultAdmissionMinFrequency = 2;
+uint32_t CacheObserver::sAdmissionMinFrequency = kDefaultAdmissionMinFrequency;
+
 static uint32_t const kDefaultMaxDiskChunksMemoryUsage = 10 * 1024; // 10MB
 uint32_t CacheObserver::sMaxDiskChunksMemoryUsage = kDefaultMaxDiskChunksMemoryUsage;
 
@@ -171,6 +183,13 @@ CacheObserver::AttachToPreferences()
   mozilla::Preferences::AddUintVarCache(
     &sMaxMemoryEntrySize, "browser.cache.memory.max_entry_size", kDefaultMaxMemoryEntrySize);
 
+  mozilla::Preferences::AddUintVarCache(
+    &sDiskAdmissionSize, "browser.cache.disk.admission_size", kDefaultDiskAdmissionSize);
+  mozilla::Preferences::AddUintVarCache(
+    &sMemoryAdmissionSize, "browser.cache.memory.admission_size", kDefaultMemoryAdmissionSize);
+  mozilla::Preferences::AddUintVarCache(
+    &sAdmissionMinFrequency, "browser.cache.admission_min_frequency", kDefaultAdmissionMinFrequency);
+
   mozilla::Preferences::AddUintVarCache(
     &sMaxDiskChunksMemoryUsage, "browser.cache.disk.max_chunks_memory_usage", kDefaultMaxDiskChunksMemoryUsage);
   mozilla::Preferences::AddUintVarCache(
@@ -462,6 +481,17 @@ CacheStorageEvictHelper::ClearStorage(bool const aPrivate,
 } // namespace
 
 // static
+bool const CacheObserver::EntryNeedsAdmission(int64_t aOldSize, int64_t aNewSize,
+                                              bool aUsingDisk)
+{
+  int64_t limit = aUsingDisk
+    ? static_cast<int64_t>(sDiskAdmissionSize) << 10
+    : static_cast<int64_t>(sMemoryAdmissionSize) << 10;
+
+  // Check only once, when the entry grows over the limit.
+  return limit && aOldSize <= limit && aNewSize > limit;
+}
+
 bool const CacheObserver::EntryIsTooBig(int64_t aSize, bool aUsingDisk)
 {
   // If custom limit is set, check it.
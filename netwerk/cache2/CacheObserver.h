@@ -70,6 +70,12 @@ class CacheObserver : public nsIObserver
   static void ParentDirOverride(nsIFile ** aDir);
 
   static bool const EntryIsTooBig(int64_t aSize, bool aUsingDisk);
+  // True when an entry growing from aOldSize to aNewSize crosses the size
+  // over which it has to pass CacheStorageService::ShouldAdmitEntry().
+  static bool const EntryNeedsAdmission(int64_t aOldSize, int64_t aNewSize,
+                                        bool aUsingDisk);
+  static uint32_t const AdmissionMinFrequency()
+    { return sAdmissionMinFrequency; }
 
 private:
   static CacheObserver* sSelf;
@@ -92,6 +98,9 @@ private:
   static uint32_t sPreloadChunkCount;
   static uint32_t sMaxMemoryEntrySize;
   static uint32_t sMaxDiskEntrySize;
+  static uint32_t sDiskAdmissionSize;
+  static uint32_t sMemoryAdmissionSize;
+  static uint32_t sAdmissionMinFrequency;
   static uint32_t sMaxDiskChunksMemoryUsage;
   static uint32_t sMaxDiskPriorityChunksMemoryUsage;
   static uint32_t sCompressionLevel;
@@ -754,6 +754,8 @@ NS_IMETHODIMP CacheStorageService::Clear()
         DoomStorageEntries(keys[i], nullptr, true, nullptr);
     }
 
+    mFrequencySketch.Clear();
+
     rv = CacheFileIOManager::EvictAll();
     NS_ENSURE_SUCCESS(rv, rv);
   } else {
@@ -768,6 +770,25 @@ NS_IMETHODIMP CacheStorageService::Clear()
   return NS_OK;
 }
 
+void CacheStorageService::RecordEntryRequest(uint32_t aKeyHash)
+{
+  mFrequencySketch.Record(aKeyHash);
+}
+
+bool CacheStorageService::ShouldAdmitEntry(uint32_t aKeyHash)
+{
+  uint32_t frequency = mFrequencySketch.Estimate(aKeyHash);
+  uint32_t minFrequency = CacheObserver::AdmissionMinFrequency();
+  if (minFrequency > CacheFrequencySketch::kMaxCount) {
+    minFrequency = CacheFrequencySketch::kMaxCount;
+  }
+
+  LOG(("CacheStorageService::ShouldAdmitEntry [hash=%08x, frequency=%u, min=%u]",
+       aKeyHash, frequency, minFrequency));
+
+  return frequency >= minFrequency;
+}
+
 NS_IMETHODIMP CacheStorageService::PurgeFromMemory(uint32_t aWhat)
 {
   uint32_t what;
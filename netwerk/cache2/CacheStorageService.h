@@ -7,6 +7,7 @@
 
 #include "nsICacheStorageService.h"
 #include "nsIMemoryReporter.h"
+#include "CacheFrequencySketch.h"
 
 #include "nsITimer.h"
 #include "nsClassHashtable.h"
@@ -106,6 +107,18 @@ public:
   // Invokes OnEntryInfo for the given aEntry, synchronously.
   static void GetCacheEntryInfo(CacheEntry* aEntry, EntryInfoCallback *aVisitor);
 
+  /**
+   * Admission filter for big entries.  Every request for an entry is recorded
+   * by its key hash (CacheHash of the entry's hashing key with storage).  An
+   * entry that grows over the admission size (see
+   * CacheObserver::EntryNeedsAdmission()) is kept only when it has been
+   * requested at least CacheObserver::AdmissionMinFrequency() times recently,
+   * so one-off big responses don't push hot small entries out of the cache.
+   * Both may be called on any thread.
+   */
+  void RecordEntryRequest(uint32_t aKeyHash);
+  bool ShouldAdmitEntry(uint32_t aKeyHash);
+
   // Memory reporting
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -287,6 +300,9 @@ private:
   mozilla::Mutex mLock;
   mozilla::Mutex mForcedValidEntriesLock;
 
+  // Request frequency of recently used entries, has its own lock.
+  CacheFrequencySketch mFrequencySketch;
+
   bool mShutdown;
 
   // Accessible only on the service thread
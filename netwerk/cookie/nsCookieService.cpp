@@ -609,9 +609,72 @@ nsCookieEntry::SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const
     amount += mCookies[i]->SizeOfIncludingThis(aMallocSizeOf);
   }
 
+  amount += mCachedHeaders.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (uint32_t i = 0; i < mCachedHeaders.Length(); ++i) {
+    const CachedHeader &cached = mCachedHeaders[i];
+    amount += cached.mHost.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+    amount += cached.mPath.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+    amount += cached.mCookies.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    amount += cached.mHeader.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  }
+
   return amount;
 }
 
+// number of cookie headers remembered per base domain
+static const uint32_t kMaxCachedHeadersPerEntry = 8;
+
+const nsCookieEntry::CachedHeader*
+nsCookieEntry::GetCachedHeader(const nsACString &aHost,
+                               const nsACString &aPath,
+                               bool aIsSecure, bool aHttpBound,
+                               int64_t aCurrentTime) const
+{
+  for (uint32_t i = 0; i < mCachedHeaders.Length(); ++i) {
+    const CachedHeader &cached = mCachedHeaders[i];
+    if (cached.mIsSecure == aIsSecure && cached.mHttpBound == aHttpBound &&
+        cached.mHost == aHost && cached.mPath == aPath) {
+      // once one of the cookies expired, the header has to be rebuilt
+      return aCurrentTime < cached.mExpiry ? &cached : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+void
+nsCookieEntry::CacheHeader(const nsACString &aHost, const nsACString &aPath,
+                           bool aIsSecure, bool aHttpBound,
+                           const nsTArray<nsCookie*> &aCookies,
+                           const nsACString &aHeader)
+{
+  // drop an expired header for the same request, then the oldest one
+  for (uint32_t i = 0; i < mCachedHeaders.Length(); ++i) {
+    const CachedHeader &cached = mCachedHeaders[i];
+    if (cached.mIsSecure == aIsSecure && cached.mHttpBound == aHttpBound &&
+        cached.mHost == aHost && cached.mPath == aPath) {
+      mCachedHeaders.RemoveElementAt(i);
+      break;
+    }
+  }
+  if (mCachedHeaders.Length() >= kMaxCachedHeadersPerEntry) {
+    mCachedHeaders.RemoveElementAt(0);
+  }
+
+  CachedHeader *cached = mCachedHeaders.AppendElement();
+  cached->mHost = aHost;
+  cached->mPath = aPath;
+  cached->mIsSecure = aIsSecure;
+  cached->mHttpBound = aHttpBound;
+  cached->mExpiry = INT64_MAX;
+  for (uint32_t i = 0; i < aCookies.Length(); ++i) {
+    cached->mCookies.AppendElement(aCookies[i]);
+    if (aCookies[i]->Expiry() < cached->mExpiry) {
+      cached->mExpiry = aCookies[i]->Expiry();
+    }
+  }
+  cached->mHeader = aHeader;
+}
+
 size_t
 CookieDomainTuple::SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const
 {
@@ -2682,59 +2745,119 @@ nsCookieService::GetCookieStringInternal(nsIURI *aHostURI,
   if (!entry)
     return;
 
-  // iterate the cookies!
-  const nsCookieEntry::ArrayType &cookies = entry->GetCookies();
-  for (nsCookieEntry::IndexType i = 0; i < cookies.Length(); ++i) {
-    cookie = cookies[i];
-
-    // check the host, since the base domain lookup is conservative.
-    // first, check for an exact host or domain cookie match, e.g. "google.com"
-    // or ".google.com"; second a subdomain match, e.g.
-    // host = "mail.google.com", cookie domain = ".google.com".
-    if (cookie->RawHost() != hostFromURI &&
-        !(cookie->IsDomain() && StringEndsWith(hostFromURI, cookie->Host())))
-      continue;
+  // the query and ref don't affect which cookies match, unless a cookie path
+  // contains one of their delimiters (in which case nothing gets cached).
+  nsAutoCString requestPath(pathFromURI);
+  int32_t delimiter = requestPath.FindCharInSet("?#;");
+  if (delimiter != kNotFound) {
+    requestPath.Truncate(delimiter);
+  }
+
+  const nsCookieEntry::CachedHeader *cached =
+    entry->GetCachedHeader(hostFromURI, requestPath, isSecure, aHttpBound,
+                           currentTime);
+  if (cached) {
+    for (nsCookieEntry::IndexType i = 0; i < cached->mCookies.Length(); ++i) {
+      cookie = cached->mCookies[i];
+      foundCookieList.AppendElement(cookie);
+      if (cookie->IsStale()) {
+        stale = true;
+      }
+    }
+    aCookieString = cached->mHeader;
+  } else {
+    bool cacheable = true;
 
-    // if the cookie is secure and the host scheme isn't, we can't send it
-    if (cookie->IsSecure() && !isSecure)
-      continue;
+    // iterate the cookies!
+    const nsCookieEntry::ArrayType &cookies = entry->GetCookies();
+    for (nsCookieEntry::IndexType i = 0; i < cookies.Length(); ++i) {
+      cookie = cookies[i];
 
-    // if the cookie is httpOnly and it's not going directly to the HTTP
-    // connection, don't send it
-    if (cookie->IsHttpOnly() && !aHttpBound)
-      continue;
+      if (cookie->Path().FindCharInSet("?#;") != kNotFound) {
+        cacheable = false;
+      }
 
-    // calculate cookie path length, excluding trailing '/'
-    uint32_t cookiePathLen = cookie->Path().Length();
-    if (cookiePathLen > 0 && cookie->Path().Last() == '/')
-      --cookiePathLen;
+      // check the host, since the base domain lookup is conservative.
+      // first, check for an exact host or domain cookie match, e.g. "google.com"
+      // or ".google.com"; second a subdomain match, e.g.
+      // host = "mail.google.com", cookie domain = ".google.com".
+      if (cookie->RawHost() != hostFromURI &&
+          !(cookie->IsDomain() && StringEndsWith(hostFromURI, cookie->Host())))
+        continue;
 
-    // if the nsIURI path is shorter than the cookie path, don't send it back
-    if (!StringBeginsWith(pathFromURI, Substring(cookie->Path(), 0, cookiePathLen)))
-      continue;
+      // if the cookie is secure and the host scheme isn't, we can't send it
+      if (cookie->IsSecure() && !isSecure)
+        continue;
 
-    if (pathFromURI.Length() > cookiePathLen &&
-        !ispathdelimiter(pathFromURI.CharAt(cookiePathLen))) {
-      /*
-       * |ispathdelimiter| tests four cases: '/', '?', '#', and ';'.
-       * '/' is the "standard" case; the '?' test allows a site at host/abc?def
-       * to receive a cookie that has a path attribute of abc.  this seems
-       * strange but at least one major site (citibank, bug 156725) depends
-       * on it.  The test for # and ; are put in to proactively avoid problems
-       * with other sites - these are the only other chars allowed in the path.
-       */
-      continue;
+      // if the cookie is httpOnly and it's not going directly to the HTTP
+      // connection, don't send it
+      if (cookie->IsHttpOnly() && !aHttpBound)
+        continue;
+
+      // calculate cookie path length, excluding trailing '/'
+      uint32_t cookiePathLen = cookie->Path().Length();
+      if (cookiePathLen > 0 && cookie->Path().Last() == '/')
+        --cookiePathLen;
+
+      // if the nsIURI path is shorter than the cookie path, don't send it back
+      if (!StringBeginsWith(pathFromURI, Substring(cookie->Path(), 0, cookiePathLen)))
+        continue;
+
+      if (pathFromURI.Length() > cookiePathLen &&
+          !ispathdelimiter(pathFromURI.CharAt(cookiePathLen))) {
+        /*
+         * |ispathdelimiter| tests four cases: '/', '?', '#', and ';'.
+         * '/' is the "standard" case; the '?' test allows a site at host/abc?def
+         * to receive a cookie that has a path attribute of abc.  this seems
+         * strange but at least one major site (citibank, bug 156725) depends
+         * on it.  The test for # and ; are put in to proactively avoid problems
+         * with other sites - these are the only other chars allowed in the path.
+         */
+        continue;
+      }
+
+      // check if the cookie has expired
+      if (cookie->Expiry() <= currentTime) {
+        continue;
+      }
+
+      // all checks passed - add to list and check if lastAccessed stamp needs updating
+      foundCookieList.AppendElement(cookie);
+      if (cookie->IsStale()) {
+        stale = true;
+      }
     }
 
-    // check if the cookie has expired
-    if (cookie->Expiry() <= currentTime) {
-      continue;
+    // return cookies in order of path length; longest to shortest.
+    // this is required per RFC2109.  if cookies match in length,
+    // then sort by creation time (see bug 236772).
+    foundCookieList.Sort(CompareCookiesForSending());
+
+    for (uint32_t i = 0; i < foundCookieList.Length(); ++i) {
+      cookie = foundCookieList.ElementAt(i);
+
+      // check if we have anything to write
+      if (!cookie->Name().IsEmpty() || !cookie->Value().IsEmpty()) {
+        // if we've already added a cookie to the return list, append a "; " so
+        // that subsequent cookies are delimited in the final list.
+        if (!aCookieString.IsEmpty()) {
+          aCookieString.AppendLiteral("; ");
+        }
+
+        if (!cookie->Name().IsEmpty()) {
+          // we have a name and value - write both
+          aCookieString += cookie->Name() + NS_LITERAL_CSTRING("=") + cookie->Value();
+        } else {
+          // just write value
+          aCookieString += cookie->Value();
+        }
+      }
     }
 
-    // all checks passed - add to list and check if lastAccessed stamp needs updating
-    foundCookieList.AppendElement(cookie);
-    if (cookie->IsStale()) {
-      stale = true;
+    // remember the result, including an empty one, until the entry changes
+    if (cacheable) {
+      entry->CacheHeader(hostFromURI, requestPath, isSecure, aHttpBound,
+                         foundCookieList, aCookieString);
     }
   }
 
@@ -2775,32 +2898,6 @@ nsCookieService::GetCookieStringInternal(nsIURI *aHostURI,
     }
   }
 
-  // return cookies in order of path length; longest to shortest.
-  // this is required per RFC2109.  if cookies match in length,
-  // then sort by creation time (see bug 236772).
-  foundCookieList.Sort(CompareCookiesForSending());
-
-  for (int32_t i = 0; i < count; ++i) {
-    cookie = foundCookieList.ElementAt(i);
-
-    // check if we have anything to write
-    if (!cookie->Name().IsEmpty() || !cookie->Value().IsEmpty()) {
-      // if we've already added a cookie to the return list, append a "; " so
-      // that subsequent cookies are delimited in the final list.
-      if (!aCookieString.IsEmpty()) {
-        aCookieString.AppendLiteral("; ");
-      }
-
-      if (!cookie->Name().IsEmpty()) {
-        // we have a name and value - write both
-        aCookieString += cookie->Name() + NS_LITERAL_CSTRING("=") + cookie->Value();
-      } else {
-        // just write value
-        aCookieString += cookie->Value();
-      }
-    }
-  }
-
   if (!aCookieString.IsEmpty())
     COOKIE_LOGSUCCESS(GET_COOKIE, aHostURI, aCookieString, nullptr, false);
 }
@@ -4117,6 +4214,7 @@ nsCookieService::RemoveCookieFromList(const nsListIter              &aIter,
   } else {
     // just remove the element from the list
     aIter.entry->GetCookies().RemoveElementAt(aIter.index);
+    aIter.entry->ClearCachedHeaders();
   }
 
   --mDBState->cookieCount;
@@ -4216,6 +4314,7 @@ nsCookieService::AddCookieToList(const nsCookieKey             &aKey,
   NS_ASSERTION(entry, "can't insert element into a null entry!");
 
   entry->GetCookies().AppendElement(aCookie);
+  entry->ClearCachedHeaders();
   ++aDBState->cookieCount;
 
   // keep track of the oldest cookie, for when it comes time to purge
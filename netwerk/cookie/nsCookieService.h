@@ -138,10 +138,37 @@ class nsCookieEntry : public nsCookieKey
 
     inline ArrayType& GetCookies() { return mCookies; }
 
+    // A cookie header built from this entry for a given request host, path
+    // (without query or ref), scheme security and http-boundness. The cookies
+    // it was built from are kept in sending order, so lastAccessed times can
+    // still be updated without scanning the entry again.
+    struct CachedHeader
+    {
+      nsCString mHost;
+      nsCString mPath;
+      bool      mIsSecure;
+      bool      mHttpBound;
+      int64_t   mExpiry; // earliest expiry of mCookies, in seconds
+      ArrayType mCookies;
+      nsCString mHeader;
+    };
+
+    const CachedHeader* GetCachedHeader(const nsACString &aHost,
+                                        const nsACString &aPath,
+                                        bool aIsSecure, bool aHttpBound,
+                                        int64_t aCurrentTime) const;
+    void CacheHeader(const nsACString &aHost, const nsACString &aPath,
+                     bool aIsSecure, bool aHttpBound,
+                     const nsTArray<nsCookie*> &aCookies,
+                     const nsACString &aHeader);
+    // must be called whenever mCookies changes
+    void ClearCachedHeaders() { mCachedHeaders.Clear(); }
+
     size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const;
 
   private:
     ArrayType mCookies;
+    nsTArray<CachedHeader> mCachedHeaders;
 };
 
 // encapsulates a (key, nsCookie) tuple for temporary storage purposes.
@@ -53,6 +53,8 @@ static const char kPrefDisablePrefetch[]     = "network.dns.disablePrefetch";
 static const char kPrefDnsLocalDomains[]     = "network.dns.localDomains";
 static const char kPrefDnsOfflineLocalhost[] = "network.dns.offline-localhost";
 static const char kPrefDnsNotifyResolution[] = "network.dns.notifyResolution";
+static const char kPrefDnsMaxAnyPriorityThreads[]  = "network.dns.max_any_priority_threads";
+static const char kPrefDnsMaxHighPriorityThreads[] = "network.dns.max_high_priority_threads";
 
 //-----------------------------------------------------------------------------
 
@@ -540,6 +542,8 @@ nsDNSService::Init()
     uint32_t maxCacheEntries  = 400;
     uint32_t defaultCacheLifetime = 120; // seconds
     uint32_t defaultGracePeriod = 60; // seconds
+    uint32_t maxAnyPriorityThreads = MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY;
+    uint32_t maxHighPriorityThreads = MAX_RESOLVER_THREADS_FOR_HIGH_PRIORITY;
     bool     disableIPv6      = false;
     bool     offlineLocalhost = true;
     bool     disablePrefetch  = false;
@@ -559,6 +563,10 @@ nsDNSService::Init()
             defaultCacheLifetime = val;
         if (NS_SUCCEEDED(prefs->GetIntPref(kPrefDnsCacheGrace, &val)))
             defaultGracePeriod = val;
+        if (NS_SUCCEEDED(prefs->GetIntPref(kPrefDnsMaxAnyPriorityThreads, &val)) && val > 0)
+            maxAnyPriorityThreads = val;
+        if (NS_SUCCEEDED(prefs->GetIntPref(kPrefDnsMaxHighPriorityThreads, &val)) && val >= 0)
+            maxHighPriorityThreads = val;
 
         // ASSUMPTION: pref branch does not modify out params on failure
         prefs->GetBoolPref(kPrefDisableIPv6, &disableIPv6);
@@ -586,6 +594,8 @@ nsDNSService::Init()
             prefs->AddObserver(kPrefDnsOfflineLocalhost, this, false);
             prefs->AddObserver(kPrefDisablePrefetch, this, false);
             prefs->AddObserver(kPrefDnsNotifyResolution, this, false);
+            prefs->AddObserver(kPrefDnsMaxAnyPriorityThreads, this, false);
+            prefs->AddObserver(kPrefDnsMaxHighPriorityThreads, this, false);
 
             // Monitor these to see if there is a change in proxy configuration
             // If a manual proxy is in use, disable prefetch implicitly
@@ -609,6 +619,8 @@ nsDNSService::Init()
     nsresult rv = nsHostResolver::Create(maxCacheEntries,
                                          defaultCacheLifetime,
                                          defaultGracePeriod,
+                                         maxAnyPriorityThreads,
+                                         maxHighPriorityThreads,
                                          getter_AddRefs(res));
     if (NS_SUCCEEDED(rv)) {
         // now, set all of our member variables while holding the lock
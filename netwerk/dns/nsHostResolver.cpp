@@ -14,6 +14,7 @@
 
 #include <stdlib.h>
 #include <ctime>
+#include <algorithm>
 #include "nsHostResolver.h"
 #include "nsError.h"
 #include "nsISupportsBase.h"
@@ -49,22 +50,22 @@ static const unsigned int NEGATIVE_RECORD_LIFETIME = 60;
 // In particular, thread creation results in a res_init() call from libc which is 
 // quite expensive.
 //
-// The pool dynamically grows between 0 and MAX_RESOLVER_THREADS in size. New requests
-// go first to an idle thread. If that cannot be found and there are fewer than MAX_RESOLVER_THREADS
+// The pool dynamically grows between 0 and mMaxResolverThreads in size. New requests
+// go first to an idle thread. If that cannot be found and there are fewer than mMaxResolverThreads
 // currently in the pool a new thread is created for high priority requests. If
 // the new request is at a lower priority a new thread will only be created if 
-// there are fewer than HighThreadThreshold currently outstanding. If a thread cannot be
+// there are fewer than mMaxAnyPriorityThreads currently outstanding. If a thread cannot be
 // created or an idle thread located for the request it is queued.
 //
-// When the pool is greater than HighThreadThreshold in size a thread will be destroyed after
+// When the pool is greater than mMaxAnyPriorityThreads in size a thread will be destroyed after
 // ShortIdleTimeoutSeconds of idle time. Smaller pools use LongIdleTimeoutSeconds for a 
 // timeout period.
+//
+// Both limits come from prefs, so that pages referencing many hosts don't
+// have to wait in the queue behind a handful of slow lookups.
 
-#define HighThreadThreshold     MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY
-#define LongIdleTimeoutSeconds  300           // for threads 1 -> HighThreadThreshold
-#define ShortIdleTimeoutSeconds 60            // for threads HighThreadThreshold+1 -> MAX_RESOLVER_THREADS
-
-PR_STATIC_ASSERT (HighThreadThreshold <= MAX_RESOLVER_THREADS);
+#define LongIdleTimeoutSeconds  300           // for threads 1 -> mMaxAnyPriorityThreads
+#define ShortIdleTimeoutSeconds 60            // for threads mMaxAnyPriorityThreads+1 -> mMaxResolverThreads
 
 //----------------------------------------------------------------------------
 
@@ -516,10 +517,14 @@ static void DnsPrefChanged(const char* aPref, void* aClosure)
 
 nsHostResolver::nsHostResolver(uint32_t maxCacheEntries,
                                uint32_t defaultCacheEntryLifetime,
-                               uint32_t defaultGracePeriod)
+                               uint32_t defaultGracePeriod,
+                               uint32_t maxAnyPriorityThreads,
+                               uint32_t maxHighPriorityThreads)
     : mMaxCacheEntries(maxCacheEntries)
     , mDefaultCacheLifetime(defaultCacheEntryLifetime)
     , mDefaultGracePeriod(defaultGracePeriod)
+    , mMaxAnyPriorityThreads(std::max<uint32_t>(maxAnyPriorityThreads, 1))
+    , mMaxResolverThreads(mMaxAnyPriorityThreads + maxHighPriorityThreads)
     , mLock("nsHostResolver.mLock")
     , mIdleThreadCV(mLock, "nsHostResolver.mIdleThreadCV")
     , mNumIdleThreads(0)
@@ -1005,8 +1010,8 @@ nsHostResolver::ConditionallyCreateThread(nsHostRecord *rec)
         // wake up idle thread to process this lookup
         mIdleThreadCV.Notify();
     }
-    else if ((mThreadCount < HighThreadThreshold) ||
-             (IsHighPriority(rec->flags) && mThreadCount < MAX_RESOLVER_THREADS)) {
+    else if ((mThreadCount < mMaxAnyPriorityThreads) ||
+             (IsHighPriority(rec->flags) && mThreadCount < mMaxResolverThreads)) {
         // dispatch new worker thread
         NS_ADDREF_THIS(); // owning reference passed to thread
 
@@ -1112,7 +1117,7 @@ nsHostResolver::GetHostToLookup(nsHostRecord **result)
     
     MutexAutoLock lock(mLock);
 
-    timeout = (mNumIdleThreads >= HighThreadThreshold) ? mShortIdleTimeout : mLongIdleTimeout;
+    timeout = (mNumIdleThreads >= mMaxAnyPriorityThreads) ? mShortIdleTimeout : mLongIdleTimeout;
     epoch = PR_IntervalNow();
 
     while (!mShutdown) {
@@ -1131,7 +1136,7 @@ nsHostResolver::GetHostToLookup(nsHostRecord **result)
             return true;
         }
 
-        if (mActiveAnyThreadCount < HighThreadThreshold) {
+        if (mActiveAnyThreadCount < mMaxAnyPriorityThreads) {
             if (!PR_CLIST_IS_EMPTY(&mMediumQ)) {
                 DeQueue (mMediumQ, result);
                 mActiveAnyThreadCount++;
@@ -1454,13 +1459,16 @@ nsresult
 nsHostResolver::Create(uint32_t maxCacheEntries,
                        uint32_t defaultCacheEntryLifetime,
                        uint32_t defaultGracePeriod,
+                       uint32_t maxAnyPriorityThreads,
+                       uint32_t maxHighPriorityThreads,
                        nsHostResolver **result)
 {
     if (!gHostResolverLog)
         gHostResolverLog = PR_NewLogModule("nsHostResolver");
 
     nsHostResolver *res = new nsHostResolver(maxCacheEntries, defaultCacheEntryLifetime,
-                                             defaultGracePeriod);
+                                             defaultGracePeriod, maxAnyPriorityThreads,
+                                             maxHighPriorityThreads);
     NS_ADDREF(res);
 
     nsresult rv = res->Init();
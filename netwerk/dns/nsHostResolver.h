@@ -25,13 +25,12 @@ class nsHostResolver;
 class nsHostRecord;
 class nsResolveHostCallback;
 
-#define MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY  3
-#define MAX_RESOLVER_THREADS_FOR_HIGH_PRIORITY 5
+// Default thread pool limits, overridable by the network.dns.max_*_threads
+// prefs.
+#define MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY  8
+#define MAX_RESOLVER_THREADS_FOR_HIGH_PRIORITY 8
 #define MAX_NON_PRIORITY_REQUESTS 150
 
-#define MAX_RESOLVER_THREADS (MAX_RESOLVER_THREADS_FOR_ANY_PRIORITY + \
-                              MAX_RESOLVER_THREADS_FOR_HIGH_PRIORITY)
-
 struct nsHostKey
 {
     const char *host;
@@ -224,6 +223,8 @@ public:
     static nsresult Create(uint32_t maxCacheEntries, // zero disables cache
                            uint32_t defaultCacheEntryLifetime, // seconds
                            uint32_t defaultGracePeriod, // seconds
+                           uint32_t maxAnyPriorityThreads,
+                           uint32_t maxHighPriorityThreads,
                            nsHostResolver **resolver);
     
     /**
@@ -298,7 +299,9 @@ public:
 private:
    explicit nsHostResolver(uint32_t maxCacheEntries,
                            uint32_t defaultCacheEntryLifetime,
-                           uint32_t defaultGracePeriod);
+                           uint32_t defaultGracePeriod,
+                           uint32_t maxAnyPriorityThreads,
+                           uint32_t maxHighPriorityThreads);
    ~nsHostResolver();
 
     nsresult Init();
@@ -338,6 +341,8 @@ private:
     uint32_t      mMaxCacheEntries;
     uint32_t      mDefaultCacheLifetime; // granularity seconds
     uint32_t      mDefaultGracePeriod; // granularity seconds
+    uint32_t      mMaxAnyPriorityThreads; // threads usable by any request
+    uint32_t      mMaxResolverThreads;    // including high priority only
     mutable Mutex mLock;    // mutable so SizeOfIncludingThis can be const
     CondVar       mIdleThreadCV;
     uint32_t      mNumIdleThreads;
@@ -16,6 +16,7 @@
 #include "Http2Compression.h"
 #include "Http2HuffmanIncoming.h"
 #include "Http2HuffmanOutgoing.h"
+#include "mozilla/DebugOnly.h"
 #include "mozilla/StaticPtr.h"
 
 extern PRThread *gSocketThread;
@@ -25,6 +26,22 @@ namespace net {
 
 static nsDeque *gStaticHeaders = nullptr;
 
+// lookups into gStaticHeaders by name and value, and by name only. The
+// values are the lowest matching index.
+static nsDataHashtable<nsCStringHashKey, uint32_t> *gStaticHeaderIndex = nullptr;
+static nsDataHashtable<nsCStringHashKey, uint32_t> *gStaticNameIndex = nullptr;
+
+// builds an unambiguous hash key for a name and value pair
+static void
+MakeHeaderKey(const nsACString &name, const nsACString &value, nsACString &key)
+{
+  key.Truncate();
+  key.AppendInt(name.Length());
+  key.Append(':');
+  key.Append(name);
+  key.Append(value);
+}
+
 class HpackStaticTableReporter final : public nsIMemoryReporter
 {
 public:
@@ -87,6 +104,10 @@ Http2CompressionCleanup()
   // this happens after the socket thread has been destroyed
   delete gStaticHeaders;
   gStaticHeaders = nullptr;
+  delete gStaticHeaderIndex;
+  gStaticHeaderIndex = nullptr;
+  delete gStaticNameIndex;
+  gStaticNameIndex = nullptr;
   UnregisterStrongMemoryReporter(gStaticReporter);
   gStaticReporter = nullptr;
 }
@@ -94,8 +115,18 @@ Http2CompressionCleanup()
 static void
 AddStaticElement(const nsCString &name, const nsCString &value)
 {
+  uint32_t index = gStaticHeaders->GetSize();
   nvPair *pair = new nvPair(name, value);
   gStaticHeaders->Push(pair);
+
+  nsAutoCString key;
+  MakeHeaderKey(name, value, key);
+  if (!gStaticHeaderIndex->Contains(key)) {
+    gStaticHeaderIndex->Put(key, index);
+  }
+  if (!gStaticNameIndex->Contains(name)) {
+    gStaticNameIndex->Put(name, index);
+  }
 }
 
 static void
@@ -110,6 +141,8 @@ InitializeStaticHeaders()
   MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
   if (!gStaticHeaders) {
     gStaticHeaders = new nsDeque();
+    gStaticHeaderIndex = new nsDataHashtable<nsCStringHashKey, uint32_t>();
+    gStaticNameIndex = new nsDataHashtable<nsCStringHashKey, uint32_t>();
     gStaticReporter = new HpackStaticTableReporter();
     RegisterStrongMemoryReporter(gStaticReporter);
     AddStaticElement(NS_LITERAL_CSTRING(":authority"));
@@ -1034,10 +1067,19 @@ Http2Compressor::EncodeHeaderBlock(const nsCString &nvInput,
         ProcessHeader(nvPair(name, cookie), false, cookie.Length() < 20);
         nextCookie = semiSpaceIndex + 2;
       }
+    } else if (name.EqualsLiteral("authorization") ||
+               name.EqualsLiteral("proxy-authorization")) {
+      // credentials are never indexed
+      ProcessHeader(nvPair(name, value), false, true);
     } else {
-      // allow indexing of every non-cookie except authorization
-      ProcessHeader(nvPair(name, value), false,
-                    name.EqualsLiteral("authorization"));
+      // values that change with every request would only push reusable
+      // entries out of the dynamic table, so don't index them
+      bool volatileValue = name.EqualsLiteral("content-length") ||
+                           name.EqualsLiteral("if-modified-since") ||
+                           name.EqualsLiteral("if-none-match") ||
+                           name.EqualsLiteral("if-range") ||
+                           name.EqualsLiteral("range");
+      ProcessHeader(nvPair(name, value), volatileValue, false);
     }
   }
 
@@ -1158,73 +1200,60 @@ Http2Compressor::EncodeInteger(uint32_t prefixLen, uint32_t val)
 void
 Http2Compressor::HuffmanAppend(const nsCString &value)
 {
-  nsAutoCString buf;
-  uint8_t bitsLeft = 8;
   uint32_t length = value.Length();
-  uint32_t offset;
-  uint8_t *startByte;
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(value.BeginReading());
 
+  // Sum up the code lengths first, so we know the size of the encoded string
+  // before writing it out.
+  uint32_t totalBits = 0;
   for (uint32_t i = 0; i < length; ++i) {
-    uint8_t idx = static_cast<uint8_t>(value[i]);
-    uint8_t huffLength = HuffmanOutgoing[idx].mLength;
-    uint32_t huffValue = HuffmanOutgoing[idx].mValue;
-
-    if (bitsLeft < 8) {
-      // Fill in the least significant <bitsLeft> bits of the previous byte
-      // first
-      uint32_t val;
-      if (huffLength >= bitsLeft) {
-        val = huffValue & ~((1 << (huffLength - bitsLeft)) - 1);
-        val >>= (huffLength - bitsLeft);
-      } else {
-        val = huffValue << (bitsLeft - huffLength);
-      }
-      val &= ((1 << bitsLeft) - 1);
-      offset = buf.Length() - 1;
-      startByte = reinterpret_cast<unsigned char *>(buf.BeginWriting()) + offset;
-      *startByte = *startByte | static_cast<uint8_t>(val & 0xFF);
-      if (huffLength >= bitsLeft) {
-        huffLength -= bitsLeft;
-        bitsLeft = 8;
-      } else {
-        bitsLeft -= huffLength;
-        huffLength = 0;
-      }
-    }
-
-    while (huffLength >= 8) {
-      uint32_t mask = ~((1 << (huffLength - 8)) - 1);
-      uint8_t val = ((huffValue & mask) >> (huffLength - 8)) & 0xFF;
-      buf.Append(reinterpret_cast<char *>(&val), 1);
-      huffLength -= 8;
-    }
-
-    if (huffLength) {
-      // Fill in the most significant <huffLength> bits of the next byte
-      bitsLeft = 8 - huffLength;
-      uint8_t val = (huffValue & ((1 << huffLength) - 1)) << bitsLeft;
-      buf.Append(reinterpret_cast<char *>(&val), 1);
-    }
+    totalBits += HuffmanOutgoing[data[i]].mLength;
   }
+  uint32_t bufLength = (totalBits + 7) / 8;
+
+  uint32_t offset = mOutput->Length();
+  uint8_t *startByte;
 
-  if (bitsLeft != 8) {
-    // Pad the last <bitsLeft> bits with ones, which corresponds to the EOS
-    // encoding
-    uint8_t val = (1 << bitsLeft) - 1;
-    offset = buf.Length() - 1;
-    startByte = reinterpret_cast<unsigned char *>(buf.BeginWriting()) + offset;
-    *startByte = *startByte | val;
+  if (bufLength >= length) {
+    // Huffman coding doesn't make this one any smaller (e.g. random tokens),
+    // so send the octets as they are with the H bit clear
+    EncodeInteger(7, length);
+    mOutput->Append(value);
+    LOG(("Http2Compressor::HuffmanAppend %p sent %d byte original as is.\n",
+         this, length));
+    return;
   }
 
-  // Now we know how long our encoded string is, we can fill in our length
-  uint32_t bufLength = buf.Length();
-  offset = mOutput->Length();
   EncodeInteger(7, bufLength);
   startByte = reinterpret_cast<unsigned char *>(mOutput->BeginWriting()) + offset;
   *startByte = *startByte | 0x80;
 
-  // Finally, we can add our REAL data!
-  mOutput->Append(buf);
+  offset = mOutput->Length();
+  mOutput->SetLength(offset + bufLength);
+  uint8_t *out = reinterpret_cast<uint8_t *>(mOutput->BeginWriting()) + offset;
+  DebugOnly<uint8_t *> end = out + bufLength;
+
+  // Codes are at most 30 bits long, so the accumulator never holds more than
+  // 37 pending bits. Whole bytes are written out as soon as they are complete.
+  uint64_t accum = 0;
+  uint32_t accumBits = 0;
+  for (uint32_t i = 0; i < length; ++i) {
+    const HuffmanOutgoingEntry &entry = HuffmanOutgoing[data[i]];
+    accum = (accum << entry.mLength) | entry.mValue;
+    accumBits += entry.mLength;
+    while (accumBits >= 8) {
+      accumBits -= 8;
+      *out++ = static_cast<uint8_t>(accum >> accumBits);
+    }
+  }
+
+  if (accumBits) {
+    // Pad the last bits with ones, which corresponds to the EOS encoding
+    uint8_t padBits = 8 - accumBits;
+    *out++ = static_cast<uint8_t>(accum << padBits) | ((1 << padBits) - 1);
+  }
+  MOZ_ASSERT(out == end);
+
   LOG(("Http2Compressor::HuffmanAppend %p encoded %d byte original on %d "
        "bytes.\n", this, length, bufLength));
 }
@@ -1234,24 +1263,26 @@ Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
                                bool neverIndex)
 {
   uint32_t newSize = inputPair.Size();
-  uint32_t headerTableSize = mHeaderTable.Length();
-  uint32_t matchedIndex;
+  uint32_t matchedIndex = 0;
   uint32_t nameReference = 0;
   bool match = false;
 
   LOG(("Http2Compressor::ProcessHeader %s %s", inputPair.mName.get(),
        inputPair.mValue.get()));
 
-  // NWGH - make this index = 1; index <= headerTableSize; ++index
-  for (uint32_t index = 0; index < headerTableSize; ++index) {
-    if (mHeaderTable[index]->mName.Equals(inputPair.mName)) {
-      // NWGH - make this nameReference = index
-      nameReference = index + 1;
-      if (mHeaderTable[index]->mValue.Equals(inputPair.mValue)) {
-        match = true;
-        matchedIndex = index;
-        break;
-      }
+  // static entries have the lower indices, so they are preferred
+  nsAutoCString key;
+  MakeHeaderKey(inputPair.mName, inputPair.mValue, key);
+  if (gStaticHeaderIndex->Get(key, &matchedIndex) ||
+      LookupDynamicEntry(mHeaderIndex, key, matchedIndex)) {
+    match = true;
+    // NWGH - make this nameReference = index
+    nameReference = matchedIndex + 1;
+  } else {
+    uint32_t nameIndex;
+    if (gStaticNameIndex->Get(inputPair.mName, &nameIndex) ||
+        LookupDynamicEntry(mNameIndex, inputPair.mName, nameIndex)) {
+      nameReference = nameIndex + 1;
     }
   }
 
@@ -1277,6 +1308,7 @@ Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
     DoOutput(kIndexedLiteral, &inputPair, nameReference);
 
     mHeaderTable.AddElement(inputPair.mName, inputPair.mValue);
+    IndexNewestEntry();
     LOG(("HTTP compressor %p new literal placed at index 0\n",
          this));
     LOG(("Compressor state after literal with index"));
@@ -1292,6 +1324,78 @@ Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
   return;
 }
 
+void
+Http2Compressor::ClearHeaderTable()
+{
+  Http2BaseCompressor::ClearHeaderTable();
+  mHeaderIndex.Clear();
+  mNameIndex.Clear();
+}
+
+void
+Http2Compressor::MakeRoom(uint32_t amount, const char *direction)
+{
+  // same as the base class, but keeps the dynamic table lookups in sync
+  while (mHeaderTable.VariableLength() && ((mHeaderTable.ByteCount() + amount) > mMaxBuffer)) {
+    uint32_t index = mHeaderTable.Length() - 1;
+    LOG(("HTTP %s header table index %u %s %s removed for size.\n",
+         direction, index, mHeaderTable[index]->mName.get(),
+         mHeaderTable[index]->mValue.get()));
+    RemoveOldestEntry();
+  }
+}
+
+bool
+Http2Compressor::LookupDynamicEntry(const nsDataHashtable<nsCStringHashKey, uint32_t> &table,
+                                    const nsACString &key, uint32_t &index) const
+{
+  uint32_t serial;
+  if (!table.Get(key, &serial)) {
+    return false;
+  }
+
+  // the newest entry is at the front of the dynamic table
+  uint32_t position = mInsertCount - 1 - serial;
+  MOZ_ASSERT(position < mHeaderTable.VariableLength());
+  index = mHeaderTable.StaticLength() + position;
+  return true;
+}
+
+void
+Http2Compressor::IndexNewestEntry()
+{
+  const nvPair *pair = mHeaderTable[mHeaderTable.StaticLength()];
+  uint32_t serial = mInsertCount++;
+
+  nsAutoCString key;
+  MakeHeaderKey(pair->mName, pair->mValue, key);
+  mHeaderIndex.Put(key, serial);
+  mNameIndex.Put(pair->mName, serial);
+}
+
+void
+Http2Compressor::RemoveOldestEntry()
+{
+  MOZ_ASSERT(mHeaderTable.VariableLength());
+
+  const nvPair *pair = mHeaderTable[mHeaderTable.Length() - 1];
+  uint32_t serial = mInsertCount - mHeaderTable.VariableLength();
+
+  // only drop lookups that still point at this entry, a newer duplicate
+  // takes over otherwise
+  nsAutoCString key;
+  MakeHeaderKey(pair->mName, pair->mValue, key);
+  uint32_t stored;
+  if (mHeaderIndex.Get(key, &stored) && stored == serial) {
+    mHeaderIndex.Remove(key);
+  }
+  if (mNameIndex.Get(pair->mName, &stored) && stored == serial) {
+    mNameIndex.Remove(pair->mName);
+  }
+
+  mHeaderTable.RemoveElement();
+}
+
 void
 Http2Compressor::EncodeTableSizeChange(uint32_t newMaxSize)
 {
@@ -1326,7 +1430,7 @@ Http2Compressor::SetMaxBufferSizeInternal(uint32_t maxBufferSize)
   LOG(("Http2Compressor::SetMaxBufferSizeInternal %u called", maxBufferSize));
 
   while (mHeaderTable.VariableLength() && (mHeaderTable.ByteCount() > maxBufferSize)) {
-    mHeaderTable.RemoveElement();
+    RemoveOldestEntry();
     ++removedCount;
   }
 
@@ -10,7 +10,9 @@
 // https://www.rfc-editor.org/rfc/rfc7541.txt
 
 #include "mozilla/Attributes.h"
+#include "nsDataHashtable.h"
 #include "nsDeque.h"
+#include "nsHashKeys.h"
 #include "nsString.h"
 #include "nsIMemoryReporter.h"
 
@@ -145,7 +147,8 @@ public:
   Http2Compressor() : mParsedContentLength(-1),
                       mMaxBufferSetting(kDefaultMaxBuffer),
                       mBufferSizeChangeWaiting(false),
-                      mLowestBufferSizeWaiting(0)
+                      mLowestBufferSizeWaiting(0),
+                      mInsertCount(0)
   { };
   virtual ~Http2Compressor() { }
 
@@ -161,6 +164,10 @@ public:
   void SetMaxBufferSize(uint32_t maxBufferSize);
   nsresult SetMaxBufferSizeInternal(uint32_t maxBufferSize);
 
+protected:
+  void ClearHeaderTable() override;
+  void MakeRoom(uint32_t amount, const char *direction) override;
+
 private:
   enum outputCode {
     kNeverIndexedLiteral,
@@ -177,10 +184,23 @@ private:
   void HuffmanAppend(const nsCString &value);
   void EncodeTableSizeChange(uint32_t newMaxSize);
 
+  bool LookupDynamicEntry(const nsDataHashtable<nsCStringHashKey, uint32_t> &table,
+                          const nsACString &key, uint32_t &index) const;
+  void IndexNewestEntry();
+  void RemoveOldestEntry();
+
   int64_t mParsedContentLength;
   uint32_t mMaxBufferSetting;
   bool mBufferSizeChangeWaiting;
   uint32_t mLowestBufferSizeWaiting;
+
+  // The dynamic table is indexed by the serial number each entry got when it
+  // was inserted, which turns into a table index as newer entries push it
+  // back. mHeaderIndex is keyed by name and value, mNameIndex by name only;
+  // both point at the newest entry with that key.
+  uint32_t mInsertCount;
+  nsDataHashtable<nsCStringHashKey, uint32_t> mHeaderIndex;
+  nsDataHashtable<nsCStringHashKey, uint32_t> mNameIndex;
 };
 
 } // namespace net
@@ -775,18 +775,19 @@ Http2Session::GenerateSettingsAck()
 }
 
 void
-Http2Session::GeneratePriority(uint32_t aID, uint8_t aPriorityWeight)
+Http2Session::GeneratePriority(uint32_t aID, uint32_t aDependsOn,
+                               uint8_t aPriorityWeight)
 {
   MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
-  LOG3(("Http2Session::GeneratePriority %p %X %X\n",
-        this, aID, aPriorityWeight));
+  LOG3(("Http2Session::GeneratePriority %p %X depends on %X weight %X\n",
+        this, aID, aDependsOn, aPriorityWeight));
 
   uint32_t frameSize = kFrameHeaderBytes + 5;
   char *packet = EnsureOutputBuffer(frameSize);
   mOutputQueueUsed += frameSize;
 
   CreateFrameHeader(packet, 5, FRAME_TYPE_PRIORITY, 0, aID);
-  CopyAsNetwork32(packet + kFrameHeaderBytes, 0);
+  CopyAsNetwork32(packet + kFrameHeaderBytes, aDependsOn);
   memcpy(packet + frameSize - 1, &aPriorityWeight, 1);
   LogIO(this, nullptr, "Generate Priority", packet, frameSize);
   FlushOutputQueue();
@@ -1771,7 +1772,7 @@ Http2Session::RecvPushPromise(Http2Session *self)
   uint8_t priorityWeight = (nsISupportsPriority::PRIORITY_LOWEST + 1) -
     (Http2Stream::kWorstPriority - Http2Stream::kNormalPriority);
   pushedStream->SetPriority(Http2Stream::kWorstPriority);
-  self->GeneratePriority(promisedID, priorityWeight);
+  self->GeneratePriority(promisedID, 0, priorityWeight);
   self->ResetDownstreamState();
   return NS_OK;
 }
@@ -3511,6 +3512,34 @@ Http2Session::TransactionHasDataToWrite(nsAHttpTransaction *caller)
 
 }
 
+void
+Http2Session::TransactionPriorityChanged(nsAHttpTransaction *caller)
+{
+  MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+
+  Http2Stream *stream = mStreamTransactionHash.Get(caller);
+  if (!stream || !VerifyStream(stream)) {
+    LOG3(("Http2Session::TransactionPriorityChanged %p caller %p not found",
+          this, caller));
+    return;
+  }
+
+  nsHttpTransaction *trans = caller->QueryHttpTransaction();
+  if (!trans || mClosed) {
+    return;
+  }
+
+  if (!stream->RefreshPriority(trans->Priority())) {
+    return;
+  }
+
+  LOG3(("Http2Session::TransactionPriorityChanged %p stream 0x%X now depends "
+        "on 0x%X weight %u\n", this, stream->StreamID(),
+        stream->PriorityDependency(), stream->PriorityWeight()));
+  GeneratePriority(stream->StreamID(), stream->PriorityDependency(),
+                   stream->PriorityWeight());
+}
+
 void
 Http2Session::TransactionHasDataToWrite(Http2Stream *stream)
 {
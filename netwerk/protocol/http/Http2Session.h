@@ -197,6 +197,9 @@ public:
   // a similar version for Http2Stream
   void TransactionHasDataToWrite(Http2Stream *);
 
+  // an overload of nsAHttpConnection
+  void TransactionPriorityChanged(nsAHttpTransaction *) override;
+
   // an overload of nsAHttpSegementReader
   virtual nsresult CommitToSegmentSize(uint32_t size, bool forceCommitment) override;
   nsresult BufferOutput(const char *, uint32_t, uint32_t *);
@@ -252,7 +255,7 @@ private:
   nsresult    UncompressAndDiscard();
   void        GeneratePing(bool);
   void        GenerateSettingsAck();
-  void        GeneratePriority(uint32_t, uint8_t);
+  void        GeneratePriority(uint32_t, uint32_t, uint8_t);
   void        GenerateRstStream(uint32_t, uint32_t);
   void        GenerateGoAway(uint32_t);
   void        CleanupStream(Http2Stream *, nsresult, errorType);
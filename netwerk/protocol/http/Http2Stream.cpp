@@ -86,9 +86,15 @@ Http2Stream::Http2Stream(nsAHttpTransaction *httpTransaction,
 
   PR_STATIC_ASSERT(nsISupportsPriority::PRIORITY_LOWEST <= kNormalPriority);
 
-  // values of priority closer to 0 are higher priority for the priority
-  // argument. This value is used as a group, which maps to a
-  // weight that is related to the nsISupportsPriority that we are given.
+  SetPriority(HttpPriorityFromTransaction(priority));
+}
+
+// values of priority closer to 0 are higher priority for the priority
+// argument. This value is used as a group, which maps to a
+// weight that is related to the nsISupportsPriority that we are given.
+uint32_t
+Http2Stream::HttpPriorityFromTransaction(int32_t priority)
+{
   int32_t httpPriority;
   if (priority >= nsISupportsPriority::PRIORITY_LOWEST) {
     httpPriority = kWorstPriority;
@@ -98,7 +104,7 @@ Http2Stream::Http2Stream(nsAHttpTransaction *httpTransaction,
     httpPriority = kNormalPriority + priority;
   }
   MOZ_ASSERT(httpPriority >= 0);
-  SetPriority(static_cast<uint32_t>(httpPriority));
+  return static_cast<uint32_t>(httpPriority);
 }
 
 Http2Stream::~Http2Stream()
@@ -1130,6 +1136,29 @@ Http2Stream::UpdatePriorityDependency()
         this, classFlags, mPriorityDependency));
 }
 
+bool
+Http2Stream::RefreshPriority(int32_t aTransactionPriority)
+{
+  uint32_t oldDependency = mPriorityDependency;
+  uint8_t oldWeight = mPriorityWeight;
+
+  SetPriority(HttpPriorityFromTransaction(aTransactionPriority));
+  if (!mRequestHeadersDone) {
+    // the HEADERS frame will pick up the new values when it is generated
+    return false;
+  }
+  UpdatePriorityDependency();
+
+  // a PRIORITY frame must not be interleaved with a header block that is
+  // still waiting to be written
+  if (!mStreamID || mTxInlineFrameUsed) {
+    return false;
+  }
+
+  return (oldDependency != mPriorityDependency) ||
+    (oldWeight != mPriorityWeight);
+}
+
 void
 Http2Stream::SetRecvdFin(bool aStatus)
 {
@@ -134,6 +134,13 @@ public:
   void SetPriority(uint32_t);
   void SetPriorityDependency(uint32_t, uint8_t, bool);
   void UpdatePriorityDependency();
+  uint32_t PriorityDependency() { return mPriorityDependency; }
+  uint8_t PriorityWeight() { return mPriorityWeight; }
+
+  // Re-derives the weight and the dependency from the transaction after its
+  // priority or class of service changed. Returns true if the stream is
+  // already open on the wire and a PRIORITY frame needs to be sent.
+  bool RefreshPriority(int32_t);
 
   // A pull stream has an implicit sink, a pushed stream has a sink
   // once it is matched to a pull stream.
@@ -207,6 +214,7 @@ private:
   nsresult GenerateOpen();
 
   void     AdjustPushedPriority();
+  static uint32_t HttpPriorityFromTransaction(int32_t);
   void     AdjustInitialWindow();
   nsresult TransmitFrame(const char *, uint32_t *, bool forceCommitment);
   void     GenerateDataFrameHeader(uint32_t, bool);
@@ -30,6 +30,7 @@
 #include "mozilla/net/DNS.h"
 #include "SerializedLoadContext.h"
 #include "nsInputStreamPump.h"
+#include "nsIThreadRetargetableStreamListener.h"
 #include "InterceptedChannel.h"
 #include "nsPerformance.h"
 #include "mozIThirdPartyUtil.h"
@@ -183,6 +184,10 @@ HttpChannelChild::HttpChannelChild()
   , mSuspendSent(false)
   , mSynthesizedResponse(false)
   , mShouldParentIntercept(false)
+  , mODALock("HttpChannelChild.mODALock")
+  , mODAScheduled(false)
+  , mODAStopPending(false)
+  , mODAFailed(false)
 {
   LOG(("Creating HttpChannelChild @%x\n", this));
 
@@ -249,6 +254,7 @@ NS_INTERFACE_MAP_BEGIN(HttpChannelChild)
   NS_INTERFACE_MAP_ENTRY(nsIHttpChannelChild)
   NS_INTERFACE_MAP_ENTRY_CONDITIONAL(nsIAssociatedContentSecurity, GetAssociatedContentSecurity())
   NS_INTERFACE_MAP_ENTRY(nsIDivertableChannel)
+  NS_INTERFACE_MAP_ENTRY(nsIThreadRetargetableRequest)
 NS_INTERFACE_MAP_END_INHERITING(HttpBaseChannel)
 
 //-----------------------------------------------------------------------------
@@ -582,12 +588,51 @@ HttpChannelChild::RecvOnTransportAndData(const nsresult& channelStatus,
   return true;
 }
 
+bool
+HttpChannelChild::RecvOnTransportAndDataShmem(const nsresult& channelStatus,
+                                              const nsresult& transportStatus,
+                                              const uint64_t& progress,
+                                              const uint64_t& progressMax,
+                                              Shmem&& data,
+                                              const uint64_t& offset,
+                                              const uint32_t& count)
+{
+  LOG(("HttpChannelChild::RecvOnTransportAndDataShmem [this=%p]\n", this));
+  MOZ_RELEASE_ASSERT(!mFlushedForDiversion,
+                     "Should not be receiving any more callbacks from parent!");
+
+  if (!data.IsReadable() || data.Size<char>() < count) {
+    return false;
+  }
+
+  if (mEventQ->ShouldEnqueue()) {
+    // Queued events may outlive the shared memory, so copy the data in this
+    // (rare) case.
+    nsCString copy(data.get<char>(), count);
+    DeallocShmem(data);
+    mEventQ->Enqueue(new TransportAndDataEvent(this, channelStatus,
+                                               transportStatus, progress,
+                                               progressMax, copy, offset,
+                                               count));
+  } else {
+    MOZ_RELEASE_ASSERT(!mDivertingToParent,
+                       "ShouldEnqueue when diverting to parent!");
+
+    OnTransportAndData(channelStatus, transportStatus, progress, progressMax,
+                       Substring(data.get<char>(), count), offset, count);
+    if (mIPCOpen) {
+      DeallocShmem(data);
+    }
+  }
+  return true;
+}
+
 void
 HttpChannelChild::OnTransportAndData(const nsresult& channelStatus,
                                      const nsresult& transportStatus,
                                      const uint64_t progress,
                                      const uint64_t& progressMax,
-                                     const nsCString& data,
+                                     const nsCSubstring& data,
                                      const uint64_t& offset,
                                      const uint32_t& count)
 {
@@ -602,7 +647,7 @@ HttpChannelChild::OnTransportAndData(const nsresult& channelStatus,
     MOZ_RELEASE_ASSERT(!mFlushedForDiversion,
       "Should not be processing any more callbacks from parent!");
 
-    SendDivertOnDataAvailable(data, offset, count);
+    SendDivertOnDataAvailable(PromiseFlatCString(data), offset, count);
     return;
   }
 
@@ -616,6 +661,11 @@ HttpChannelChild::OnTransportAndData(const nsresult& channelStatus,
   DoOnStatus(this, transportStatus);
   DoOnProgress(this, progress, progressMax);
 
+  if (mODATarget) {
+    RetargetDataAvailable(data, offset, count);
+    return;
+  }
+
   // OnDataAvailable
   //
   // NOTE: the OnDataAvailable contract requires the client to read all the data
@@ -624,8 +674,9 @@ HttpChannelChild::OnTransportAndData(const nsresult& channelStatus,
   // support only reading part of the data, allowing later calls to read the
   // rest.
   nsCOMPtr<nsIInputStream> stringStream;
-  nsresult rv = NS_NewByteInputStream(getter_AddRefs(stringStream), data.get(),
-                                      count, NS_ASSIGNMENT_DEPEND);
+  nsresult rv = NS_NewByteInputStream(getter_AddRefs(stringStream),
+                                      data.BeginReading(), count,
+                                      NS_ASSIGNMENT_DEPEND);
   if (NS_FAILED(rv)) {
     Cancel(rv);
     return;
@@ -635,6 +686,173 @@ HttpChannelChild::OnTransportAndData(const nsresult& channelStatus,
   stringStream->Close();
 }
 
+// Runnables used for retargeted OnDataAvailable delivery. HttpChannelChild
+// may only be AddRef'd and Released on the main thread (and its last Release
+// may Send__delete__), so the runnables that travel to and from the target
+// thread hold it through nsMainThreadPtrHandle, which always releases on the
+// main thread. The handle is non-strict because DeliverRetargetedData runs on
+// the target thread.
+class DeliverRetargetedDataEvent final : public nsRunnable
+{
+public:
+  explicit DeliverRetargetedDataEvent(
+    const nsMainThreadPtrHandle<HttpChannelChild>& aChannel)
+    : mChannel(aChannel) {}
+
+  NS_IMETHOD Run() override
+  {
+    mChannel->DeliverRetargetedData(mChannel);
+    return NS_OK;
+  }
+
+private:
+  nsMainThreadPtrHandle<HttpChannelChild> mChannel;
+};
+
+class CancelRetargetedDataEvent final : public nsRunnable
+{
+public:
+  CancelRetargetedDataEvent(
+    const nsMainThreadPtrHandle<HttpChannelChild>& aChannel, nsresult aStatus)
+    : mChannel(aChannel), mStatus(aStatus) {}
+
+  NS_IMETHOD Run() override
+  {
+    MOZ_ASSERT(NS_IsMainThread());
+    mChannel->Cancel(mStatus);
+    return NS_OK;
+  }
+
+private:
+  nsMainThreadPtrHandle<HttpChannelChild> mChannel;
+  nsresult mStatus;
+};
+
+class ResumeAfterRetargetedDataEvent final : public nsRunnable
+{
+public:
+  explicit ResumeAfterRetargetedDataEvent(
+    const nsMainThreadPtrHandle<HttpChannelChild>& aChannel)
+    : mChannel(aChannel) {}
+
+  NS_IMETHOD Run() override
+  {
+    MOZ_ASSERT(NS_IsMainThread());
+    mChannel->ResumeAfterRetargetedData();
+    return NS_OK;
+  }
+
+private:
+  nsMainThreadPtrHandle<HttpChannelChild> mChannel;
+};
+
+void
+HttpChannelChild::RetargetDataAvailable(const nsCSubstring& data,
+                                        const uint64_t& offset,
+                                        const uint32_t& count)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  {
+    MutexAutoLock lock(mODALock);
+    if (mODAFailed) {
+      return;
+    }
+
+    // 'data' goes away after this call, so the chunk keeps its own copy.
+    RetargetedData* chunk = mRetargetedData.AppendElement();
+    chunk->mData.Assign(data.BeginReading(), count);
+    chunk->mOffset = offset;
+    chunk->mCount = count;
+
+    if (mODAScheduled) {
+      return;
+    }
+    mODAScheduled = true;
+  }
+
+  nsMainThreadPtrHandle<HttpChannelChild> self(
+    new nsMainThreadPtrHolder<HttpChannelChild>(this, false));
+  nsresult rv = mODATarget->Dispatch(new DeliverRetargetedDataEvent(self),
+                                     NS_DISPATCH_NORMAL);
+  if (NS_FAILED(rv)) {
+    {
+      MutexAutoLock lock(mODALock);
+      mODAScheduled = false;
+      mODAFailed = true;
+      mRetargetedData.Clear();
+    }
+    Cancel(rv);
+  }
+}
+
+void
+HttpChannelChild::DeliverRetargetedData(
+  const nsMainThreadPtrHandle<HttpChannelChild>& aSelf)
+{
+  MOZ_ASSERT(!NS_IsMainThread());
+
+  // The main thread doesn't touch mListener and mListenerContext while
+  // chunks are outstanding: OnStopRequest waits for us.
+  bool stopPending;
+  while (true) {
+    nsTArray<RetargetedData> chunks;
+    {
+      MutexAutoLock lock(mODALock);
+      if (mODAFailed || mRetargetedData.IsEmpty()) {
+        mRetargetedData.Clear();
+        mODAScheduled = false;
+        stopPending = mODAStopPending;
+        break;
+      }
+      chunks.SwapElements(mRetargetedData);
+    }
+
+    for (uint32_t i = 0; i < chunks.Length(); ++i) {
+      LOG(("HttpChannelChild::DeliverRetargetedData [this=%p count=%u]\n",
+           this, chunks[i].mCount));
+
+      nsCOMPtr<nsIInputStream> stringStream;
+      nsresult rv = NS_NewByteInputStream(getter_AddRefs(stringStream),
+                                          chunks[i].mData.BeginReading(),
+                                          chunks[i].mCount,
+                                          NS_ASSIGNMENT_DEPEND);
+      if (NS_SUCCEEDED(rv)) {
+        rv = mListener->OnDataAvailable(this, mListenerContext, stringStream,
+                                        chunks[i].mOffset, chunks[i].mCount);
+        stringStream->Close();
+      }
+
+      if (NS_FAILED(rv)) {
+        {
+          MutexAutoLock lock(mODALock);
+          mODAFailed = true;
+        }
+        NS_DispatchToMainThread(new CancelRetargetedDataEvent(aSelf, rv));
+        break;
+      }
+    }
+  }
+
+  if (stopPending) {
+    NS_DispatchToMainThread(new ResumeAfterRetargetedDataEvent(aSelf));
+  }
+}
+
+void
+HttpChannelChild::ResumeAfterRetargetedData()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  LOG(("HttpChannelChild::ResumeAfterRetargetedData [this=%p]\n", this));
+
+  {
+    MutexAutoLock lock(mODALock);
+    mODAStopPending = false;
+  }
+  // Runs the OnStopRequest event that was held back.
+  mEventQ->Resume();
+}
+
 void
 HttpChannelChild::DoOnStatus(nsIRequest* aRequest, nsresult status)
 {
@@ -759,6 +977,19 @@ HttpChannelChild::OnStopRequest(const nsresult& channelStatus,
     return;
   }
 
+  if (mODATarget) {
+    MutexAutoLock lock(mODALock);
+    if (mODAScheduled) {
+      // Data is still being delivered on the retargeted thread.  Hold this
+      // and any later events back until it has all been consumed.
+      LOG(("  waiting for retargeted OnDataAvailable [this=%p]\n", this));
+      mODAStopPending = true;
+      mEventQ->Enqueue(new StopRequestEvent(this, channelStatus, timing));
+      mEventQ->Suspend();
+      return;
+    }
+  }
+
   mTransactionTimings.domainLookupStart = timing.domainLookupStart;
   mTransactionTimings.domainLookupEnd = timing.domainLookupEnd;
   mTransactionTimings.connectStart = timing.connectStart;
@@ -1413,6 +1644,11 @@ HttpChannelChild::Cancel(nsresult status)
       mSynthesizedResponsePump->Cancel(status);
     }
     mInterceptListener = nullptr;
+    if (mODATarget) {
+      // Drop data not yet handed to the retargeted listener.
+      MutexAutoLock lock(mODALock);
+      mODAFailed = true;
+    }
   }
   return NS_OK;
 }
@@ -2138,6 +2374,44 @@ NS_IMETHODIMP HttpChannelChild::GetClientSetRequestHeaders(RequestHeaderTuples *
   return NS_OK;
 }
 
+//-----------------------------------------------------------------------------
+// HttpChannelChild::nsIThreadRetargetableRequest
+//-----------------------------------------------------------------------------
+
+NS_IMETHODIMP
+HttpChannelChild::RetargetDeliveryTo(nsIEventTarget* aNewTarget)
+{
+  LOG(("HttpChannelChild::RetargetDeliveryTo [this=%p target=%p]\n",
+       this, aNewTarget));
+  MOZ_ASSERT(NS_IsMainThread(), "Should be called on main thread only");
+
+  NS_ENSURE_ARG(aNewTarget);
+  if (aNewTarget == NS_GetCurrentThread()) {
+    NS_WARNING("Retargeting delivery to same thread");
+    return NS_OK;
+  }
+
+  // Only data coming from the parent can be retargeted, and only once.
+  NS_ENSURE_TRUE(mIsPending && !mODATarget, NS_ERROR_NOT_AVAILABLE);
+  NS_ENSURE_TRUE(!mDivertingToParent && !mSynthesizedResponse,
+                 NS_ERROR_NOT_AVAILABLE);
+
+  // Every listener in the chain must be able to take the data off the
+  // main thread.
+  nsCOMPtr<nsIThreadRetargetableStreamListener> retargetableListener =
+    do_QueryInterface(mListener);
+  if (!retargetableListener) {
+    return NS_ERROR_NO_INTERFACE;
+  }
+  nsresult rv = retargetableListener->CheckListenerChain();
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  mODATarget = aNewTarget;
+  return NS_OK;
+}
+
 //-----------------------------------------------------------------------------
 // HttpChannelChild::nsIDivertableChannel
 //-----------------------------------------------------------------------------
@@ -2149,6 +2423,11 @@ HttpChannelChild::DivertToParent(ChannelDiverterChild **aChild)
   MOZ_RELEASE_ASSERT(gNeckoChild);
   MOZ_RELEASE_ASSERT(!mDivertingToParent);
 
+  // Data already goes to another thread of this process.
+  if (mODATarget) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
   // We must fail DivertToParent() if there's no parent end of the channel (and
   // won't be!) due to early failure.
   if (NS_FAILED(mStatus) && !RemoteChannelExists()) {
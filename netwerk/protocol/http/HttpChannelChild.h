@@ -28,6 +28,9 @@
 #include "nsIChildChannel.h"
 #include "nsIHttpChannelChild.h"
 #include "nsIDivertableChannel.h"
+#include "nsIThreadRetargetableRequest.h"
+#include "nsProxyRelease.h"
+#include "mozilla/Mutex.h"
 #include "mozilla/net/DNS.h"
 
 class nsInputStreamPump;
@@ -49,6 +52,7 @@ class HttpChannelChild final : public PHttpChannelChild
                              , public nsIChildChannel
                              , public nsIHttpChannelChild
                              , public nsIDivertableChannel
+                             , public nsIThreadRetargetableRequest
 {
   virtual ~HttpChannelChild();
 public:
@@ -62,6 +66,7 @@ public:
   NS_DECL_NSICHILDCHANNEL
   NS_DECL_NSIHTTPCHANNELCHILD
   NS_DECL_NSIDIVERTABLECHANNEL
+  NS_DECL_NSITHREADRETARGETABLEREQUEST
 
   HttpChannelChild();
 
@@ -128,6 +133,13 @@ protected:
                               const nsCString& data,
                               const uint64_t& offset,
                               const uint32_t& count) override;
+  bool RecvOnTransportAndDataShmem(const nsresult& channelStatus,
+                                   const nsresult& status,
+                                   const uint64_t& progress,
+                                   const uint64_t& progressMax,
+                                   mozilla::ipc::Shmem&& data,
+                                   const uint64_t& offset,
+                                   const uint32_t& count) override;
   bool RecvOnStopRequest(const nsresult& statusCode, const ResourceTimingStruct& timing) override;
   bool RecvOnProgress(const int64_t& progress, const int64_t& progressMax) override;
   bool RecvOnStatus(const nsresult& status) override;
@@ -162,6 +174,15 @@ private:
   void DoPreOnStopRequest(nsresult aStatus);
   void DoOnStopRequest(nsIRequest* aRequest, nsISupports* aContext);
 
+  // Retargeted OnDataAvailable delivery, see RetargetDeliveryTo().
+  void RetargetDataAvailable(const nsCSubstring& data,
+                             const uint64_t& offset,
+                             const uint32_t& count);
+  // Runs on the retarget thread; aSelf keeps the channel alive and is what
+  // the runnables it sends back to the main thread hold on to.
+  void DeliverRetargetedData(const nsMainThreadPtrHandle<HttpChannelChild>& aSelf);
+  void ResumeAfterRetargetedData();
+
   // Discard the prior interception and continue with the original network request.
   void ResetInterception();
 
@@ -207,6 +228,24 @@ private:
   // before the network transaction is initiated.
   bool mShouldParentIntercept;
 
+  // Set by RetargetDeliveryTo(): OnDataAvailable is called on this target
+  // instead of the main thread.  Chunks are queued in mRetargetedData and
+  // delivered in order by a single runnable at a time, while OnStopRequest
+  // waits on the main thread until all of them have been consumed.
+  struct RetargetedData
+  {
+    nsCString mData;
+    uint64_t mOffset;
+    uint32_t mCount;
+  };
+  nsCOMPtr<nsIEventTarget> mODATarget;
+  Mutex mODALock;
+  // Everything below is protected by mODALock.
+  nsTArray<RetargetedData> mRetargetedData;
+  bool mODAScheduled;
+  bool mODAStopPending;
+  bool mODAFailed;
+
   // true after successful AsyncOpen until OnStopRequest completes.
   bool RemoteChannelExists() { return mIPCOpen && !mKeptAlive; }
 
@@ -228,7 +267,7 @@ private:
                           const nsresult& status,
                           const uint64_t progress,
                           const uint64_t& progressMax,
-                          const nsCString& data,
+                          const nsCSubstring& data,
                           const uint64_t& offset,
                           const uint32_t& count);
   void OnStopRequest(const nsresult& channelStatus, const ResourceTimingStruct& timing);
@@ -256,6 +295,9 @@ private:
   friend class HttpAsyncAborter<HttpChannelChild>;
   friend class InterceptStreamListener;
   friend class InterceptedChannelContent;
+  friend class DeliverRetargetedDataEvent;
+  friend class CancelRetargetedDataEvent;
+  friend class ResumeAfterRetargetedDataEvent;
 };
 
 //-----------------------------------------------------------------------------
@@ -41,6 +41,10 @@ using namespace mozilla::ipc;
 namespace mozilla {
 namespace net {
 
+// OnDataAvailable payloads of at least this size are sent to the child in
+// shared memory.  Smaller ones are cheaper to copy than to map.
+static const uint32_t kMinShmemDataSize = 64 * 1024;
+
 HttpChannelParent::HttpChannelParent(const PBrowserOrId& iframeEmbedding,
                                      nsILoadContext* aLoadContext,
                                      PBOverrideStatus aOverrideStatus)
@@ -927,21 +931,46 @@ HttpChannelParent::OnDataAvailable(nsIRequest *aRequest,
   MOZ_RELEASE_ASSERT(!mDivertingFromChild,
     "Cannot call OnDataAvailable if diverting is set!");
 
+  if (mIPCClosed) {
+    return NS_ERROR_UNEXPECTED;
+  }
+
+  nsresult channelStatus = NS_OK;
+  mChannel->GetStatus(&channelStatus);
+
+  // Big payloads (typically coming from the cache in whole chunks) are read
+  // straight into shared memory.  This saves copying the data into the IPC
+  // message and out of it again in the child.
+  Shmem shmem;
+  if (aCount >= kMinShmemDataSize &&
+      AllocShmem(aCount, SharedMemory::TYPE_BASIC, &shmem)) {
+    void* dest = shmem.get<char>();
+    nsresult rv = NS_ReadInputStreamToBuffer(aInputStream, &dest, aCount);
+    if (NS_FAILED(rv)) {
+      DeallocShmem(shmem);
+      return rv;
+    }
+
+    if (!SendOnTransportAndDataShmem(channelStatus, mStoredStatus,
+                                     mStoredProgress, mStoredProgressMax,
+                                     shmem, aOffset, aCount)) {
+      return NS_ERROR_UNEXPECTED;
+    }
+    return NS_OK;
+  }
+
   nsCString data;
   nsresult rv = NS_ReadInputStreamToString(aInputStream, data, aCount);
   if (NS_FAILED(rv))
     return rv;
 
-  nsresult channelStatus = NS_OK;
-  mChannel->GetStatus(&channelStatus);
-
   // OnDataAvailable is always preceded by OnStatus/OnProgress calls that set
   // mStoredStatus/mStoredProgress(Max) to appropriate values, unless
   // LOAD_BACKGROUND set.  In that case, they'll have garbage values, but
   // child doesn't use them.
-  if (mIPCClosed || !SendOnTransportAndData(channelStatus, mStoredStatus,
-                                            mStoredProgress, mStoredProgressMax,
-                                            data, aOffset, aCount)) {
+  if (!SendOnTransportAndData(channelStatus, mStoredStatus,
+                              mStoredProgress, mStoredProgressMax,
+                              data, aOffset, aCount)) {
     return NS_ERROR_UNEXPECTED;
   }
   return NS_OK;
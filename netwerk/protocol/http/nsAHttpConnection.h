@@ -70,6 +70,16 @@ public:
         // by default do nothing - only multiplexed protocols need to overload
         return;
     }
+
+    // Called by the connection manager after the priority or the class of
+    // service of a transaction being processed by this connection changed.
+    // Multiplexed protocols can use it to reprioritize the transaction's
+    // stream on the wire.
+    virtual void TransactionPriorityChanged(nsAHttpTransaction *)
+    {
+        // by default do nothing - only multiplexed protocols need to overload
+        return;
+    }
     //
     // called by the connection manager to close a transaction being processed
     // by this connection.
@@ -5424,24 +5424,44 @@ nsHttpChannel::ContinueBeginConnect()
 NS_IMETHODIMP
 nsHttpChannel::SetClassFlags(uint32_t inFlags)
 {
+    uint32_t previous = mClassOfService;
     mClassOfService = inFlags;
+    if (previous != mClassOfService)
+        OnClassOfServiceUpdated();
     return NS_OK;
 }
 
 NS_IMETHODIMP
 nsHttpChannel::AddClassFlags(uint32_t inFlags)
 {
+    uint32_t previous = mClassOfService;
     mClassOfService |= inFlags;
+    if (previous != mClassOfService)
+        OnClassOfServiceUpdated();
     return NS_OK;
 }
 
 NS_IMETHODIMP
 nsHttpChannel::ClearClassFlags(uint32_t inFlags)
 {
+    uint32_t previous = mClassOfService;
     mClassOfService &= ~inFlags;
+    if (previous != mClassOfService)
+        OnClassOfServiceUpdated();
     return NS_OK;
 }
 
+void
+nsHttpChannel::OnClassOfServiceUpdated()
+{
+    LOG(("nsHttpChannel::OnClassOfServiceUpdated this=%p, cos=%u",
+         this, mClassOfService));
+
+    if (mTransaction)
+        gHttpHandler->UpdateClassOfServiceOnTransaction(mTransaction,
+                                                        mClassOfService);
+}
+
 //-----------------------------------------------------------------------------
 // nsHttpChannel::nsIProtocolProxyCallback
 //-----------------------------------------------------------------------------
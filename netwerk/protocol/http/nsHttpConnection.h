@@ -195,6 +195,11 @@ public:
     // non null HTTP transaction of any version.
     bool    IsExperienced() { return mExperienced; }
 
+    // IsSpeculative() returns true while a connection that was opened by
+    // SpeculativeConnect() hasn't been handed a real transaction yet.
+    bool    IsSpeculative() { return mSpeculative; }
+    void    SetSpeculative(bool val) { mSpeculative = val; }
+
     static nsresult MakeConnectString(nsAHttpTransaction *trans,
                                       nsHttpRequestHead *request,
                                       nsACString &result);
@@ -305,6 +310,7 @@ private:
     bool                            mIdleMonitoring;
     bool                            mProxyConnectInProgress;
     bool                            mExperienced;
+    bool                            mSpeculative;
     bool                            mInSpdyTunnel;
     bool                            mForcePlainText;
 
@@ -313,6 +313,21 @@ nsHttpConnectionMgr::RescheduleTransaction(nsHttpTransaction *trans, int32_t pri
     return rv;
 }
 
+nsresult
+nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction(nsHttpTransaction *trans,
+                                                       uint32_t classOfService)
+{
+    LOG(("nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction [trans=%p %x]\n",
+         trans, classOfService));
+
+    NS_ADDREF(trans);
+    nsresult rv = PostEvent(&nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction,
+                            static_cast<int32_t>(classOfService), trans);
+    if (NS_FAILED(rv))
+        NS_RELEASE(trans);
+    return rv;
+}
+
 nsresult
 nsHttpConnectionMgr::CancelTransaction(nsHttpTransaction *trans, nsresult reason)
 {
@@ -1516,6 +1531,7 @@ nsHttpConnectionMgr::MakeNewConnection(nsConnectionEntry *ent,
 
             Telemetry::AutoCounter<Telemetry::HTTPCONNMGR_USED_SPECULATIVE_CONN> usedSpeculativeConn;
             ++usedSpeculativeConn;
+            ++ent->mSpeculativeConnUsed;
 
             if (ent->mHalfOpens[i]->IsFromPredictor()) {
               Telemetry::AutoCounter<Telemetry::PREDICTOR_TOTAL_PRECONNECTS_USED> totalPreconnectsUsed;
@@ -1947,6 +1963,12 @@ nsHttpConnectionMgr::DispatchTransaction(nsConnectionEntry *ent,
     // when a muxed connection (e.g. spdy or pipelines) becomes available.
     trans->CancelPacing(NS_OK);
 
+    // a connection that was warmed up speculatively paid off
+    if (conn->IsSpeculative()) {
+        conn->SetSpeculative(false);
+        ++ent->mSpeculativeConnUsed;
+    }
+
     if (conn->UsingSpdy()) {
         LOG(("Spdy Dispatch Transaction via Activate(). Transaction host = %s, "
              "Connection host = %s\n",
@@ -2230,6 +2252,7 @@ nsHttpConnectionMgr::CreateTransport(nsConnectionEntry *ent,
         sock->SetAllow1918(allow1918);
         Telemetry::AutoCounter<Telemetry::HTTPCONNMGR_TOTAL_SPECULATIVE_CONN> totalSpeculativeConn;
         ++totalSpeculativeConn;
+        ++ent->mSpeculativeConnCreated;
 
         if (isFromPredictor) {
           sock->SetIsFromPredictor(true);
@@ -2425,6 +2448,32 @@ nsHttpConnectionMgr::OnMsgReschedTransaction(int32_t priority, void *param)
         }
     }
 
+    // let a multiplexed connection reprioritize the stream carrying it
+    nsAHttpConnection *conn = trans->Connection();
+    if (conn) {
+        conn->TransactionPriorityChanged(trans);
+    }
+
+    NS_RELEASE(trans);
+}
+
+void
+nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction(int32_t arg, void *param)
+{
+    MOZ_ASSERT(PR_GetCurrentThread() == gSocketThread);
+    LOG(("nsHttpConnectionMgr::OnMsgUpdateClassOfServiceOnTransaction [trans=%p]\n", param));
+
+    nsHttpTransaction *trans = (nsHttpTransaction *) param;
+    uint32_t cos = static_cast<uint32_t>(arg);
+    if (trans->ClassOfService() != cos) {
+        trans->SetClassOfService(cos);
+
+        nsAHttpConnection *conn = trans->Connection();
+        if (conn) {
+            conn->TransactionPriorityChanged(trans);
+        }
+    }
+
     NS_RELEASE(trans);
 }
 
@@ -3487,6 +3536,10 @@ nsHalfOpenSocket::OnOutputStreamReady(nsIAsyncOutputStream *out)
         // completion. Afterwards the connection will be 100% ready for the next
         // transaction to use it. Make an exception for SSL tunneled HTTP proxy as the
         // NullHttpTransaction does not know how to drive Connect
+        //
+        // Either way the connection wasn't claimed yet, so it stays
+        // speculative until a real transaction is dispatched on it.
+        conn->SetSpeculative(mSpeculative);
         if (mEnt->mConnInfo->FirstHopSSL() && !mEnt->mPendingQ.Length() &&
             !mEnt->mConnInfo->UsingConnect()) {
             LOG(("nsHalfOpenSocket::OnOutputStreamReady null transaction will "
@@ -3673,6 +3726,8 @@ nsConnectionEntry::nsConnectionEntry(nsHttpConnectionInfo *ci)
     , mUsingSpdy(false)
     , mTestedSpdy(false)
     , mInPreferredHash(false)
+    , mSpeculativeConnCreated(0)
+    , mSpeculativeConnUsed(0)
     , mPreferIPv4(false)
     , mPreferIPv6(false)
 {
@@ -3965,6 +4020,8 @@ nsHttpConnectionMgr::ReadConnectionEntry(const nsACString &key,
     }
     data.spdy = ent->mUsingSpdy;
     data.ssl = ent->mConnInfo->EndToEndSSL();
+    data.speculativeCreated = ent->mSpeculativeConnCreated;
+    data.speculativeUsed = ent->mSpeculativeConnUsed;
     args->AppendElement(data);
     return PL_DHASH_NEXT;
 }
@@ -85,6 +85,11 @@ public:
     // added to the connection manager via AddTransaction.
     nsresult RescheduleTransaction(nsHttpTransaction *, int32_t priority);
 
+    // called to update the class of service of the given transaction, which
+    // must already have been added via AddTransaction.
+    nsresult UpdateClassOfServiceOnTransaction(nsHttpTransaction *,
+                                               uint32_t classOfService);
+
     // cancels a transaction w/ the given reason.
     nsresult CancelTransaction(nsHttpTransaction *, nsresult reason);
     nsresult CancelTransactions(nsHttpConnectionInfo *, nsresult reason);
@@ -384,6 +389,12 @@ private:
 
         bool mInPreferredHash;
 
+        // Speculative connections opened for this entry, and how many of
+        // them were later claimed by a real transaction. Reported through
+        // the networking dashboard.
+        uint32_t mSpeculativeConnCreated;
+        uint32_t mSpeculativeConnUsed;
+
         // Flags to remember our happy-eyeballs decision.
         // Reset only by Ctrl-F5 reload.
         // True when we've first connected an IPv4 server for this host,
@@ -656,6 +667,7 @@ private:
     void OnMsgShutdownConfirm      (int32_t, void *);
     void OnMsgNewTransaction       (int32_t, void *);
     void OnMsgReschedTransaction   (int32_t, void *);
+    void OnMsgUpdateClassOfServiceOnTransaction (int32_t, void *);
     void OnMsgCancelTransaction    (int32_t, void *);
     void OnMsgCancelTransactions   (int32_t, void *);
     void OnMsgProcessPendingQ      (int32_t, void *);
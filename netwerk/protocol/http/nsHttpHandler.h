@@ -195,6 +195,14 @@ public:
         return mConnMgr->RescheduleTransaction(trans, priority);
     }
 
+    // Called to change the class of service of an existing transaction that
+    // has already been initiated, e.g. when it turns out to be page blocking.
+    nsresult UpdateClassOfServiceOnTransaction(nsHttpTransaction *trans,
+                                               uint32_t classOfService)
+    {
+        return mConnMgr->UpdateClassOfServiceOnTransaction(trans, classOfService);
+    }
+
     // Called to cancel a transaction, which may or may not be assigned to
     // a connection.  Callable from any thread.
     nsresult CancelTransaction(nsHttpTransaction *trans, nsresult reason)
@@ -1140,6 +1140,9 @@ WebSocketChannel::WebSocketChannel() :
   mCurrentOutSent(0),
   mDynamicOutputSize(0),
   mDynamicOutput(nullptr),
+  mCoalescedCount(0),
+  mCoalescedAckSize(0),
+  mMaskCacheOffset(kMaskCacheSize),
   mPrivateBrowsing(false),
   mConnectionLogService(nullptr),
   mCountRecv(0),
@@ -2030,19 +2033,26 @@ WebSocketChannel::PrimeNewOutgoingMessage()
 
   MOZ_ASSERT(payload, "payload offset not found");
 
-  // Perform the sending mask. Never use a zero mask
+  // Perform the sending mask. Never use a zero mask. Random bytes are fetched
+  // a block at a time rather than once per frame.
   uint32_t mask;
   do {
-    uint8_t *buffer;
-    nsresult rv = mRandomGenerator->GenerateRandomBytes(4, &buffer);
-    if (NS_FAILED(rv)) {
-      LOG(("WebSocketChannel::PrimeNewOutgoingMessage(): "
-           "GenerateRandomBytes failure %x\n", rv));
-      StopSession(rv);
-      return;
+    if (mMaskCacheOffset + sizeof(uint32_t) > kMaskCacheSize) {
+      uint8_t *buffer;
+      nsresult rv = mRandomGenerator->GenerateRandomBytes(kMaskCacheSize,
+                                                          &buffer);
+      if (NS_FAILED(rv)) {
+        LOG(("WebSocketChannel::PrimeNewOutgoingMessage(): "
+             "GenerateRandomBytes failure %x\n", rv));
+        StopSession(rv);
+        return;
+      }
+      memcpy(mMaskCache, buffer, kMaskCacheSize);
+      free(buffer);
+      mMaskCacheOffset = 0;
     }
-    mask = * reinterpret_cast<uint32_t *>(buffer);
-    free(buffer);
+    mask = * reinterpret_cast<uint32_t *>(mMaskCache + mMaskCacheOffset);
+    mMaskCacheOffset += sizeof(uint32_t);
   } while (!mask);
   NetworkEndian::writeUint32(payload - sizeof(uint32_t), mask);
 
@@ -2079,6 +2089,83 @@ WebSocketChannel::PrimeNewOutgoingMessage()
   // compression process,
 }
 
+bool
+WebSocketChannel::NextOutgoingMessageIsSmall()
+{
+  // Look at the queues in the order PrimeNewOutgoingMessage() takes from them
+  OutboundMessage *next =
+    (OutboundMessage *)mOutgoingPongMessages.PeekFront();
+  if (!next)
+    next = (OutboundMessage *)mOutgoingPingMessages.PeekFront();
+  if (!next)
+    next = (OutboundMessage *)mOutgoingMessages.PeekFront();
+  if (!next)
+    return false;
+
+  switch (next->GetMsgType()) {
+  case kMsgTypeString:
+  case kMsgTypeBinaryString:
+  case kMsgTypePing:
+  case kMsgTypePong:
+    return next->Length() <= kCopyBreak;
+  default:
+    return false;
+  }
+}
+
+void
+WebSocketChannel::CoalesceSmallFrames()
+{
+  MOZ_ASSERT(mCurrentOut, "no current message");
+
+  // Only gather when nothing of the current frame was written yet, all of it
+  // sits in mOutHeader, and another small frame is waiting behind it.
+  if (mHdrOut != mOutHeader ||
+      mCurrentOut->GetMsgType() == kMsgTypeFin ||
+      mCurrentOutSent != (uint32_t)mCurrentOut->Length() ||
+      !NextOutgoingMessageIsSmall()) {
+    return;
+  }
+
+  if (mDynamicOutputSize < kCoalesceLimit + sizeof(mOutHeader)) {
+    mDynamicOutputSize = kCoalesceLimit + sizeof(mOutHeader);
+    mDynamicOutput =
+      (uint8_t *) moz_xrealloc(mDynamicOutput, mDynamicOutputSize);
+  }
+
+  uint32_t batched = 0;
+  while (true) {
+    memcpy(mDynamicOutput + batched, mOutHeader, mHdrOutToSend);
+    batched += mHdrOutToSend;
+
+    // Stop at a frame whose payload isn't in mOutHeader; its header still
+    // goes out with the batch and the payload follows as usual.
+    if (mCurrentOutSent != (uint32_t)mCurrentOut->Length() ||
+        batched > kCoalesceLimit ||
+        !NextOutgoingMessageIsSmall()) {
+      break;
+    }
+
+    mCoalescedCount++;
+    mCoalescedAckSize += mCurrentOut->OrigLength();
+    DeleteCurrentOutGoingMessage();
+    PrimeNewOutgoingMessage();
+
+    if (!mCurrentOut || !mSocketOut) {
+      // The session was stopped while priming, nothing left to send.
+      mCoalescedCount = 0;
+      mCoalescedAckSize = 0;
+      return;
+    }
+  }
+
+  LOG(("WebSocketChannel::CoalesceSmallFrames() %p gathered %u frames "
+       "into %u bytes\n", this, mCoalescedCount + 1, batched));
+
+  mHdrOut = mDynamicOutput;
+  mHdrOutToSend = batched;
+}
+
 void
 WebSocketChannel::DeleteCurrentOutGoingMessage()
 {
@@ -3632,6 +3719,11 @@ WebSocketChannel::OnOutputStreamReady(nsIAsyncOutputStream *aStream)
     uint32_t toSend;
     uint32_t amtSent;
 
+    // Write a run of small queued frames with a single socket write
+    CoalesceSmallFrames();
+    if (!mCurrentOut || !mSocketOut)
+      break;
+
     if (mHdrOut) {
       sndBuf = (const char *)mHdrOut;
       toSend = mHdrOutToSend;
@@ -3671,6 +3763,15 @@ WebSocketChannel::OnOutputStreamReady(nsIAsyncOutputStream *aStream)
       if (amtSent == toSend) {
         mHdrOut = nullptr;
         mHdrOutToSend = 0;
+        if (mCoalescedCount) {
+          if (!mStopped) {
+            mTargetThread->Dispatch(
+              new CallAcknowledge(this, mCoalescedAckSize),
+              NS_DISPATCH_NORMAL);
+          }
+          mCoalescedCount = 0;
+          mCoalescedAckSize = 0;
+        }
       } else {
         mHdrOut += amtSent;
         mHdrOutToSend -= amtSent;
@@ -141,6 +141,8 @@ private:
   void EnqueueOutgoingMessage(nsDeque &aQueue, OutboundMessage *aMsg);
 
   void PrimeNewOutgoingMessage();
+  bool NextOutgoingMessageIsSmall();
+  void CoalesceSmallFrames();
   void DeleteCurrentOutGoingMessage();
   void GeneratePong(uint8_t *payload, uint32_t len);
   void GeneratePing();
@@ -262,6 +264,10 @@ private:
 
   // These are for the send buffers
   const static int32_t kCopyBreak = 1000;
+  // Upper bound of the small frames gathered into one socket write.
+  const static uint32_t kCoalesceLimit = 16384;
+  // Masks are taken from a block of random bytes of this size.
+  const static uint32_t kMaskCacheSize = 256;
 
   OutboundMessage                *mCurrentOut;
   uint32_t                        mCurrentOutSent;
@@ -274,6 +280,13 @@ private:
   nsAutoPtr<PMCECompression>      mPMCECompressor;
   uint32_t                        mDynamicOutputSize;
   uint8_t                        *mDynamicOutput;
+  // Number and total original length of the messages whose frames were
+  // gathered into mDynamicOutput ahead of mCurrentOut.  They are
+  // acknowledged once that buffer has been written.
+  uint32_t                        mCoalescedCount;
+  uint32_t                        mCoalescedAckSize;
+  uint32_t                        mMaskCacheOffset;
+  uint8_t                         mMaskCache[kMaskCacheSize];
   bool                            mPrivateBrowsing;
 
   nsCOMPtr<nsIDashboardEventNotifier> mConnectionLogService;
@@ -23,6 +23,15 @@
 namespace mozilla {
 namespace net {
 
+// Decoded data is handed to the listener in chunks of at least this size, so
+// small network segments don't turn into many small inflate rounds and
+// OnDataAvailable calls.
+static const uint32_t kMinOutBufferLen = 32 * 1024;
+
+// Output chunk size for brotli, which is called in a loop until all the input
+// is consumed.
+static const uint32_t kBrotliOutBufferLen = 128 * 1024;
+
 // nsISupports implementation
 NS_IMPL_ISUPPORTS(nsHTTPCompressConv,
                   nsIStreamConverter,
@@ -143,8 +152,6 @@ nsHTTPCompressConv::BrotliHandler(nsIInputStream *stream, void *closure, const c
   nsHTTPCompressConv *self = static_cast<nsHTTPCompressConv *>(closure);
   *countRead = 0;
 
-  const uint32_t kOutSize = 128 * 1024; // just a chunk size, we call in a loop
-  unsigned char outBuffer[kOutSize];
   unsigned char *outPtr;
   size_t outSize;
   size_t avail = aAvail;
@@ -155,10 +162,17 @@ nsHTTPCompressConv::BrotliHandler(nsIInputStream *stream, void *closure, const c
     return NS_OK;
   }
 
-  if (outBuffer == nullptr) {
-    self->mBrotli->mStatus = NS_ERROR_OUT_OF_MEMORY;
-    return self->mBrotli->mStatus;
+  // the output buffer is kept for the whole response
+  if (!self->mOutBuffer) {
+    self->mOutBuffer = (unsigned char *) malloc(kBrotliOutBufferLen);
+    if (!self->mOutBuffer) {
+      self->mBrotli->mStatus = NS_ERROR_OUT_OF_MEMORY;
+      return self->mBrotli->mStatus;
+    }
+    self->mOutBufferLen = kBrotliOutBufferLen;
   }
+  unsigned char *outBuffer = self->mOutBuffer;
+  const uint32_t kOutSize = self->mOutBufferLen;
 
   do {
     outSize = kOutSize;
@@ -249,25 +263,26 @@ nsHTTPCompressConv::OnDataAvailable(nsIRequest* request,
 
         case HTTP_COMPRESS_DEFLATE:
 
-            if (mInpBuffer != nullptr && streamLen > mInpBufferLen)
+            // both buffers are kept across calls and only ever grow
+            if (streamLen > mInpBufferLen)
             {
-                mInpBuffer = (unsigned char *) realloc(mInpBuffer, mInpBufferLen = streamLen);
-               
-                if (mOutBufferLen < streamLen * 2)
-                    mOutBuffer = (unsigned char *) realloc(mOutBuffer, mOutBufferLen = streamLen * 3);
-
-                if (mInpBuffer == nullptr || mOutBuffer == nullptr)
+                unsigned char *inpBuffer = (unsigned char *) realloc(mInpBuffer, streamLen);
+                if (inpBuffer == nullptr)
                     return NS_ERROR_OUT_OF_MEMORY;
+                mInpBuffer = inpBuffer;
+                mInpBufferLen = streamLen;
             }
 
-            if (mInpBuffer == nullptr)
-                mInpBuffer = (unsigned char *) malloc(mInpBufferLen = streamLen);
-
-            if (mOutBuffer == nullptr)
-                mOutBuffer = (unsigned char *) malloc(mOutBufferLen = streamLen * 3);
-
-            if (mInpBuffer == nullptr || mOutBuffer == nullptr)
-                return NS_ERROR_OUT_OF_MEMORY;
+            if (mOutBufferLen < streamLen * 2 || mOutBufferLen < kMinOutBufferLen)
+            {
+                uint32_t outBufferLen = (streamLen > kMinOutBufferLen / 3) ?
+                                        streamLen * 3 : kMinOutBufferLen;
+                unsigned char *outBuffer = (unsigned char *) realloc(mOutBuffer, outBufferLen);
+                if (outBuffer == nullptr)
+                    return NS_ERROR_OUT_OF_MEMORY;
+                mOutBuffer = outBuffer;
+                mOutBufferLen = outBufferLen;
+            }
 
             uint32_t unused;
             iStr->Read((char *)mInpBuffer, streamLen, &unused);
@@ -31,7 +31,8 @@ nsHtml5SpeculativeLoad::Perform(nsHtml5TreeOpExecutor* aExecutor)
       aExecutor->SetSpeculationReferrerPolicy(mReferrerPolicy);
       break;
     case eSpeculativeLoadImage:
-      aExecutor->PreloadImage(mUrl, mCrossOrigin, mSrcset, mSizes, mReferrerPolicy);
+      aExecutor->PreloadImage(mUrl, mCrossOrigin, mSrcset, mSizes,
+                              mReferrerPolicy, mWidth, mHeight);
       break;
     case eSpeculativeLoadOpenPicture:
       aExecutor->PreloadOpenPicture();
@@ -53,7 +53,9 @@ class nsHtml5SpeculativeLoad {
                           const nsAString& aCrossOrigin,
                           const nsAString& aReferrerPolicy,
                           const nsAString& aSrcset,
-                          const nsAString& aSizes)
+                          const nsAString& aSizes,
+                          const nsAString& aWidth,
+                          const nsAString& aHeight)
     {
       NS_PRECONDITION(mOpCode == eSpeculativeLoadUninitialized,
                       "Trying to reinitialize a speculative load!");
@@ -64,6 +66,8 @@ class nsHtml5SpeculativeLoad {
         nsContentUtils::TrimWhitespace<nsContentUtils::IsHTMLWhitespace>(aReferrerPolicy));
       mSrcset.Assign(aSrcset);
       mSizes.Assign(aSizes);
+      mWidth.Assign(aWidth);
+      mHeight.Assign(aHeight);
     }
 
     // <picture> elements have multiple <source> nodes followed by an <img>,
@@ -229,6 +233,13 @@ class nsHtml5SpeculativeLoad {
      * string.
      */
     nsString mIntegrity;
+    /**
+     * If mOpCode is eSpeculativeLoadImage, these are the values of the "width"
+     * and "height" attributes.  If an attribute is not set, it will be a void
+     * string.
+     */
+    nsString mWidth;
+    nsString mHeight;
 };
 
 #endif // nsHtml5SpeculativeLoad_h
@@ -131,12 +131,18 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace, nsIAtom* aName,
             aAttributes->getValue(nsHtml5AttributeName::ATTR_REFERRER);
           nsString* sizes =
             aAttributes->getValue(nsHtml5AttributeName::ATTR_SIZES);
+          nsString* width =
+            aAttributes->getValue(nsHtml5AttributeName::ATTR_WIDTH);
+          nsString* height =
+            aAttributes->getValue(nsHtml5AttributeName::ATTR_HEIGHT);
           mSpeculativeLoadQueue.AppendElement()->
             InitImage(url ? *url : NullString(),
                       crossOrigin ? *crossOrigin : NullString(),
                       referrerPolicy ? *referrerPolicy : NullString(),
                       srcset ? *srcset : NullString(),
-                      sizes ? *sizes : NullString());
+                      sizes ? *sizes : NullString(),
+                      width ? *width : NullString(),
+                      height ? *height : NullString());
         } else if (nsHtml5Atoms::source == aName) {
           nsString* srcset =
             aAttributes->getValue(nsHtml5AttributeName::ATTR_SRCSET);
@@ -213,6 +219,8 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace, nsIAtom* aName,
           nsString* url = aAttributes->getValue(nsHtml5AttributeName::ATTR_POSTER);
           if (url) {
             mSpeculativeLoadQueue.AppendElement()->InitImage(*url, NullString(),
+                                                             NullString(),
+                                                             NullString(),
                                                              NullString(),
                                                              NullString(),
                                                              NullString());
@@ -250,6 +258,8 @@ nsHtml5TreeBuilder::createElement(int32_t aNamespace, nsIAtom* aName,
           nsString* url = aAttributes->getValue(nsHtml5AttributeName::ATTR_XLINK_HREF);
           if (url) {
             mSpeculativeLoadQueue.AppendElement()->InitImage(*url, NullString(),
+                                                             NullString(),
+                                                             NullString(),
                                                              NullString(),
                                                              NullString(),
                                                              NullString());
@@ -938,12 +938,34 @@ nsHtml5TreeOpExecutor::PreloadStyle(const nsAString& aURL,
                           mSpeculationReferrerPolicy, aIntegrity);
 }
 
+// Returns the number of CSS pixels given by a width or height attribute, or 0
+// if the attribute is missing, a percentage, or otherwise unusable.
+static int32_t
+ParseDimensionForPreload(const nsAString& aValue)
+{
+  if (aValue.IsVoid()) {
+    return 0;
+  }
+
+  nsContentUtils::ParseHTMLIntegerResultFlags result;
+  int32_t value = nsContentUtils::ParseHTMLInteger(aValue, &result);
+  if ((result & (nsContentUtils::eParseHTMLInteger_Error |
+                 nsContentUtils::eParseHTMLInteger_IsPercent)) ||
+      value <= 0) {
+    return 0;
+  }
+
+  return value;
+}
+
 void
 nsHtml5TreeOpExecutor::PreloadImage(const nsAString& aURL,
                                     const nsAString& aCrossOrigin,
                                     const nsAString& aSrcset,
                                     const nsAString& aSizes,
-                                    const nsAString& aImageReferrerPolicy)
+                                    const nsAString& aImageReferrerPolicy,
+                                    const nsAString& aWidth,
+                                    const nsAString& aHeight)
 {
   nsCOMPtr<nsIURI> baseURI = BaseURIForPreload();
   nsCOMPtr<nsIURI> uri = mDocument->ResolvePreloadImage(baseURI, aURL, aSrcset,
@@ -960,7 +982,12 @@ nsHtml5TreeOpExecutor::PreloadImage(const nsAString& aURL,
       }
     }
 
-    mDocument->MaybePreLoadImage(uri, aCrossOrigin, referrerPolicy);
+    // The size the image will be laid out at, in CSS pixels, if the width and
+    // height attributes pin it down.
+    CSSIntSize cssSize(ParseDimensionForPreload(aWidth),
+                       ParseDimensionForPreload(aHeight));
+
+    mDocument->MaybePreLoadImage(uri, aCrossOrigin, referrerPolicy, cssSize);
   }
 }
 
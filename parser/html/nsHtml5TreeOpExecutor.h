@@ -259,7 +259,9 @@ class nsHtml5TreeOpExecutor final : public nsHtml5DocumentBuilder,
                       const nsAString& aCrossOrigin,
                       const nsAString& aSrcset,
                       const nsAString& aSizes,
-                      const nsAString& aImageReferrerPolicy);
+                      const nsAString& aImageReferrerPolicy,
+                      const nsAString& aWidth,
+                      const nsAString& aHeight);
 
     void PreloadOpenPicture();
 
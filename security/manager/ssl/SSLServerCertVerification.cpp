@@ -94,6 +94,7 @@
 
 #include "SSLServerCertVerification.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pkix/pkix.h"
@@ -132,6 +133,7 @@
 #include "secoidt.h"
 #include "secport.h"
 #include "sslerr.h"
+#include "prsystem.h"
 
 extern PRLogModuleInfo* gPIPNSSLog;
 
@@ -179,9 +181,14 @@ InitializeSSLServerCertVerificationThreads()
     return;
   }
 
-  (void) gCertVerificationThreadPool->SetIdleThreadLimit(5);
+  // Verification threads spend much of their time blocked on OCSP fetches,
+  // so keep at least five, but let machines with more cores verify more
+  // chains at once.
+  int32_t processors = PR_GetNumberOfProcessors();
+  uint32_t threadLimit = processors > 5 ? std::min(processors, 16) : 5;
+  (void) gCertVerificationThreadPool->SetIdleThreadLimit(threadLimit);
   (void) gCertVerificationThreadPool->SetIdleThreadTimeout(30 * 1000);
-  (void) gCertVerificationThreadPool->SetThreadLimit(5);
+  (void) gCertVerificationThreadPool->SetThreadLimit(threadLimit);
   (void) gCertVerificationThreadPool->SetName(NS_LITERAL_CSTRING("SSL Cert"));
 }
 
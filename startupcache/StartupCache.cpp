@@ -7,6 +7,7 @@
 #include "prio.h"
 #include "pldhash.h"
 #include "nsXPCOMStrings.h"
+#include "mozilla/FileUtils.h"
 #include "mozilla/IOInterposer.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/scache/StartupCache.h"
@@ -248,7 +249,16 @@ StartupCache::LoadArchive(enum TelemetrifyAge flag)
   nsresult rv = mFile->Exists(&exists);
   if (NS_FAILED(rv) || !exists)
     return NS_ERROR_FILE_NOT_FOUND;
-  
+
+  // At startup, entries are pulled out of the archive one at a time in
+  // whatever order startup happens to need them, which turns into scattered
+  // page faults on the mapping. The whole file is going to be read anyway, so
+  // ask the OS to pull it in sequentially up front. Reloads after a write
+  // don't need this; the file is already in the page cache.
+  if (flag == RECORD_AGE) {
+    mozilla::ReadAheadFile(mFile);
+  }
+
   mArchive = new nsZipArchive();
   rv = mArchive->OpenArchive(mFile);
   if (NS_FAILED(rv) || flag == IGNORE_AGE)
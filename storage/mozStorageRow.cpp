@@ -22,6 +22,7 @@ Row::initialize(sqlite3_stmt *aStatement)
 {
   // Get the number of results
   mNumCols = ::sqlite3_column_count(aStatement);
+  mData.SetCapacity(mNumCols);
 
   // Start copying over values
   for (uint32_t i = 0; i < mNumCols; i++) {
@@ -59,13 +60,12 @@ Row::initialize(sqlite3_stmt *aStatement)
     NS_ENSURE_TRUE(variant, NS_ERROR_OUT_OF_MEMORY);
 
     // Insert into our storage array
-    NS_ENSURE_TRUE(mData.InsertObjectAt(variant, i), NS_ERROR_OUT_OF_MEMORY);
+    NS_ENSURE_TRUE(mData.AppendObject(variant), NS_ERROR_OUT_OF_MEMORY);
 
     // Associate the name (if any) with the index
     const char *name = ::sqlite3_column_name(aStatement, i);
     if (!name) break;
-    nsAutoCString colName(name);
-    mNameHashtable.Put(colName, i);
+    mNameHashtable.Put(nsDependentCString(name), i);
   }
 
   return NS_OK;
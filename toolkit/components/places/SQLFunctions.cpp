@@ -206,31 +206,37 @@ namespace places {
                                           int32_t aMatchBehavior,
                                           nsCString &_fixedSpec)
   {
+    // This runs for every candidate row, so avoid copying the spec when
+    // there is nothing to unescape, which is the common case.
     nsCString unescapedSpec;
-    (void)NS_UnescapeURL(aURISpec, esc_SkipControl | esc_AlwaysCopy,
-                         unescapedSpec);
+    const nsCSubstring& unescaped =
+      NS_UnescapeURL(aURISpec, esc_SkipControl, unescapedSpec);
 
     // If this unescaped string is valid UTF-8, we'll use it.  Otherwise,
     // we will simply use our original string.
+    const nsCSubstring& spec =
+      (&unescaped == &aURISpec || IsUTF8(unescapedSpec)) ? unescaped : aURISpec;
+
     NS_ASSERTION(_fixedSpec.IsEmpty(),
                  "Passing a non-empty string as an out parameter!");
-    if (IsUTF8(unescapedSpec))
-      _fixedSpec.Assign(unescapedSpec);
-    else
-      _fixedSpec.Assign(aURISpec);
-
-    if (aMatchBehavior == mozIPlacesAutoComplete::MATCH_ANYWHERE_UNMODIFIED)
+    if (aMatchBehavior == mozIPlacesAutoComplete::MATCH_ANYWHERE_UNMODIFIED) {
+      _fixedSpec.Assign(spec);
       return;
+    }
 
-    if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("http://")))
-      _fixedSpec.Cut(0, 7);
-    else if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("https://")))
-      _fixedSpec.Cut(0, 8);
-    else if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("ftp://")))
-      _fixedSpec.Cut(0, 6);
+    // Work out how much to strip before copying, so we copy at most once.
+    uint32_t start = 0;
+    if (StringBeginsWith(spec, NS_LITERAL_CSTRING("http://")))
+      start = 7;
+    else if (StringBeginsWith(spec, NS_LITERAL_CSTRING("https://")))
+      start = 8;
+    else if (StringBeginsWith(spec, NS_LITERAL_CSTRING("ftp://")))
+      start = 6;
 
-    if (StringBeginsWith(_fixedSpec, NS_LITERAL_CSTRING("www.")))
-      _fixedSpec.Cut(0, 4);
+    if (StringBeginsWith(Substring(spec, start), NS_LITERAL_CSTRING("www.")))
+      start += 4;
+
+    _fixedSpec.Assign(Substring(spec, start));
   }
 
   /* static */
@@ -386,9 +392,12 @@ namespace places {
     // Obtain our search function.
     searchFunctionPtr searchFunction = getSearchFunction(matchBehavior);
 
-    // Clean up our URI spec and prepare it for searching.
+    // Clean up our URI spec and prepare it for searching.  Title-only
+    // searches never look at it.
     nsCString fixedURI;
-    fixupURISpec(url, matchBehavior, fixedURI);
+    if (HAS_BEHAVIOR(URL) || !HAS_BEHAVIOR(TITLE)) {
+      fixupURISpec(url, matchBehavior, fixedURI);
+    }
 
     nsAutoCString title;
     (void)aArguments->GetUTF8String(kArgIndexTitle, title);
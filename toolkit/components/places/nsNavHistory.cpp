@@ -3200,9 +3200,12 @@ nsNavHistory::DecayFrecency()
   // original value after 28 days.
   // When changing the scaling factor, ensure that the barrier in
   // moz_places_afterupdate_frecency_trigger still ignores these changes.
+  // Rounding leaves small frecencies (below 20) unchanged, so skip those rows
+  // rather than rewriting them, and firing the trigger, for nothing; on large
+  // histories they are the bulk of the table.
   nsCOMPtr<mozIStorageAsyncStatement> decayFrecency = mDB->GetAsyncStatement(
     "UPDATE moz_places SET frecency = ROUND(frecency * .975) "
-    "WHERE frecency > 0"
+    "WHERE frecency > 0 AND ROUND(frecency * .975) <> frecency"
   );
   NS_ENSURE_STATE(decayFrecency);
 
@@ -31,6 +31,7 @@
 #include "nsBinaryStream.h"
 #include "nsStorageStream.h"
 #include "nsPipe.h"
+#include "nsSegmentedBuffer.h"
 #include "nsScriptableBase64Encoder.h"
 
 #include "nsMemoryImpl.h"
@@ -980,6 +981,8 @@ ShutdownXPCOM(nsIServiceManager* aServMgr)
   nsComponentManagerImpl::gComponentManager = nullptr;
   nsCategoryManager::Destroy();
 
+  nsSegmentedBuffer::ShutdownSegmentPool();
+
   NS_PurgeAtomTable();
 
   NS_IF_RELEASE(gDebug);
@@ -68,23 +68,27 @@ nsObserverList::GetObserverList(nsISimpleEnumerator** anEnumerator)
 }
 
 void
-nsObserverList::FillObserverArray(nsCOMArray<nsIObserver>& aArray)
+nsObserverList::FillObserverArray(nsTArray<nsCOMPtr<nsIObserver>>& aArray)
 {
   aArray.SetCapacity(mObservers.Length());
 
-  nsTArray<ObserverRef> observers(mObservers);
+  // Resolving a weak reference can run script, which may add or remove
+  // observers, so walk a snapshot.  Most topics only have a handful of
+  // observers; keep the snapshot on the stack for those.
+  nsAutoTArray<ObserverRef, 16> observers;
+  observers.AppendElements(mObservers);
 
   for (int32_t i = observers.Length() - 1; i >= 0; --i) {
     if (observers[i].isWeakRef) {
       nsCOMPtr<nsIObserver> o(do_QueryReferent(observers[i].asWeak()));
       if (o) {
-        aArray.AppendObject(o);
+        aArray.AppendElement(o.forget());
       } else {
         // the object has gone away, remove the weakref
         mObservers.RemoveElement(observers[i].asWeak());
       }
     } else {
-      aArray.AppendObject(observers[i].asObserver());
+      aArray.AppendElement(observers[i].asObserver());
     }
   }
 }
@@ -106,10 +110,11 @@ nsObserverList::NotifyObservers(nsISupports* aSubject,
                                 const char* aTopic,
                                 const char16_t* someData)
 {
-  nsCOMArray<nsIObserver> observers;
+  // Hot topics fire often enough that the array allocation shows up.
+  nsAutoTArray<nsCOMPtr<nsIObserver>, 16> observers;
   FillObserverArray(observers);
 
-  for (int32_t i = 0; i < observers.Count(); ++i) {
+  for (uint32_t i = 0; i < observers.Length(); ++i) {
     observers[i]->Observe(aSubject, aTopic, someData);
   }
 }
@@ -125,14 +130,14 @@ nsObserverEnumerator::nsObserverEnumerator(nsObserverList* aObserverList)
 NS_IMETHODIMP
 nsObserverEnumerator::HasMoreElements(bool* aResult)
 {
-  *aResult = (mIndex < mObservers.Count());
+  *aResult = (mIndex < mObservers.Length());
   return NS_OK;
 }
 
 NS_IMETHODIMP
 nsObserverEnumerator::GetNext(nsISupports** aResult)
 {
-  if (mIndex == mObservers.Count()) {
+  if (mIndex == mObservers.Length()) {
     NS_ERROR("Enumerating after HasMoreElements returned false.");
     return NS_ERROR_UNEXPECTED;
   }
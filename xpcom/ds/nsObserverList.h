@@ -66,7 +66,7 @@ public:
 
   // Fill an array with the observers of this category.
   // The array is filled in last-added-first order.
-  void FillObserverArray(nsCOMArray<nsIObserver>& aArray);
+  void FillObserverArray(nsTArray<nsCOMPtr<nsIObserver>>& aArray);
 
   // Like FillObserverArray(), but only for strongly held observers.
   void AppendStrongObservers(nsCOMArray<nsIObserver>& aArray);
@@ -86,8 +86,8 @@ public:
 private:
   ~nsObserverEnumerator() {}
 
-  int32_t mIndex; // Counts up from 0
-  nsCOMArray<nsIObserver> mObservers;
+  uint32_t mIndex; // Counts up from 0
+  nsTArray<nsCOMPtr<nsIObserver>> mObservers;
 };
 
 #endif /* nsObserverList_h___ */
@@ -6,6 +6,90 @@
 
 #include "nsSegmentedBuffer.h"
 #include "nsMemory.h"
+#include "mozilla/StaticMutex.h"
+
+using mozilla::StaticMutex;
+using mozilla::StaticMutexAutoLock;
+
+// Pipes and storage streams come and go constantly on the network and cache
+// paths, each allocating and freeing segments of a handful of sizes.  Keep a
+// small, process-wide free list per power-of-two segment size so those
+// segments are reused instead of going back to the allocator.
+//
+// Freed segments are chained through their first word.
+static const uint32_t kMinPooledSegmentShift = 12;  // 4k
+static const uint32_t kMaxPooledSegmentShift = 16;  // 64k
+static const uint32_t kSegmentPoolClassCount =
+  kMaxPooledSegmentShift - kMinPooledSegmentShift + 1;
+// Upper bound of the memory each size class may keep cached.
+static const uint32_t kSegmentPoolMaxBytesPerClass = 256 * 1024;
+
+static StaticMutex sSegmentPoolLock;
+static char* sSegmentPool[kSegmentPoolClassCount];
+static uint32_t sSegmentPoolCount[kSegmentPoolClassCount];
+static bool sSegmentPoolShutdown = false;
+
+// Returns the size class of aSize, or -1 if segments of that size are not
+// pooled.
+static int32_t
+SegmentPoolClass(uint32_t aSize)
+{
+  for (uint32_t i = 0; i < kSegmentPoolClassCount; ++i) {
+    if (aSize == (1u << (kMinPooledSegmentShift + i))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static char*
+AllocSegment(uint32_t aSize)
+{
+  int32_t sizeClass = SegmentPoolClass(aSize);
+  if (sizeClass >= 0) {
+    StaticMutexAutoLock lock(sSegmentPoolLock);
+    char* seg = sSegmentPool[sizeClass];
+    if (seg) {
+      sSegmentPool[sizeClass] = *reinterpret_cast<char**>(seg);
+      --sSegmentPoolCount[sizeClass];
+      return seg;
+    }
+  }
+  return (char*)malloc(aSize);
+}
+
+static void
+FreeSegment(char* aSegment, uint32_t aSize, bool aRecycle)
+{
+  int32_t sizeClass = aRecycle ? SegmentPoolClass(aSize) : -1;
+  if (sizeClass >= 0) {
+    StaticMutexAutoLock lock(sSegmentPoolLock);
+    if (!sSegmentPoolShutdown &&
+        (sSegmentPoolCount[sizeClass] + 1) * aSize <=
+          kSegmentPoolMaxBytesPerClass) {
+      *reinterpret_cast<char**>(aSegment) = sSegmentPool[sizeClass];
+      sSegmentPool[sizeClass] = aSegment;
+      ++sSegmentPoolCount[sizeClass];
+      return;
+    }
+  }
+  free(aSegment);
+}
+
+/* static */ void
+nsSegmentedBuffer::ShutdownSegmentPool()
+{
+  StaticMutexAutoLock lock(sSegmentPoolLock);
+  sSegmentPoolShutdown = true;
+  for (uint32_t i = 0; i < kSegmentPoolClassCount; ++i) {
+    while (sSegmentPool[i]) {
+      char* seg = sSegmentPool[i];
+      sSegmentPool[i] = *reinterpret_cast<char**>(seg);
+      free(seg);
+    }
+    sSegmentPoolCount[i] = 0;
+  }
+}
 
 nsresult
 nsSegmentedBuffer::Init(uint32_t aSegmentSize, uint32_t aMaxSize)
@@ -64,7 +148,7 @@ nsSegmentedBuffer::AppendNewSegment()
     mSegmentArrayCount = newArraySize;
   }
 
-  char* seg = (char*)malloc(mSegmentSize);
+  char* seg = AllocSegment(mSegmentSize);
   if (!seg) {
     return nullptr;
   }
@@ -77,7 +161,8 @@ bool
 nsSegmentedBuffer::DeleteFirstSegment()
 {
   NS_ASSERTION(mSegmentArray[mFirstSegmentIndex] != nullptr, "deleting bad segment");
-  free(mSegmentArray[mFirstSegmentIndex]);
+  FreeSegment(mSegmentArray[mFirstSegmentIndex], mSegmentSize,
+              mRecycleSegments);
   mSegmentArray[mFirstSegmentIndex] = nullptr;
   int32_t last = ModSegArraySize(mLastSegmentIndex - 1);
   if (mFirstSegmentIndex == last) {
@@ -94,7 +179,7 @@ nsSegmentedBuffer::DeleteLastSegment()
 {
   int32_t last = ModSegArraySize(mLastSegmentIndex - 1);
   NS_ASSERTION(mSegmentArray[last] != nullptr, "deleting bad segment");
-  free(mSegmentArray[last]);
+  FreeSegment(mSegmentArray[last], mSegmentSize, mRecycleSegments);
   mSegmentArray[last] = nullptr;
   mLastSegmentIndex = last;
   return (bool)(mLastSegmentIndex == mFirstSegmentIndex);
@@ -107,6 +192,7 @@ nsSegmentedBuffer::ReallocLastSegment(size_t aNewSize)
   NS_ASSERTION(mSegmentArray[last] != nullptr, "realloc'ing bad segment");
   char* newSegment = (char*)realloc(mSegmentArray[last], aNewSize);
   if (newSegment) {
+    mRecycleSegments = false;
     mSegmentArray[last] = newSegment;
     return true;
   }
@@ -119,7 +205,7 @@ nsSegmentedBuffer::Empty()
   if (mSegmentArray) {
     for (uint32_t i = 0; i < mSegmentArrayCount; i++) {
       if (mSegmentArray[i]) {
-        free(mSegmentArray[i]);
+        FreeSegment(mSegmentArray[i], mSegmentSize, mRecycleSegments);
       }
     }
     free(mSegmentArray);
@@ -19,6 +19,7 @@ public:
     , mSegmentArrayCount(0)
     , mFirstSegmentIndex(0)
     , mLastSegmentIndex(0)
+    , mRecycleSegments(true)
   {
   }
 
@@ -44,6 +45,10 @@ public:
 
   void Empty();               // frees all segments
 
+  // Frees the segments cached for reuse by all buffers.  Called once at
+  // XPCOM shutdown.
+  static void ShutdownSegmentPool();
+
   inline uint32_t GetSegmentCount()
   {
     if (mFirstSegmentIndex <= mLastSegmentIndex) {
@@ -94,6 +99,9 @@ protected:
   uint32_t            mSegmentArrayCount;
   int32_t             mFirstSegmentIndex;
   int32_t             mLastSegmentIndex;
+  // False once a segment may have been resized, so segments no longer
+  // match a pool size class and are released straight to the allocator.
+  bool                mRecycleSegments;
 };
 
 // NS_SEGMENTARRAY_INITIAL_SIZE: This number needs to start out as a
@@ -13,6 +13,7 @@
 #include "nscore.h"
 #include "mozilla/Assertions.h"
 #include "mozilla/SSE.h"
+#include "mozilla/ppc.h"
 
 #include "nsCharTraits.h"
 
@@ -655,6 +656,12 @@ public:
       write_sse2(aSource, aSourceLength);
       return;
     }
+#endif
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+    if (mozilla::supports_vmx()) {
+      write_vmx(aSource, aSourceLength);
+      return;
+    }
 #endif
     const char* done_writing = aSource + aSourceLength;
     while (aSource < done_writing) {
@@ -665,6 +672,11 @@ public:
   void
   write_sse2(const char* aSource, uint32_t aSourceLength);
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+  void
+  write_vmx(const char* aSource, uint32_t aSourceLength);
+#endif
+
   void
   write_terminator()
   {
@@ -699,6 +711,12 @@ public:
       write_sse2(aSource, aSourceLength);
       return;
     }
+#endif
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+    if (mozilla::supports_vmx()) {
+      write_vmx(aSource, aSourceLength);
+      return;
+    }
 #endif
     const char16_t* done_writing = aSource + aSourceLength;
     while (aSource < done_writing) {
@@ -711,6 +729,11 @@ public:
   write_sse2(const char16_t* aSource, uint32_t aSourceLength);
 #endif
 
+#ifdef MOZILLA_MAY_SUPPORT_VMX
+  void
+  write_vmx(const char16_t* aSource, uint32_t aSourceLength);
+#endif
+
   void
   write_terminator()
   {
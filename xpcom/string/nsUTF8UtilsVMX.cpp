@@ -0,0 +1,123 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nscore.h"
+#include "nsAlgorithm.h"
+#include "mozilla/Endian.h"
+#include <altivec.h>
+#include <string.h>
+#include <nsUTF8Utils.h>
+
+union ByteVector {
+  vector unsigned char v;
+  unsigned char b[16];
+};
+
+// Zero extends eight bytes of aSource into eight char16_t. Which half of the
+// merge ends up as the high-order byte depends on the byte order.
+static inline vector unsigned char
+ZeroExtendHigh(vector unsigned char aSource)
+{
+  vector unsigned char zero = vec_splat_u8(0);
+#if MOZ_LITTLE_ENDIAN
+  return vec_mergeh(aSource, zero);
+#else
+  return vec_mergeh(zero, aSource);
+#endif
+}
+
+static inline vector unsigned char
+ZeroExtendLow(vector unsigned char aSource)
+{
+  vector unsigned char zero = vec_splat_u8(0);
+#if MOZ_LITTLE_ENDIAN
+  return vec_mergel(aSource, zero);
+#else
+  return vec_mergel(zero, aSource);
+#endif
+}
+
+void
+LossyConvertEncoding16to8::write_vmx(const char16_t* aSource,
+                                     uint32_t aSourceLength)
+{
+  char* dest = mDestination;
+
+  // Align source to a 16-byte boundary, as required by vec_ld.
+  uint32_t i = 0;
+  uint32_t alignLen =
+    XPCOM_MIN<uint32_t>(aSourceLength,
+                        uint32_t(-NS_PTR_TO_INT32(aSource) & 0xf) / sizeof(char16_t));
+  for (; i < alignLen; ++i) {
+    dest[i] = static_cast<unsigned char>(aSource[i]);
+  }
+
+  // Walk 64 bytes (four vector registers) at a time.
+  ByteVector packed[2];
+  for (; aSourceLength - i > 31; i += 32) {
+    const unsigned short* source =
+      reinterpret_cast<const unsigned short*>(aSource + i);
+    vector unsigned short source1 = vec_ld(0, source);
+    vector unsigned short source2 = vec_ld(16, source);
+    vector unsigned short source3 = vec_ld(32, source);
+    vector unsigned short source4 = vec_ld(48, source);
+
+    // vec_pack truncates every uint16_t to its low-order byte, which is
+    // exactly the lossy conversion we want, so there is no need to mask.
+    packed[0].v = vec_pack(source1, source2);
+    packed[1].v = vec_pack(source3, source4);
+
+    // The destination isn't necessarily aligned.
+    memcpy(dest + i, packed, sizeof(packed));
+  }
+
+  // Finish up the rest.
+  for (; i < aSourceLength; ++i) {
+    dest[i] = static_cast<unsigned char>(aSource[i]);
+  }
+
+  mDestination += i;
+}
+
+void
+LossyConvertEncoding8to16::write_vmx(const char* aSource,
+                                     uint32_t aSourceLength)
+{
+  char16_t* dest = mDestination;
+
+  // Align source to a 16-byte boundary.  We choose to align source rather than
+  // dest because we'd rather have our loads than our stores be fast.
+  uint32_t i = 0;
+  uint32_t alignLen = XPCOM_MIN(aSourceLength,
+                                uint32_t(-NS_PTR_TO_INT32(aSource) & 0xf));
+  for (; i < alignLen; ++i) {
+    dest[i] = static_cast<unsigned char>(aSource[i]);
+  }
+
+  // Walk 32 bytes (two vector registers) at a time.
+  ByteVector widened[4];
+  for (; aSourceLength - i > 31; i += 32) {
+    const unsigned char* source =
+      reinterpret_cast<const unsigned char*>(aSource + i);
+    vector unsigned char source1 = vec_ld(0, source);
+    vector unsigned char source2 = vec_ld(16, source);
+
+    widened[0].v = ZeroExtendHigh(source1);
+    widened[1].v = ZeroExtendLow(source1);
+    widened[2].v = ZeroExtendHigh(source2);
+    widened[3].v = ZeroExtendLow(source2);
+
+    // The destination isn't necessarily aligned.
+    memcpy(dest + i, widened, sizeof(widened));
+  }
+
+  // Finish up whatever's left.
+  for (; i < aSourceLength; ++i) {
+    dest[i] = static_cast<unsigned char>(aSource[i]);
+  }
+
+  mDestination += i;
+}
@@ -21,6 +21,10 @@
 
 using namespace mozilla;
 
+// How late the timer thread may fire a timer so that the timers due soon
+// after it fire in the same wakeup. Timers are never fired early for this.
+static const double kCoalescingSlackMilliseconds = 1.0;
+
 NS_IMPL_ISUPPORTS(TimerThread, nsIRunnable, nsIObserver)
 
 TimerThread::TimerThread() :
@@ -308,6 +312,17 @@ TimerThread::Run()
 
         TimeStamp timeout = timer->mTimeout;
 
+        // Sleep until the last of the timers due within
+        // kCoalescingSlackMilliseconds of this one, so that they are all fired
+        // in one wakeup rather than each in its own.
+        TimeStamp coalesceUntil = timeout +
+          TimeDuration::FromMilliseconds(kCoalescingSlackMilliseconds);
+        for (uint32_t i = 1;
+             i < mTimers.Length() && mTimers[i]->mTimeout <= coalesceUntil;
+             ++i) {
+          timeout = mTimers[i]->mTimeout;
+        }
+
         // Don't wait at all (even for PR_INTERVAL_NO_WAIT) if the next timer
         // is due now or overdue.
         //
@@ -31,6 +31,7 @@ nsEventQueue::nsEventQueue()
   : mReentrantMonitor("nsEventQueue.mReentrantMonitor")
   , mHead(nullptr)
   , mTail(nullptr)
+  , mSparePage(nullptr)
   , mOffsetHead(0)
   , mOffsetTail(0)
 {
@@ -46,6 +47,9 @@ nsEventQueue::~nsEventQueue()
   if (mHead) {
     FreePage(mHead);
   }
+  if (mSparePage) {
+    FreePage(mSparePage);
+  }
 }
 
 bool
@@ -73,7 +77,7 @@ nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult)
       if (mOffsetHead == EVENTS_PER_PAGE) {
         Page* dead = mHead;
         mHead = mHead->mNext;
-        FreePage(dead);
+        ReleasePage(dead);
         mOffsetHead = 0;
       }
     }
@@ -106,14 +110,14 @@ nsEventQueue::PutEvent(already_AddRefed<nsIRunnable>&& aRunnable)
   ReentrantMonitorAutoEnter mon(mReentrantMonitor);
 
   if (!mHead) {
-    mHead = NewPage();
+    mHead = AcquirePage();
     MOZ_ASSERT(mHead);
 
     mTail = mHead;
     mOffsetHead = 0;
     mOffsetTail = 0;
   } else if (mOffsetTail == EVENTS_PER_PAGE) {
-    Page* page = NewPage();
+    Page* page = AcquirePage();
     MOZ_ASSERT(page);
 
     mTail->mNext = page;
@@ -124,7 +128,10 @@ nsEventQueue::PutEvent(already_AddRefed<nsIRunnable>&& aRunnable)
   event.swap(mTail->mEvents[mOffsetTail]);
   ++mOffsetTail;
   LOG(("EVENTQ(%p): notify\n", this));
-  mon.NotifyAll();
+  // Every waiter in GetEvent is a consumer that would take this one event, so
+  // waking more than one of them (e.g. all idle nsThreadPool threads) only
+  // makes the rest contend for the monitor and go back to sleep.
+  mon.Notify();
 }
 
 size_t
@@ -8,6 +8,7 @@
 #define nsEventQueue_h__
 
 #include <stdlib.h>
+#include <string.h>
 #include "mozilla/ReentrantMonitor.h"
 #include "nsIRunnable.h"
 #include "nsCOMPtr.h"
@@ -89,10 +90,36 @@ private:
     free(aPage);
   }
 
+  // A queue that is drained as fast as it is filled would otherwise allocate
+  // and free a page every EVENTS_PER_PAGE events, under the monitor.  Keep the
+  // most recently drained page around and hand it back out instead.
+  Page* AcquirePage()
+  {
+    Page* page = mSparePage;
+    if (!page) {
+      return NewPage();
+    }
+    mSparePage = nullptr;
+    return page;
+  }
+
+  void ReleasePage(Page* aPage)
+  {
+    if (mSparePage) {
+      FreePage(aPage);
+      return;
+    }
+    // The consumed slots still hold the (already-transferred) event pointers;
+    // PutEvent swaps into the slots, so they must be cleared before reuse.
+    memset(aPage, 0, sizeof(Page));
+    mSparePage = aPage;
+  }
+
   ReentrantMonitor mReentrantMonitor;
 
   Page* mHead;
   Page* mTail;
+  Page* mSparePage;
 
   uint16_t mOffsetHead;  // offset into mHead where next item is removed
   uint16_t mOffsetTail;  // offset into mTail where next item is added